@@ -606,6 +606,8 @@ Error ProjectSettings::setup(const String &p_path, const String &p_main_pack, bo
 
 	Compression::gzip_level = GLOBAL_GET("compression/formats/gzip/compression_level");
 
+	Compression::file_block_size = GLOBAL_GET("compression/formats/block_size");
+
 	return err;
 }
 
@@ -1238,6 +1240,8 @@ ProjectSettings::ProjectSettings() {
 	custom_prop_info["compression/formats/zstd/compression_level"] = PropertyInfo(Variant::INT, "compression/formats/zstd/compression_level", PROPERTY_HINT_RANGE, "1,22,1");
 	GLOBAL_DEF("compression/formats/zstd/window_log_size", Compression::zstd_window_log_size);
 	custom_prop_info["compression/formats/zstd/window_log_size"] = PropertyInfo(Variant::INT, "compression/formats/zstd/window_log_size", PROPERTY_HINT_RANGE, "10,30,1");
+	GLOBAL_DEF("compression/formats/zstd/pack_dictionary_size", 65536);
+	custom_prop_info["compression/formats/zstd/pack_dictionary_size"] = PropertyInfo(Variant::INT, "compression/formats/zstd/pack_dictionary_size", PROPERTY_HINT_RANGE, "0,1048576,1");
 
 	GLOBAL_DEF("compression/formats/zlib/compression_level", Compression::zlib_level);
 	custom_prop_info["compression/formats/zlib/compression_level"] = PropertyInfo(Variant::INT, "compression/formats/zlib/compression_level", PROPERTY_HINT_RANGE, "-1,9,1");
@@ -1245,6 +1249,9 @@ ProjectSettings::ProjectSettings() {
 	GLOBAL_DEF("compression/formats/gzip/compression_level", Compression::gzip_level);
 	custom_prop_info["compression/formats/gzip/compression_level"] = PropertyInfo(Variant::INT, "compression/formats/gzip/compression_level", PROPERTY_HINT_RANGE, "-1,9,1");
 
+	GLOBAL_DEF("compression/formats/block_size", Compression::file_block_size);
+	custom_prop_info["compression/formats/block_size"] = PropertyInfo(Variant::INT, "compression/formats/block_size", PROPERTY_HINT_RANGE, "1024,1048576,1,or_greater");
+
 	// These properties will not show up in the dialog nor in the documentation. If you want to exclude whole groups, see _get_property_list() method.
 	GLOBAL_DEF_INTERNAL("application/config/features", PackedStringArray());
 	GLOBAL_DEF_INTERNAL("internationalization/locale/translation_remaps", PackedStringArray());
@@ -32,13 +32,178 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/zip_io.h"
+#include "core/os/rw_lock.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 
 #include "thirdparty/misc/fastlz.h"
 
 #include <zlib.h>
 #include <zstd.h>
 
-int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode) {
+// Contexts are expensive to create, so every thread reuses its own.
+struct ZstdContexts {
+	ZSTD_CCtx *cctx = nullptr;
+	ZSTD_DCtx *dctx = nullptr;
+
+	~ZstdContexts() {
+		ZSTD_freeCCtx(cctx);
+		ZSTD_freeDCtx(dctx);
+	}
+};
+
+static thread_local ZstdContexts zstd_contexts;
+
+struct ZstdDictionary {
+	Vector<uint8_t> data;
+	ZSTD_DDict *ddict = nullptr;
+	ZSTD_CDict *cdict = nullptr;
+	int cdict_level = 0;
+};
+
+static RWLock zstd_dictionaries_lock;
+static HashMap<uint32_t, ZstdDictionary> zstd_dictionaries;
+
+uint32_t Compression::add_zstd_dictionary(const Vector<uint8_t> &p_dictionary) {
+	ERR_FAIL_COND_V_MSG(p_dictionary.size() < 8, 0, "Zstandard dictionaries can't be smaller than 8 bytes.");
+	uint32_t id = ZSTD_getDictID_fromDict(p_dictionary.ptr(), p_dictionary.size());
+	if (id == 0) {
+		// Raw content, like the dictionaries train_zstd_dictionary() makes. These have
+		// no ID of their own, so the compressed data can't record which one it needs.
+		id = hash_murmur3_buffer(p_dictionary.ptr(), p_dictionary.size());
+		id = id == 0 ? 1 : id;
+	}
+
+	RWLockWrite lock(zstd_dictionaries_lock);
+	if (!zstd_dictionaries.has(id)) {
+		ZstdDictionary &dictionary = zstd_dictionaries[id];
+		dictionary.data = p_dictionary;
+		dictionary.ddict = ZSTD_createDDict(p_dictionary.ptr(), p_dictionary.size());
+	}
+	return id;
+}
+
+static _FORCE_INLINE_ uint32_t _zstd_dmer_hash(const uint8_t *p_data, int p_bits) {
+	uint64_t dmer;
+	memcpy(&dmer, p_data, sizeof(dmer));
+	return uint32_t((dmer * 0x9E3779B97F4A7C15ULL) >> (64 - p_bits));
+}
+
+Vector<uint8_t> Compression::train_zstd_dictionary(const Vector<Vector<uint8_t>> &p_samples, int p_max_size) {
+	// Like the COVER algorithm of the Zstandard dictionary builder: the samples are
+	// split in as many epochs as segments fit in the dictionary, and each epoch
+	// contributes the segment made of the 8 byte sequences found in most samples.
+	const int DMER_SIZE = 8;
+	const int SEGMENT_SIZE = 64;
+	const int HASH_BITS = 20;
+	const uint32_t NO_DMER = UINT32_MAX;
+	ERR_FAIL_COND_V(p_max_size < SEGMENT_SIZE, Vector<uint8_t>());
+
+	LocalVector<uint8_t> data;
+	LocalVector<uint32_t> dmers; // Hash of the sequence starting at each byte of data.
+	LocalVector<uint32_t> frequencies; // How many samples have each sequence.
+	LocalVector<uint32_t> last_sample;
+	frequencies.resize(1 << HASH_BITS);
+	last_sample.resize(1 << HASH_BITS);
+	memset(frequencies.ptr(), 0, frequencies.size() * sizeof(uint32_t));
+	memset(last_sample.ptr(), 0xFF, last_sample.size() * sizeof(uint32_t));
+
+	for (int i = 0; i < p_samples.size(); i++) {
+		const Vector<uint8_t> &sample = p_samples[i];
+		uint32_t offset = data.size();
+		data.resize(offset + sample.size());
+		dmers.resize(offset + sample.size());
+		memcpy(data.ptr() + offset, sample.ptr(), sample.size());
+		for (int j = 0; j < sample.size(); j++) {
+			if (j + DMER_SIZE > sample.size()) {
+				dmers[offset + j] = NO_DMER; // Sequences don't span samples.
+				continue;
+			}
+			uint32_t hash = _zstd_dmer_hash(sample.ptr() + j, HASH_BITS);
+			dmers[offset + j] = hash;
+			if (last_sample[hash] != uint32_t(i)) {
+				last_sample[hash] = i;
+				frequencies[hash]++;
+			}
+		}
+	}
+
+	// Sequences found in a single sample don't help.
+	for (uint32_t i = 0; i < frequencies.size(); i++) {
+		if (frequencies[i] < 2) {
+			frequencies[i] = 0;
+		}
+	}
+
+	if (data.size() < uint32_t(SEGMENT_SIZE)) {
+		return Vector<uint8_t>();
+	}
+
+	// Zstandard finds matches at the end of the dictionary faster, so it's filled
+	// from the end, with the segments of the first epochs there.
+	Vector<uint8_t> dictionary;
+	dictionary.resize(MIN(p_max_size, int(data.size())));
+	int dictionary_start = dictionary.size();
+	uint32_t epoch_size = MAX(data.size() / (dictionary.size() / SEGMENT_SIZE), uint32_t(SEGMENT_SIZE));
+
+	for (uint32_t epoch = 0; epoch + SEGMENT_SIZE <= data.size() && dictionary_start >= SEGMENT_SIZE; epoch += epoch_size) {
+		uint32_t epoch_end = MIN(epoch + epoch_size, data.size());
+		// Sliding window over the segments starting in the epoch.
+		uint64_t score = 0;
+		for (uint32_t i = epoch; i < epoch + SEGMENT_SIZE - DMER_SIZE + 1; i++) {
+			score += dmers[i] == NO_DMER ? 0 : frequencies[dmers[i]];
+		}
+		uint64_t best_score = score;
+		uint32_t best = epoch;
+		for (uint32_t i = epoch + 1; i < epoch_end && i + SEGMENT_SIZE <= data.size(); i++) {
+			uint32_t removed = dmers[i - 1];
+			uint32_t added = dmers[i + SEGMENT_SIZE - DMER_SIZE];
+			score -= removed == NO_DMER ? 0 : frequencies[removed];
+			score += added == NO_DMER ? 0 : frequencies[added];
+			if (score > best_score) {
+				best_score = score;
+				best = i;
+			}
+		}
+		if (best_score == 0) {
+			continue;
+		}
+
+		dictionary_start -= SEGMENT_SIZE;
+		memcpy(dictionary.ptrw() + dictionary_start, data.ptr() + best, SEGMENT_SIZE);
+		// Later segments get nothing for the same sequences.
+		for (uint32_t i = best; i < best + SEGMENT_SIZE - DMER_SIZE + 1; i++) {
+			if (dmers[i] != NO_DMER) {
+				frequencies[dmers[i]] = 0;
+			}
+		}
+	}
+
+	if (dictionary_start == dictionary.size()) {
+		return Vector<uint8_t>(); // Nothing in common.
+	}
+	if (dictionary_start > 0) {
+		memmove(dictionary.ptrw(), dictionary.ptr() + dictionary_start, dictionary.size() - dictionary_start);
+		dictionary.resize(dictionary.size() - dictionary_start);
+	}
+	return dictionary;
+}
+
+void Compression::remove_zstd_dictionary(uint32_t p_id) {
+	RWLockWrite lock(zstd_dictionaries_lock);
+	ZstdDictionary *dictionary = zstd_dictionaries.getptr(p_id);
+	ERR_FAIL_COND_MSG(!dictionary, vformat("Zstandard dictionary %d was not added.", p_id));
+	ZSTD_freeDDict(dictionary->ddict);
+	ZSTD_freeCDict(dictionary->cdict);
+	zstd_dictionaries.erase(p_id);
+}
+
+bool Compression::has_zstd_dictionary(uint32_t p_id) {
+	RWLockRead lock(zstd_dictionaries_lock);
+	return zstd_dictionaries.has(p_id);
+}
+
+int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode, uint32_t p_zstd_dictionary) {
 	switch (p_mode) {
 		case MODE_FASTLZ: {
 			if (p_src_size < 16) {
@@ -77,16 +242,47 @@ int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size,
 
 		} break;
 		case MODE_ZSTD: {
-			ZSTD_CCtx *cctx = ZSTD_createCCtx();
+			if (!zstd_contexts.cctx) {
+				zstd_contexts.cctx = ZSTD_createCCtx();
+			}
+			ZSTD_CCtx *cctx = zstd_contexts.cctx;
+			ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
 			ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, zstd_level);
 			if (zstd_long_distance_matching) {
 				ZSTD_CCtx_setParameter(cctx, ZSTD_c_enableLongDistanceMatching, 1);
 				ZSTD_CCtx_setParameter(cctx, ZSTD_c_windowLog, zstd_window_log_size);
 			}
 			int max_dst_size = get_max_compressed_buffer_size(p_src_size, MODE_ZSTD);
-			int ret = ZSTD_compressCCtx(cctx, p_dst, max_dst_size, p_src, p_src_size, zstd_level);
-			ZSTD_freeCCtx(cctx);
-			return ret;
+
+			if (p_zstd_dictionary == 0) {
+				size_t ret = ZSTD_compress2(cctx, p_dst, max_dst_size, p_src, p_src_size);
+				return ZSTD_isError(ret) ? -1 : int(ret);
+			}
+
+			zstd_dictionaries_lock.read_lock();
+			ZstdDictionary *dictionary = zstd_dictionaries.getptr(p_zstd_dictionary);
+			if (dictionary && (!dictionary->cdict || dictionary->cdict_level != zstd_level)) {
+				// Digested dictionaries depend on the compression level, so they are created on demand.
+				zstd_dictionaries_lock.read_unlock();
+				zstd_dictionaries_lock.write_lock();
+				dictionary = zstd_dictionaries.getptr(p_zstd_dictionary);
+				if (dictionary && (!dictionary->cdict || dictionary->cdict_level != zstd_level)) {
+					ZSTD_freeCDict(dictionary->cdict);
+					dictionary->cdict = ZSTD_createCDict(dictionary->data.ptr(), dictionary->data.size(), zstd_level);
+					dictionary->cdict_level = zstd_level;
+				}
+				zstd_dictionaries_lock.write_unlock();
+				zstd_dictionaries_lock.read_lock();
+				dictionary = zstd_dictionaries.getptr(p_zstd_dictionary);
+			}
+			if (!dictionary) {
+				zstd_dictionaries_lock.read_unlock();
+				ERR_FAIL_V_MSG(-1, vformat("Zstandard dictionary %d was not added.", p_zstd_dictionary));
+			}
+			ZSTD_CCtx_refCDict(cctx, dictionary->cdict);
+			size_t ret = ZSTD_compress2(cctx, p_dst, max_dst_size, p_src, p_src_size);
+			zstd_dictionaries_lock.read_unlock();
+			return ZSTD_isError(ret) ? -1 : int(ret);
 		} break;
 	}
 
@@ -127,7 +323,7 @@ int Compression::get_max_compressed_buffer_size(int p_src_size, Mode p_mode) {
 	ERR_FAIL_V(-1);
 }
 
-int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode) {
+int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode, uint32_t p_zstd_dictionary) {
 	switch (p_mode) {
 		case MODE_FASTLZ: {
 			int ret_size = 0;
@@ -167,13 +363,27 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 			return total;
 		} break;
 		case MODE_ZSTD: {
-			ZSTD_DCtx *dctx = ZSTD_createDCtx();
+			if (!zstd_contexts.dctx) {
+				zstd_contexts.dctx = ZSTD_createDCtx();
+			}
+			ZSTD_DCtx *dctx = zstd_contexts.dctx;
+			ZSTD_DCtx_reset(dctx, ZSTD_reset_session_and_parameters);
 			if (zstd_long_distance_matching) {
 				ZSTD_DCtx_setParameter(dctx, ZSTD_d_windowLogMax, zstd_window_log_size);
 			}
-			int ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
-			ZSTD_freeDCtx(dctx);
-			return ret;
+
+			uint32_t dictionary_id = p_zstd_dictionary != 0 ? p_zstd_dictionary : ZSTD_getDictID_fromFrame(p_src, p_src_size);
+			if (dictionary_id == 0) {
+				size_t ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
+				return ZSTD_isError(ret) ? -1 : int(ret);
+			}
+
+			RWLockRead lock(zstd_dictionaries_lock);
+			ZstdDictionary *dictionary = zstd_dictionaries.getptr(dictionary_id);
+			ERR_FAIL_COND_V_MSG(!dictionary, -1, vformat("Zstandard dictionary %d is needed to decompress, but it was not added.", dictionary_id));
+			ZSTD_DCtx_refDDict(dctx, dictionary->ddict);
+			size_t ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
+			return ZSTD_isError(ret) ? -1 : int(ret);
 		} break;
 	}
 
@@ -275,3 +485,4 @@ int Compression::zstd_level = 3;
 bool Compression::zstd_long_distance_matching = false;
 int Compression::zstd_window_log_size = 27; // ZSTD_WINDOWLOG_LIMIT_DEFAULT
 int Compression::gzip_chunk = 16384;
+int Compression::file_block_size = 4096;
@@ -42,6 +42,7 @@ public:
 	static bool zstd_long_distance_matching;
 	static int zstd_window_log_size;
 	static int gzip_chunk;
+	static int file_block_size;
 
 	enum Mode {
 		MODE_FASTLZ,
@@ -50,9 +51,19 @@ public:
 		MODE_GZIP
 	};
 
-	static int compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
+	// Zstandard dictionaries, trained on samples of the data to compress, improve
+	// the ratio of small inputs a lot. Dictionaries trained by `zstd --train` have
+	// an ID the compressed data records. Raw content dictionaries, like the ones
+	// train_zstd_dictionary() makes, don't, so their ID (returned when adding them)
+	// has to be passed to decompress() too.
+	static uint32_t add_zstd_dictionary(const Vector<uint8_t> &p_dictionary);
+	static void remove_zstd_dictionary(uint32_t p_id);
+	static bool has_zstd_dictionary(uint32_t p_id);
+	static Vector<uint8_t> train_zstd_dictionary(const Vector<Vector<uint8_t>> &p_samples, int p_max_size);
+
+	static int compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD, uint32_t p_zstd_dictionary = 0);
 	static int get_max_compressed_buffer_size(int p_src_size, Mode p_mode = MODE_ZSTD);
-	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
+	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD, uint32_t p_zstd_dictionary = 0);
 	static int decompress_dynamic(Vector<uint8_t> *p_dst_vect, int p_max_dst_size, const uint8_t *p_src, int p_src_size, Mode p_mode);
 };
 
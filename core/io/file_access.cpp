@@ -37,6 +37,7 @@
 #include "core/os/os.h"
 
 FileAccess::CreateFunc FileAccess::create_func[ACCESS_MAX] = { nullptr, nullptr };
+FileAccess::CreateFunc FileAccess::create_mapped_func[ACCESS_MAX] = { nullptr, nullptr };
 
 FileAccess::FileCloseFailNotify FileAccess::close_fail_notify = nullptr;
 
@@ -111,6 +112,35 @@ Ref<FileAccess> FileAccess::open(const String &p_path, int p_mode_flags, Error *
 	return ret;
 }
 
+Ref<FileAccess> FileAccess::open_mapped(const String &p_path, MappingHint p_hint, Error *r_error) {
+	AccessType access = ACCESS_FILESYSTEM;
+	if (p_path.begins_with("res://")) {
+		access = ACCESS_RESOURCES;
+	} else if (p_path.begins_with("user://")) {
+		access = ACCESS_USERDATA;
+	}
+
+	// Files inside packs are already read from the mapping of the pack, if any.
+	if (!create_mapped_func[access] || (PackedData::get_singleton() && !PackedData::get_singleton()->is_disabled() && PackedData::get_singleton()->has_path(p_path))) {
+		return open(p_path, READ, r_error);
+	}
+
+	Ref<FileAccess> ret = create_mapped_func[access]();
+	ret->_set_access_type(access);
+	Error err = ret->_open(p_path, READ);
+
+	if (r_error) {
+		*r_error = err;
+	}
+	if (err != OK) {
+		ret.unref();
+		return ret;
+	}
+
+	ret->_set_mapping_hint(p_hint);
+	return ret;
+}
+
 FileAccess::CreateFunc FileAccess::get_create_func(AccessType p_access) {
 	return create_func[p_access];
 }
@@ -50,6 +50,12 @@ public:
 		ACCESS_MAX
 	};
 
+	enum MappingHint {
+		MAPPING_HINT_NORMAL,
+		MAPPING_HINT_SEQUENTIAL,
+		MAPPING_HINT_RANDOM,
+	};
+
 	typedef void (*FileCloseFailNotify)(const String &);
 
 	typedef Ref<FileAccess> (*CreateFunc)();
@@ -63,6 +69,7 @@ protected:
 	String fix_path(const String &p_path) const;
 	virtual Error _open(const String &p_path, int p_mode_flags) = 0; ///< open a file
 	virtual uint64_t _get_modified_time(const String &p_file) = 0;
+	virtual void _set_mapping_hint(MappingHint p_hint) {}
 
 	static FileCloseFailNotify close_fail_notify;
 
@@ -71,6 +78,7 @@ private:
 
 	AccessType _access_type = ACCESS_FILESYSTEM;
 	static CreateFunc create_func[ACCESS_MAX]; /** default file access creation function for a platform */
+	static CreateFunc create_mapped_func[ACCESS_MAX]; /** memory mapped, read-only file access creation function, if the platform has one */
 	template <class T>
 	static Ref<FileAccess> _create_builtin() {
 		return memnew(T);
@@ -110,6 +118,14 @@ public:
 	virtual real_t get_real() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
+	// Returns the next p_length bytes in place and advances past them, when the file is
+	// memory mapped. The pointer is valid for as long as the file is open. Returns nullptr
+	// if the file is not mapped or has fewer bytes left, in that case use get_buffer().
+	virtual const uint8_t *get_buffer_view(uint64_t p_length) const { return nullptr; }
+	// If the views can be adopted by CowData (see CowData::adopt()), returns their owner:
+	// the memory before them is a private copy of the file that can be written to, and
+	// it stays mapped for as long as anything adopted it, even after closing the file.
+	virtual CowDataOwner *get_buffer_view_owner() const { return nullptr; }
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -151,6 +167,7 @@ public:
 	static Ref<FileAccess> create(AccessType p_access); /// Create a file access (for the current platform) this is the only portable way of accessing files.
 	static Ref<FileAccess> create_for_path(const String &p_path);
 	static Ref<FileAccess> open(const String &p_path, int p_mode_flags, Error *r_error = nullptr); /// Create a file access (for the current platform) this is the only portable way of accessing files.
+	static Ref<FileAccess> open_mapped(const String &p_path, MappingHint p_hint = MAPPING_HINT_NORMAL, Error *r_error = nullptr); /// Open a file for reading, memory mapped if the platform supports it. The file must not be modified while open.
 	static CreateFunc get_create_func(AccessType p_access);
 	static bool exists(const String &p_name); ///< return true if a file exists
 	static uint64_t get_modified_time(const String &p_file);
@@ -170,6 +187,12 @@ public:
 	template <class T>
 	static void make_default(AccessType p_access) {
 		create_func[p_access] = _create_builtin<T>;
+		create_mapped_func[p_access] = nullptr; // Must be set again for the new file access.
+	}
+
+	template <class T>
+	static void make_default_mapped(AccessType p_access) {
+		create_mapped_func[p_access] = _create_builtin<T>;
 	}
 
 	FileAccess() {}
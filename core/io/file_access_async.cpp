@@ -0,0 +1,199 @@
+/*************************************************************************/
+/*  file_access_async.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "file_access_async.h"
+
+#include "core/config/project_settings.h"
+#include "core/io/file_access.h"
+#include "core/io/file_access_pack.h"
+#include "core/object/worker_thread_pool.h"
+
+FileAccessAsync::CreateFunc FileAccessAsync::create_func = nullptr;
+FileAccessAsync *FileAccessAsync::singleton = nullptr;
+
+Error FileAccessAsync::_submit(Read *p_read) {
+	p_read->task_id = WorkerThreadPool::get_singleton()->add_template_task(this, &FileAccessAsync::_read_task, p_read, WorkerThreadPool::PRIORITY_HIGH, "Read " + p_read->path);
+	return OK;
+}
+
+void FileAccessAsync::_read_task(Read *p_read) {
+	Ref<FileAccess> f = FileAccess::open(p_read->path, FileAccess::READ);
+	if (f.is_null()) {
+		_finish(p_read, STATUS_FAILED);
+		return;
+	}
+
+	f->seek(p_read->offset);
+	p_read->read = f->get_buffer(p_read->buffer, p_read->length);
+	_finish(p_read, f->get_error() == OK || f->get_error() == ERR_FILE_EOF ? STATUS_DONE : STATUS_FAILED);
+}
+
+void FileAccessAsync::_finish(Read *p_read, Status p_status) {
+	// Locked so the read isn't released before the semaphore is posted.
+	MutexLock lock(mutex);
+	p_read->status = p_status;
+	p_read->done.post();
+}
+
+bool FileAccessAsync::_get_os_location(const String &p_path, String &r_os_path, uint64_t &r_offset, uint64_t &r_size) {
+	PackedData *packed_data = PackedData::get_singleton();
+	if (packed_data && !packed_data->is_disabled() && packed_data->has_path(p_path)) {
+		String pack_path;
+		if (!packed_data->get_file_location(p_path, pack_path, r_offset, r_size)) {
+			return false;
+		}
+		r_os_path = ProjectSettings::get_singleton()->globalize_path(pack_path);
+		return true;
+	}
+
+	r_os_path = ProjectSettings::get_singleton() ? ProjectSettings::get_singleton()->globalize_path(p_path) : p_path;
+	r_offset = 0;
+	r_size = UINT64_MAX;
+	return true;
+}
+
+FileAccessAsync::Status FileAccessAsync::_release(Read *p_read, uint64_t *r_read) {
+	if (p_read->task_id >= 0) {
+		// Tasks are only freed once waited for.
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(p_read->task_id);
+	}
+
+	const Status status = p_read->status;
+	if (r_read) {
+		*r_read = p_read->read;
+	}
+	memdelete(p_read);
+	return status;
+}
+
+void FileAccessAsync::initialize() {
+	ERR_FAIL_COND(singleton);
+
+	if (create_func) {
+		singleton = create_func();
+		if (singleton->_initialize() != OK) {
+			memdelete(singleton);
+			singleton = nullptr;
+		}
+	}
+	if (!singleton) {
+		singleton = memnew(FileAccessAsync);
+	}
+}
+
+void FileAccessAsync::finalize() {
+	if (singleton) {
+		memdelete(singleton);
+		singleton = nullptr;
+	}
+}
+
+FileAccessAsync::ReadID FileAccessAsync::_start(Read *p_read, bool p_prefetch) {
+	mutex.lock();
+	const ReadID id = ++last_read_id;
+	reads.insert(id, p_read);
+	mutex.unlock();
+
+	if ((p_prefetch ? _submit_prefetch(p_read) : _submit(p_read)) != OK) {
+		mutex.lock();
+		reads.erase(id);
+		mutex.unlock();
+		memdelete(p_read);
+		return INVALID_READ_ID;
+	}
+
+	return id;
+}
+
+FileAccessAsync::ReadID FileAccessAsync::read(const String &p_path, uint64_t p_offset, uint8_t *p_buffer, uint64_t p_length) {
+	ERR_FAIL_COND_V(!p_buffer && p_length > 0, INVALID_READ_ID);
+
+	Read *r = _create_read();
+	r->path = p_path;
+	r->offset = p_offset;
+	r->buffer = p_buffer;
+	r->length = p_length;
+	return _start(r, false);
+}
+
+FileAccessAsync::ReadID FileAccessAsync::prefetch(const String &p_path, uint64_t p_offset, uint64_t p_length) {
+	Read *r = _create_read();
+	r->path = p_path;
+	r->offset = p_offset;
+	r->length = p_length;
+	return _start(r, true);
+}
+
+FileAccessAsync::Status FileAccessAsync::poll(ReadID p_id, uint64_t *r_read) {
+	mutex.lock();
+	Read **r = reads.getptr(p_id);
+	if (!r) {
+		mutex.unlock();
+		ERR_FAIL_V_MSG(STATUS_FAILED, "Invalid read ID: " + itos(p_id) + ".");
+	}
+	Read *read = *r;
+	if (read->status == STATUS_PENDING) {
+		mutex.unlock();
+		return STATUS_PENDING;
+	}
+	reads.erase(p_id);
+	mutex.unlock();
+
+	return _release(read, r_read);
+}
+
+FileAccessAsync::Status FileAccessAsync::wait(ReadID p_id, uint64_t *r_read) {
+	mutex.lock();
+	Read **r = reads.getptr(p_id);
+	if (!r) {
+		mutex.unlock();
+		ERR_FAIL_V_MSG(STATUS_FAILED, "Invalid read ID: " + itos(p_id) + ".");
+	}
+	Read *read = *r;
+	mutex.unlock();
+
+	if (read->task_id >= 0) {
+		// The pool may run the task on this thread instead of waiting for it.
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(read->task_id);
+		read->task_id = -1;
+	} else {
+		read->done.wait();
+	}
+
+	mutex.lock();
+	reads.erase(p_id);
+	mutex.unlock();
+
+	return _release(read, r_read);
+}
+
+FileAccessAsync::~FileAccessAsync() {
+	ERR_FAIL_COND_MSG(!reads.is_empty(), itos(reads.size()) + " file reads were not waited for.");
+}
@@ -0,0 +1,138 @@
+/*************************************************************************/
+/*  file_access_async.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_ACCESS_ASYNC_H
+#define FILE_ACCESS_ASYNC_H
+
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/string/ustring.h"
+#include "core/templates/hash_map.h"
+
+// Reads parts of files in the background. Reads are submitted with read(), and
+// poll() or wait() tell when they are done; each read must be checked from one
+// thread only, until it's done or failed, and its buffer kept until then.
+//
+// By default reads are done with FileAccess on the WorkerThreadPool, taking up
+// a thread each while in progress. Platforms can provide an implementation
+// reading without threads, see make_default(). Files in packs are read from
+// the pack directly when they can be.
+class FileAccessAsync {
+public:
+	typedef int64_t ReadID;
+	static constexpr ReadID INVALID_READ_ID = -1;
+
+	enum Status {
+		STATUS_PENDING,
+		STATUS_DONE,
+		STATUS_FAILED,
+	};
+
+	typedef FileAccessAsync *(*CreateFunc)();
+
+protected:
+	struct Read {
+		String path;
+		uint64_t offset = 0;
+		uint8_t *buffer = nullptr;
+		uint64_t length = 0;
+		uint64_t read = 0;
+		Status status = STATUS_PENDING;
+		Semaphore done;
+		int64_t task_id = -1; // If read on the WorkerThreadPool.
+
+		virtual ~Read() {}
+	};
+
+	virtual Read *_create_read() { return memnew(Read); }
+	// Starts reading, _finish() must be called when done.
+	virtual Error _submit(Read *p_read);
+	// Same for prefetch(), which has no buffer. Unavailable by default.
+	virtual Error _submit_prefetch(Read *p_read) { return ERR_UNAVAILABLE; }
+	void _finish(Read *p_read, Status p_status);
+
+	// Called once after creating the default implementation, which is not used
+	// if this fails.
+	virtual Error _initialize() { return OK; }
+
+	// Where the contents of a file are on the OS filesystem: the file itself, or
+	// the pack it's in, from r_offset, with r_size bytes (UINT64_MAX if it's
+	// the whole file). False if they must be read through FileAccess.
+	static bool _get_os_location(const String &p_path, String &r_os_path, uint64_t &r_offset, uint64_t &r_size);
+
+private:
+	static CreateFunc create_func;
+	static FileAccessAsync *singleton;
+
+	Mutex mutex;
+	HashMap<ReadID, Read *> reads;
+	ReadID last_read_id = 0;
+
+	template <class T>
+	static FileAccessAsync *_create_builtin() {
+		return memnew(T);
+	}
+
+	void _read_task(Read *p_read);
+	ReadID _start(Read *p_read, bool p_prefetch);
+	Status _release(Read *p_read, uint64_t *r_read);
+
+public:
+	static FileAccessAsync *get_singleton() { return singleton; }
+
+	template <class T>
+	static void make_default() {
+		create_func = _create_builtin<T>;
+	}
+
+	static void initialize();
+	static void finalize();
+
+	// Reads up to p_length bytes at p_offset into p_buffer, fewer if the file
+	// ends before. Returns INVALID_READ_ID if the read couldn't be started.
+	ReadID read(const String &p_path, uint64_t p_offset, uint8_t *p_buffer, uint64_t p_length);
+	// Asks the OS to read up to p_length bytes at p_offset into its own cache, so
+	// reading them later doesn't wait for the disk. Nothing is read into memory
+	// owned here. Returns INVALID_READ_ID if this can't be done without taking
+	// up a thread. Polled and waited for like reads, nothing is read into r_read.
+	ReadID prefetch(const String &p_path, uint64_t p_offset, uint64_t p_length);
+	// Once a read isn't pending anymore its ID is released, and r_read is set to
+	// the number of bytes read.
+	Status poll(ReadID p_id, uint64_t *r_read = nullptr);
+	Status wait(ReadID p_id, uint64_t *r_read = nullptr);
+
+	// Whether reads in progress take up a thread each.
+	virtual bool uses_threads() const { return true; }
+
+	FileAccessAsync() {}
+	virtual ~FileAccessAsync();
+};
+
+#endif // FILE_ACCESS_ASYNC_H
@@ -30,9 +30,10 @@
 
 #include "file_access_compressed.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/string/print_string.h"
 
-void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size) {
+void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size, uint32_t p_zstd_dictionary) {
 	magic = p_magic.ascii().get_data();
 	if (magic.length() > 4) {
 		magic = magic.substr(0, 4);
@@ -43,7 +44,8 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 	}
 
 	cmode = p_mode;
-	block_size = p_block_size;
+	block_size = p_block_size > 0 ? p_block_size : MAX(Compression::file_block_size, 1);
+	zstd_dictionary = p_zstd_dictionary;
 }
 
 #define WRITE_FIT(m_bytes)                                  \
@@ -60,7 +62,9 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 
 Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 	f = p_base;
-	cmode = (Compression::Mode)f->get_32();
+	uint32_t mode = f->get_32();
+	cmode = (Compression::Mode)(mode & ~HEADER_FLAG_ZSTD_DICTIONARY);
+	zstd_dictionary = (mode & HEADER_FLAG_ZSTD_DICTIONARY) ? f->get_32() : 0;
 	block_size = f->get_32();
 	if (block_size == 0) {
 		f.unref();
@@ -82,17 +86,81 @@ Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 	comp_buffer.resize(max_bs);
 	buffer.resize(block_size);
 	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
-	at_end = false;
+	at_end = read_total == 0;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
 
-	int ret = Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
-	read_block = 0;
+	return _read_block(0) ? OK : ERR_FILE_CORRUPT;
+}
+
+bool FileAccessCompressed::_read_block(uint32_t p_block) const {
+	// Blocks are read sequentially, seek() moves to other blocks first.
+	const ReadBlock &rb = read_blocks[p_block];
+	f->get_buffer(comp_buffer.ptrw(), rb.csize);
+	read_block = p_block;
+	read_block_size = _get_block_size(p_block);
 	read_pos = 0;
+	int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), rb.csize, cmode, zstd_dictionary);
+	ERR_FAIL_COND_V_MSG(ret == -1, false, "Compressed file is corrupt.");
+	return true;
+}
 
-	return ret == -1 ? ERR_FILE_CORRUPT : OK;
+bool FileAccessCompressed::_next_block() const {
+	// The last block is empty when the length is a multiple of the block size.
+	if (read_block + 1 < read_block_count && _get_block_size(read_block + 1) > 0) {
+		return _read_block(read_block + 1);
+	}
+	at_end = true;
+	return false;
+}
+
+void FileAccessCompressed::_decompress_block(uint32_t p_index, BlockJob *p_job) const {
+	uint32_t block = p_job->first_block + p_index;
+	const uint8_t *src = p_job->src + (read_blocks[block].offset - read_blocks[p_job->first_block].offset);
+	int ret = Compression::decompress(p_job->dst + uint64_t(p_index) * block_size, block_size, src, read_blocks[block].csize, cmode, zstd_dictionary);
+	if (ret != int(block_size)) {
+		p_job->failed.set();
+	}
+}
+
+bool FileAccessCompressed::_read_blocks(uint32_t p_first, uint32_t p_count, uint8_t *p_dst) const {
+	const ReadBlock &first = read_blocks[p_first];
+	const ReadBlock &last = read_blocks[p_first + p_count - 1];
+	Vector<uint8_t> compressed;
+	compressed.resize(last.offset + last.csize - first.offset);
+	ERR_FAIL_COND_V_MSG(f->get_buffer(compressed.ptrw(), compressed.size()) != uint64_t(compressed.size()), false, "Compressed file is truncated.");
+
+	BlockJob job;
+	job.src = compressed.ptr();
+	job.dst = p_dst;
+	job.first_block = p_first;
+	if (WorkerThreadPool::get_singleton()) {
+		WorkerThreadPool::get_singleton()->do_work(p_count, this, &FileAccessCompressed::_decompress_block, &job, WorkerThreadPool::PRIORITY_HIGH, "Decompress blocks");
+	} else {
+		for (uint32_t i = 0; i < p_count; i++) {
+			_decompress_block(i, &job);
+		}
+	}
+	ERR_FAIL_COND_V_MSG(job.failed.is_set(), false, "Compressed file is corrupt.");
+
+	// Keep the last block around, as if it had been read the regular way.
+	memcpy(buffer.ptrw(), p_dst + uint64_t(p_count - 1) * block_size, block_size);
+	read_block = p_first + p_count - 1;
+	read_block_size = block_size;
+	read_pos = block_size;
+	return true;
+}
+
+void FileAccessCompressed::_compress_block(uint32_t p_index, BlockJob *p_job) const {
+	uint32_t bl = p_index == uint32_t(p_job->compressed.size() - 1) ? write_max % block_size : block_size;
+	Vector<uint8_t> &cblock = p_job->compressed.write[p_index];
+	cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
+	int s = Compression::compress(cblock.ptrw(), p_job->src + uint64_t(p_index) * block_size, bl, cmode, zstd_dictionary);
+	if (s < 0) {
+		p_job->failed.set();
+		s = 0;
+	}
+	cblock.resize(s);
 }
 
 Error FileAccessCompressed::_open(const String &p_path, int p_mode_flags) {
@@ -141,31 +209,44 @@ void FileAccessCompressed::_close() {
 
 		CharString mgc = magic.utf8();
 		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //write header 4
-		f->store_32(cmode); //write compression mode 4
+		if (zstd_dictionary) {
+			// Raw content dictionaries aren't named by the compressed data, so the file does.
+			f->store_32(cmode | HEADER_FLAG_ZSTD_DICTIONARY); //write compression mode 4
+			f->store_32(zstd_dictionary); //write dictionary ID 4
+		} else {
+			f->store_32(cmode); //write compression mode 4
+		}
 		f->store_32(block_size); //write block size 4
 		f->store_32(write_max); //max amount of data written 4
 		uint32_t bc = (write_max / block_size) + 1;
+		uint64_t block_sizes_pos = f->get_position();
 
 		for (uint32_t i = 0; i < bc; i++) {
 			f->store_32(0); //compressed sizes, will update later
 		}
 
-		Vector<int> block_sizes;
-		for (uint32_t i = 0; i < bc; i++) {
-			uint32_t bl = i == (bc - 1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i * block_size];
-
-			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
+		// Blocks are compressed independently, so they can all be compressed at once.
+		BlockJob job;
+		job.src = write_ptr;
+		job.compressed.resize(bc);
+		if (WorkerThreadPool::get_singleton()) {
+			WorkerThreadPool::get_singleton()->do_work(bc, this, &FileAccessCompressed::_compress_block, &job, WorkerThreadPool::PRIORITY_HIGH, "Compress blocks");
+		} else {
+			for (uint32_t i = 0; i < bc; i++) {
+				_compress_block(i, &job);
+			}
+		}
+		if (job.failed.is_set()) {
+			ERR_PRINT("Compressing '" + f->get_path() + "' failed.");
+		}
 
-			f->store_buffer(cblock.ptr(), s);
-			block_sizes.push_back(s);
+		for (uint32_t i = 0; i < bc; i++) {
+			f->store_buffer(job.compressed[i].ptr(), job.compressed[i].size());
 		}
 
-		f->seek(16); //ok write block sizes
+		f->seek(block_sizes_pos); //ok write block sizes
 		for (uint32_t i = 0; i < bc; i++) {
-			f->store_32(block_sizes[i]);
+			f->store_32(job.compressed[i].size());
 		}
 		f->seek_end();
 		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //magic at the end too
@@ -201,12 +282,10 @@ void FileAccessCompressed::seek(uint64_t p_position) {
 			read_eof = false;
 			uint32_t block_idx = p_position / block_size;
 			if (block_idx != read_block) {
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_MSG(ret == -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				f->seek(read_blocks[block_idx].offset);
+				if (!_read_block(block_idx)) {
+					return;
+				}
 			}
 
 			read_pos = p_position % block_size;
@@ -263,20 +342,7 @@ uint8_t FileAccessCompressed::get_8() const {
 
 	read_pos++;
 	if (read_pos >= read_block_size) {
-		read_block++;
-
-		if (read_block < read_block_count) {
-			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			int total = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			ERR_FAIL_COND_V_MSG(total == -1, 0, "Compressed file is corrupt.");
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-			read_pos = 0;
-
-		} else {
-			read_block--;
-			at_end = true;
-		}
+		_next_block();
 	}
 
 	return ret;
@@ -292,32 +358,37 @@ uint64_t FileAccessCompressed::get_buffer(uint8_t *p_dst, uint64_t p_length) con
 		return 0;
 	}
 
-	for (uint64_t i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
-		if (read_pos >= read_block_size) {
-			read_block++;
-
-			if (read_block < read_block_count) {
-				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_V_MSG(ret == -1, -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-				read_pos = 0;
-
-			} else {
-				read_block--;
-				at_end = true;
-				if (i + 1 < p_length) {
-					read_eof = true;
-				}
-				return i + 1;
+	uint64_t dst_pos = 0;
+	while (true) {
+		uint64_t n = MIN(uint64_t(read_block_size - read_pos), p_length - dst_pos);
+		memcpy(p_dst + dst_pos, read_ptr + read_pos, n);
+		dst_pos += n;
+		read_pos += n;
+		if (read_pos < read_block_size) {
+			return dst_pos;
+		}
+
+		// Decompress the whole blocks the rest of the read covers straight into
+		// the destination. The last block is never whole.
+		int64_t whole_blocks = MIN(int64_t((p_length - dst_pos) / block_size), int64_t(read_block_count) - 2 - read_block);
+		if (whole_blocks > 0) {
+			if (!_read_blocks(read_block + 1, whole_blocks, p_dst + dst_pos)) {
+				read_eof = true;
+				return dst_pos;
 			}
+			dst_pos += whole_blocks * block_size;
 		}
-	}
 
-	return p_length;
+		if (!_next_block()) {
+			if (dst_pos < p_length) {
+				read_eof = true;
+			}
+			return dst_pos;
+		}
+		if (dst_pos == p_length) {
+			return dst_pos;
+		}
+	}
 }
 
 Error FileAccessCompressed::get_error() const {
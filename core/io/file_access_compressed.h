@@ -33,8 +33,13 @@
 
 #include "core/io/compression.h"
 #include "core/io/file_access.h"
+#include "core/templates/safe_refcount.h"
 
 class FileAccessCompressed : public FileAccess {
+	enum {
+		HEADER_FLAG_ZSTD_DICTIONARY = 1 << 16, // Stored with the compression mode, the dictionary ID follows.
+	};
+
 	Compression::Mode cmode = Compression::MODE_ZSTD;
 	bool writing = false;
 	uint64_t write_pos = 0;
@@ -42,6 +47,7 @@ class FileAccessCompressed : public FileAccess {
 	uint32_t write_buffer_size = 0;
 	uint64_t write_max = 0;
 	uint32_t block_size = 0;
+	uint32_t zstd_dictionary = 0;
 	mutable bool read_eof = false;
 	mutable bool at_end = false;
 
@@ -63,12 +69,33 @@ class FileAccessCompressed : public FileAccess {
 	mutable Vector<uint8_t> buffer;
 	Ref<FileAccess> f;
 
+	// Reads spanning several whole blocks decompress them in parallel, straight
+	// into the destination.
+	struct BlockJob {
+		const uint8_t *src = nullptr;
+		uint8_t *dst = nullptr;
+		uint32_t first_block = 0;
+		Vector<Vector<uint8_t>> compressed;
+		SafeFlag failed;
+	};
+
+	_FORCE_INLINE_ uint32_t _get_block_size(uint32_t p_block) const { return p_block == read_block_count - 1 ? read_total % block_size : block_size; }
+	bool _read_block(uint32_t p_block) const;
+	bool _next_block() const;
+	bool _read_blocks(uint32_t p_first, uint32_t p_count, uint8_t *p_dst) const;
+	void _decompress_block(uint32_t p_index, BlockJob *p_job) const;
+	void _compress_block(uint32_t p_index, BlockJob *p_job) const;
+
 	void _close();
 
 public:
-	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 4096);
+	// A block size of 0 uses compression/formats/block_size. Larger blocks compress
+	// better, but make seeking slower. Zstandard can use a dictionary (see
+	// Compression::add_zstd_dictionary()), the file records its ID.
+	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 0, uint32_t p_zstd_dictionary = 0);
 
 	Error open_after_magic(Ref<FileAccess> p_base);
+	uint32_t get_zstd_dictionary() const { return zstd_dictionary; }
 
 	virtual Error _open(const String &p_path, int p_mode_flags); ///< open a file
 	virtual bool is_open() const; ///< true when file is open
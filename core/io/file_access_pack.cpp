@@ -30,6 +30,7 @@
 
 #include "file_access_pack.h"
 
+#include "core/io/compression.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/object/script_language.h"
 #include "core/os/os.h"
@@ -47,6 +48,52 @@ Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t
 	return ERR_FILE_UNRECOGNIZED;
 }
 
+void PackedData::_remove_pack_files(PackedDir *p_dir, const String &p_dir_path, const String &p_pack_path) {
+	Vector<String> empty_subdirs;
+	for (const KeyValue<String, PackedDir *> &E : p_dir->subdirs) {
+		_remove_pack_files(E.value, p_dir_path.plus_file(E.key), p_pack_path);
+		if (E.value->files.is_empty() && E.value->subdirs.is_empty()) {
+			empty_subdirs.push_back(E.key);
+		}
+	}
+	for (const String &subdir : empty_subdirs) {
+		memdelete(p_dir->subdirs[subdir]);
+		p_dir->subdirs.erase(subdir);
+	}
+
+	Vector<String> removed_files;
+	for (const String &file : p_dir->files) {
+		PathMD5 pmd5(p_dir_path.plus_file(file).md5_buffer());
+		const PackedFile *pf = files.getptr(pmd5);
+		if (pf && pf->pack == p_pack_path) {
+			files.erase(pmd5);
+			removed_files.push_back(file);
+		}
+	}
+	for (const String &file : removed_files) {
+		p_dir->files.erase(file);
+	}
+}
+
+void PackedData::remove_pack(const String &p_path) {
+	_remove_pack_files(root, "res://", p_path);
+	for (int i = 0; i < sources.size(); i++) {
+		sources[i]->remove_pack(p_path);
+	}
+}
+
+bool PackedData::get_file_location(const String &p_path, String &r_pack_path, uint64_t &r_offset, uint64_t &r_size) {
+	const PackedFile *file = files.getptr(PathMD5(p_path.md5_buffer()));
+	if (!file || file->offset == 0 || !file->src->is_stored_raw(*file)) {
+		return false;
+	}
+
+	r_pack_path = file->pack;
+	r_offset = file->offset;
+	r_size = file->size;
+	return true;
+}
+
 void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted) {
 	PathMD5 pmd5(p_path.md5_buffer());
 
@@ -231,6 +278,8 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f = fae;
 	}
 
+	uint64_t zstd_dictionary_ofs = 0;
+	uint64_t zstd_dictionary_size = 0;
 	for (int i = 0; i < file_count; i++) {
 		uint32_t sl = f->get_32();
 		CharString cs;
@@ -248,12 +297,43 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		uint32_t flags = f->get_32();
 
 		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED));
+
+		if (path == PackedData::ZSTD_DICTIONARY_PATH && !(flags & PACK_FILE_ENCRYPTED)) {
+			zstd_dictionary_ofs = ofs + p_offset;
+			zstd_dictionary_size = size;
+		}
+	}
+
+	if (zstd_dictionary_size > 0) {
+		Ref<FileAccess> df = FileAccess::open(p_path, FileAccess::READ);
+		ERR_FAIL_COND_V_MSG(df.is_null(), false, "Can't open pack '" + p_path + "'.");
+		Vector<uint8_t> dictionary;
+		dictionary.resize(zstd_dictionary_size);
+		df->seek(zstd_dictionary_ofs);
+		if (df->get_buffer(dictionary.ptrw(), dictionary.size()) == uint64_t(dictionary.size())) {
+			Compression::add_zstd_dictionary(dictionary);
+		}
+	}
+
+	if (!mappings.has(p_path)) {
+		Mapping mapping;
+		mapping.file = FileAccess::open_mapped(p_path);
+		if (mapping.file.is_valid()) {
+			mapping.data = mapping.file->get_buffer_view(mapping.file->get_length());
+			if (mapping.data) {
+				mappings[p_path] = mapping;
+			}
+		}
 	}
 
 	return true;
 }
 
 Ref<FileAccess> PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
+	const Mapping *mapping = mappings.getptr(p_file->pack);
+	if (mapping && !p_file->encrypted) {
+		return memnew(FileAccessPack(p_path, *p_file, mapping->file, mapping->data + p_file->offset));
+	}
 	return memnew(FileAccessPack(p_path, *p_file));
 }
 
@@ -281,7 +361,9 @@ void FileAccessPack::seek(uint64_t p_position) {
 		eof = false;
 	}
 
-	f->seek(off + p_position);
+	if (!mapped_data) {
+		f->seek(off + p_position);
+	}
 	pos = p_position;
 }
 
@@ -308,6 +390,9 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (mapped_data) {
+		return mapped_data[pos++];
+	}
 	pos++;
 	return f->get_8();
 }
@@ -326,21 +411,44 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 		to_read = (int64_t)pf.size - (int64_t)pos;
 	}
 
+	uint64_t read_pos = pos;
 	pos += p_length;
 
 	if (to_read <= 0) {
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+	if (mapped_data) {
+		memcpy(p_dst, mapped_data + read_pos, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_buffer_view(uint64_t p_length) const {
+	ERR_FAIL_COND_V_MSG(f.is_null(), nullptr, "File must be opened before use.");
+
+	if (!mapped_data || eof || p_length > pf.size - pos) {
+		return nullptr;
+	}
+
+	const uint8_t *view = mapped_data + pos;
+	pos += p_length;
+	return view;
+}
+
+CowDataOwner *FileAccessPack::get_buffer_view_owner() const {
+	return mapped_data ? f->get_buffer_view_owner() : nullptr;
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
 	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
 
 	FileAccess::set_big_endian(p_big_endian);
-	f->set_big_endian(p_big_endian);
+	if (!mapped_data) {
+		f->set_big_endian(p_big_endian);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -366,9 +474,19 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
-		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const Ref<FileAccess> &p_mapping, const uint8_t *p_mapped_data) :
+		pf(p_file) {
+	if (p_mapped_data) {
+		// The mapping is shared by every file in the pack, only read from it directly.
+		f = p_mapping;
+		mapped_data = p_mapped_data;
+		off = pf.offset;
+		pos = 0;
+		eof = false;
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	ERR_FAIL_COND_MSG(f.is_null(), "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
 	f->seek(pf.offset);
@@ -106,8 +106,13 @@ private:
 	bool disabled = false;
 
 	void _free_packed_dirs(PackedDir *p_dir);
+	void _remove_pack_files(PackedDir *p_dir, const String &p_dir_path, const String &p_pack_path);
 
 public:
+	// A Zstandard dictionary stored at this path in a pack is added when the pack
+	// is, so the compressed resources it contains can share it.
+	static constexpr const char *ZSTD_DICTIONARY_PATH = "res://.godot/zstd_dictionary";
+
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
 
@@ -116,9 +121,13 @@ public:
 
 	static PackedData *get_singleton() { return singleton; }
 	Error add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset);
+	// Removes the files added by a pack. Files it replaced are not brought back.
+	void remove_pack(const String &p_path);
 
 	_FORCE_INLINE_ Ref<FileAccess> try_open_path(const String &p_path);
 	_FORCE_INLINE_ bool has_path(const String &p_path);
+	// Where the contents of a file are in its pack, if they are stored as they are.
+	bool get_file_location(const String &p_path, String &r_pack_path, uint64_t &r_offset, uint64_t &r_size);
 
 	_FORCE_INLINE_ Ref<DirAccess> try_open_directory(const String &p_path);
 	_FORCE_INLINE_ bool has_directory(const String &p_path);
@@ -131,13 +140,25 @@ class PackSource {
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) = 0;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) = 0;
+	// Whether the contents of the file are stored as they are, from its offset.
+	virtual bool is_stored_raw(const PackedData::PackedFile &p_file) const { return false; }
+	virtual void remove_pack(const String &p_path) {}
 	virtual ~PackSource() {}
 };
 
 class PackedSourcePCK : public PackSource {
+	struct Mapping {
+		Ref<FileAccess> file;
+		const uint8_t *data = nullptr;
+	};
+	// Packs that could be memory mapped, their files are read straight from the mapping.
+	HashMap<String, Mapping> mappings;
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) override;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) override;
+	virtual bool is_stored_raw(const PackedData::PackedFile &p_file) const override { return !p_file.encrypted; }
+	virtual void remove_pack(const String &p_path) override { mappings.erase(p_path); }
 };
 
 class FileAccessPack : public FileAccess {
@@ -148,6 +169,7 @@ class FileAccessPack : public FileAccess {
 	uint64_t off;
 
 	Ref<FileAccess> f;
+	const uint8_t *mapped_data = nullptr; // Start of the file if the pack is memory mapped, f is the mapping then.
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) { return 0; }
@@ -166,6 +188,8 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const;
+	virtual const uint8_t *get_buffer_view(uint64_t p_length) const;
+	virtual CowDataOwner *get_buffer_view_owner() const;
 
 	virtual void set_big_endian(bool p_big_endian);
 
@@ -178,7 +202,7 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const Ref<FileAccess> &p_mapping = Ref<FileAccess>(), const uint8_t *p_mapped_data = nullptr);
 };
 
 Ref<FileAccess> PackedData::try_open_path(const String &p_path) {
@@ -100,7 +100,7 @@ String JSON::_stringify(const Variant &p_var, const String &p_indent, int p_cur_
 					s += ",";
 					s += end_statement;
 				}
-				s += _make_indent(p_indent, p_cur_indent + 1) + _stringify(a[i], p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
+				s += _make_indent(p_indent, p_cur_indent + 1) + _stringify(a.get(i), p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
 			}
 			s += end_statement + _make_indent(p_indent, p_cur_indent) + "]";
 			p_markers.erase(a.id());
@@ -549,3 +549,818 @@ void JSON::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_error_line"), &JSON::get_error_line);
 	ClassDB::bind_method(D_METHOD("get_error_message"), &JSON::get_error_message);
 }
+
+// Number of bytes at the start of p_str that are copied into a string as they
+// are, i.e. up to the first quote, backslash or line break. Most strings have
+// no escapes, so eight bytes are checked at a time.
+static _FORCE_INLINE_ uint32_t _json_plain_length(const uint8_t *p_str, uint32_t p_length) {
+	const uint64_t ones = 0x0101010101010101;
+	const uint64_t highs = 0x8080808080808080;
+	uint32_t i = 0;
+	for (; i + 8 <= p_length; i += 8) {
+		uint64_t word;
+		memcpy(&word, p_str + i, 8);
+		const uint64_t quote = word ^ (ones * '"');
+		const uint64_t backslash = word ^ (ones * '\\');
+		const uint64_t line_break = word ^ (ones * '\n');
+		// A byte is zero in one of them if it's a special character.
+		const uint64_t zero = ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash) | ((line_break - ones) & ~line_break);
+		if (zero & highs) {
+			break;
+		}
+	}
+	for (; i < p_length; i++) {
+		const uint8_t c = p_str[i];
+		if (c == '"' || c == '\\' || c == '\n') {
+			break;
+		}
+	}
+	return i;
+}
+
+static void _json_append_utf8(LocalVector<char> &r_text, char32_t p_char) {
+	if (p_char < 0x80) {
+		r_text.push_back(p_char);
+	} else if (p_char < 0x800) {
+		r_text.push_back(0xc0 | (p_char >> 6));
+		r_text.push_back(0x80 | (p_char & 0x3f));
+	} else if (p_char < 0x10000) {
+		r_text.push_back(0xe0 | (p_char >> 12));
+		r_text.push_back(0x80 | ((p_char >> 6) & 0x3f));
+		r_text.push_back(0x80 | (p_char & 0x3f));
+	} else {
+		r_text.push_back(0xf0 | (p_char >> 18));
+		r_text.push_back(0x80 | ((p_char >> 12) & 0x3f));
+		r_text.push_back(0x80 | ((p_char >> 6) & 0x3f));
+		r_text.push_back(0x80 | (p_char & 0x3f));
+	}
+}
+
+bool JSONReader::_fill() {
+	pos = 0;
+	end = 0;
+	if (file.is_valid()) {
+		const uint64_t length = MIN((uint64_t)CHUNK_SIZE, file->get_length() - file->get_position());
+		if (length == 0) {
+			return false;
+		}
+		data = file->get_buffer_view(length);
+		if (data) {
+			end = length;
+		} else {
+			data = buffer.ptr();
+			end = file->get_buffer(buffer.ptr(), length);
+		}
+	} else if (peer.is_valid()) {
+		int received = 0;
+		if (peer->get_partial_data(buffer.ptr(), CHUNK_SIZE, received) != OK) {
+			return false;
+		}
+		if (received == 0) {
+			// Nothing available yet, like on a non-blocking connection, isn't the end of
+			// the stream. Wait for more, peers that have no more data fail instead.
+			if (peer->get_data(buffer.ptr(), 1) != OK) {
+				return false;
+			}
+			received = 1;
+		}
+		data = buffer.ptr();
+		end = received;
+	}
+	return end > 0;
+}
+
+void JSONReader::_skip_whitespace() {
+	while (true) {
+		const int c = _peek();
+		if (c < 0 || c > 32) {
+			return;
+		}
+		if (c == '\n') {
+			line++;
+		}
+		pos++;
+	}
+}
+
+bool JSONReader::_read_hex(char32_t &r_value) {
+	r_value = 0;
+	for (int i = 0; i < 4; i++) {
+		const int c = _peek();
+		if (c < 0) {
+			_error("Unterminated String");
+			return false;
+		}
+		if (!is_hex_digit(c)) {
+			_error("Malformed hex constant in string");
+			return false;
+		}
+		pos++;
+		r_value <<= 4;
+		if (is_digit(c)) {
+			r_value |= c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			r_value |= c - 'a' + 10;
+		} else {
+			r_value |= c - 'A' + 10;
+		}
+	}
+	return true;
+}
+
+bool JSONReader::_read_escape() {
+	// Past the backslash.
+	const int next = _peek();
+	if (next < 0) {
+		_error("Unterminated String");
+		return false;
+	}
+	pos++;
+
+	char32_t res = 0;
+	switch (next) {
+		case 'b':
+			res = 8;
+			break;
+		case 't':
+			res = 9;
+			break;
+		case 'n':
+			res = 10;
+			break;
+		case 'f':
+			res = 12;
+			break;
+		case 'r':
+			res = 13;
+			break;
+		case 'u': {
+			if (!_read_hex(res)) {
+				return false;
+			}
+			if ((res & 0xfffffc00) == 0xd800) {
+				if (_peek() != '\\') {
+					_error("Invalid UTF-16 sequence in string, unpaired lead surrogate");
+					return false;
+				}
+				pos++;
+				if (_peek() != 'u') {
+					_error("Invalid UTF-16 sequence in string, unpaired lead surrogate");
+					return false;
+				}
+				pos++;
+				char32_t trail = 0;
+				if (!_read_hex(trail)) {
+					return false;
+				}
+				if ((trail & 0xfffffc00) != 0xdc00) {
+					_error("Invalid UTF-16 sequence in string, unpaired lead surrogate");
+					return false;
+				}
+				res = (res << 10UL) + trail - ((0xd800 << 10UL) + 0xdc00 - 0x10000);
+			} else if ((res & 0xfffffc00) == 0xdc00) {
+				_error("Invalid UTF-16 sequence in string, unpaired trail surrogate");
+				return false;
+			}
+		} break;
+		default: {
+			res = next;
+		} break;
+	}
+	_json_append_utf8(text, res);
+	return true;
+}
+
+bool JSONReader::_read_string(String &r_string) {
+	// Past the opening quote.
+	text.clear();
+	while (true) {
+		if (pos == end && !_fill()) {
+			_error("Unterminated String");
+			return false;
+		}
+		const uint32_t length = _json_plain_length(data + pos, end - pos);
+		if (pos + length < end && data[pos + length] == '"' && text.is_empty()) {
+			// The whole string is in the chunk, decode it from there.
+			r_string.parse_utf8((const char *)data + pos, length);
+			pos += length + 1;
+			return true;
+		}
+		if (length) {
+			const uint32_t size = text.size();
+			text.resize(size + length);
+			memcpy(text.ptr() + size, data + pos, length);
+			pos += length;
+		}
+		if (pos == end) {
+			continue;
+		}
+
+		const uint8_t c = data[pos++];
+		if (c == '"') {
+			break;
+		} else if (c == '\\') {
+			if (!_read_escape()) {
+				return false;
+			}
+		} else {
+			// Line break.
+			line++;
+			text.push_back(c);
+		}
+	}
+	if (text.is_empty()) {
+		r_string = String();
+	} else {
+		r_string.parse_utf8(text.ptr(), text.size());
+	}
+	return true;
+}
+
+bool JSONReader::_read_number() {
+	text.clear();
+	while (true) {
+		const int c = _peek();
+		if (!(is_digit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+			break;
+		}
+		text.push_back(c);
+		pos++;
+	}
+	text.push_back(0);
+	value = String::to_float(text.ptr());
+	return true;
+}
+
+bool JSONReader::_read_identifier() {
+	text.clear();
+	while (true) {
+		const int c = _peek();
+		if (c < 0 || !is_ascii_char(c)) {
+			break;
+		}
+		text.push_back(c);
+		pos++;
+	}
+	const uint32_t length = text.size();
+	if (length == 4 && memcmp(text.ptr(), "true", 4) == 0) {
+		value = true;
+	} else if (length == 5 && memcmp(text.ptr(), "false", 5) == 0) {
+		value = false;
+	} else if (length == 4 && memcmp(text.ptr(), "null", 4) == 0) {
+		value = Variant();
+	} else {
+		_error("Expected 'true','false' or 'null', got '" + String::utf8(text.ptr(), length) + "'.");
+		return false;
+	}
+	return true;
+}
+
+JSONReader::Event JSONReader::_error(const String &p_message) {
+	if (error == OK) {
+		error = ERR_PARSE_ERROR;
+		err_str = p_message;
+	}
+	state = STATE_DONE;
+	return EVENT_ERROR;
+}
+
+void JSONReader::_value_done() {
+	if (containers.is_empty()) {
+		state = STATE_DONE;
+	} else if (containers[containers.size() - 1] == '{') {
+		state = STATE_OBJECT_NEXT;
+	} else {
+		state = STATE_ARRAY_NEXT;
+	}
+}
+
+JSONReader::Event JSONReader::_read_value() {
+	const int c = _peek();
+	if (c == '{') {
+		pos++;
+		containers.push_back('{');
+		state = STATE_OBJECT_FIRST;
+		return EVENT_OBJECT_BEGIN;
+	} else if (c == '[') {
+		pos++;
+		containers.push_back('[');
+		state = STATE_ARRAY_FIRST;
+		return EVENT_ARRAY_BEGIN;
+	} else if (c == '"') {
+		pos++;
+		String str;
+		if (!_read_string(str)) {
+			return EVENT_ERROR;
+		}
+		value = str;
+	} else if (c == '-' || is_digit(c)) {
+		_read_number();
+	} else if (c >= 0 && is_ascii_char(c)) {
+		if (!_read_identifier()) {
+			return EVENT_ERROR;
+		}
+	} else if (c < 0) {
+		return _error("Expected value, got EOF.");
+	} else {
+		return _error("Unexpected character.");
+	}
+	_value_done();
+	return EVENT_VALUE;
+}
+
+JSONReader::Event JSONReader::_read_key() {
+	if (_peek() != '"') {
+		return _error("Expected key");
+	}
+	pos++;
+	if (!_read_string(key)) {
+		return EVENT_ERROR;
+	}
+	_skip_whitespace();
+	if (_peek() != ':') {
+		return _error("Expected ':'");
+	}
+	pos++;
+	state = STATE_OBJECT_VALUE;
+	return EVENT_KEY;
+}
+
+JSONReader::Event JSONReader::_close_container(uint8_t p_bracket) {
+	pos++;
+	containers.resize(containers.size() - 1);
+	_value_done();
+	return p_bracket == '}' ? EVENT_OBJECT_END : EVENT_ARRAY_END;
+}
+
+JSONReader::Event JSONReader::next() {
+	last_event = _next();
+	return last_event;
+}
+
+JSONReader::Event JSONReader::_next() {
+	if (error != OK) {
+		return EVENT_ERROR;
+	}
+	_skip_whitespace();
+	const int c = _peek();
+
+	switch (state) {
+		case STATE_ROOT:
+		case STATE_OBJECT_VALUE:
+			return _read_value();
+		case STATE_OBJECT_FIRST:
+			if (c == '}') {
+				return _close_container(c);
+			}
+			return _read_key();
+		case STATE_OBJECT_NEXT:
+			if (c == '}') {
+				return _close_container(c);
+			} else if (c != ',') {
+				return _error("Expected '}' or ','");
+			}
+			pos++;
+			_skip_whitespace();
+			return _read_key();
+		case STATE_ARRAY_FIRST:
+			if (c == ']') {
+				return _close_container(c);
+			}
+			return _read_value();
+		case STATE_ARRAY_NEXT:
+			if (c == ']') {
+				return _close_container(c);
+			} else if (c != ',') {
+				return _error("Expected ','");
+			}
+			pos++;
+			_skip_whitespace();
+			return _read_value();
+		case STATE_DONE:
+			if (c >= 0) {
+				return _error("Expected 'EOF'");
+			}
+			return EVENT_END;
+	}
+	return EVENT_ERROR;
+}
+
+Variant JSONReader::read_value() {
+	Event event = last_event;
+	if (event != EVENT_OBJECT_BEGIN && event != EVENT_ARRAY_BEGIN) {
+		event = next();
+		if (event == EVENT_VALUE) {
+			return value;
+		} else if (event != EVENT_OBJECT_BEGIN && event != EVENT_ARRAY_BEGIN) {
+			_error("Expected value");
+			return Variant();
+		}
+	}
+
+	// Containers being read, and the key their next value goes to. Built
+	// without recursion, so deeply nested documents can't overflow the stack.
+	LocalVector<Variant> stack;
+	LocalVector<String> keys;
+	stack.push_back(event == EVENT_OBJECT_BEGIN ? Variant(Dictionary()) : Variant(Array()));
+	keys.push_back(String());
+
+	while (true) {
+		Variant item;
+		event = next();
+		switch (event) {
+			case EVENT_KEY: {
+				keys[keys.size() - 1] = key;
+				continue;
+			}
+			case EVENT_OBJECT_BEGIN:
+			case EVENT_ARRAY_BEGIN: {
+				stack.push_back(event == EVENT_OBJECT_BEGIN ? Variant(Dictionary()) : Variant(Array()));
+				keys.push_back(String());
+				continue;
+			}
+			case EVENT_VALUE: {
+				item = value;
+			} break;
+			case EVENT_OBJECT_END:
+			case EVENT_ARRAY_END: {
+				item = stack[stack.size() - 1];
+				stack.resize(stack.size() - 1);
+				keys.resize(keys.size() - 1);
+				if (stack.is_empty()) {
+					return item;
+				}
+			} break;
+			default: {
+				return Variant();
+			}
+		}
+
+		const Variant &parent = stack[stack.size() - 1];
+		if (parent.get_type() == Variant::DICTIONARY) {
+			Dictionary d = parent;
+			d[keys[keys.size() - 1]] = item;
+		} else {
+			Array a = parent;
+			a.push_back(item);
+		}
+	}
+}
+
+Error JSONReader::skip_value() {
+	Event event = last_event;
+	if (event != EVENT_OBJECT_BEGIN && event != EVENT_ARRAY_BEGIN) {
+		event = next();
+		if (event == EVENT_VALUE) {
+			return OK;
+		} else if (event != EVENT_OBJECT_BEGIN && event != EVENT_ARRAY_BEGIN) {
+			_error("Expected value");
+			return error;
+		}
+	}
+
+	const uint32_t depth = containers.size() - 1;
+	while (containers.size() > depth) {
+		if (next() == EVENT_ERROR) {
+			return error;
+		}
+	}
+	return OK;
+}
+
+void JSONReader::_start() {
+	buffer.resize(CHUNK_SIZE);
+	data = buffer.ptr();
+	pos = 0;
+	end = 0;
+	state = STATE_ROOT;
+	last_event = EVENT_END;
+	containers.clear();
+	key = String();
+	value = Variant();
+	line = 0;
+	error = OK;
+	err_str = String();
+
+	// Skip the byte order mark.
+	if (_peek() == 0xef && end - pos >= 3 && data[pos + 1] == 0xbb && data[pos + 2] == 0xbf) {
+		pos += 3;
+	}
+}
+
+Error JSONReader::open(const String &p_path) {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(f.is_null(), err, "Cannot open file '" + p_path + "'.");
+	return open_file(f);
+}
+
+Error JSONReader::open_file(const Ref<FileAccess> &p_file) {
+	ERR_FAIL_COND_V(p_file.is_null(), ERR_INVALID_PARAMETER);
+	close();
+	file = p_file;
+	_start();
+	return OK;
+}
+
+Error JSONReader::open_stream(const Ref<StreamPeer> &p_peer) {
+	ERR_FAIL_COND_V(p_peer.is_null(), ERR_INVALID_PARAMETER);
+	close();
+	peer = p_peer;
+	_start();
+	return OK;
+}
+
+void JSONReader::close() {
+	file.unref();
+	peer.unref();
+	buffer.reset();
+	data = nullptr;
+	pos = 0;
+	end = 0;
+	state = STATE_DONE;
+	containers.reset();
+	text.reset();
+}
+
+void JSONReader::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("open", "path"), &JSONReader::open);
+	ClassDB::bind_method(D_METHOD("open_stream", "peer"), &JSONReader::open_stream);
+	ClassDB::bind_method(D_METHOD("close"), &JSONReader::close);
+
+	ClassDB::bind_method(D_METHOD("next"), &JSONReader::next);
+	ClassDB::bind_method(D_METHOD("read_value"), &JSONReader::read_value);
+	ClassDB::bind_method(D_METHOD("skip_value"), &JSONReader::skip_value);
+
+	ClassDB::bind_method(D_METHOD("get_key"), &JSONReader::get_key);
+	ClassDB::bind_method(D_METHOD("get_value"), &JSONReader::get_value);
+	ClassDB::bind_method(D_METHOD("get_depth"), &JSONReader::get_depth);
+	ClassDB::bind_method(D_METHOD("get_error_line"), &JSONReader::get_error_line);
+	ClassDB::bind_method(D_METHOD("get_error_message"), &JSONReader::get_error_message);
+
+	BIND_ENUM_CONSTANT(EVENT_OBJECT_BEGIN);
+	BIND_ENUM_CONSTANT(EVENT_OBJECT_END);
+	BIND_ENUM_CONSTANT(EVENT_ARRAY_BEGIN);
+	BIND_ENUM_CONSTANT(EVENT_ARRAY_END);
+	BIND_ENUM_CONSTANT(EVENT_KEY);
+	BIND_ENUM_CONSTANT(EVENT_VALUE);
+	BIND_ENUM_CONSTANT(EVENT_END);
+	BIND_ENUM_CONSTANT(EVENT_ERROR);
+}
+
+void JSONWriter::_write(const char *p_text, uint32_t p_length) {
+	const uint32_t size = buffer.size();
+	buffer.resize(size + p_length);
+	memcpy(buffer.ptr() + size, p_text, p_length);
+	if (buffer.size() >= CHUNK_SIZE) {
+		flush();
+	}
+}
+
+void JSONWriter::_write(const String &p_text) {
+	const CharString utf8 = p_text.utf8();
+	_write(utf8.get_data(), utf8.length());
+}
+
+void JSONWriter::_write_indent(int p_depth) {
+	for (int i = 0; i < p_depth; i++) {
+		_write(indent.get_data(), indent.length());
+	}
+}
+
+Error JSONWriter::_begin_value() {
+	ERR_FAIL_COND_V_MSG(file.is_null() && peer.is_null(), ERR_UNCONFIGURED, "The JSONWriter is not open.");
+	if (levels.is_empty()) {
+		ERR_FAIL_COND_V_MSG(root_written, ERR_INVALID_DATA, "A JSON document can only have one root value.");
+		root_written = true;
+		return OK;
+	}
+
+	Level &level = levels[levels.size() - 1];
+	if (level.object) {
+		ERR_FAIL_COND_V_MSG(!level.has_key, ERR_INVALID_DATA, "Values in a JSON object must follow a key.");
+		level.has_key = false;
+	} else {
+		if (!level.empty) {
+			_write(",");
+			if (indent.length()) {
+				_write("\n");
+			}
+		}
+		_write_indent(levels.size());
+	}
+	level.empty = false;
+	return OK;
+}
+
+void JSONWriter::_write_variant(const Variant &p_var) {
+	switch (p_var.get_type()) {
+		case Variant::PACKED_INT32_ARRAY:
+		case Variant::PACKED_INT64_ARRAY:
+		case Variant::PACKED_FLOAT32_ARRAY:
+		case Variant::PACKED_FLOAT64_ARRAY:
+		case Variant::PACKED_STRING_ARRAY:
+		case Variant::ARRAY: {
+			Array a = p_var;
+			ERR_FAIL_COND_MSG(markers.has(a.id()), "Converting circular structure to JSON.");
+			markers.insert(a.id());
+
+			begin_array();
+			for (int i = 0; i < a.size(); i++) {
+				write_value(a.get(i));
+			}
+			end_array();
+
+			markers.erase(a.id());
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary d = p_var;
+			ERR_FAIL_COND_MSG(markers.has(d.id()), "Converting circular structure to JSON.");
+			markers.insert(d.id());
+
+			List<Variant> keys;
+			d.get_key_list(&keys);
+			if (sort_keys) {
+				keys.sort();
+			}
+
+			begin_object();
+			for (const Variant &E : keys) {
+				write_key(E);
+				write_value(d[E]);
+			}
+			end_object();
+
+			markers.erase(d.id());
+		} break;
+		default: {
+			HashSet<const void *> no_markers;
+			_write(JSON::_stringify(p_var, String(), 0, false, no_markers, full_precision));
+		} break;
+	}
+}
+
+Error JSONWriter::begin_object() {
+	const Error err = _begin_value();
+	ERR_FAIL_COND_V(err != OK, err);
+	_write("{");
+	if (indent.length()) {
+		_write("\n");
+	}
+	Level level;
+	level.object = true;
+	levels.push_back(level);
+	return OK;
+}
+
+Error JSONWriter::end_object() {
+	ERR_FAIL_COND_V_MSG(levels.is_empty() || !levels[levels.size() - 1].object, ERR_INVALID_DATA, "There is no JSON object to end.");
+	ERR_FAIL_COND_V_MSG(levels[levels.size() - 1].has_key, ERR_INVALID_DATA, "The last key of the JSON object has no value.");
+	levels.resize(levels.size() - 1);
+	if (indent.length()) {
+		_write("\n");
+	}
+	_write_indent(levels.size());
+	_write("}");
+	return error;
+}
+
+Error JSONWriter::begin_array() {
+	const Error err = _begin_value();
+	ERR_FAIL_COND_V(err != OK, err);
+	_write("[");
+	if (indent.length()) {
+		_write("\n");
+	}
+	levels.push_back(Level());
+	return OK;
+}
+
+Error JSONWriter::end_array() {
+	ERR_FAIL_COND_V_MSG(levels.is_empty() || levels[levels.size() - 1].object, ERR_INVALID_DATA, "There is no JSON array to end.");
+	levels.resize(levels.size() - 1);
+	if (indent.length()) {
+		_write("\n");
+	}
+	_write_indent(levels.size());
+	_write("]");
+	return error;
+}
+
+Error JSONWriter::write_key(const String &p_key) {
+	ERR_FAIL_COND_V_MSG(levels.is_empty() || !levels[levels.size() - 1].object, ERR_INVALID_DATA, "Keys can only be written inside a JSON object.");
+	Level &level = levels[levels.size() - 1];
+	ERR_FAIL_COND_V_MSG(level.has_key, ERR_INVALID_DATA, "The last key of the JSON object has no value.");
+	if (!level.empty) {
+		_write(",");
+		if (indent.length()) {
+			_write("\n");
+		}
+	}
+	_write_indent(levels.size());
+	_write("\"" + p_key.json_escape() + "\"");
+	_write(indent.length() ? ": " : ":");
+	level.has_key = true;
+	return error;
+}
+
+Error JSONWriter::write_value(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::PACKED_INT32_ARRAY:
+		case Variant::PACKED_INT64_ARRAY:
+		case Variant::PACKED_FLOAT32_ARRAY:
+		case Variant::PACKED_FLOAT64_ARRAY:
+		case Variant::PACKED_STRING_ARRAY:
+		case Variant::ARRAY:
+		case Variant::DICTIONARY: {
+			// Checked by begin_array() and begin_object().
+		} break;
+		default: {
+			const Error err = _begin_value();
+			ERR_FAIL_COND_V(err != OK, err);
+		} break;
+	}
+	_write_variant(p_value);
+	return error;
+}
+
+Error JSONWriter::flush() {
+	if (buffer.is_empty()) {
+		return error;
+	}
+	if (file.is_valid()) {
+		file->store_buffer(buffer.ptr(), buffer.size());
+		if (error == OK) {
+			error = file->get_error();
+		}
+	} else if (peer.is_valid()) {
+		const Error err = peer->put_data(buffer.ptr(), buffer.size());
+		if (error == OK) {
+			error = err;
+		}
+	}
+	buffer.clear();
+	return error;
+}
+
+Error JSONWriter::close() {
+	ERR_FAIL_COND_V_MSG(!levels.is_empty(), ERR_INVALID_DATA, "JSON containers were not ended before closing the JSONWriter.");
+	const Error err = flush();
+	file.unref();
+	peer.unref();
+	buffer.reset();
+	return err;
+}
+
+void JSONWriter::_start(const String &p_indent, bool p_sort_keys, bool p_full_precision) {
+	indent = p_indent.utf8();
+	sort_keys = p_sort_keys;
+	full_precision = p_full_precision;
+	levels.clear();
+	root_written = false;
+	markers.clear();
+	error = OK;
+}
+
+Error JSONWriter::open(const String &p_path, const String &p_indent, bool p_sort_keys, bool p_full_precision) {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(f.is_null(), err, "Cannot open file '" + p_path + "'.");
+	return open_file(f, p_indent, p_sort_keys, p_full_precision);
+}
+
+Error JSONWriter::open_file(const Ref<FileAccess> &p_file, const String &p_indent, bool p_sort_keys, bool p_full_precision) {
+	ERR_FAIL_COND_V(p_file.is_null(), ERR_INVALID_PARAMETER);
+	flush();
+	peer.unref();
+	file = p_file;
+	_start(p_indent, p_sort_keys, p_full_precision);
+	return OK;
+}
+
+Error JSONWriter::open_stream(const Ref<StreamPeer> &p_peer, const String &p_indent, bool p_sort_keys, bool p_full_precision) {
+	ERR_FAIL_COND_V(p_peer.is_null(), ERR_INVALID_PARAMETER);
+	flush();
+	file.unref();
+	peer = p_peer;
+	_start(p_indent, p_sort_keys, p_full_precision);
+	return OK;
+}
+
+void JSONWriter::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("open", "path", "indent", "sort_keys", "full_precision"), &JSONWriter::open, DEFVAL(""), DEFVAL(true), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("open_stream", "peer", "indent", "sort_keys", "full_precision"), &JSONWriter::open_stream, DEFVAL(""), DEFVAL(true), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("flush"), &JSONWriter::flush);
+	ClassDB::bind_method(D_METHOD("close"), &JSONWriter::close);
+
+	ClassDB::bind_method(D_METHOD("begin_object"), &JSONWriter::begin_object);
+	ClassDB::bind_method(D_METHOD("end_object"), &JSONWriter::end_object);
+	ClassDB::bind_method(D_METHOD("begin_array"), &JSONWriter::begin_array);
+	ClassDB::bind_method(D_METHOD("end_array"), &JSONWriter::end_array);
+	ClassDB::bind_method(D_METHOD("write_key", "key"), &JSONWriter::write_key);
+	ClassDB::bind_method(D_METHOD("write_value", "value"), &JSONWriter::write_value);
+}
+
+JSONWriter::~JSONWriter() {
+	flush();
+}
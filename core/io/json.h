@@ -31,12 +31,17 @@
 #ifndef JSON_H
 #define JSON_H
 
+#include "core/io/file_access.h"
+#include "core/io/stream_peer.h"
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/variant.h"
 
 class JSON : public RefCounted {
 	GDCLASS(JSON, RefCounted);
 
+	friend class JSONWriter;
+
 	enum TokenType {
 		TK_CURLY_BRACKET_OPEN,
 		TK_CURLY_BRACKET_CLOSE,
@@ -89,4 +94,157 @@ public:
 	inline String get_error_message() const { return err_str; }
 };
 
+// Parses JSON from a file or a stream peer a chunk at a time, without
+// converting it to a String first. Each call to next() reads one event, so a
+// document can be processed while only keeping the current key or value (and
+// whichever subtrees are read with read_value()) in memory.
+class JSONReader : public RefCounted {
+	GDCLASS(JSONReader, RefCounted);
+
+public:
+	enum Event {
+		EVENT_OBJECT_BEGIN,
+		EVENT_OBJECT_END,
+		EVENT_ARRAY_BEGIN,
+		EVENT_ARRAY_END,
+		EVENT_KEY,
+		EVENT_VALUE,
+		EVENT_END,
+		EVENT_ERROR,
+	};
+
+	enum {
+		CHUNK_SIZE = 64 * 1024,
+	};
+
+private:
+	enum State {
+		STATE_ROOT,
+		STATE_OBJECT_FIRST,
+		STATE_OBJECT_NEXT,
+		STATE_OBJECT_VALUE,
+		STATE_ARRAY_FIRST,
+		STATE_ARRAY_NEXT,
+		STATE_DONE,
+	};
+
+	Ref<FileAccess> file;
+	Ref<StreamPeer> peer;
+	LocalVector<uint8_t> buffer;
+	const uint8_t *data = nullptr; // Either the buffer or a view of a mapped file.
+	uint32_t pos = 0;
+	uint32_t end = 0;
+
+	State state = STATE_DONE;
+	Event last_event = EVENT_END;
+	LocalVector<uint8_t> containers; // '{' or '[' for each open container.
+	LocalVector<char> text;
+	String key;
+	Variant value;
+
+	int line = 0;
+	Error error = OK;
+	String err_str;
+
+	bool _fill();
+	_FORCE_INLINE_ int _peek() {
+		if (pos == end && !_fill()) {
+			return -1;
+		}
+		return data[pos];
+	}
+	void _skip_whitespace();
+	bool _read_string(String &r_string);
+	bool _read_escape();
+	bool _read_hex(char32_t &r_value);
+	bool _read_number();
+	bool _read_identifier();
+	Event _read_value();
+	Event _read_key();
+	Event _close_container(uint8_t p_bracket);
+	void _value_done();
+	Event _error(const String &p_message);
+	void _start();
+	Event _next();
+
+protected:
+	static void _bind_methods();
+
+public:
+	Error open(const String &p_path);
+	Error open_file(const Ref<FileAccess> &p_file);
+	Error open_stream(const Ref<StreamPeer> &p_peer);
+	void close();
+
+	Event next();
+	Variant read_value();
+	Error skip_value();
+
+	inline String get_key() const { return key; }
+	inline Variant get_value() const { return value; }
+	inline int get_depth() const { return containers.size(); }
+	inline Error get_error() const { return error; }
+	inline int get_error_line() const { return line; }
+	inline String get_error_message() const { return err_str; }
+};
+
+VARIANT_ENUM_CAST(JSONReader::Event);
+
+// Writes JSON to a file or a stream peer as it is produced, formatted the same
+// way as JSON::stringify(). Containers can be written element by element with
+// the begin_*() and end_*() methods, or whole with write_value().
+class JSONWriter : public RefCounted {
+	GDCLASS(JSONWriter, RefCounted);
+
+	struct Level {
+		bool object = false;
+		bool empty = true;
+		bool has_key = false;
+	};
+
+	Ref<FileAccess> file;
+	Ref<StreamPeer> peer;
+	LocalVector<uint8_t> buffer;
+
+	CharString indent;
+	bool sort_keys = true;
+	bool full_precision = false;
+
+	LocalVector<Level> levels;
+	bool root_written = false;
+	HashSet<const void *> markers;
+	Error error = OK;
+
+	void _write(const char *p_text, uint32_t p_length);
+	_FORCE_INLINE_ void _write(const char *p_text) { _write(p_text, strlen(p_text)); }
+	void _write(const String &p_text);
+	void _write_indent(int p_depth);
+	Error _begin_value();
+	void _write_variant(const Variant &p_var);
+	void _start(const String &p_indent, bool p_sort_keys, bool p_full_precision);
+
+protected:
+	static void _bind_methods();
+
+public:
+	enum {
+		CHUNK_SIZE = 64 * 1024,
+	};
+
+	Error open(const String &p_path, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
+	Error open_file(const Ref<FileAccess> &p_file, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
+	Error open_stream(const Ref<StreamPeer> &p_peer, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
+	Error flush();
+	Error close();
+
+	Error begin_object();
+	Error end_object();
+	Error begin_array();
+	Error end_array();
+	Error write_key(const String &p_key);
+	Error write_value(const Variant &p_value);
+
+	~JSONWriter();
+};
+
 #endif // JSON_H
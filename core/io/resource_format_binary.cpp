@@ -81,6 +81,7 @@ enum {
 	VARIANT_VECTOR3I = 47,
 	VARIANT_PACKED_INT64_ARRAY = 48,
 	VARIANT_PACKED_FLOAT64_ARRAY = 49,
+	VARIANT_ALIGNED_PACKED_ARRAY = 50,
 	OBJECT_EMPTY = 0,
 	OBJECT_EXTERNAL_RESOURCE = 1,
 	OBJECT_INTERNAL_RESOURCE = 2,
@@ -88,9 +89,16 @@ enum {
 	// Version 2: added 64 bits support for float and int.
 	// Version 3: changed nodepath encoding.
 	// Version 4: new string ID for ext/subresources, breaks forward compat.
-	FORMAT_VERSION = 4,
+	// Version 5: large packed arrays are stored aligned, so they can be used in place.
+	FORMAT_VERSION = 5,
+	// Files without aligned arrays are saved with this version, so older versions of the engine can read them.
+	FORMAT_VERSION_NO_ALIGNED_ARRAYS = 4,
 	FORMAT_VERSION_CAN_RENAME_DEPS = 1,
 	FORMAT_VERSION_NO_NODEPATH_PROPERTY = 3,
+	// Packed arrays of numbers at least this large are stored page aligned, with room for
+	// a CowData header before them.
+	ALIGNED_ARRAY_MIN_SIZE = 64 * 1024,
+	ALIGNED_ARRAY_ALIGNMENT = 4096,
 };
 
 void ResourceLoaderBinary::_advance_padding(uint32_t p_len) {
@@ -146,6 +154,30 @@ static Error read_reals(real_t *dst, Ref<FileAccess> &f, size_t count) {
 	return OK;
 }
 
+// Reads an array stored by ResourceFormatSaverBinaryInstance::_write_aligned_array().
+// When the file is memory mapped, the array uses the data in place instead of a copy.
+template <class T>
+static Error read_aligned_array(Ref<FileAccess> &f, uint32_t p_len, bool p_can_adopt, Vector<T> &r_array) {
+	uint64_t size = uint64_t(p_len) * sizeof(T);
+	const uint8_t *view = f->get_buffer_view(size);
+	if (view) {
+		CowDataOwner *owner = f->get_buffer_view_owner();
+		if (p_can_adopt && owner && uintptr_t(view) % 16 == 0) {
+			r_array.adopt((T *)view, p_len, owner);
+		} else {
+			r_array.resize(p_len);
+			memcpy(r_array.ptrw(), view, size);
+		}
+		return OK;
+	}
+
+	r_array.resize(p_len);
+	if (f->get_buffer((uint8_t *)r_array.ptrw(), size) != size) {
+		return ERR_FILE_CORRUPT;
+	}
+	return OK;
+}
+
 StringName ResourceLoaderBinary::_get_string() {
 	uint32_t id = f->get_32();
 	if (id & 0x80000000) {
@@ -156,8 +188,13 @@ StringName ResourceLoaderBinary::_get_string() {
 		if (len == 0) {
 			return StringName();
 		}
-		f->get_buffer((uint8_t *)&str_buf[0], len);
 		String s;
+		const uint8_t *view = f->get_buffer_view(len);
+		if (view) {
+			s.parse_utf8((const char *)view, len);
+			return s;
+		}
+		f->get_buffer((uint8_t *)&str_buf[0], len);
 		s.parse_utf8(&str_buf[0]);
 		return s;
 	}
@@ -555,6 +592,86 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 
 			r_v = array;
 		} break;
+		case VARIANT_ALIGNED_PACKED_ARRAY: {
+#ifdef BIG_ENDIAN_ENABLED
+			ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "Aligned packed arrays are not supported on big endian systems.");
+#endif
+			uint32_t array_type = f->get_32();
+			uint32_t len = f->get_32();
+			uint32_t padding = f->get_32();
+			f->seek(f->get_position() + padding);
+			bool can_adopt = padding >= CowData<uint8_t>::ADOPTED_HEADER_SIZE;
+			bool real_matches = f->real_is_double == (sizeof(real_t) == 8);
+
+			Error err = OK;
+			uint64_t size = 0;
+			switch (array_type) {
+				case VARIANT_PACKED_BYTE_ARRAY: {
+					Vector<uint8_t> array;
+					err = read_aligned_array(f, len, can_adopt, array);
+					size = len;
+					r_v = array;
+				} break;
+				case VARIANT_PACKED_INT32_ARRAY: {
+					Vector<int32_t> array;
+					err = read_aligned_array(f, len, can_adopt, array);
+					size = len * sizeof(int32_t);
+					r_v = array;
+				} break;
+				case VARIANT_PACKED_INT64_ARRAY: {
+					Vector<int64_t> array;
+					err = read_aligned_array(f, len, can_adopt, array);
+					size = len * sizeof(int64_t);
+					r_v = array;
+				} break;
+				case VARIANT_PACKED_FLOAT32_ARRAY: {
+					Vector<float> array;
+					err = read_aligned_array(f, len, can_adopt, array);
+					size = len * sizeof(float);
+					r_v = array;
+				} break;
+				case VARIANT_PACKED_FLOAT64_ARRAY: {
+					Vector<double> array;
+					err = read_aligned_array(f, len, can_adopt, array);
+					size = len * sizeof(double);
+					r_v = array;
+				} break;
+				case VARIANT_PACKED_VECTOR2_ARRAY: {
+					Vector<Vector2> array;
+					if (real_matches) {
+						err = read_aligned_array(f, len, can_adopt, array);
+					} else {
+						array.resize(len);
+						err = read_reals(reinterpret_cast<real_t *>(array.ptrw()), f, len * 2);
+					}
+					size = len * 2 * (f->real_is_double ? sizeof(double) : sizeof(float));
+					r_v = array;
+				} break;
+				case VARIANT_PACKED_VECTOR3_ARRAY: {
+					Vector<Vector3> array;
+					if (real_matches) {
+						err = read_aligned_array(f, len, can_adopt, array);
+					} else {
+						array.resize(len);
+						err = read_reals(reinterpret_cast<real_t *>(array.ptrw()), f, len * 3);
+					}
+					size = len * 3 * (f->real_is_double ? sizeof(double) : sizeof(float));
+					r_v = array;
+				} break;
+				case VARIANT_PACKED_COLOR_ARRAY: {
+					Vector<Color> array;
+					err = read_aligned_array(f, len, can_adopt, array);
+					size = len * sizeof(Color);
+					r_v = array;
+				} break;
+				default: {
+					ERR_FAIL_V(ERR_FILE_CORRUPT);
+				}
+			}
+			ERR_FAIL_COND_V(err != OK, err);
+			_advance_padding(size);
+
+		} break;
 		case VARIANT_PACKED_STRING_ARRAY: {
 			uint32_t len = f->get_32();
 			Vector<String> array;
@@ -859,8 +976,13 @@ String ResourceLoaderBinary::get_unicode_string() {
 	if (len == 0) {
 		return String();
 	}
-	f->get_buffer((uint8_t *)&str_buf[0], len);
 	String s;
+	const uint8_t *view = f->get_buffer_view(len);
+	if (view) {
+		s.parse_utf8((const char *)view, len);
+		return s;
+	}
+	f->get_buffer((uint8_t *)&str_buf[0], len);
 	s.parse_utf8(&str_buf[0]);
 	return s;
 }
@@ -1150,7 +1272,7 @@ Error ResourceFormatLoaderBinary::rename_dependencies(const String &p_path, cons
 
 		Ref<FileAccessCompressed> facw;
 		facw.instantiate();
-		facw->configure("RSCC");
+		facw->configure("RSCC", Compression::MODE_ZSTD, 0, fac->get_zstd_dictionary());
 		err = facw->_open(p_path + ".depren", FileAccess::WRITE);
 		ERR_FAIL_COND_V_MSG(err, ERR_FILE_CORRUPT, "Cannot create file '" + p_path + ".depren'.");
 
@@ -1384,7 +1506,34 @@ void ResourceFormatSaverBinaryInstance::_pad_buffer(Ref<FileAccess> f, int p_byt
 	}
 }
 
-void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const Variant &p_property, HashMap<Ref<Resource>, int> &resource_map, HashMap<Ref<Resource>, int> &external_resources, HashMap<StringName, int> &string_map, const PropertyInfo &p_hint) {
+bool ResourceFormatSaverBinaryInstance::_write_aligned_array(Ref<FileAccess> f, bool *r_aligned_arrays, uint32_t p_type, uint32_t p_len, const void *p_data, uint64_t p_size) {
+#ifdef BIG_ENDIAN_ENABLED
+	// The data is stored as it is in memory, which must be little endian.
+	return false;
+#else
+	if (!r_aligned_arrays || p_size < ALIGNED_ARRAY_MIN_SIZE) {
+		return false;
+	}
+	*r_aligned_arrays = true;
+
+	f->store_32(VARIANT_ALIGNED_PACKED_ARRAY);
+	f->store_32(p_type);
+	f->store_32(p_len);
+
+	// Align the data, leaving room for the header CowData needs to use it in place.
+	uint64_t data_pos = f->get_position() + 4 + CowData<uint8_t>::ADOPTED_HEADER_SIZE;
+	uint32_t padding = CowData<uint8_t>::ADOPTED_HEADER_SIZE + (ALIGNED_ARRAY_ALIGNMENT - data_pos % ALIGNED_ARRAY_ALIGNMENT) % ALIGNED_ARRAY_ALIGNMENT;
+	f->store_32(padding);
+	static const uint8_t zeros[ALIGNED_ARRAY_ALIGNMENT + CowData<uint8_t>::ADOPTED_HEADER_SIZE] = {};
+	f->store_buffer(zeros, padding);
+
+	f->store_buffer((const uint8_t *)p_data, p_size);
+	_pad_buffer(f, p_size);
+	return true;
+#endif
+}
+
+void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const Variant &p_property, HashMap<Ref<Resource>, int> &resource_map, HashMap<Ref<Resource>, int> &external_resources, HashMap<StringName, int> &string_map, const PropertyInfo &p_hint, bool *r_aligned_arrays) {
 	switch (p_property.get_type()) {
 		case Variant::NIL: {
 			f->store_32(VARIANT_NIL);
@@ -1633,8 +1782,8 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			d.get_key_list(&keys);
 
 			for (const Variant &E : keys) {
-				write_variant(f, E, resource_map, external_resources, string_map);
-				write_variant(f, d[E], resource_map, external_resources, string_map);
+				write_variant(f, E, resource_map, external_resources, string_map, PropertyInfo(), r_aligned_arrays);
+				write_variant(f, d[E], resource_map, external_resources, string_map, PropertyInfo(), r_aligned_arrays);
 			}
 
 		} break;
@@ -1643,14 +1792,17 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			Array a = p_property;
 			f->store_32(uint32_t(a.size()));
 			for (int i = 0; i < a.size(); i++) {
-				write_variant(f, a[i], resource_map, external_resources, string_map);
+				write_variant(f, a.get(i), resource_map, external_resources, string_map, PropertyInfo(), r_aligned_arrays);
 			}
 
 		} break;
 		case Variant::PACKED_BYTE_ARRAY: {
-			f->store_32(VARIANT_PACKED_BYTE_ARRAY);
 			Vector<uint8_t> arr = p_property;
 			int len = arr.size();
+			if (_write_aligned_array(f, r_aligned_arrays, VARIANT_PACKED_BYTE_ARRAY, len, arr.ptr(), uint64_t(len) * sizeof(uint8_t))) {
+				break;
+			}
+			f->store_32(VARIANT_PACKED_BYTE_ARRAY);
 			f->store_32(len);
 			const uint8_t *r = arr.ptr();
 			f->store_buffer(r, len);
@@ -1658,9 +1810,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 
 		} break;
 		case Variant::PACKED_INT32_ARRAY: {
-			f->store_32(VARIANT_PACKED_INT32_ARRAY);
 			Vector<int32_t> arr = p_property;
 			int len = arr.size();
+			if (_write_aligned_array(f, r_aligned_arrays, VARIANT_PACKED_INT32_ARRAY, len, arr.ptr(), uint64_t(len) * sizeof(int32_t))) {
+				break;
+			}
+			f->store_32(VARIANT_PACKED_INT32_ARRAY);
 			f->store_32(len);
 			const int32_t *r = arr.ptr();
 			for (int i = 0; i < len; i++) {
@@ -1669,9 +1824,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 
 		} break;
 		case Variant::PACKED_INT64_ARRAY: {
-			f->store_32(VARIANT_PACKED_INT64_ARRAY);
 			Vector<int64_t> arr = p_property;
 			int len = arr.size();
+			if (_write_aligned_array(f, r_aligned_arrays, VARIANT_PACKED_INT64_ARRAY, len, arr.ptr(), uint64_t(len) * sizeof(int64_t))) {
+				break;
+			}
+			f->store_32(VARIANT_PACKED_INT64_ARRAY);
 			f->store_32(len);
 			const int64_t *r = arr.ptr();
 			for (int i = 0; i < len; i++) {
@@ -1680,9 +1838,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 
 		} break;
 		case Variant::PACKED_FLOAT32_ARRAY: {
-			f->store_32(VARIANT_PACKED_FLOAT32_ARRAY);
 			Vector<float> arr = p_property;
 			int len = arr.size();
+			if (_write_aligned_array(f, r_aligned_arrays, VARIANT_PACKED_FLOAT32_ARRAY, len, arr.ptr(), uint64_t(len) * sizeof(float))) {
+				break;
+			}
+			f->store_32(VARIANT_PACKED_FLOAT32_ARRAY);
 			f->store_32(len);
 			const float *r = arr.ptr();
 			for (int i = 0; i < len; i++) {
@@ -1691,9 +1852,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 
 		} break;
 		case Variant::PACKED_FLOAT64_ARRAY: {
-			f->store_32(VARIANT_PACKED_FLOAT64_ARRAY);
 			Vector<double> arr = p_property;
 			int len = arr.size();
+			if (_write_aligned_array(f, r_aligned_arrays, VARIANT_PACKED_FLOAT64_ARRAY, len, arr.ptr(), uint64_t(len) * sizeof(double))) {
+				break;
+			}
+			f->store_32(VARIANT_PACKED_FLOAT64_ARRAY);
 			f->store_32(len);
 			const double *r = arr.ptr();
 			for (int i = 0; i < len; i++) {
@@ -1713,9 +1877,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 
 		} break;
 		case Variant::PACKED_VECTOR3_ARRAY: {
-			f->store_32(VARIANT_PACKED_VECTOR3_ARRAY);
 			Vector<Vector3> arr = p_property;
 			int len = arr.size();
+			if (_write_aligned_array(f, r_aligned_arrays, VARIANT_PACKED_VECTOR3_ARRAY, len, arr.ptr(), uint64_t(len) * sizeof(Vector3))) {
+				break;
+			}
+			f->store_32(VARIANT_PACKED_VECTOR3_ARRAY);
 			f->store_32(len);
 			const Vector3 *r = arr.ptr();
 			for (int i = 0; i < len; i++) {
@@ -1726,9 +1893,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 
 		} break;
 		case Variant::PACKED_VECTOR2_ARRAY: {
-			f->store_32(VARIANT_PACKED_VECTOR2_ARRAY);
 			Vector<Vector2> arr = p_property;
 			int len = arr.size();
+			if (_write_aligned_array(f, r_aligned_arrays, VARIANT_PACKED_VECTOR2_ARRAY, len, arr.ptr(), uint64_t(len) * sizeof(Vector2))) {
+				break;
+			}
+			f->store_32(VARIANT_PACKED_VECTOR2_ARRAY);
 			f->store_32(len);
 			const Vector2 *r = arr.ptr();
 			for (int i = 0; i < len; i++) {
@@ -1738,9 +1908,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 
 		} break;
 		case Variant::PACKED_COLOR_ARRAY: {
-			f->store_32(VARIANT_PACKED_COLOR_ARRAY);
 			Vector<Color> arr = p_property;
 			int len = arr.size();
+			if (_write_aligned_array(f, r_aligned_arrays, VARIANT_PACKED_COLOR_ARRAY, len, arr.ptr(), uint64_t(len) * sizeof(Color))) {
+				break;
+			}
+			f->store_32(VARIANT_PACKED_COLOR_ARRAY);
 			f->store_32(len);
 			const Color *r = arr.ptr();
 			for (int i = 0; i < len; i++) {
@@ -1894,6 +2067,8 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 	bundle_resources = p_flags & ResourceSaver::FLAG_BUNDLE_RESOURCES;
 	big_endian = p_flags & ResourceSaver::FLAG_SAVE_BIG_ENDIAN;
 	takeover_paths = p_flags & ResourceSaver::FLAG_REPLACE_SUBRESOURCE_PATHS;
+	// Aligning only helps when the file can be memory mapped.
+	aligned_arrays = write_aligned_arrays && !big_endian && !(p_flags & ResourceSaver::FLAG_COMPRESS);
 
 	if (!p_path.begins_with("res://")) {
 		takeover_paths = false;
@@ -1920,7 +2095,9 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 	f->store_32(0); //64 bits file, false for now
 	f->store_32(VERSION_MAJOR);
 	f->store_32(VERSION_MINOR);
-	f->store_32(FORMAT_VERSION);
+	// Raised once an aligned array is stored.
+	uint64_t format_version_pos = f->get_position();
+	f->store_32(FORMAT_VERSION_NO_ALIGNED_ARRAYS);
 
 	if (f->get_error() != OK && f->get_error() != ERR_FILE_EOF) {
 		return ERR_CANT_CREATE;
@@ -2071,6 +2248,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 	}
 
 	Vector<uint64_t> ofs_table;
+	bool wrote_aligned_arrays = false;
 
 	//now actually save the resources
 	for (const ResourceData &rd : resources) {
@@ -2080,7 +2258,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 
 		for (const Property &p : rd.properties) {
 			f->store_32(p.name_idx);
-			write_variant(f, p.value, resource_map, external_resources, string_map, p.pi);
+			write_variant(f, p.value, resource_map, external_resources, string_map, p.pi, aligned_arrays ? &wrote_aligned_arrays : nullptr);
 		}
 	}
 
@@ -2089,6 +2267,11 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 		f->store_64(ofs_table[i]);
 	}
 
+	if (wrote_aligned_arrays) {
+		f->seek(format_version_pos);
+		f->store_32(FORMAT_VERSION);
+	}
+
 	f->seek_end();
 
 	f->store_buffer((const uint8_t *)"RSRC", 4); //magic at end
@@ -126,6 +126,7 @@ class ResourceFormatSaverBinaryInstance {
 	bool skip_editor;
 	bool big_endian;
 	bool takeover_paths;
+	bool aligned_arrays = false;
 	String magic;
 	HashSet<Ref<Resource>> resource_set;
 
@@ -154,11 +155,16 @@ class ResourceFormatSaverBinaryInstance {
 	};
 
 	static void _pad_buffer(Ref<FileAccess> f, int p_bytes);
+	static bool _write_aligned_array(Ref<FileAccess> f, bool *r_aligned_arrays, uint32_t p_type, uint32_t p_len, const void *p_data, uint64_t p_size);
 	void _find_resources(const Variant &p_variant, bool p_main = false);
 	static void save_unicode_string(Ref<FileAccess> f, const String &p_string, bool p_bit_on_len = false);
 	int get_string_index(const String &p_string);
 
 public:
+	// Store large packed arrays aligned when possible. Files with aligned arrays need
+	// format version 5 to be read.
+	bool write_aligned_arrays = true;
+
 	enum {
 		FORMAT_FLAG_NAMED_SCENE_IDS = 1,
 		FORMAT_FLAG_UIDS = 2,
@@ -168,7 +174,7 @@ public:
 		RESERVED_FIELDS = 11
 	};
 	Error save(const String &p_path, const Ref<Resource> &p_resource, uint32_t p_flags = 0);
-	static void write_variant(Ref<FileAccess> f, const Variant &p_property, HashMap<Ref<Resource>, int> &resource_map, HashMap<Ref<Resource>, int> &external_resources, HashMap<StringName, int> &string_map, const PropertyInfo &p_hint = PropertyInfo());
+	static void write_variant(Ref<FileAccess> f, const Variant &p_property, HashMap<Ref<Resource>, int> &resource_map, HashMap<Ref<Resource>, int> &external_resources, HashMap<StringName, int> &string_map, const PropertyInfo &p_hint = PropertyInfo(), bool *r_aligned_arrays = nullptr);
 };
 
 class ResourceFormatSaverBinary : public ResourceFormatSaver {
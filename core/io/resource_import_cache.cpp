@@ -0,0 +1,275 @@
+/*************************************************************************/
+/*  resource_import_cache.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "resource_import_cache.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/variant/variant_parser.h"
+#include "core/version.h"
+
+String ResourceImportCache::_get_entry_path(const String &p_key) const {
+	// Spread over subdirectories, as there can be many entries.
+	return directory.plus_file(p_key.substr(0, 2)).plus_file(p_key);
+}
+
+void ResourceImportCache::set_directory(const String &p_directory) {
+	directory = p_directory;
+}
+
+String ResourceImportCache::get_directory() const {
+	return directory;
+}
+
+PackedByteArray ResourceImportCache::load_entry(const String &p_key) const {
+	PackedByteArray data;
+	if (GDVIRTUAL_CALL(_load_entry, p_key, data)) {
+		return data;
+	}
+
+	if (directory.is_empty()) {
+		return data;
+	}
+
+	const String path = _get_entry_path(p_key);
+	if (FileAccess::exists(path)) {
+		data = FileAccess::get_file_as_array(path);
+	}
+	return data;
+}
+
+Error ResourceImportCache::store_entry(const String &p_key, const PackedByteArray &p_data) {
+	if (GDVIRTUAL_CALL(_store_entry, p_key, p_data)) {
+		return OK;
+	}
+
+	ERR_FAIL_COND_V_MSG(directory.is_empty(), ERR_UNCONFIGURED, "The import cache has no directory.");
+
+	const String path = _get_entry_path(p_key);
+	Ref<DirAccess> da = DirAccess::create_for_path(directory);
+	ERR_FAIL_COND_V(da.is_null(), ERR_CANT_CREATE);
+	Error err = da->make_dir_recursive(path.get_base_dir());
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot create import cache directory '" + path.get_base_dir() + "'.");
+
+	// Written aside first, so editors sharing the cache never read a partial entry.
+	const String temp_path = path + "." + itos(OS::get_singleton()->get_process_id()) + "." + itos(Thread::get_caller_id()) + ".tmp";
+	{
+		Ref<FileAccess> f = FileAccess::open(temp_path, FileAccess::WRITE, &err);
+		ERR_FAIL_COND_V_MSG(f.is_null(), err, "Cannot create import cache entry '" + temp_path + "'.");
+		f->store_buffer(p_data.ptr(), p_data.size());
+	}
+
+	err = da->rename(temp_path, path);
+	if (err != OK) {
+		// Another editor may have just stored the same entry.
+		da->remove(temp_path);
+	}
+	return err;
+}
+
+String ResourceImportCache::get_key(const String &p_source_file, const Ref<ResourceImporter> &p_importer, const HashMap<StringName, Variant> &p_options) {
+	ERR_FAIL_COND_V(p_importer.is_null(), String());
+
+	const String source_sha256 = FileAccess::get_sha256(p_source_file);
+	if (source_sha256.is_empty()) {
+		return String();
+	}
+
+	String key = "source=" + source_sha256 + "\n";
+	key += "importer=" + p_importer->get_importer_name() + "\n";
+	key += "format_version=" + itos(p_importer->get_format_version()) + "\n";
+	key += "settings=" + p_importer->get_import_settings_string() + "\n";
+	key += "engine=" + String(VERSION_FULL_BUILD) + "." + String(VERSION_HASH) + "\n";
+
+	List<ResourceImporter::ImportOption> options;
+	p_importer->get_import_options(p_source_file, &options);
+	for (const ResourceImporter::ImportOption &E : options) {
+		const Variant *option_value = p_options.getptr(E.option.name);
+		const Variant &value = option_value ? *option_value : E.default_value;
+
+		String value_string;
+		VariantWriter::write_to_string(value, value_string);
+		key += E.option.name + "=" + value_string + "\n";
+
+		// Other files the import reads, such as the normal map of a texture.
+		if (E.option.hint == PROPERTY_HINT_FILE && value.get_type() == Variant::STRING) {
+			const String path = value;
+			if (!path.is_empty() && FileAccess::exists(path)) {
+				key += E.option.name + ".sha256=" + FileAccess::get_sha256(path) + "\n";
+			}
+		}
+	}
+
+	return key.sha256_text();
+}
+
+Error ResourceImportCache::retrieve(const String &p_key, const String &p_base_path, List<String> *r_platform_variants, Variant *r_metadata) {
+	const PackedByteArray data = load_entry(p_key);
+	if (data.is_empty()) {
+		misses.increment();
+		return ERR_FILE_NOT_FOUND;
+	}
+
+	Variant entry_value;
+	Error err = decode_variant(entry_value, data.ptr(), data.size());
+	if (err != OK || entry_value.get_type() != Variant::DICTIONARY) {
+		misses.increment();
+		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, "Corrupt import cache entry '" + p_key + "'.");
+	}
+
+	const Dictionary entry = entry_value;
+	const Dictionary files = entry.get("files", Dictionary());
+	const Array suffixes = files.keys();
+	for (int i = 0; i < suffixes.size(); i++) {
+		const String suffix = suffixes[i];
+		const PackedByteArray contents = files[suffix];
+
+		const String path = p_base_path + suffix;
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE, &err);
+		if (f.is_null()) {
+			misses.increment();
+			ERR_FAIL_V_MSG(err, "Cannot write imported file '" + path + "' from the import cache.");
+		}
+		f->store_buffer(contents.ptr(), contents.size());
+	}
+
+	if (r_platform_variants) {
+		const PackedStringArray variants = entry.get("platform_variants", PackedStringArray());
+		for (int i = 0; i < variants.size(); i++) {
+			r_platform_variants->push_back(variants[i]);
+		}
+	}
+	if (r_metadata) {
+		*r_metadata = entry.get("metadata", Variant());
+	}
+
+	hits.increment();
+	return OK;
+}
+
+Error ResourceImportCache::store(const String &p_key, const String &p_base_path, const String &p_save_extension, const List<String> &p_platform_variants, const Variant &p_metadata) {
+	ERR_FAIL_COND_V(p_key.is_empty(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_save_extension.is_empty(), ERR_INVALID_PARAMETER);
+
+	// The same files EditorFileSystem lists as the destination of the import.
+	Vector<String> suffixes;
+	if (p_platform_variants.size()) {
+		for (const String &E : p_platform_variants) {
+			suffixes.push_back("." + E + "." + p_save_extension);
+		}
+	} else {
+		suffixes.push_back("." + p_save_extension);
+	}
+
+	Dictionary files;
+	for (int i = 0; i < suffixes.size(); i++) {
+		Error err;
+		const PackedByteArray contents = FileAccess::get_file_as_array(p_base_path + suffixes[i], &err);
+		ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot read imported file '" + p_base_path + suffixes[i] + "'.");
+		files[suffixes[i]] = contents;
+	}
+
+	PackedStringArray variants;
+	for (const String &E : p_platform_variants) {
+		variants.push_back(E);
+	}
+
+	Dictionary entry;
+	entry["files"] = files;
+	entry["platform_variants"] = variants;
+	entry["metadata"] = p_metadata;
+
+	int len = 0;
+	Error err = encode_variant(entry, nullptr, len);
+	ERR_FAIL_COND_V(err != OK, err);
+	PackedByteArray data;
+	data.resize(len);
+	encode_variant(entry, data.ptrw(), len);
+
+	return store_entry(p_key, data);
+}
+
+Error ResourceImportCache::import(Ref<ResourceImporter> p_importer, const String &p_source_file, const String &p_base_path, const HashMap<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files, Variant *r_metadata) {
+	ERR_FAIL_COND_V(p_importer.is_null(), ERR_INVALID_PARAMETER);
+
+	String key;
+	if (p_importer->can_cache_import() && !p_importer->get_save_extension().is_empty()) {
+		key = get_key(p_source_file, p_importer, p_options);
+	}
+	if (!key.is_empty() && retrieve(key, p_base_path, r_platform_variants, r_metadata) == OK) {
+		return OK;
+	}
+
+	List<String> gen_files;
+	Error err = p_importer->import(p_source_file, p_base_path, p_options, r_platform_variants, &gen_files, r_metadata);
+	if (r_gen_files) {
+		for (const String &E : gen_files) {
+			r_gen_files->push_back(E);
+		}
+	}
+	if (err == OK && !key.is_empty() && gen_files.is_empty()) {
+		List<String> platform_variants;
+		if (r_platform_variants) {
+			platform_variants = *r_platform_variants;
+		}
+		store(key, p_base_path, p_importer->get_save_extension(), platform_variants, r_metadata ? *r_metadata : Variant());
+	}
+	return err;
+}
+
+uint32_t ResourceImportCache::get_hits() const {
+	return hits.get();
+}
+
+uint32_t ResourceImportCache::get_misses() const {
+	return misses.get();
+}
+
+void ResourceImportCache::reset_stats() {
+	hits.set(0);
+	misses.set(0);
+}
+
+void ResourceImportCache::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_directory", "directory"), &ResourceImportCache::set_directory);
+	ClassDB::bind_method(D_METHOD("get_directory"), &ResourceImportCache::get_directory);
+
+	ClassDB::bind_method(D_METHOD("get_hits"), &ResourceImportCache::get_hits);
+	ClassDB::bind_method(D_METHOD("get_misses"), &ResourceImportCache::get_misses);
+	ClassDB::bind_method(D_METHOD("reset_stats"), &ResourceImportCache::reset_stats);
+
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "directory", PROPERTY_HINT_GLOBAL_DIR), "set_directory", "get_directory");
+
+	GDVIRTUAL_BIND(_load_entry, "key");
+	GDVIRTUAL_BIND(_store_entry, "key", "data");
+}
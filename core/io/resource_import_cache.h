@@ -0,0 +1,93 @@
+/*************************************************************************/
+/*  resource_import_cache.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RESOURCE_IMPORT_CACHE_H
+#define RESOURCE_IMPORT_CACHE_H
+
+#include "core/io/resource_importer.h"
+#include "core/object/gdvirtual.gen.inc"
+#include "core/object/script_language.h"
+#include "core/templates/safe_refcount.h"
+
+// Keeps the files importers produce, keyed by everything the result depends
+// on (see get_key()), so importing the same source with the same options again
+// restores them instead. Keys don't depend on where the source file is, so a
+// cache can be shared by several projects, or machines.
+//
+// Entries are files in a directory by default. Other backends can implement
+// _load_entry() and _store_entry(), which may be called from several import
+// threads at once.
+class ResourceImportCache : public RefCounted {
+	GDCLASS(ResourceImportCache, RefCounted);
+
+	String directory;
+
+	SafeNumeric<uint32_t> hits;
+	SafeNumeric<uint32_t> misses;
+
+	String _get_entry_path(const String &p_key) const;
+
+protected:
+	static void _bind_methods();
+
+	GDVIRTUAL1RC(PackedByteArray, _load_entry, String)
+	GDVIRTUAL2(_store_entry, String, PackedByteArray)
+
+public:
+	void set_directory(const String &p_directory);
+	String get_directory() const;
+
+	// Empty if there is no entry for the key.
+	PackedByteArray load_entry(const String &p_key) const;
+	Error store_entry(const String &p_key, const PackedByteArray &p_data);
+
+	// Hash of the contents of the source file (and of other files the options
+	// point to), the importer and its version, its options and the engine
+	// version. Empty if the source file can't be read.
+	static String get_key(const String &p_source_file, const Ref<ResourceImporter> &p_importer, const HashMap<StringName, Variant> &p_options);
+
+	// Writes the files stored for the key next to p_base_path, as
+	// ResourceImporter::import() would have, and returns what it returned.
+	Error retrieve(const String &p_key, const String &p_base_path, List<String> *r_platform_variants, Variant *r_metadata);
+	// Stores the files ResourceImporter::import() wrote next to p_base_path.
+	Error store(const String &p_key, const String &p_base_path, const String &p_save_extension, const List<String> &p_platform_variants, const Variant &p_metadata);
+
+	// Same as p_importer->import(), but retrieves the result from the cache when
+	// possible, and stores it otherwise. Importers that don't opt in with
+	// ResourceImporter::can_cache_import(), or that generate other files, are
+	// only run.
+	Error import(Ref<ResourceImporter> p_importer, const String &p_source_file, const String &p_base_path, const HashMap<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files, Variant *r_metadata);
+
+	uint32_t get_hits() const;
+	uint32_t get_misses() const;
+	void reset_stats();
+};
+
+#endif // RESOURCE_IMPORT_CACHE_H
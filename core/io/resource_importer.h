@@ -139,6 +139,10 @@ public:
 
 	virtual Error import(const String &p_source_file, const String &p_save_path, const HashMap<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = nullptr, Variant *r_metadata = nullptr) = 0;
 	virtual bool can_import_threaded() const { return true; }
+	// Whether the result only depends on the source file, the options and the
+	// import settings string, and is only written to the destination files, so
+	// it can be kept in a ResourceImportCache.
+	virtual bool can_cache_import() const { return false; }
 	virtual void import_threaded_begin() {}
 	virtual void import_threaded_end() {}
 
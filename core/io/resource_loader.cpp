@@ -32,7 +32,9 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/file_access.h"
+#include "core/io/file_access_async.h"
 #include "core/io/resource_importer.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "core/string/translation.h"
@@ -187,6 +189,8 @@ void ResourceFormatLoader::_bind_methods() {
 
 Ref<Resource> ResourceLoader::_load(const String &p_path, const String &p_original_path, const String &p_type_hint, ResourceFormatLoader::CacheMode p_cache_mode, Error *r_error, bool p_use_sub_threads, float *r_progress) {
 	bool found = false;
+	const bool profile_load = profiling.is_set();
+	const uint64_t profile_start = profile_load ? OS::get_singleton()->get_ticks_usec() : 0;
 
 	// Try all loaders and pick the first match for the type hint
 	for (int i = 0; i < loader_count; i++) {
@@ -199,6 +203,16 @@ Ref<Resource> ResourceLoader::_load(const String &p_path, const String &p_origin
 			continue;
 		}
 
+		if (profile_load) {
+			LoadProfileEntry entry;
+			entry.path = !p_original_path.is_empty() ? p_original_path : p_path;
+			entry.thread_id = Thread::get_caller_id();
+			entry.start_usec = profile_start;
+			entry.usec = OS::get_singleton()->get_ticks_usec() - profile_start;
+			MutexLock lock(profile_mutex);
+			profile.push_back(entry);
+		}
+
 		return res;
 	}
 
@@ -221,6 +235,12 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 		//this is an actual thread, so wait for Ok from semaphore
 		thread_load_semaphore->wait(); //wait until its ok to start loading
 	}
+
+	HashMap<String, DependencyGraphNode> dependency_graph;
+	if (load_task.use_sub_threads) {
+		_load_dependency_graph(load_task.local_path, dependency_graph);
+	}
+
 	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, load_task.cache_mode, &load_task.error, load_task.use_sub_threads, &load_task.progress);
 
 	load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
@@ -284,6 +304,86 @@ static String _validate_local_path(const String &p_path) {
 		return ProjectSettings::get_singleton()->localize_path(p_path);
 	}
 }
+
+void ResourceLoader::_prefetch_dependency_graph_node(DependencyGraphNode *p_node) {
+	FileAccessAsync *file_access_async = FileAccessAsync::get_singleton();
+	if (!file_access_async) {
+		return;
+	}
+
+	// The file the loader will read, the imported one if any.
+	String path = _path_remap(p_node->local_path);
+	if (ResourceFormatImporter::get_singleton()) {
+		const String imported_path = ResourceFormatImporter::get_singleton()->get_internal_resource_path(path);
+		if (!imported_path.is_empty()) {
+			path = imported_path;
+		}
+	}
+
+	// Not available when it would take threads from loading the graph.
+	p_node->prefetch_id = file_access_async->prefetch(path, 0, DEPENDENCY_PREFETCH_MAX);
+}
+
+void ResourceLoader::_load_dependency_graph_node(void *p_userdata) {
+	DependencyGraphNode *node = (DependencyGraphNode *)p_userdata;
+	if (node->prefetch_id != FileAccessAsync::INVALID_READ_ID) {
+		FileAccessAsync::get_singleton()->wait(node->prefetch_id);
+		node->prefetch_id = FileAccessAsync::INVALID_READ_ID;
+	}
+	node->resource = load(node->local_path, node->type_hint);
+}
+
+void ResourceLoader::_add_dependency_graph_nodes(const String &p_local_path, HashMap<String, DependencyGraphNode> &r_graph, Vector<int64_t> &r_tasks) {
+	List<String> dependencies;
+	get_dependencies(p_local_path, &dependencies, true);
+
+	for (const String &E : dependencies) {
+		const String local_path = _validate_local_path(E.get_slice("::", 0));
+		if (local_path.is_empty() || ResourceCache::has(local_path)) {
+			continue;
+		}
+
+		DependencyGraphNode *node = r_graph.getptr(local_path);
+		if (node) {
+			// Nodes without a task yet are still being visited, so this is a cycle.
+			// The loader will deal with it, as it would without the graph.
+			if (node->task_id >= 0) {
+				r_tasks.push_back(node->task_id);
+			}
+			continue;
+		}
+
+		node = &r_graph.insert(local_path, DependencyGraphNode())->value;
+		node->local_path = local_path;
+		node->type_hint = E.get_slice_count("::") > 1 ? E.get_slice("::", 1) : String();
+		_prefetch_dependency_graph_node(node);
+
+		Vector<int64_t> node_dependencies;
+		_add_dependency_graph_nodes(local_path, r_graph, node_dependencies);
+		node->task_id = WorkerThreadPool::get_singleton()->add_native_task(&ResourceLoader::_load_dependency_graph_node, node, WorkerThreadPool::PRIORITY_NORMAL, "Load " + local_path, node_dependencies);
+		r_tasks.push_back(node->task_id);
+	}
+}
+
+void ResourceLoader::_load_dependency_graph(const String &p_local_path, HashMap<String, DependencyGraphNode> &r_graph) {
+	if (!WorkerThreadPool::get_singleton()) {
+		return;
+	}
+
+	// The resource itself is never loaded from the graph, a dependency cycle
+	// leading back to it would wait for it to finish loading.
+	r_graph.insert(p_local_path, DependencyGraphNode());
+
+	Vector<int64_t> tasks;
+	_add_dependency_graph_nodes(p_local_path, r_graph, tasks);
+
+	for (const KeyValue<String, DependencyGraphNode> &E : r_graph) {
+		if (E.value.task_id >= 0) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(E.value.task_id);
+		}
+	}
+}
+
 Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource) {
 	String local_path = _validate_local_path(p_path);
 
@@ -377,6 +477,24 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 	return OK;
 }
 
+void ResourceLoader::set_profiling(bool p_enabled) {
+	if (p_enabled) {
+		profiling.set();
+	} else {
+		profiling.clear();
+	}
+}
+
+Vector<ResourceLoader::LoadProfileEntry> ResourceLoader::get_profile() {
+	MutexLock lock(profile_mutex);
+	return profile;
+}
+
+void ResourceLoader::clear_profile() {
+	MutexLock lock(profile_mutex);
+	profile.clear();
+}
+
 float ResourceLoader::_dependency_get_progress(const String &p_path) {
 	if (thread_load_tasks.has(p_path)) {
 		ThreadLoadTask &load_task = thread_load_tasks[p_path];
@@ -1030,6 +1148,10 @@ int ResourceLoader::thread_waiting_count = 0;
 int ResourceLoader::thread_suspended_count = 0;
 int ResourceLoader::thread_load_max = 0;
 
+SafeFlag ResourceLoader::profiling;
+Mutex ResourceLoader::profile_mutex;
+Vector<ResourceLoader::LoadProfileEntry> ResourceLoader::profile;
+
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
 HashMap<String, String> ResourceLoader::path_remaps;
@@ -100,6 +100,13 @@ public:
 		THREAD_LOAD_LOADED
 	};
 
+	struct LoadProfileEntry {
+		String path;
+		Thread::ID thread_id = 0;
+		uint64_t start_usec = 0;
+		uint64_t usec = 0;
+	};
+
 private:
 	static Ref<ResourceFormatLoader> loader[MAX_LOADERS];
 	static int loader_count;
@@ -159,11 +166,45 @@ private:
 
 	static float _dependency_get_progress(const String &p_path);
 
+	// Resources loaded with sub-threads read their whole dependency graph first,
+	// then load it on the WorkerThreadPool, dependencies before the resources
+	// using them, so independent resources are loaded in parallel. The graph
+	// keeps the loaded dependencies referenced (and so cached) until the
+	// resource using them is loaded.
+	//
+	// When FileAccessAsync can prefetch without threads, the OS is asked to read
+	// the files of the graph ahead while it's built, so they're cached by the
+	// time they're loaded.
+	struct DependencyGraphNode {
+		String local_path;
+		String type_hint;
+		int64_t task_id = -1;
+		Ref<Resource> resource;
+		int64_t prefetch_id = -1;
+	};
+
+	static constexpr uint64_t DEPENDENCY_PREFETCH_MAX = 4 * 1024 * 1024; // Read ahead per file.
+
+	static void _prefetch_dependency_graph_node(DependencyGraphNode *p_node);
+	static void _load_dependency_graph_node(void *p_userdata);
+	static void _add_dependency_graph_nodes(const String &p_local_path, HashMap<String, DependencyGraphNode> &r_graph, Vector<int64_t> &r_tasks);
+	static void _load_dependency_graph(const String &p_local_path, HashMap<String, DependencyGraphNode> &r_graph);
+
+	static SafeFlag profiling;
+	static Mutex profile_mutex;
+	static Vector<LoadProfileEntry> profile;
+
 public:
 	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, const String &p_source_resource = String());
 	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = nullptr);
 	static Ref<Resource> load_threaded_get(const String &p_path, Error *r_error = nullptr);
 
+	// When profiling, every resource loaded records when and how long it took.
+	static void set_profiling(bool p_enabled);
+	static bool is_profiling() { return profiling.is_set(); }
+	static Vector<LoadProfileEntry> get_profile();
+	static void clear_profile();
+
 	static Ref<Resource> load(const String &p_path, const String &p_type_hint = "", ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, Error *r_error = nullptr);
 	static bool exists(const String &p_path, const String &p_type_hint = "");
 
@@ -0,0 +1,730 @@
+/*************************************************************************/
+/*  variant_schema.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "variant_schema.h"
+
+#include "core/io/marshalls.h"
+#include "core/object/class_db.h"
+
+static void _encode_varuint(uint64_t p_value, uint8_t *&r_buf, int &r_len) {
+	do {
+		uint8_t byte = p_value & 0x7f;
+		p_value >>= 7;
+		if (p_value) {
+			byte |= 0x80;
+		}
+		if (r_buf) {
+			*(r_buf++) = byte;
+		}
+		r_len++;
+	} while (p_value);
+}
+
+static Error _decode_varuint(const uint8_t *&r_buf, int &r_len, uint64_t &r_value) {
+	r_value = 0;
+	for (int shift = 0;; shift += 7) {
+		ERR_FAIL_COND_V(r_len < 1 || shift > 63, ERR_INVALID_DATA);
+		const uint8_t byte = *(r_buf++);
+		r_len--;
+		r_value |= uint64_t(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return OK;
+		}
+	}
+}
+
+static void _encode_string(const String &p_string, uint8_t *&r_buf, int &r_len) {
+	const CharString utf8 = p_string.utf8();
+	_encode_varuint(utf8.length(), r_buf, r_len);
+	if (r_buf) {
+		memcpy(r_buf, utf8.get_data(), utf8.length());
+		r_buf += utf8.length();
+	}
+	r_len += utf8.length();
+}
+
+static Error _decode_string(const uint8_t *&r_buf, int &r_len, String &r_string) {
+	uint64_t length = 0;
+	Error err = _decode_varuint(r_buf, r_len, length);
+	ERR_FAIL_COND_V(err != OK, err);
+	ERR_FAIL_COND_V(length > (uint64_t)r_len, ERR_INVALID_DATA);
+	r_string = String();
+	ERR_FAIL_COND_V(r_string.parse_utf8((const char *)r_buf, length) != OK, ERR_INVALID_DATA);
+	r_buf += length;
+	r_len -= length;
+	return OK;
+}
+
+static _FORCE_INLINE_ unsigned int _encode_component(float p_value, uint8_t *p_buf) {
+	return encode_float(p_value, p_buf);
+}
+
+static _FORCE_INLINE_ unsigned int _encode_component(double p_value, uint8_t *p_buf) {
+	return encode_double(p_value, p_buf);
+}
+
+static _FORCE_INLINE_ unsigned int _encode_component(int32_t p_value, uint8_t *p_buf) {
+	return encode_uint32(p_value, p_buf);
+}
+
+static _FORCE_INLINE_ unsigned int _encode_component(int64_t p_value, uint8_t *p_buf) {
+	return encode_uint64(p_value, p_buf);
+}
+
+static _FORCE_INLINE_ void _decode_component(const uint8_t *p_buf, float &r_value) {
+	r_value = decode_float(p_buf);
+}
+
+static _FORCE_INLINE_ void _decode_component(const uint8_t *p_buf, double &r_value) {
+	r_value = decode_double(p_buf);
+}
+
+static _FORCE_INLINE_ void _decode_component(const uint8_t *p_buf, int32_t &r_value) {
+	r_value = decode_uint32(p_buf);
+}
+
+static _FORCE_INLINE_ void _decode_component(const uint8_t *p_buf, int64_t &r_value) {
+	r_value = decode_uint64(p_buf);
+}
+
+// Math types are encoded as their components (C), all of the same type.
+template <class T, class C>
+static void _encode_components(const T *p_values, int p_count, uint8_t *&r_buf, int &r_len) {
+	static_assert(sizeof(T) % sizeof(C) == 0);
+	const int count = p_count * (sizeof(T) / sizeof(C));
+	if (r_buf) {
+		const C *components = reinterpret_cast<const C *>(p_values);
+		for (int i = 0; i < count; i++) {
+			r_buf += _encode_component(components[i], r_buf);
+		}
+	}
+	r_len += count * sizeof(C);
+}
+
+// Components can be stored (S) with a different width than they have (C), for
+// real_t encoded by a build with the other precision.
+template <class T, class C, class S = C>
+static Error _decode_components(const uint8_t *&r_buf, int &r_len, T *r_values, int p_count) {
+	const int count = p_count * (sizeof(T) / sizeof(C));
+	ERR_FAIL_COND_V(count * (int64_t)sizeof(S) > r_len, ERR_INVALID_DATA);
+	C *components = reinterpret_cast<C *>(r_values);
+	for (int i = 0; i < count; i++) {
+		S component;
+		_decode_component(r_buf, component);
+		components[i] = component;
+		r_buf += sizeof(S);
+	}
+	r_len -= count * sizeof(S);
+	return OK;
+}
+
+template <class T, class C>
+static void _encode_value(const Variant &p_value, uint8_t *&r_buf, int &r_len) {
+	const T value = p_value;
+	_encode_components<T, C>(&value, 1, r_buf, r_len);
+}
+
+template <class T, class C, class S = C>
+static Error _decode_value(const uint8_t *&r_buf, int &r_len, Variant &r_value) {
+	T value;
+	Error err = _decode_components<T, C, S>(r_buf, r_len, &value, 1);
+	ERR_FAIL_COND_V(err != OK, err);
+	r_value = value;
+	return OK;
+}
+
+template <class T, class C>
+static void _encode_packed(const Variant &p_value, uint8_t *&r_buf, int &r_len) {
+	const Vector<T> array = p_value;
+	_encode_varuint(array.size(), r_buf, r_len);
+	_encode_components<T, C>(array.ptr(), array.size(), r_buf, r_len);
+}
+
+template <class T, class C, class S = C>
+static Error _decode_packed(const uint8_t *&r_buf, int &r_len, Variant &r_value) {
+	uint64_t size = 0;
+	Error err = _decode_varuint(r_buf, r_len, size);
+	ERR_FAIL_COND_V(err != OK, err);
+	ERR_FAIL_COND_V(size > (uint64_t)r_len / (sizeof(T) / sizeof(C) * sizeof(S)), ERR_INVALID_DATA);
+	Vector<T> array;
+	array.resize(size);
+	err = _decode_components<T, C, S>(r_buf, r_len, array.ptrw(), size);
+	ERR_FAIL_COND_V(err != OK, err);
+	r_value = array;
+	return OK;
+}
+
+// Types made of real_t, stored as floats or doubles depending on the build
+// that encoded them.
+template <class T>
+static Error _decode_real_value(const uint8_t *&r_buf, int &r_len, Variant &r_value, bool p_reals_64) {
+	if (p_reals_64) {
+		return _decode_value<T, real_t, double>(r_buf, r_len, r_value);
+	}
+	return _decode_value<T, real_t, float>(r_buf, r_len, r_value);
+}
+
+template <class T>
+static Error _decode_real_packed(const uint8_t *&r_buf, int &r_len, Variant &r_value, bool p_reals_64) {
+	if (p_reals_64) {
+		return _decode_packed<T, real_t, double>(r_buf, r_len, r_value);
+	}
+	return _decode_packed<T, real_t, float>(r_buf, r_len, r_value);
+}
+
+Error VariantSchema::_encode_field(const Field &p_field, const Variant &p_value, uint8_t *&r_buf, int &r_len, uint8_t *p_bits, int p_depth) const {
+	if (p_field.type != Variant::NIL && p_value.get_type() != p_field.type) {
+		ERR_FAIL_COND_V_MSG(!Variant::can_convert_strict(p_value.get_type(), p_field.type), ERR_INVALID_DATA,
+				vformat("Field '%s' should be %s, not %s.", p_field.name, Variant::get_type_name(p_field.type), Variant::get_type_name(p_value.get_type())));
+		Variant converted;
+		Callable::CallError ce;
+		const Variant *args[1] = { &p_value };
+		Variant::construct(p_field.type, converted, args, 1, ce);
+		ERR_FAIL_COND_V(ce.error != Callable::CallError::CALL_OK, ERR_INVALID_DATA);
+		return _encode_field(p_field, converted, r_buf, r_len, p_bits, p_depth);
+	}
+
+	switch (p_field.type) {
+		case Variant::BOOL: {
+			if (p_bits && p_value.operator bool()) {
+				p_bits[p_field.bit / 8] |= 1 << (p_field.bit % 8);
+			}
+		} break;
+		case Variant::INT: {
+			// Zigzag, so small negative numbers are small too.
+			const int64_t value = p_value;
+			_encode_varuint((uint64_t(value) << 1) ^ uint64_t(value >> 63), r_buf, r_len);
+		} break;
+		case Variant::FLOAT: {
+			_encode_value<double, double>(p_value, r_buf, r_len);
+		} break;
+		case Variant::STRING:
+		case Variant::STRING_NAME:
+		case Variant::NODE_PATH: {
+			_encode_string(p_value, r_buf, r_len);
+		} break;
+		case Variant::VECTOR2: {
+			_encode_value<Vector2, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::VECTOR2I: {
+			_encode_value<Vector2i, int32_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::RECT2: {
+			_encode_value<Rect2, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::RECT2I: {
+			_encode_value<Rect2i, int32_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::VECTOR3: {
+			_encode_value<Vector3, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::VECTOR3I: {
+			_encode_value<Vector3i, int32_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::TRANSFORM2D: {
+			_encode_value<Transform2D, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::PLANE: {
+			_encode_value<Plane, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::QUATERNION: {
+			_encode_value<Quaternion, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::AABB: {
+			_encode_value<::AABB, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::BASIS: {
+			_encode_value<Basis, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::TRANSFORM3D: {
+			_encode_value<Transform3D, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::COLOR: {
+			_encode_value<Color, float>(p_value, r_buf, r_len);
+		} break;
+		case Variant::PACKED_BYTE_ARRAY: {
+			const PackedByteArray array = p_value;
+			_encode_varuint(array.size(), r_buf, r_len);
+			if (r_buf) {
+				memcpy(r_buf, array.ptr(), array.size());
+				r_buf += array.size();
+			}
+			r_len += array.size();
+		} break;
+		case Variant::PACKED_INT32_ARRAY: {
+			_encode_packed<int32_t, int32_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::PACKED_INT64_ARRAY: {
+			_encode_packed<int64_t, int64_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::PACKED_FLOAT32_ARRAY: {
+			_encode_packed<float, float>(p_value, r_buf, r_len);
+		} break;
+		case Variant::PACKED_FLOAT64_ARRAY: {
+			_encode_packed<double, double>(p_value, r_buf, r_len);
+		} break;
+		case Variant::PACKED_VECTOR2_ARRAY: {
+			_encode_packed<Vector2, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::PACKED_VECTOR3_ARRAY: {
+			_encode_packed<Vector3, real_t>(p_value, r_buf, r_len);
+		} break;
+		case Variant::PACKED_COLOR_ARRAY: {
+			_encode_packed<Color, float>(p_value, r_buf, r_len);
+		} break;
+		case Variant::PACKED_STRING_ARRAY: {
+			const PackedStringArray array = p_value;
+			_encode_varuint(array.size(), r_buf, r_len);
+			for (const String &E : array) {
+				_encode_string(E, r_buf, r_len);
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			if (p_field.schema.is_valid()) {
+				return p_field.schema->_encode(p_value, r_buf, r_len, p_depth + 1);
+			}
+			[[fallthrough]];
+		}
+		case Variant::ARRAY: {
+			if (p_field.type == Variant::ARRAY && p_field.schema.is_valid()) {
+				const Array array = p_value;
+				_encode_varuint(array.size(), r_buf, r_len);
+				for (int i = 0; i < array.size(); i++) {
+					Error err = p_field.schema->_encode(array[i], r_buf, r_len, p_depth + 1);
+					ERR_FAIL_COND_V(err != OK, err);
+				}
+				break;
+			}
+			[[fallthrough]];
+		}
+		default: {
+			// Anything else is encoded as usual, with its type.
+			int len = 0;
+			Error err = encode_variant(p_value, r_buf, len, false, p_depth + 1);
+			ERR_FAIL_COND_V(err != OK, err);
+			if (r_buf) {
+				r_buf += len;
+			}
+			r_len += len;
+		} break;
+	}
+	return OK;
+}
+
+Error VariantSchema::_decode_field(const Field &p_field, const uint8_t *&r_buf, int &r_len, const uint8_t *p_bits, bool p_reals_64, Variant &r_value, int p_depth) const {
+	switch (p_field.type) {
+		case Variant::BOOL: {
+			r_value = bool(p_bits[p_field.bit / 8] & (1 << (p_field.bit % 8)));
+		} break;
+		case Variant::INT: {
+			uint64_t value = 0;
+			Error err = _decode_varuint(r_buf, r_len, value);
+			ERR_FAIL_COND_V(err != OK, err);
+			r_value = int64_t(value >> 1) ^ -int64_t(value & 1);
+		} break;
+		case Variant::FLOAT: {
+			return _decode_value<double, double>(r_buf, r_len, r_value);
+		}
+		case Variant::STRING:
+		case Variant::STRING_NAME:
+		case Variant::NODE_PATH: {
+			String string;
+			Error err = _decode_string(r_buf, r_len, string);
+			ERR_FAIL_COND_V(err != OK, err);
+			if (p_field.type == Variant::STRING_NAME) {
+				r_value = StringName(string);
+			} else if (p_field.type == Variant::NODE_PATH) {
+				r_value = NodePath(string);
+			} else {
+				r_value = string;
+			}
+		} break;
+		case Variant::VECTOR2: {
+			return _decode_real_value<Vector2>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::VECTOR2I: {
+			return _decode_value<Vector2i, int32_t>(r_buf, r_len, r_value);
+		}
+		case Variant::RECT2: {
+			return _decode_real_value<Rect2>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::RECT2I: {
+			return _decode_value<Rect2i, int32_t>(r_buf, r_len, r_value);
+		}
+		case Variant::VECTOR3: {
+			return _decode_real_value<Vector3>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::VECTOR3I: {
+			return _decode_value<Vector3i, int32_t>(r_buf, r_len, r_value);
+		}
+		case Variant::TRANSFORM2D: {
+			return _decode_real_value<Transform2D>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::PLANE: {
+			return _decode_real_value<Plane>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::QUATERNION: {
+			return _decode_real_value<Quaternion>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::AABB: {
+			return _decode_real_value<::AABB>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::BASIS: {
+			return _decode_real_value<Basis>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::TRANSFORM3D: {
+			return _decode_real_value<Transform3D>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::COLOR: {
+			return _decode_value<Color, float>(r_buf, r_len, r_value);
+		}
+		case Variant::PACKED_BYTE_ARRAY: {
+			uint64_t size = 0;
+			Error err = _decode_varuint(r_buf, r_len, size);
+			ERR_FAIL_COND_V(err != OK, err);
+			ERR_FAIL_COND_V(size > (uint64_t)r_len, ERR_INVALID_DATA);
+			PackedByteArray array;
+			array.resize(size);
+			memcpy(array.ptrw(), r_buf, size);
+			r_buf += size;
+			r_len -= size;
+			r_value = array;
+		} break;
+		case Variant::PACKED_INT32_ARRAY: {
+			return _decode_packed<int32_t, int32_t>(r_buf, r_len, r_value);
+		}
+		case Variant::PACKED_INT64_ARRAY: {
+			return _decode_packed<int64_t, int64_t>(r_buf, r_len, r_value);
+		}
+		case Variant::PACKED_FLOAT32_ARRAY: {
+			return _decode_packed<float, float>(r_buf, r_len, r_value);
+		}
+		case Variant::PACKED_FLOAT64_ARRAY: {
+			return _decode_packed<double, double>(r_buf, r_len, r_value);
+		}
+		case Variant::PACKED_VECTOR2_ARRAY: {
+			return _decode_real_packed<Vector2>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::PACKED_VECTOR3_ARRAY: {
+			return _decode_real_packed<Vector3>(r_buf, r_len, r_value, p_reals_64);
+		}
+		case Variant::PACKED_COLOR_ARRAY: {
+			return _decode_packed<Color, float>(r_buf, r_len, r_value);
+		}
+		case Variant::PACKED_STRING_ARRAY: {
+			uint64_t size = 0;
+			Error err = _decode_varuint(r_buf, r_len, size);
+			ERR_FAIL_COND_V(err != OK, err);
+			// Each string takes at least a byte.
+			ERR_FAIL_COND_V(size > (uint64_t)r_len, ERR_INVALID_DATA);
+			PackedStringArray array;
+			array.resize(size);
+			String *w = array.ptrw();
+			for (uint64_t i = 0; i < size; i++) {
+				err = _decode_string(r_buf, r_len, w[i]);
+				ERR_FAIL_COND_V(err != OK, err);
+			}
+			r_value = array;
+		} break;
+		case Variant::DICTIONARY: {
+			if (p_field.schema.is_valid()) {
+				Dictionary dictionary;
+				Error err = p_field.schema->_decode(r_buf, r_len, p_reals_64, &dictionary, nullptr, p_depth + 1);
+				ERR_FAIL_COND_V(err != OK, err);
+				r_value = dictionary;
+				break;
+			}
+			[[fallthrough]];
+		}
+		case Variant::ARRAY: {
+			if (p_field.type == Variant::ARRAY && p_field.schema.is_valid()) {
+				uint64_t size = 0;
+				Error err = _decode_varuint(r_buf, r_len, size);
+				ERR_FAIL_COND_V(err != OK, err);
+				ERR_FAIL_COND_V(size > (uint64_t)r_len, ERR_INVALID_DATA);
+				Array array;
+				array.resize(size);
+				for (uint64_t i = 0; i < size; i++) {
+					Dictionary dictionary;
+					err = p_field.schema->_decode(r_buf, r_len, p_reals_64, &dictionary, nullptr, p_depth + 1);
+					ERR_FAIL_COND_V(err != OK, err);
+					array[i] = dictionary;
+				}
+				r_value = array;
+				break;
+			}
+			[[fallthrough]];
+		}
+		default: {
+			int len = 0;
+			Error err = decode_variant(r_value, r_buf, r_len, &len, false, p_depth + 1);
+			ERR_FAIL_COND_V(err != OK, err);
+			r_buf += len;
+			r_len -= len;
+		} break;
+	}
+	return OK;
+}
+
+Error VariantSchema::_encode(const Variant &p_value, uint8_t *&r_buf, int &r_len, int p_depth) const {
+	ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, ERR_OUT_OF_MEMORY, "Potential infinite recursion detected. Bailing.");
+
+	Dictionary dictionary;
+	Object *object = nullptr;
+	if (p_value.get_type() == Variant::DICTIONARY) {
+		dictionary = p_value;
+	} else if (p_value.get_type() == Variant::OBJECT) {
+		object = p_value.get_validated_object();
+		ERR_FAIL_NULL_V(object, ERR_INVALID_PARAMETER);
+	} else {
+		ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Only dictionaries and objects can be encoded with a schema.");
+	}
+
+	// Booleans come first, as bits.
+	uint8_t *bits = r_buf;
+	const int bits_size = (bool_count + 7) / 8;
+	if (r_buf) {
+		memset(bits, 0, bits_size);
+		r_buf += bits_size;
+	}
+	r_len += bits_size;
+
+	for (uint32_t i = 0; i < fields.size(); i++) {
+		const Field &field = fields[i];
+		Variant value;
+		if (object) {
+			bool valid = false;
+			value = object->get(field.name, &valid);
+			ERR_FAIL_COND_V_MSG(!valid, ERR_INVALID_DATA, vformat("Missing field '%s'.", field.name));
+		} else {
+			const Variant *ptr = dictionary.getptr(field.key);
+			ERR_FAIL_COND_V_MSG(!ptr, ERR_INVALID_DATA, vformat("Missing field '%s'.", field.name));
+			value = *ptr;
+		}
+		Error err = _encode_field(field, value, r_buf, r_len, bits, p_depth);
+		ERR_FAIL_COND_V(err != OK, err);
+	}
+	return OK;
+}
+
+Error VariantSchema::_decode(const uint8_t *&r_buf, int &r_len, bool p_reals_64, Dictionary *r_dictionary, Object *r_object, int p_depth) const {
+	ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, ERR_OUT_OF_MEMORY, "Variant is too deep. Bailing.");
+
+	const uint8_t *bits = r_buf;
+	const int bits_size = (bool_count + 7) / 8;
+	ERR_FAIL_COND_V(bits_size > r_len, ERR_INVALID_DATA);
+	r_buf += bits_size;
+	r_len -= bits_size;
+
+	for (uint32_t i = 0; i < fields.size(); i++) {
+		const Field &field = fields[i];
+		Variant value;
+		Error err = _decode_field(field, r_buf, r_len, bits, p_reals_64, value, p_depth);
+		ERR_FAIL_COND_V(err != OK, err);
+		if (r_object) {
+			r_object->set(field.name, value);
+		} else {
+			(*r_dictionary)[field.key] = value;
+		}
+	}
+	return OK;
+}
+
+Error VariantSchema::encode(const Variant &p_value, uint8_t *r_buffer, int &r_len) const {
+	uint8_t *buf = r_buffer;
+	// Math types are encoded with the precision of this build, flagged so
+	// builds with the other precision can decode them too.
+	uint8_t flags = 0;
+#ifdef REAL_T_IS_DOUBLE
+	flags |= ENCODE_FLAG_REAL_64;
+#endif
+	if (buf) {
+		*(buf++) = flags;
+	}
+	r_len = 1;
+	return _encode(p_value, buf, r_len, 0);
+}
+
+Error VariantSchema::_decode_flags(const uint8_t *&r_buf, int &r_len, bool &r_reals_64) {
+	ERR_FAIL_COND_V(r_len < 1, ERR_INVALID_DATA);
+	const uint8_t flags = *(r_buf++);
+	r_len--;
+	ERR_FAIL_COND_V_MSG(flags & ~ENCODE_FLAG_REAL_64, ERR_INVALID_DATA, "Unknown encoding flags.");
+	r_reals_64 = flags & ENCODE_FLAG_REAL_64;
+	return OK;
+}
+
+Error VariantSchema::decode(const uint8_t *p_buffer, int p_len, Dictionary &r_dictionary, int *r_len) const {
+	const uint8_t *buf = p_buffer;
+	int len = p_len;
+	r_dictionary = Dictionary();
+	bool reals_64 = false;
+	Error err = _decode_flags(buf, len, reals_64);
+	ERR_FAIL_COND_V(err != OK, err);
+	err = _decode(buf, len, reals_64, &r_dictionary, nullptr, 0);
+	if (err == OK && r_len) {
+		*r_len = p_len - len;
+	}
+	return err;
+}
+
+Error VariantSchema::decode_object(const uint8_t *p_buffer, int p_len, Object *p_object, int *r_len) const {
+	ERR_FAIL_NULL_V(p_object, ERR_INVALID_PARAMETER);
+	const uint8_t *buf = p_buffer;
+	int len = p_len;
+	bool reals_64 = false;
+	Error err = _decode_flags(buf, len, reals_64);
+	ERR_FAIL_COND_V(err != OK, err);
+	err = _decode(buf, len, reals_64, nullptr, p_object, 0);
+	if (err == OK && r_len) {
+		*r_len = p_len - len;
+	}
+	return err;
+}
+
+void VariantSchema::_add_field(const Variant &p_key, Variant::Type p_type, const Ref<VariantSchema> &p_schema) {
+	ERR_FAIL_INDEX(p_type, Variant::VARIANT_MAX);
+	ERR_FAIL_COND_MSG(p_schema.is_valid() && p_type != Variant::DICTIONARY && p_type != Variant::ARRAY, "Only dictionary and array fields can have a schema.");
+
+	Field field;
+	field.key = p_key;
+	field.name = p_key;
+	field.type = p_type;
+	field.schema = p_schema;
+	if (p_type == Variant::BOOL) {
+		field.bit = bool_count++;
+	}
+	fields.push_back(field);
+}
+
+void VariantSchema::add_field(const StringName &p_name, Variant::Type p_type, const Ref<VariantSchema> &p_schema) {
+	_add_field(String(p_name), p_type, p_schema);
+}
+
+void VariantSchema::clear() {
+	fields.clear();
+	bool_count = 0;
+}
+
+int VariantSchema::get_field_count() const {
+	return fields.size();
+}
+
+StringName VariantSchema::get_field_name(int p_index) const {
+	ERR_FAIL_UNSIGNED_INDEX_V((uint32_t)p_index, fields.size(), StringName());
+	return fields[p_index].name;
+}
+
+Variant::Type VariantSchema::get_field_type(int p_index) const {
+	ERR_FAIL_UNSIGNED_INDEX_V((uint32_t)p_index, fields.size(), Variant::NIL);
+	return fields[p_index].type;
+}
+
+Ref<VariantSchema> VariantSchema::get_field_schema(int p_index) const {
+	ERR_FAIL_UNSIGNED_INDEX_V((uint32_t)p_index, fields.size(), Ref<VariantSchema>());
+	return fields[p_index].schema;
+}
+
+Error VariantSchema::create_from_dictionary(const Dictionary &p_template) {
+	clear();
+
+	List<Variant> keys;
+	p_template.get_key_list(&keys);
+	for (const Variant &E : keys) {
+		const Variant &value = p_template[E];
+		Ref<VariantSchema> schema;
+		if (value.get_type() == Variant::DICTIONARY && !Dictionary(value).is_empty()) {
+			schema.instantiate();
+			Error err = schema->create_from_dictionary(value);
+			ERR_FAIL_COND_V(err != OK, err);
+		} else if (value.get_type() == Variant::ARRAY && !Array(value).is_empty() && Array(value)[0].get_type() == Variant::DICTIONARY) {
+			schema.instantiate();
+			Error err = schema->create_from_dictionary(Array(value)[0]);
+			ERR_FAIL_COND_V(err != OK, err);
+		}
+		_add_field(E, value.get_type(), schema);
+	}
+	return OK;
+}
+
+Error VariantSchema::create_from_class(const StringName &p_class) {
+	ERR_FAIL_COND_V_MSG(!ClassDB::class_exists(p_class), ERR_INVALID_PARAMETER, "Class '" + String(p_class) + "' does not exist.");
+	clear();
+
+	List<PropertyInfo> properties;
+	ClassDB::get_property_list(p_class, &properties);
+	for (const PropertyInfo &E : properties) {
+		if (!(E.usage & PROPERTY_USAGE_STORAGE) || E.type == Variant::OBJECT) {
+			continue;
+		}
+		_add_field(String(E.name), E.type, Ref<VariantSchema>());
+	}
+	return OK;
+}
+
+PackedByteArray VariantSchema::_encode_bind(const Variant &p_value) const {
+	int len = 0;
+	Error err = encode(p_value, nullptr, len);
+	ERR_FAIL_COND_V(err != OK, PackedByteArray());
+
+	PackedByteArray bytes;
+	bytes.resize(len);
+	err = encode(p_value, bytes.ptrw(), len);
+	ERR_FAIL_COND_V(err != OK, PackedByteArray());
+	return bytes;
+}
+
+Variant VariantSchema::_decode_bind(const PackedByteArray &p_bytes) const {
+	Dictionary dictionary;
+	Error err = decode(p_bytes.ptr(), p_bytes.size(), dictionary);
+	ERR_FAIL_COND_V(err != OK, Variant());
+	return dictionary;
+}
+
+Error VariantSchema::_decode_object_bind(const PackedByteArray &p_bytes, Object *p_object) const {
+	return decode_object(p_bytes.ptr(), p_bytes.size(), p_object);
+}
+
+void VariantSchema::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("add_field", "name", "type", "schema"), &VariantSchema::add_field, DEFVAL(Ref<VariantSchema>()));
+	ClassDB::bind_method(D_METHOD("clear"), &VariantSchema::clear);
+
+	ClassDB::bind_method(D_METHOD("get_field_count"), &VariantSchema::get_field_count);
+	ClassDB::bind_method(D_METHOD("get_field_name", "index"), &VariantSchema::get_field_name);
+	ClassDB::bind_method(D_METHOD("get_field_type", "index"), &VariantSchema::get_field_type);
+	ClassDB::bind_method(D_METHOD("get_field_schema", "index"), &VariantSchema::get_field_schema);
+
+	ClassDB::bind_method(D_METHOD("create_from_dictionary", "template"), &VariantSchema::create_from_dictionary);
+	ClassDB::bind_method(D_METHOD("create_from_class", "class_name"), &VariantSchema::create_from_class);
+
+	ClassDB::bind_method(D_METHOD("encode", "value"), &VariantSchema::_encode_bind);
+	ClassDB::bind_method(D_METHOD("decode", "bytes"), &VariantSchema::_decode_bind);
+	ClassDB::bind_method(D_METHOD("decode_object", "bytes", "object"), &VariantSchema::_decode_object_bind);
+}
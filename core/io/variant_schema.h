@@ -0,0 +1,98 @@
+/*************************************************************************/
+/*  variant_schema.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef VARIANT_SCHEMA_H
+#define VARIANT_SCHEMA_H
+
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+// Describes the fields of a Dictionary or an Object, so their values can be
+// encoded without the keys and the type header encode_variant() writes for
+// each of them. Both ends need the same schema: fields are encoded in the order
+// they were added, booleans as bits, integers and lengths as variable length
+// integers, and the components of math types as they are. A flags byte comes
+// first, telling whether those components are floats or doubles.
+class VariantSchema : public RefCounted {
+	GDCLASS(VariantSchema, RefCounted);
+
+	enum {
+		ENCODE_FLAG_REAL_64 = 1 << 0,
+	};
+
+	struct Field {
+		Variant key;
+		StringName name;
+		Variant::Type type = Variant::NIL;
+		Ref<VariantSchema> schema;
+		int bit = -1; // For booleans.
+	};
+
+	LocalVector<Field> fields;
+	int bool_count = 0;
+
+	Error _encode(const Variant &p_value, uint8_t *&r_buf, int &r_len, int p_depth) const;
+	Error _encode_field(const Field &p_field, const Variant &p_value, uint8_t *&r_buf, int &r_len, uint8_t *p_bits, int p_depth) const;
+	static Error _decode_flags(const uint8_t *&r_buf, int &r_len, bool &r_reals_64);
+	Error _decode(const uint8_t *&r_buf, int &r_len, bool p_reals_64, Dictionary *r_dictionary, Object *r_object, int p_depth) const;
+	Error _decode_field(const Field &p_field, const uint8_t *&r_buf, int &r_len, const uint8_t *p_bits, bool p_reals_64, Variant &r_value, int p_depth) const;
+	void _add_field(const Variant &p_key, Variant::Type p_type, const Ref<VariantSchema> &p_schema);
+
+	PackedByteArray _encode_bind(const Variant &p_value) const;
+	Variant _decode_bind(const PackedByteArray &p_bytes) const;
+	Error _decode_object_bind(const PackedByteArray &p_bytes, Object *p_object) const;
+
+protected:
+	static void _bind_methods();
+
+public:
+	void add_field(const StringName &p_name, Variant::Type p_type, const Ref<VariantSchema> &p_schema = Ref<VariantSchema>());
+	void clear();
+
+	int get_field_count() const;
+	StringName get_field_name(int p_index) const;
+	Variant::Type get_field_type(int p_index) const;
+	Ref<VariantSchema> get_field_schema(int p_index) const;
+
+	// Fields with the keys and types of the values in p_template. Dictionaries
+	// in it (and the first element of arrays of dictionaries) become schemas too.
+	Error create_from_dictionary(const Dictionary &p_template);
+	// Fields for the stored properties of a class, except objects.
+	Error create_from_class(const StringName &p_class);
+
+	// p_value can be a Dictionary or an Object. Same as encode_variant(), if
+	// r_buffer is nullptr only the length is computed.
+	Error encode(const Variant &p_value, uint8_t *r_buffer, int &r_len) const;
+	Error decode(const uint8_t *p_buffer, int p_len, Dictionary &r_dictionary, int *r_len = nullptr) const;
+	Error decode_object(const uint8_t *p_buffer, int p_len, Object *p_object, int *r_len = nullptr) const;
+};
+
+#endif // VARIANT_SCHEMA_H
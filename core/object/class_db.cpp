@@ -64,6 +64,7 @@ ClassDB::APIType ClassDB::get_current_api() {
 HashMap<StringName, ClassDB::ClassInfo> ClassDB::classes;
 HashMap<StringName, StringName> ClassDB::resource_base_extensions;
 HashMap<StringName, StringName> ClassDB::compat_classes;
+SafeNumeric<uint32_t> ClassDB::method_generation(1);
 
 bool ClassDB::_is_parent_class(const StringName &p_class, const StringName &p_inherits) {
 	if (!classes.has(p_class)) {
@@ -378,7 +379,7 @@ bool ClassDB::is_virtual(const StringName &p_class) {
 	return (!ti->disabled && ti->creation_func != nullptr && !(ti->native_extension && !ti->native_extension->create_instance) && ti->is_virtual);
 }
 
-void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherits) {
+void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherits, bool p_overrides_callp) {
 	OBJTYPE_WLOCK;
 
 	const StringName &name = p_class;
@@ -390,6 +391,7 @@ void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherit
 	ti.name = name;
 	ti.inherits = p_inherits;
 	ti.api = current_api;
+	ti.overrides_callp = p_overrides_callp;
 
 	if (ti.inherits) {
 		ERR_FAIL_COND(!classes.has(ti.inherits)); //it MUST be registered.
@@ -536,6 +538,20 @@ MethodBind *ClassDB::get_method(const StringName &p_class, const StringName &p_n
 	return nullptr;
 }
 
+bool ClassDB::is_callp_overridden(const StringName &p_class) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *type = classes.getptr(p_class);
+
+	while (type) {
+		if (type->overrides_callp) {
+			return true;
+		}
+		type = type->inherits_ptr;
+	}
+	return false;
+}
+
 void ClassDB::bind_integer_constant(const StringName &p_class, const StringName &p_enum, const StringName &p_name, int64_t p_constant, bool p_is_bitfield) {
 	OBJTYPE_WLOCK;
 
@@ -1241,6 +1257,7 @@ void ClassDB::bind_method_custom(const StringName &p_class, MethodBind *p_method
 #endif
 
 	type->method_map[p_method->get_name()] = p_method;
+	method_generation.increment();
 }
 
 #ifdef DEBUG_METHODS_ENABLED
@@ -1287,6 +1304,7 @@ MethodBind *ClassDB::bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const c
 #endif
 
 	type->method_map[mdname] = p_bind;
+	method_generation.increment();
 
 	Vector<Variant> defvals;
 
@@ -1511,6 +1529,7 @@ void ClassDB::register_extension_class(ObjectNativeExtension *p_extension) {
 void ClassDB::unregister_extension_class(const StringName &p_class) {
 	ERR_FAIL_COND(!classes.has(p_class));
 	classes.erase(p_class);
+	method_generation.increment();
 }
 
 HashMap<StringName, ClassDB::NativeStruct> ClassDB::native_structs;
@@ -1555,6 +1574,7 @@ void ClassDB::cleanup() {
 		}
 	}
 	classes.clear();
+	method_generation.increment();
 	resource_base_extensions.clear();
 	compat_classes.clear();
 	native_structs.clear();
@@ -128,6 +128,7 @@ public:
 		bool disabled = false;
 		bool exposed = false;
 		bool is_virtual = false;
+		bool overrides_callp = false; // Calls may not go to the bound methods, see MethodHandle.
 		Object *(*creation_func)() = nullptr;
 
 		ClassInfo() {}
@@ -143,6 +144,7 @@ public:
 	static HashMap<StringName, ClassInfo> classes;
 	static HashMap<StringName, StringName> resource_base_extensions;
 	static HashMap<StringName, StringName> compat_classes;
+	static SafeNumeric<uint32_t> method_generation;
 
 #ifdef DEBUG_METHODS_ENABLED
 	static MethodBind *bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const MethodDefinition &method_name, const Variant **p_defs, int p_defcount);
@@ -152,7 +154,7 @@ public:
 
 	static APIType current_api;
 
-	static void _add_class2(const StringName &p_class, const StringName &p_inherits);
+	static void _add_class2(const StringName &p_class, const StringName &p_inherits, bool p_overrides_callp);
 
 	static HashMap<StringName, HashMap<StringName, Variant>> default_values;
 	static HashSet<StringName> default_values_cached;
@@ -173,7 +175,8 @@ public:
 	// DO NOT USE THIS!!!!!! NEEDS TO BE PUBLIC BUT DO NOT USE NO MATTER WHAT!!!
 	template <class T>
 	static void _add_class() {
-		_add_class2(T::get_class_static(), T::get_parent_class_static());
+		// `&T::callp` has the type of the class that declares it last.
+		_add_class2(T::get_class_static(), T::get_parent_class_static(), !std::is_same<decltype(&T::callp), decltype(&Object::callp)>::value);
 	}
 
 	template <class T>
@@ -326,6 +329,10 @@ public:
 	static void get_method_list(const StringName &p_class, List<MethodInfo> *p_methods, bool p_no_inheritance = false, bool p_exclude_from_properties = false);
 	static bool get_method_info(const StringName &p_class, const StringName &p_method, MethodInfo *r_info, bool p_no_inheritance = false, bool p_exclude_from_properties = false);
 	static MethodBind *get_method(const StringName &p_class, const StringName &p_name);
+	// Whether the class or one of its parents overrides Object::callp(), so calls may not reach the bound methods.
+	static bool is_callp_overridden(const StringName &p_class);
+	// Changes whenever methods are bound or unregistered, for caches of get_method() results (see MethodHandle).
+	static uint32_t get_method_generation() { return method_generation.get(); }
 
 	static void add_virtual_method(const StringName &p_class, const MethodInfo &p_method, bool p_virtual = true, const Vector<String> &p_arg_names = Vector<String>(), bool p_object_core = false);
 	static void get_virtual_methods(const StringName &p_class, List<MethodInfo> *p_methods, bool p_no_inheritance = false);
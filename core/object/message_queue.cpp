@@ -33,69 +33,287 @@
 #include "core/config/project_settings.h"
 #include "core/core_string_names.h"
 #include "core/object/class_db.h"
+#include "core/object/method_handle.h"
 #include "core/object/script_language.h"
 
 MessageQueue *MessageQueue::singleton = nullptr;
 
+thread_local MessageQueue::ThreadSlot MessageQueue::thread_slot;
+SafeNumeric<uint64_t> MessageQueue::last_queue_id;
+
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
+MessageQueue::ThreadSlot::~ThreadSlot() {
+	// The queue may have been replaced (or be gone) by the time the thread exits.
+	if (queue && singleton && singleton->queue_id == queue_id) {
+		queue->abandoned.set();
+	}
+}
+
+MessageQueue::Page *MessageQueue::_alloc_page(uint32_t p_min_size) {
+	if (p_min_size <= PAGE_SIZE) {
+		MutexLock lock(page_pool_mutex);
+		if (page_pool) {
+			Page *page = page_pool;
+			page_pool = page->next.load(std::memory_order_relaxed);
+			page_pool_size--;
+			page->next.store(nullptr, std::memory_order_relaxed);
+			page->committed.set(0);
+			return page;
+		}
+	}
+
+	uint32_t capacity = MAX(uint32_t(PAGE_SIZE), p_min_size);
+	void *mem = Memory::alloc_static(sizeof(Page) + capacity);
+	ERR_FAIL_COND_V(!mem, nullptr);
+	Page *page = memnew_placement(mem, Page);
+	page->capacity = capacity;
+	page_count.increment();
+	return page;
+}
+
+void MessageQueue::_free_page(Page *p_page) {
+	if (p_page->capacity == PAGE_SIZE) {
+		MutexLock lock(page_pool_mutex);
+		if (page_pool_size < MAX_POOLED_PAGES) {
+			p_page->next.store(page_pool, std::memory_order_relaxed);
+			page_pool = p_page;
+			page_pool_size++;
+			return;
+		}
+	}
+
+	page_count.decrement();
+	p_page->~Page();
+	Memory::free_static(p_page);
+}
+
+MessageQueue::ThreadQueue *MessageQueue::_get_thread_queue() {
+	ThreadSlot &slot = thread_slot;
+	if (likely(slot.queue_id == queue_id)) {
+		return slot.queue;
+	}
+
+	// No page yet, the first push gets one.
+	ThreadQueue *queue = memnew(ThreadQueue);
+
+	ThreadQueue *head = thread_queues.load(std::memory_order_relaxed);
+	do {
+		queue->next = head;
+	} while (!thread_queues.compare_exchange_weak(head, queue, std::memory_order_release, std::memory_order_relaxed));
+
+	slot.queue_id = queue_id;
+	slot.queue = queue;
+	return queue;
+}
+
+uint8_t *MessageQueue::_reserve(ThreadQueue *p_queue, uint32_t p_size) {
+	// Hold on to the last page until the message is committed, so the flushing
+	// thread can't take it back meanwhile.
+	Page *page = p_queue->write_page.exchange(nullptr, std::memory_order_acquire);
+	Page *fresh_page = nullptr;
+	if (!page) {
+		page = _alloc_page(p_size);
+		if (!page) {
+			return nullptr;
+		}
+		fresh_page = page;
+	} else if (page->committed.get() + p_size > page->capacity) {
+		Page *new_page = _alloc_page(p_size);
+		if (!new_page) {
+			p_queue->write_page.store(page, std::memory_order_release);
+			return nullptr;
+		}
+		// Nothing else gets written to the old page, the flushing thread can give
+		// it back once it has read up to its last commit.
+		page->next.store(new_page, std::memory_order_release);
+		page = new_page;
+	}
+
+	p_queue->writing_page = page;
+	p_queue->writing_fresh_page = fresh_page;
+	return page->data() + page->committed.get();
+}
+
+void MessageQueue::_commit(ThreadQueue *p_queue, uint32_t p_type, uint32_t p_size) {
+	p_queue->pushed_bytes.add(p_size);
+	p_queue->pushed_messages.increment();
+	pending_messages[p_type].increment();
+	const uint64_t used = buffer_used.add(p_size);
+	buffer_max_used.exchange_if_greater(used);
+
+	Page *page = p_queue->writing_page;
+	page->committed.set(page->committed.get() + p_size);
+	if (p_queue->writing_fresh_page) {
+		p_queue->fresh_page.store(p_queue->writing_fresh_page, std::memory_order_release);
+	}
+	p_queue->write_page.store(page, std::memory_order_release);
+
+	// Pairs with the fence in _gather_queues(): either the flushing thread sees
+	// this message, or this sees the queue isn't listed and asks for another look.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (!p_queue->listed.load(std::memory_order_relaxed)) {
+		p_queue->listed.store(true, std::memory_order_relaxed);
+		queue_activations.increment();
+	}
+
+	if (unlikely(used > buffer_size)) {
+		_warn_buffer_size();
+	}
+}
+
+void MessageQueue::_warn_buffer_size() {
+	if (buffer_size_warned.exchange(true, std::memory_order_relaxed)) {
+		return;
+	}
+	WARN_PRINT("The message queue uses more than 'memory/limits/message_queue/max_size_kb'. Something may be deferring calls faster than they are flushed.");
+	statistics();
+}
+
+MessageQueue::Message *MessageQueue::_peek(ThreadQueue *p_queue) {
+	while (true) {
+		Page *page = p_queue->read_page;
+		if (!page) {
+			page = p_queue->fresh_page.exchange(nullptr, std::memory_order_acquire);
+			if (!page) {
+				return nullptr;
+			}
+			p_queue->read_page = page;
+			p_queue->read_pos = 0;
+			p_queue->read_page_taken = false;
+		}
+
+		if (p_queue->read_pos < page->committed.get()) {
+			return (Message *)(page->data() + p_queue->read_pos);
+		}
+
+		Page *next = page->next.load(std::memory_order_acquire);
+		if (next) {
+			if (p_queue->read_pos < page->committed.get()) {
+				continue; // Committed right before moving on to the next page.
+			}
+			_free_page(page);
+			p_queue->read_page = next;
+			p_queue->read_pos = 0;
+			continue;
+		}
+
+		if (!p_queue->read_page_taken) {
+			// All read, take the page back unless the pushing thread is writing to it.
+			Page *expected = page;
+			if (!p_queue->write_page.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+				return nullptr;
+			}
+			p_queue->read_page_taken = true;
+			continue; // Something may have been committed right before.
+		}
+
+		// Nothing can be added to a page taken back, the next push starts a new list.
+		_free_page(page);
+		p_queue->read_page = nullptr;
+	}
+}
+
+void MessageQueue::_gather_queues(LocalVector<ThreadQueue *> &r_queues) {
+	r_queues.clear();
+	for (ThreadQueue *queue = thread_queues.load(std::memory_order_acquire); queue; queue = queue->next) {
+		queue->listed.store(false, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (_peek(queue)) {
+			queue->listed.store(true, std::memory_order_relaxed);
+			r_queues.push_back(queue);
+		}
+	}
+}
+
+void MessageQueue::_free_thread_queue(ThreadQueue *p_queue) {
+	Message *message = _peek(p_queue);
+	while (message) {
+		uint32_t size = _get_message_size(message);
+		p_queue->read_pos += size;
+		_destroy_message(message);
+		message = _peek(p_queue);
+	}
+
+	// Empty and no longer pushed to, so _peek() gave back every page.
+	DEV_ASSERT(!p_queue->read_page && !p_queue->write_page.load(std::memory_order_relaxed));
+	memdelete(p_queue);
+}
+
+uint32_t MessageQueue::_get_message_size(const Message *p_message) {
+	uint32_t size = sizeof(Message);
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		size += sizeof(Variant) * p_message->args;
+	}
+	return size;
+}
+
+void MessageQueue::_destroy_message(Message *p_message) {
+	const uint32_t type = p_message->type & FLAG_MASK;
+	buffer_used.sub(_get_message_size(p_message));
+	pending_messages[type].decrement();
+
+	if (type != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
+	p_message->~Message();
+}
+
 Error MessageQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callablep(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
+	ThreadQueue *queue = _get_thread_queue();
+	uint8_t *buffer = queue ? _reserve(queue, room_needed) : nullptr;
+	if (!buffer) {
 		String type;
 		if (ObjectDB::get_instance(p_id)) {
 			type = ObjectDB::get_instance(p_id)->get_class();
 		}
 		print_line("Failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
+		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(buffer, Message);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
 	msg->type = TYPE_SET;
+	msg->order = next_order.increment();
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
-	*v = p_value;
+	memnew_placement(buffer + sizeof(Message), Variant(p_value));
 
+	_commit(queue, TYPE_SET, room_needed);
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	uint32_t room_needed = sizeof(Message);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	ThreadQueue *queue = _get_thread_queue();
+	uint8_t *buffer = queue ? _reserve(queue, room_needed) : nullptr;
+	if (!buffer) {
 		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
+		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(buffer, Message);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
-	//msg->target;
 	msg->notification = p_notification;
+	msg->order = next_order.increment();
 
-	buffer_end += sizeof(Message);
-
+	_commit(queue, TYPE_NOTIFICATION, room_needed);
 	return OK;
 }
 
@@ -112,110 +330,69 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callablep(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
-
-	if ((buffer_end + room_needed) >= buffer_size) {
+	ThreadQueue *queue = _get_thread_queue();
+	uint8_t *buffer = queue ? _reserve(queue, room_needed) : nullptr;
+	if (!buffer) {
 		print_line("Failed method: " + p_callable);
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
+		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(buffer, Message);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
 	msg->type = TYPE_CALL;
 	if (p_show_error) {
 		msg->type |= FLAG_SHOW_ERROR;
 	}
+	msg->order = next_order.increment();
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(buffer + sizeof(Message));
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
-		*v = *p_args[i];
+		memnew_placement(&args[i], Variant(*p_args[i]));
 	}
 
+	_commit(queue, TYPE_CALL, room_needed);
 	return OK;
 }
 
 void MessageQueue::statistics() {
-	HashMap<StringName, int> set_count;
-	HashMap<int, int> notify_count;
-	HashMap<Callable, int> call_count;
-	int null_count = 0;
-
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-
-		Object *target = message->callable.get_object();
-
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
-					}
-
-					call_count[message->callable]++;
-
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
-					}
-
-					notify_count[message->notification]++;
-
-				} break;
-				case TYPE_SET: {
-					StringName t = message->callable.get_method();
-					if (!set_count.has(t)) {
-						set_count[t] = 0;
-					}
-
-					set_count[t]++;
-
-				} break;
-			}
-
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
-
-			null_count++;
-		}
-
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+	// Called from pushing threads too, while the flushing thread reads and frees
+	// the messages. Only counters can be looked at.
+	print_line("TOTAL BYTES: " + itos(buffer_used.get()));
+	print_line("CALLS: " + itos(pending_messages[TYPE_CALL].get()));
+	print_line("SETS: " + itos(pending_messages[TYPE_SET].get()));
+	print_line("NOTIFICATIONS: " + itos(pending_messages[TYPE_NOTIFICATION].get()));
+
+	ThreadSlot &slot = thread_slot;
+	if (slot.queue_id == queue_id) {
+		print_line("PUSHED BY THIS THREAD: " + itos(slot.queue->pushed_messages.get()) + " messages, " + itos(slot.queue->pushed_bytes.get()) + " bytes");
 	}
+}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
-	print_line("NULL count: " + itos(null_count));
-
-	for (const KeyValue<StringName, int> &E : set_count) {
-		print_line("SET " + E.key + ": " + itos(E.value));
-	}
+int MessageQueue::get_max_buffer_usage() const {
+	return buffer_max_used.get();
+}
 
-	for (const KeyValue<Callable, int> &E : call_count) {
-		print_line("CALL " + E.key + ": " + itos(E.value));
+MessageQueue::Stats MessageQueue::get_stats() const {
+	Stats stats;
+	for (ThreadQueue *queue = thread_queues.load(std::memory_order_acquire); queue; queue = queue->next) {
+		stats.thread_queues++;
 	}
-
-	for (const KeyValue<int, int> &E : notify_count) {
-		print_line("NOTIFY " + itos(E.key) + ": " + itos(E.value));
+	stats.pages = page_count.get();
+	{
+		MutexLock lock(page_pool_mutex);
+		stats.pooled_pages = page_pool_size;
 	}
+	stats.buffer_used = buffer_used.get();
+	stats.buffer_max_used = buffer_max_used.get();
+	stats.last_flush_messages = last_flush_messages;
+	stats.max_flush_messages = max_flush_messages;
+	return stats;
 }
 
-int MessageQueue::get_max_buffer_usage() const {
-	return buffer_max_used;
-}
-
-void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error) {
+void MessageQueue::_call_function(const Callable &p_callable, Object *p_target, MethodHandle &r_method, const Variant *p_args, int p_argcount, bool p_show_error) {
 	const Variant **argptrs = nullptr;
 	if (p_argcount) {
 		argptrs = (const Variant **)alloca(sizeof(Variant *) * p_argcount);
@@ -226,42 +403,60 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 
 	Callable::CallError ce;
 	Variant ret;
-	p_callable.call(argptrs, p_argcount, ret, ce);
+	if (p_callable.is_custom()) {
+		p_callable.call(argptrs, p_argcount, ret, ce);
+	} else {
+		// Deferred calls usually come in runs of the same method, keep the handle resolved across them.
+		if (r_method.get_method() != p_callable.get_method()) {
+			r_method.set_method(p_callable.get_method());
+		}
+		ret = r_method.call(p_target, argptrs, p_argcount, ce);
+	}
 	if (p_show_error && ce.error != Callable::CallError::CALL_OK) {
 		ERR_PRINT("Error calling deferred method: " + Variant::get_callable_error_text(p_callable, argptrs, p_argcount, ce) + ".");
 	}
 }
 
 void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
-	}
-
-	uint32_t read_pos = 0;
-
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
-
-	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
-		ERR_FAIL_COND(flushing); //already flushing, you did something odd
+	if (flushing.exchange(true, std::memory_order_acquire)) {
+		ERR_FAIL_MSG("Already flushing the message queue."); // You did something odd.
 	}
-	flushing = true;
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
-
-		Message *message = (Message *)&buffer[read_pos];
+	MethodHandle method;
+	uint32_t message_count = 0;
+
+	// Only the queues that have messages are looked at for each message. All of
+	// them are gathered again when a queue that had none gets some, so messages
+	// pushed while flushing are processed too.
+	LocalVector<ThreadQueue *> queues;
+	uint32_t activations = 0;
+
+	while (true) {
+		if (queues.is_empty() || queue_activations.get() != activations) {
+			activations = queue_activations.get();
+			_gather_queues(queues);
+			if (queues.is_empty()) {
+				break;
+			}
+		}
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+		// The oldest message first, so the order of pushes made one after the
+		// other by different threads is kept.
+		uint32_t queue_index = 0;
+		Message *message = _peek(queues[0]);
+		for (uint32_t i = 1; i < queues.size(); i++) {
+			Message *head = _peek(queues[i]);
+			if (head->order < message->order) {
+				queue_index = i;
+				message = head;
+			}
 		}
+		ThreadQueue *queue = queues[queue_index];
+		uint32_t message_size = _get_message_size(message);
 
 		//pre-advance so this function is reentrant
-		read_pos += advance;
-
-		_THREAD_SAFE_UNLOCK_
+		queue->read_pos += message_size;
+		message_count++;
 
 		Object *target = message->callable.get_object();
 
@@ -272,7 +467,7 @@ void MessageQueue::flush() {
 
 					// messages don't expect a return value
 
-					_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
+					_call_function(message->callable, target, method, args, message->args, message->type & FLAG_SHOW_ERROR);
 
 				} break;
 				case TYPE_NOTIFICATION: {
@@ -289,57 +484,81 @@ void MessageQueue::flush() {
 			}
 		}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
+		_destroy_message(message);
+
+		if (!_peek(queue)) {
+			queue->listed.store(false, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (_peek(queue)) {
+				queue->listed.store(true, std::memory_order_relaxed);
+			} else {
+				queues.remove_at_unordered(queue_index);
 			}
 		}
+	}
 
-		message->~Message();
+	last_flush_messages = message_count;
+	max_flush_messages = MAX(max_flush_messages, message_count);
+	buffer_size_warned.store(false, std::memory_order_relaxed);
+
+	// Free the queues of threads that exited, now that they are empty. Queues are
+	// only ever added at the head of the list, so only unlinking the head can race.
+	ThreadQueue *prev = nullptr;
+	ThreadQueue *queue = thread_queues.load(std::memory_order_acquire);
+	while (queue) {
+		ThreadQueue *next = queue->next;
+		if (!queue->abandoned.is_set() || _peek(queue)) {
+			prev = queue;
+			queue = next;
+			continue;
+		}
 
-		_THREAD_SAFE_LOCK_
+		if (prev) {
+			prev->next = next;
+		} else {
+			ThreadQueue *expected = queue;
+			if (!thread_queues.compare_exchange_strong(expected, next, std::memory_order_acq_rel)) {
+				// Another thread registered its queue in the meantime, try again later.
+				prev = queue;
+				queue = next;
+				continue;
+			}
+		}
+		_free_thread_queue(queue);
+		queue = next;
 	}
 
-	buffer_end = 0; // reset buffer
-	flushing = false;
-	_THREAD_SAFE_UNLOCK_
+	flushing.store(false, std::memory_order_release);
 }
 
 bool MessageQueue::is_flushing() const {
-	return flushing;
+	return flushing.load(std::memory_order_acquire);
 }
 
 MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
+	queue_id = last_queue_id.increment();
 
 	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
 	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
-			}
-		}
-		message->~Message();
+	ThreadQueue *queue = thread_queues.load(std::memory_order_acquire);
+	while (queue) {
+		ThreadQueue *next = queue->next;
+		_free_thread_queue(queue);
+		queue = next;
+	}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+	while (page_pool) {
+		Page *page = page_pool;
+		page_pool = page->next.load(std::memory_order_relaxed);
+		page->~Page();
+		Memory::free_static(page);
 	}
 
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
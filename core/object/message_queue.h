@@ -33,15 +33,20 @@
 
 #include "core/object/object_id.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 
+#include <atomic>
+
 class Object;
+class MethodHandle;
 
 class MessageQueue {
-	_THREAD_SAFE_CLASS_
-
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_QUEUE_SIZE_KB = 4096,
+		PAGE_SIZE = 64 * 1024,
+		MAX_POOLED_PAGES = 16,
 	};
 
 	enum {
@@ -55,6 +60,7 @@ class MessageQueue {
 
 	struct Message {
 		Callable callable;
+		uint64_t order;
 		int16_t type;
 		union {
 			int16_t notification;
@@ -62,16 +68,90 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer = nullptr;
-	uint32_t buffer_end = 0;
-	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size = 0;
+	// Each thread pushing messages appends them to its own list of pages, so
+	// pushing never takes a lock. The flushing thread reads every list up to
+	// what has been committed and gives back the pages it's done with. Messages
+	// pushed by one thread are processed in the order they were pushed, and so
+	// are messages whose pushes are ordered by synchronization between threads.
+	// Messages pushed concurrently from different threads have no set order.
+	struct alignas(16) Page {
+		std::atomic<Page *> next = nullptr;
+		SafeNumeric<uint32_t> committed;
+		uint32_t capacity = 0;
+
+		_FORCE_INLINE_ uint8_t *data() { return (uint8_t *)(this + 1); }
+	};
 
-	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
+	struct ThreadQueue {
+		ThreadQueue *next = nullptr;
+		// Last page of the list. The pushing thread takes it while writing a
+		// message, and the flushing thread takes it back once it has read all of
+		// it, so threads that stop pushing don't keep a page around.
+		std::atomic<Page *> write_page = nullptr;
+		// First page of a new list, started after the last one was taken back.
+		std::atomic<Page *> fresh_page = nullptr;
+		// Set by the flushing thread while it's looking at the queue, pushes
+		// that find it unset tell the flushing thread to look again.
+		std::atomic<bool> listed = false;
+		Page *writing_page = nullptr; // Only used by the pushing thread.
+		Page *writing_fresh_page = nullptr; // Only used by the pushing thread.
+		Page *read_page = nullptr; // Only used by the flushing thread.
+		uint32_t read_pos = 0; // Only used by the flushing thread.
+		bool read_page_taken = false; // Only used by the flushing thread.
+		SafeFlag abandoned; // The thread exited, free once empty.
+		// Totals of what the thread pushed, for statistics().
+		SafeNumeric<uint64_t> pushed_bytes;
+		SafeNumeric<uint32_t> pushed_messages;
+	};
+
+	struct ThreadSlot {
+		uint64_t queue_id = 0;
+		ThreadQueue *queue = nullptr;
+
+		~ThreadSlot();
+	};
+
+	static thread_local ThreadSlot thread_slot;
+	static SafeNumeric<uint64_t> last_queue_id;
+
+	uint64_t queue_id = 0;
+	std::atomic<ThreadQueue *> thread_queues = nullptr;
+	SafeNumeric<uint64_t> next_order;
+	SafeNumeric<uint32_t> queue_activations;
+
+	// Idle pages, shared by all threads.
+	Mutex page_pool_mutex;
+	Page *page_pool = nullptr;
+	uint32_t page_pool_size = 0;
+	SafeNumeric<uint32_t> page_count;
+
+	// A warning is printed once per flush when the messages waiting in the queue
+	// use more than this, the queue keeps growing past it.
+	uint32_t buffer_size = 0;
+	std::atomic<bool> buffer_size_warned = false;
+	SafeNumeric<uint64_t> buffer_used;
+	SafeNumeric<uint64_t> buffer_max_used;
+	SafeNumeric<uint32_t> pending_messages[TYPE_SET + 1];
+	uint32_t last_flush_messages = 0;
+	uint32_t max_flush_messages = 0;
+
+	Page *_alloc_page(uint32_t p_min_size);
+	void _free_page(Page *p_page);
+	ThreadQueue *_get_thread_queue();
+	uint8_t *_reserve(ThreadQueue *p_queue, uint32_t p_size);
+	void _commit(ThreadQueue *p_queue, uint32_t p_type, uint32_t p_size);
+	void _warn_buffer_size();
+	Message *_peek(ThreadQueue *p_queue);
+	void _gather_queues(LocalVector<ThreadQueue *> &r_queues);
+	void _free_thread_queue(ThreadQueue *p_queue);
+	static uint32_t _get_message_size(const Message *p_message);
+	void _destroy_message(Message *p_message);
+
+	void _call_function(const Callable &p_callable, Object *p_target, MethodHandle &r_method, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
 
-	bool flushing = false;
+	std::atomic<bool> flushing = false;
 
 public:
 	static MessageQueue *get_singleton();
@@ -122,6 +202,17 @@ public:
 
 	int get_max_buffer_usage() const;
 
+	struct Stats {
+		uint32_t thread_queues = 0;
+		uint32_t pages = 0;
+		uint32_t pooled_pages = 0;
+		uint64_t buffer_used = 0;
+		uint64_t buffer_max_used = 0;
+		uint32_t last_flush_messages = 0;
+		uint32_t max_flush_messages = 0;
+	};
+	Stats get_stats() const;
+
 	MessageQueue();
 	~MessageQueue();
 };
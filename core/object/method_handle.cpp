@@ -0,0 +1,67 @@
+/*************************************************************************/
+/*  method_handle.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "method_handle.h"
+
+#include "core/object/class_db.h"
+#include "core/object/method_bind.h"
+
+void MethodHandle::set_method(const StringName &p_method) {
+	method = p_method;
+	resolved_class = StringName();
+	bind = nullptr;
+	generation = 0;
+}
+
+MethodBind *MethodHandle::resolve(const Object *p_object) {
+	const StringName &class_name = p_object->get_class_name();
+	const uint32_t current_generation = ClassDB::get_method_generation();
+	if (likely(generation == current_generation && class_name == resolved_class)) {
+		return bind;
+	}
+
+	bind = ClassDB::is_callp_overridden(class_name) ? nullptr : ClassDB::get_method(class_name, method);
+	resolved_class = class_name;
+	generation = current_generation;
+	return bind;
+}
+
+Variant MethodHandle::call(Object *p_object, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	MethodBind *mb = resolve(p_object);
+	if (!mb) {
+		// Script methods, "free", or methods handled by an override of callp().
+		return p_object->callp(method, p_args, p_argcount, r_error);
+	}
+	return p_object->_callp_bound(method, mb, p_args, p_argcount, r_error);
+}
+
+MethodHandle::MethodHandle(const StringName &p_method) {
+	method = p_method;
+}
@@ -0,0 +1,71 @@
+/*************************************************************************/
+/*  method_handle.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef METHOD_HANDLE_H
+#define METHOD_HANDLE_H
+
+#include "core/string/string_name.h"
+#include "core/variant/callable.h"
+
+class MethodBind;
+class Object;
+
+// Call-site cache for calling a method by name on many objects.
+//
+// Finding a method by name means walking the class hierarchy in ClassDB, under
+// its lock. A handle keeps the MethodBind it found for the last class it was
+// used with, so calling the same method on many objects of the same class only
+// looks it up once. It is invalidated when methods are bound or unregistered.
+//
+// Handles are not synchronized, each caller (or thread) keeps its own, and
+// must not change the method while a call through the handle is running.
+class MethodHandle {
+	StringName method;
+	StringName resolved_class;
+	MethodBind *bind = nullptr;
+	uint32_t generation = 0;
+
+public:
+	_FORCE_INLINE_ const StringName &get_method() const { return method; }
+	void set_method(const StringName &p_method);
+
+	// Method bound in ClassDB for the class of the object, if any. Script
+	// methods are not bound, and neither are methods provided by classes that
+	// override Object::callp().
+	MethodBind *resolve(const Object *p_object);
+
+	// Same as Object::callp().
+	Variant call(Object *p_object, const Variant **p_args, int p_argcount, Callable::CallError &r_error);
+
+	MethodHandle() {}
+	MethodHandle(const StringName &p_method);
+};
+
+#endif // METHOD_HANDLE_H
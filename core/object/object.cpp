@@ -39,28 +39,6 @@
 #include "core/string/print_string.h"
 #include "core/string/translation.h"
 
-#ifdef DEBUG_ENABLED
-
-struct _ObjectDebugLock {
-	Object *obj;
-
-	_ObjectDebugLock(Object *p_obj) {
-		obj = p_obj;
-		obj->_lock_index.ref();
-	}
-	~_ObjectDebugLock() {
-		obj->_lock_index.unref();
-	}
-};
-
-#define OBJ_DEBUG_LOCK _ObjectDebugLock _debug_lock(this);
-
-#else
-
-#define OBJ_DEBUG_LOCK
-
-#endif
-
 PropertyInfo::operator Dictionary() const {
 	Dictionary d;
 	d["name"] = name;
@@ -689,6 +667,25 @@ Variant Object::callp(const StringName &p_method, const Variant **p_args, int p_
 	return ret;
 }
 
+// Same as callp(), with the method already resolved by a MethodHandle. Only
+// used for classes that don't override callp() (see ClassDB::is_callp_overridden()).
+Variant Object::_callp_bound(const StringName &p_method, MethodBind *p_bind, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	r_error.error = Callable::CallError::CALL_OK;
+
+	Variant ret;
+	OBJ_DEBUG_LOCK
+
+	if (script_instance) {
+		ret = script_instance->callp(p_method, p_args, p_argcount, r_error);
+		if (r_error.error != Callable::CallError::CALL_ERROR_INVALID_METHOD && r_error.error != Callable::CallError::CALL_ERROR_INSTANCE_IS_NULL) {
+			return ret;
+		}
+		r_error.error = Callable::CallError::CALL_OK;
+	}
+
+	return p_bind->call(this, p_args, p_argcount, r_error);
+}
+
 Variant Object::call_const(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
 	r_error.error = Callable::CallError::CALL_OK;
 
@@ -962,23 +959,41 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		return ERR_UNAVAILABLE;
 	}
 
+	if (s->emit_list_dirty) {
+		s->emit_list.resize(s->slot_map.size());
+		s->emit_max_binds = 0;
+		Connection *w = s->emit_list.ptrw();
+		const VMap<Callable, SignalData::Slot>::Pair *slot_list = s->slot_map.get_array();
+		for (int i = 0; i < s->slot_map.size(); i++) {
+			w[i] = slot_list[i].value.conn;
+			s->emit_max_binds = MAX(s->emit_max_binds, slot_list[i].value.conn.binds.size());
+		}
+		s->emit_list_dirty = false;
+	}
+
 	List<_ObjectSignalDisconnectData> disconnect_data;
 
-	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
-	VMap<Callable, SignalData::Slot> slot_map = s->slot_map;
+	// Keep a reference to the connections, connecting or disconnecting from the callbacks
+	// makes the signal build a new list, and deleting the object does not free this one.
+	// `s` may be invalidated by the callbacks, so it's not used past this point.
+	const Vector<Connection> connections_to_emit = s->emit_list;
+	const Connection *connection_list = connections_to_emit.ptr();
+	int ssize = connections_to_emit.size();
 
-	int ssize = slot_map.size();
+	const Variant **bind_mem = nullptr;
+	if (s->emit_max_binds) {
+		bind_mem = (const Variant **)alloca(sizeof(Variant *) * (p_argcount + s->emit_max_binds));
+		for (int j = 0; j < p_argcount; j++) {
+			bind_mem[j] = p_args[j];
+		}
+	}
 
 	OBJ_DEBUG_LOCK
 
-	Vector<const Variant *> bind_mem;
-
 	Error err = OK;
 
 	for (int i = 0; i < ssize; i++) {
-		const Connection &c = slot_map.getv(i).conn;
+		const Connection &c = connection_list[i];
 
 		Object *target = c.callable.get_object();
 		if (!target) {
@@ -991,17 +1006,12 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 
 		if (c.binds.size()) {
 			//handle binds
-			bind_mem.resize(p_argcount + c.binds.size());
-
-			for (int j = 0; j < p_argcount; j++) {
-				bind_mem.write[j] = p_args[j];
-			}
 			for (int j = 0; j < c.binds.size(); j++) {
-				bind_mem.write[p_argcount + j] = &c.binds[j];
+				bind_mem[p_argcount + j] = &c.binds[j];
 			}
 
-			args = (const Variant **)bind_mem.ptr();
-			argc = bind_mem.size();
+			args = bind_mem;
+			argc = p_argcount + c.binds.size();
 		}
 
 		if (c.flags & CONNECT_DEFERRED) {
@@ -1253,6 +1263,7 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, co
 
 	//use callable version as key, so binds can be ignored
 	s->slot_map[*target.get_base_comparator()] = slot;
+	s->emit_list_dirty = true;
 
 	return OK;
 }
@@ -1309,6 +1320,7 @@ void Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 
 	target_object->connections.erase(slot->cE);
 	s->slot_map.erase(*p_callable.get_base_comparator());
+	s->emit_list_dirty = true;
 
 	if (s->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
 		//not user signal, delete
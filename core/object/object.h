@@ -537,6 +537,13 @@ private:
 
 		MethodInfo user;
 		VMap<Callable, Slot> slot_map;
+
+		// Connections in emission order, rebuilt on the next emission after
+		// connecting or disconnecting. Emitting keeps a reference to it, so
+		// changes made by the callbacks don't affect the emission in progress.
+		Vector<Connection> emit_list;
+		int emit_max_binds = 0;
+		bool emit_list_dirty = true;
 	};
 
 	HashMap<StringName, SignalData> signal_map;
@@ -579,6 +586,9 @@ private:
 	friend class RefCounted;
 	bool type_is_reference = false;
 
+	friend class MethodHandle;
+	Variant _callp_bound(const StringName &p_method, MethodBind *p_bind, const Variant **p_args, int p_argcount, Callable::CallError &r_error);
+
 	std::mutex _instance_binding_mutex;
 	struct InstanceBinding {
 		void *binding = nullptr;
@@ -882,6 +892,31 @@ public:
 bool predelete_handler(Object *p_object);
 void postinitialize_handler(Object *p_object);
 
+#ifdef DEBUG_ENABLED
+
+// Makes freeing the object an error while its code runs.
+struct _ObjectDebugLock {
+	Object *obj;
+
+	_ObjectDebugLock(Object *p_obj) {
+		obj = p_obj;
+		obj->_lock_index.ref();
+	}
+	~_ObjectDebugLock() {
+		obj->_lock_index.unref();
+	}
+};
+
+#define OBJ_DEBUG_LOCK_OBJECT(m_object) _ObjectDebugLock _debug_lock(m_object);
+
+#else
+
+#define OBJ_DEBUG_LOCK_OBJECT(m_object)
+
+#endif
+
+#define OBJ_DEBUG_LOCK OBJ_DEBUG_LOCK_OBJECT(this)
+
 class ObjectDB {
 // This needs to add up to 63, 1 bit is for reference.
 #define OBJECTDB_VALIDATOR_BITS 39
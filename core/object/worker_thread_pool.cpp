@@ -0,0 +1,507 @@
+/*************************************************************************/
+/*  worker_thread_pool.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "worker_thread_pool.h"
+
+#include "core/os/arena_allocator.h"
+#include "core/os/os.h"
+
+WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
+thread_local WorkerThreadPool::ThreadData *WorkerThreadPool::current_thread = nullptr;
+
+void WorkerThreadPool::TaskQueue::push_back(Task *p_task) {
+	lock.lock();
+	uint32_t size = count.get();
+	uint32_t capacity = ring.size();
+	if (size == capacity) {
+		uint32_t new_capacity = MAX(16u, capacity * 2);
+		LocalVector<Task *> new_ring;
+		new_ring.resize(new_capacity);
+		for (uint32_t i = 0; i < size; i++) {
+			new_ring[i] = ring[(head + i) & (capacity - 1)];
+		}
+		ring = new_ring;
+		head = 0;
+		capacity = new_capacity;
+	}
+	ring[(head + size) & (capacity - 1)] = p_task;
+	count.set(size + 1);
+	lock.unlock();
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::TaskQueue::pop_back() {
+	if (is_empty()) {
+		return nullptr;
+	}
+	lock.lock();
+	Task *task = nullptr;
+	uint32_t size = count.get();
+	if (size > 0) {
+		size--;
+		task = ring[(head + size) & (ring.size() - 1)];
+		count.set(size);
+	}
+	lock.unlock();
+	return task;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::TaskQueue::pop_front() {
+	if (is_empty()) {
+		return nullptr;
+	}
+	lock.lock();
+	Task *task = nullptr;
+	uint32_t size = count.get();
+	if (size > 0) {
+		task = ring[head];
+		head = (head + 1) & (ring.size() - 1);
+		count.set(size - 1);
+	}
+	lock.unlock();
+	return task;
+}
+
+void WorkerThreadPool::_thread_function(void *p_user) {
+	ThreadData *thread_data = static_cast<ThreadData *>(p_user);
+	WorkerThreadPool *pool = thread_data->pool;
+	current_thread = thread_data;
+
+	while (true) {
+		if (pool->_process_one(thread_data->index)) {
+			continue;
+		}
+		if (pool->exit_threads.is_set()) {
+			break;
+		}
+		ThreadArena::frame_reset();
+		pool->task_available_semaphore.wait();
+	}
+
+	current_thread = nullptr;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_pop_task(int p_thread_index) {
+	for (int i = 0; i < PRIORITY_MAX; i++) {
+		Task *task = nullptr;
+
+		// Own work first, newest to oldest.
+		if (p_thread_index >= 0) {
+			task = threads[p_thread_index].queues[i].pop_back();
+			if (task) {
+				return task;
+			}
+		}
+
+		task = global_queues[i].pop_front();
+		if (task) {
+			return task;
+		}
+
+		// Steal the oldest work from the other threads.
+		for (uint32_t j = 1; j <= thread_count; j++) {
+			uint32_t victim = (uint32_t(p_thread_index + 1) + j - 1) % thread_count;
+			if (int(victim) == p_thread_index) {
+				continue;
+			}
+			task = threads[victim].queues[i].pop_front();
+			if (task) {
+				return task;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+bool WorkerThreadPool::_process_one(int p_thread_index) {
+	if (thread_count == 0) {
+		return false;
+	}
+	Task *task = _pop_task(p_thread_index);
+	if (!task) {
+		return false;
+	}
+	_process_task(task);
+	return true;
+}
+
+void WorkerThreadPool::_process_task(Task *p_task) {
+	if (p_task->group) {
+		Group *group = p_task->group;
+		while (true) {
+			uint32_t work_index = group->index.postincrement();
+			if (work_index >= group->max) {
+				break;
+			}
+			if (group->native_func) {
+				group->native_func(group->native_func_userdata, work_index);
+			} else if (group->template_userdata) {
+				group->template_userdata->callback_indexed(work_index);
+			} else {
+				Variant index = work_index;
+				const Variant *args[1] = { &index };
+				Variant ret;
+				Callable::CallError ce;
+				group->callable.call(args, 1, ret, ce);
+			}
+			group->completed_index.increment();
+		}
+
+		// Group tasks are never waited for individually.
+		task_allocator.free(p_task);
+
+		if (group->finished.increment() == group->tasks_used) {
+			if (group->template_userdata) {
+				memdelete(group->template_userdata);
+				group->template_userdata = nullptr;
+			}
+			task_mutex.lock();
+			group->completed = true;
+			for (uint32_t i = 0; i < group->waiting; i++) {
+				group->done_semaphore.post();
+			}
+			task_mutex.unlock();
+		}
+		return;
+	}
+
+	if (p_task->native_func) {
+		p_task->native_func(p_task->native_func_userdata);
+	} else if (p_task->template_userdata) {
+		p_task->template_userdata->callback();
+		memdelete(p_task->template_userdata);
+		p_task->template_userdata = nullptr;
+	} else {
+		Variant ret;
+		Callable::CallError ce;
+		p_task->callable.call(nullptr, 0, ret, ce);
+	}
+
+	LocalVector<Task *> ready;
+
+	task_mutex.lock();
+	p_task->completed = true;
+	for (uint32_t i = 0; i < p_task->dependents.size(); i++) {
+		Task *dependent = p_task->dependents[i];
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies == 0) {
+			ready.push_back(dependent);
+		}
+	}
+	p_task->dependents.clear();
+	for (uint32_t i = 0; i < p_task->waiting; i++) {
+		p_task->done_semaphore.post();
+	}
+	task_mutex.unlock();
+
+	// Continuations are queued on the thread that released them.
+	for (uint32_t i = 0; i < ready.size(); i++) {
+		_enqueue_task(ready[i]);
+	}
+}
+
+void WorkerThreadPool::_enqueue_task(Task *p_task) {
+	if (thread_count == 0) {
+		// No threads (not initialized yet, or threads are disabled), run synchronously.
+		_process_task(p_task);
+		return;
+	}
+
+	int index = _get_thread_index();
+	if (index >= 0) {
+		threads[index].queues[p_task->priority].push_back(p_task);
+	} else {
+		global_queues[p_task->priority].push_back(p_task);
+	}
+	task_available_semaphore.post();
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(Task *p_task, const Vector<TaskID> &p_dependencies) {
+	task_mutex.lock();
+	TaskID id = last_task++;
+	p_task->self = id;
+	tasks.insert(id, p_task);
+
+	for (int i = 0; i < p_dependencies.size(); i++) {
+		TaskID dependency = p_dependencies[i];
+		ERR_CONTINUE_MSG(dependency <= 0 || dependency >= id, vformat("Invalid dependency Task ID: %d.", dependency));
+		Task **dependency_task = tasks.getptr(dependency);
+		// Tasks that are no longer known were already completed and waited for.
+		if (dependency_task && !(*dependency_task)->completed) {
+			(*dependency_task)->dependents.push_back(p_task);
+			p_task->pending_dependencies++;
+		}
+	}
+
+	bool ready = p_task->pending_dependencies == 0;
+	task_mutex.unlock();
+
+	if (ready) {
+		_enqueue_task(p_task);
+	}
+
+	return id;
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, Priority p_priority, const String &p_description, const Vector<TaskID> &p_dependencies) {
+	ERR_FAIL_INDEX_V(p_priority, PRIORITY_MAX, -1);
+	Task *task = task_allocator.alloc();
+	task->native_func = p_func;
+	task->native_func_userdata = p_userdata;
+	task->priority = p_priority;
+	task->description = p_description;
+	return _add_task(task, p_dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_task(const Callable &p_action, Priority p_priority, const String &p_description, const Vector<TaskID> &p_dependencies) {
+	ERR_FAIL_INDEX_V(p_priority, PRIORITY_MAX, -1);
+	Task *task = task_allocator.alloc();
+	task->callable = p_action;
+	task->priority = p_priority;
+	task->description = p_description;
+	return _add_task(task, p_dependencies);
+}
+
+bool WorkerThreadPool::is_task_completed(TaskID p_task_id) const {
+	MutexLock lock(task_mutex);
+	Task *const *task = tasks.getptr(p_task_id);
+	ERR_FAIL_COND_V_MSG(!task, false, "Invalid Task ID.");
+	return (*task)->completed;
+}
+
+void WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
+	int index = _get_thread_index();
+
+	task_mutex.lock();
+	Task **taskp = tasks.getptr(p_task_id);
+	if (!taskp) {
+		task_mutex.unlock();
+		ERR_FAIL_MSG("Invalid Task ID.");
+	}
+	Task *task = *taskp;
+
+	while (!task->completed) {
+		task_mutex.unlock();
+		// Help with queued work rather than blocking, this also prevents
+		// deadlocks when waiting from within a task.
+		if (!_process_one(index)) {
+			task_mutex.lock();
+			if (task->completed) {
+				break;
+			}
+			task->waiting++;
+			task_mutex.unlock();
+			task->done_semaphore.wait();
+		}
+		task_mutex.lock();
+	}
+
+	tasks.erase(p_task_id);
+	task_allocator.free(task);
+	task_mutex.unlock();
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, Priority p_priority, const String &p_description) {
+	ERR_FAIL_COND_V(p_elements < 0, -1);
+	ERR_FAIL_INDEX_V(p_priority, PRIORITY_MAX, -1);
+	if (p_tasks < 0) {
+		p_tasks = MAX(1u, thread_count);
+	}
+	p_tasks = MIN(p_tasks, p_elements);
+
+	Group *group = group_allocator.alloc();
+	group->callable = p_callable;
+	group->native_func = p_func;
+	group->native_func_userdata = p_userdata;
+	group->template_userdata = p_template_userdata;
+	group->max = p_elements;
+	group->tasks_used = p_tasks;
+
+	task_mutex.lock();
+	GroupID id = last_group++;
+	group->self = id;
+	groups.insert(id, group);
+	if (p_tasks == 0) {
+		group->completed = true;
+		if (group->template_userdata) {
+			memdelete(group->template_userdata);
+			group->template_userdata = nullptr;
+		}
+	}
+	task_mutex.unlock();
+
+	for (int i = 0; i < p_tasks; i++) {
+		Task *task = task_allocator.alloc();
+		task->group = group;
+		task->priority = p_priority;
+		task->description = p_description;
+		_enqueue_task(task);
+	}
+
+	return id;
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks, Priority p_priority, const String &p_description) {
+	return _add_group_task(Callable(), p_func, p_userdata, nullptr, p_elements, p_tasks, p_priority, p_description);
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_group_task(const Callable &p_action, int p_elements, int p_tasks, Priority p_priority, const String &p_description) {
+	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_priority, p_description);
+}
+
+uint32_t WorkerThreadPool::get_group_processed_element_count(GroupID p_group) const {
+	MutexLock lock(task_mutex);
+	Group *const *group = groups.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!group, 0, "Invalid Group ID.");
+	return (*group)->completed_index.get();
+}
+
+bool WorkerThreadPool::is_group_task_completed(GroupID p_group) const {
+	MutexLock lock(task_mutex);
+	Group *const *group = groups.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!group, false, "Invalid Group ID.");
+	return (*group)->completed;
+}
+
+void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
+	int index = _get_thread_index();
+
+	task_mutex.lock();
+	Group **groupp = groups.getptr(p_group);
+	if (!groupp) {
+		task_mutex.unlock();
+		ERR_FAIL_MSG("Invalid Group ID.");
+	}
+	Group *group = *groupp;
+
+	while (!group->completed) {
+		task_mutex.unlock();
+		if (!_process_one(index)) {
+			task_mutex.lock();
+			if (group->completed) {
+				break;
+			}
+			group->waiting++;
+			task_mutex.unlock();
+			group->done_semaphore.wait();
+		}
+		task_mutex.lock();
+	}
+
+	groups.erase(p_group);
+	group_allocator.free(group);
+	task_mutex.unlock();
+}
+
+void WorkerThreadPool::init(int p_thread_count) {
+	ERR_FAIL_COND(threads != nullptr);
+	if (p_thread_count < 0) {
+		p_thread_count = OS::get_singleton()->get_default_thread_pool_size();
+	}
+#ifdef NO_THREADS
+	p_thread_count = 0;
+#endif
+
+	if (p_thread_count == 0) {
+		return;
+	}
+
+	thread_count = p_thread_count;
+	threads = memnew_arr(ThreadData, thread_count);
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].pool = this;
+		threads[i].index = i;
+		threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
+	}
+}
+
+void WorkerThreadPool::finish() {
+	if (threads != nullptr) {
+		exit_threads.set();
+		for (uint32_t i = 0; i < thread_count; i++) {
+			task_available_semaphore.post();
+		}
+		for (uint32_t i = 0; i < thread_count; i++) {
+			threads[i].thread.wait_to_finish();
+		}
+
+		memdelete_arr(threads);
+		threads = nullptr;
+		thread_count = 0;
+		exit_threads.clear();
+	}
+
+	task_mutex.lock();
+	if (tasks.size()) {
+		WARN_PRINT(vformat("WorkerThreadPool: %d task(s) were never waited for, or depend on tasks that never completed.", tasks.size()));
+		for (const KeyValue<TaskID, Task *> &E : tasks) {
+			if (E.value->template_userdata) {
+				memdelete(E.value->template_userdata);
+			}
+			task_allocator.free(E.value);
+		}
+		tasks.clear();
+	}
+	if (groups.size()) {
+		WARN_PRINT(vformat("WorkerThreadPool: %d group task(s) were never waited for.", groups.size()));
+		for (const KeyValue<GroupID, Group *> &E : groups) {
+			group_allocator.free(E.value);
+		}
+		groups.clear();
+	}
+	task_mutex.unlock();
+}
+
+void WorkerThreadPool::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("add_task", "action", "priority", "description", "dependencies"), &WorkerThreadPool::add_task, DEFVAL(PRIORITY_NORMAL), DEFVAL(String()), DEFVAL(Vector<TaskID>()));
+	ClassDB::bind_method(D_METHOD("is_task_completed", "task_id"), &WorkerThreadPool::is_task_completed);
+	ClassDB::bind_method(D_METHOD("wait_for_task_completion", "task_id"), &WorkerThreadPool::wait_for_task_completion);
+
+	ClassDB::bind_method(D_METHOD("add_group_task", "action", "elements", "tasks_needed", "priority", "description"), &WorkerThreadPool::add_group_task, DEFVAL(-1), DEFVAL(PRIORITY_NORMAL), DEFVAL(String()));
+	ClassDB::bind_method(D_METHOD("is_group_task_completed", "group_id"), &WorkerThreadPool::is_group_task_completed);
+	ClassDB::bind_method(D_METHOD("get_group_processed_element_count", "group_id"), &WorkerThreadPool::get_group_processed_element_count);
+	ClassDB::bind_method(D_METHOD("wait_for_group_task_completion", "group_id"), &WorkerThreadPool::wait_for_group_task_completion);
+
+	ClassDB::bind_method(D_METHOD("get_thread_count"), &WorkerThreadPool::get_thread_count);
+
+	BIND_ENUM_CONSTANT(PRIORITY_HIGH);
+	BIND_ENUM_CONSTANT(PRIORITY_NORMAL);
+	BIND_ENUM_CONSTANT(PRIORITY_LOW);
+}
+
+WorkerThreadPool::WorkerThreadPool() {
+	singleton = this;
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+	finish();
+	singleton = nullptr;
+}
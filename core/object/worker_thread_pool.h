@@ -0,0 +1,251 @@
+/*************************************************************************/
+/*  worker_thread_pool.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef WORKER_THREAD_POOL_H
+#define WORKER_THREAD_POOL_H
+
+#include "core/object/class_db.h"
+#include "core/os/memory.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/spin_lock.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/paged_allocator.h"
+#include "core/templates/safe_refcount.h"
+
+// Engine-wide task scheduler.
+//
+// Every worker thread owns one deque per priority class. Tasks submitted from
+// a worker are pushed to its own deque and popped LIFO (so nested work stays
+// cache-hot), idle workers steal FIFO from the others, and tasks submitted from
+// outside the pool go to a shared injection queue. Tasks can depend on other
+// tasks: they are only queued once all their dependencies have completed.
+//
+// Threads waiting for a task or group help processing queued tasks instead of
+// blocking, so it's safe to submit and wait from within a task.
+
+class WorkerThreadPool : public Object {
+	GDCLASS(WorkerThreadPool, Object)
+public:
+	enum Priority {
+		PRIORITY_HIGH,
+		PRIORITY_NORMAL,
+		PRIORITY_LOW,
+		PRIORITY_MAX
+	};
+
+	typedef int64_t TaskID;
+	typedef int64_t GroupID;
+
+private:
+	struct Task;
+
+	struct BaseTemplateUserdata {
+		virtual void callback() {}
+		virtual void callback_indexed(uint32_t p_index) {}
+		virtual ~BaseTemplateUserdata() {}
+	};
+
+	struct Group {
+		GroupID self = -1;
+		Callable callable;
+		void (*native_func)(void *, uint32_t) = nullptr;
+		void *native_func_userdata = nullptr;
+		BaseTemplateUserdata *template_userdata = nullptr;
+		SafeNumeric<uint32_t> index;
+		SafeNumeric<uint32_t> completed_index;
+		uint32_t max = 0;
+		Semaphore done_semaphore;
+		SafeNumeric<uint32_t> finished;
+		uint32_t tasks_used = 0;
+		uint32_t waiting = 0;
+		bool completed = false;
+	};
+
+	struct Task {
+		TaskID self = -1;
+		Callable callable;
+		void (*native_func)(void *) = nullptr;
+		void *native_func_userdata = nullptr;
+		BaseTemplateUserdata *template_userdata = nullptr;
+		String description;
+		Priority priority = PRIORITY_NORMAL;
+		Group *group = nullptr;
+		Semaphore done_semaphore;
+		uint32_t waiting = 0;
+		uint32_t pending_dependencies = 0;
+		LocalVector<Task *> dependents;
+		bool completed = false;
+	};
+
+	// Ring buffer of tasks, the owner thread pushes and pops at the back
+	// while thieves pop from the front.
+	struct TaskQueue {
+		SpinLock lock;
+		LocalVector<Task *> ring; // Capacity is always a power of 2.
+		uint32_t head = 0;
+		SafeNumeric<uint32_t> count;
+
+		void push_back(Task *p_task);
+		Task *pop_back();
+		Task *pop_front();
+		_FORCE_INLINE_ bool is_empty() const { return count.get() == 0; }
+	};
+
+	struct ThreadData {
+		WorkerThreadPool *pool = nullptr;
+		uint32_t index = 0;
+		Thread thread;
+		TaskQueue queues[PRIORITY_MAX];
+	};
+
+	static thread_local ThreadData *current_thread;
+
+	PagedAllocator<Task, true> task_allocator;
+	PagedAllocator<Group, true> group_allocator;
+
+	TaskQueue global_queues[PRIORITY_MAX];
+	Semaphore task_available_semaphore;
+
+	ThreadData *threads = nullptr;
+	uint32_t thread_count = 0;
+	SafeFlag exit_threads;
+
+	Mutex task_mutex;
+	HashMap<TaskID, Task *> tasks;
+	HashMap<GroupID, Group *> groups;
+	TaskID last_task = 1;
+	GroupID last_group = 1;
+
+	static void _thread_function(void *p_user);
+
+	_FORCE_INLINE_ int _get_thread_index() const { return (current_thread && current_thread->pool == this) ? int(current_thread->index) : -1; }
+	Task *_pop_task(int p_thread_index);
+	bool _process_one(int p_thread_index);
+	void _process_task(Task *p_task);
+	void _enqueue_task(Task *p_task);
+	TaskID _add_task(Task *p_task, const Vector<TaskID> &p_dependencies);
+	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, Priority p_priority, const String &p_description);
+
+	template <class C, class M, class U>
+	struct TaskUserData : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback() override {
+			(instance->*method)(userdata);
+		}
+	};
+
+	template <class C, class M, class U>
+	struct GroupUserData : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback_indexed(uint32_t p_index) override {
+			(instance->*method)(p_index, userdata);
+		}
+	};
+
+	static WorkerThreadPool *singleton;
+
+protected:
+	static void _bind_methods();
+
+public:
+	template <class C, class M, class U>
+	TaskID add_template_task(C *p_instance, M p_method, U p_userdata, Priority p_priority = PRIORITY_NORMAL, const String &p_description = String(), const Vector<TaskID> &p_dependencies = Vector<TaskID>()) {
+		typedef TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+
+		Task *task = task_allocator.alloc();
+		task->template_userdata = ud;
+		task->priority = p_priority;
+		task->description = p_description;
+		return _add_task(task, p_dependencies);
+	}
+	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, Priority p_priority = PRIORITY_NORMAL, const String &p_description = String(), const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+	TaskID add_task(const Callable &p_action, Priority p_priority = PRIORITY_NORMAL, const String &p_description = String(), const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+
+	bool is_task_completed(TaskID p_task_id) const;
+	void wait_for_task_completion(TaskID p_task_id);
+
+	// Group tasks run a callback once for every element index in [0, p_elements),
+	// spread over p_tasks tasks (-1 uses as many as there are worker threads).
+	template <class C, class M, class U>
+	GroupID add_template_group_task(C *p_instance, M p_method, U p_userdata, int p_elements, int p_tasks = -1, Priority p_priority = PRIORITY_NORMAL, const String &p_description = String()) {
+		typedef GroupUserData<C, M, U> GUD;
+		GUD *ud = memnew(GUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_group_task(Callable(), nullptr, nullptr, ud, p_elements, p_tasks, p_priority, p_description);
+	}
+	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1, Priority p_priority = PRIORITY_NORMAL, const String &p_description = String());
+	GroupID add_group_task(const Callable &p_action, int p_elements, int p_tasks = -1, Priority p_priority = PRIORITY_NORMAL, const String &p_description = String());
+
+	uint32_t get_group_processed_element_count(GroupID p_group) const;
+	bool is_group_task_completed(GroupID p_group) const;
+	void wait_for_group_task_completion(GroupID p_group);
+
+	// Convenience replacement for ThreadWorkPool::do_work(), runs the group and waits for it.
+	template <class C, class M, class U>
+	void do_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, Priority p_priority = PRIORITY_HIGH, const String &p_description = String()) {
+		switch (p_elements) {
+			case 0:
+				break;
+			case 1:
+				// Not worth dispatching a single element we'd have to wait for anyway.
+				(p_instance->*p_method)(0, p_userdata);
+				break;
+			default:
+				wait_for_group_task_completion(add_template_group_task(p_instance, p_method, p_userdata, p_elements, -1, p_priority, p_description));
+		}
+	}
+
+	// Index of the calling thread inside the pool, or -1 if it is not a worker.
+	_FORCE_INLINE_ static int get_thread_index() { return current_thread ? int(current_thread->index) : -1; }
+	_FORCE_INLINE_ int get_thread_count() const { return thread_count; }
+
+	static WorkerThreadPool *get_singleton() { return singleton; }
+	void init(int p_thread_count = -1);
+	void finish();
+	WorkerThreadPool();
+	~WorkerThreadPool();
+};
+
+VARIANT_ENUM_CAST(WorkerThreadPool::Priority);
+
+#endif // WORKER_THREAD_POOL_H
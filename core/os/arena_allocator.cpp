@@ -0,0 +1,319 @@
+/*************************************************************************/
+/*  arena_allocator.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "arena_allocator.h"
+
+#include "core/string/print_string.h"
+#include "core/variant/variant.h"
+
+#include <string.h>
+
+MemoryCounters *MemoryCounters::first = nullptr;
+
+MemoryCounters::MemoryCounters(const char *p_name) {
+	// Counters are static objects, so registration happens during static
+	// initialization, before any thread is started.
+	name = p_name;
+	next = first;
+	first = this;
+}
+
+void MemoryCounters::reset() {
+	heap_allocs.set(0);
+	heap_bytes.set(0);
+	arena_allocs.set(0);
+	arena_bytes.set(0);
+	pool_allocs.set(0);
+	pool_bytes.set(0);
+}
+
+void MemoryCounters::print_all() {
+	for (MemoryCounters *c = first; c; c = c->next) {
+		if (c->heap_allocs.get() == 0 && c->arena_allocs.get() == 0 && c->pool_allocs.get() == 0) {
+			continue;
+		}
+		print_line(vformat("Memory counters [%s]: %d heap allocations (%s), %d arena allocations (%s),", c->name, c->heap_allocs.get(), String::humanize_size(c->heap_bytes.get()), c->arena_allocs.get(), String::humanize_size(c->arena_bytes.get())) +
+				vformat(" %d pooled allocations (%s).", c->pool_allocs.get(), String::humanize_size(c->pool_bytes.get())));
+	}
+}
+
+thread_local ThreadArena::ThreadState ThreadArena::state;
+thread_local MemoryCounters *ThreadArena::counters = nullptr;
+
+#define ARENA_ALIGNED(m_size) (((m_size) + (ALIGN - 1)) & ~size_t(ALIGN - 1))
+
+ThreadArena::ThreadState::~ThreadState() {
+	while (current) {
+		Chunk *prev = current->prev;
+		Memory::free_static(current, false);
+		current = prev;
+	}
+	while (spare) {
+		Chunk *prev = spare->prev;
+		Memory::free_static(spare, false);
+		spare = prev;
+	}
+}
+
+ThreadArena::Chunk *ThreadArena::_acquire_chunk(size_t p_min_size) {
+	Chunk *chunk = nullptr;
+	if (p_min_size <= CHUNK_SIZE && state.spare) {
+		chunk = state.spare;
+		state.spare = chunk->prev;
+		state.spare_count--;
+	} else {
+		size_t size = MAX(size_t(CHUNK_SIZE), ARENA_ALIGNED(p_min_size));
+		void *mem = Memory::alloc_static(sizeof(Chunk) + size, false);
+		ERR_FAIL_COND_V(!mem, nullptr);
+		chunk = memnew_placement(mem, Chunk);
+		chunk->size = size;
+		state.stats.chunks++;
+	}
+	chunk->used = 0;
+	chunk->prev = state.current;
+	state.current = chunk;
+	return chunk;
+}
+
+void ThreadArena::_release_chunk(Chunk *p_chunk) {
+	// Oversized chunks only ever serve one large allocation, don't keep them.
+	if (p_chunk->size == CHUNK_SIZE && state.spare_count < MAX_SPARE_CHUNKS) {
+		p_chunk->prev = state.spare;
+		state.spare = p_chunk;
+		state.spare_count++;
+	} else {
+		Memory::free_static(p_chunk, false);
+		state.stats.chunks--;
+	}
+}
+
+void *ThreadArena::_alloc_heap(size_t p_bytes) {
+	void *mem = Memory::alloc_static(sizeof(Header) + p_bytes, false);
+	ERR_FAIL_COND_V(!mem, nullptr);
+	Header *header = (Header *)mem;
+	header->size = p_bytes;
+	header->kind = KIND_HEAP;
+	header->scope = 0;
+	state.stats.heap_fallbacks++;
+	return header + 1;
+}
+
+void *ThreadArena::alloc(size_t p_bytes) {
+	if (state.scope_depth == 0) {
+		return _alloc_heap(p_bytes);
+	}
+
+	size_t needed = sizeof(Header) + ARENA_ALIGNED(p_bytes);
+	Chunk *chunk = state.current;
+	if (unlikely(!chunk || chunk->used + needed > chunk->size)) {
+		chunk = _acquire_chunk(needed);
+		ERR_FAIL_COND_V(!chunk, nullptr);
+	}
+
+	Header *header = (Header *)(chunk->data() + chunk->used);
+	header->size = p_bytes;
+	header->kind = KIND_ARENA;
+	header->scope = state.scope->serial;
+	chunk->used += needed;
+
+	state.in_use += needed;
+	state.stats.allocs++;
+	state.stats.bytes += p_bytes;
+	if (state.in_use > state.stats.high_water) {
+		state.stats.high_water = state.in_use;
+	}
+	if (counters) {
+		counters->arena_allocs.increment();
+		counters->arena_bytes.add(p_bytes);
+	}
+
+	return header + 1;
+}
+
+void *ThreadArena::realloc(void *p_memory, size_t p_bytes) {
+	if (p_memory == nullptr) {
+		return alloc(p_bytes);
+	}
+	if (p_bytes == 0) {
+		free(p_memory);
+		return nullptr;
+	}
+
+	Header *header = ((Header *)p_memory) - 1;
+
+	if (header->kind == KIND_HEAP) {
+		void *mem = Memory::realloc_static(header, sizeof(Header) + p_bytes, false);
+		ERR_FAIL_COND_V(!mem, nullptr);
+		header = (Header *)mem;
+		header->size = p_bytes;
+		return header + 1;
+	}
+
+#ifdef DEBUG_ENABLED
+	CRASH_COND_MSG(header->kind != KIND_ARENA || !owns(header) || !_is_scope_open(header->scope), "Reallocating arena memory whose ArenaScope was closed, or which belongs to another thread.");
+#endif
+
+	if (!state.scope || header->scope != state.scope->serial) {
+		// Allocated by an outer scope, a new buffer on the arena would be
+		// reclaimed by the current scope while the container lives on.
+		void *mem = _alloc_heap(p_bytes);
+		ERR_FAIL_COND_V(!mem, nullptr);
+		memcpy(mem, p_memory, MIN(size_t(header->size), p_bytes));
+		return mem;
+	}
+
+	// Last allocation on the current chunk, grow or shrink in place.
+	Chunk *chunk = state.current;
+	size_t old_size = sizeof(Header) + ARENA_ALIGNED(header->size);
+	uint8_t *end = chunk ? chunk->data() + chunk->used : nullptr;
+	if (((uint8_t *)header) + old_size == end) {
+		size_t new_size = sizeof(Header) + ARENA_ALIGNED(p_bytes);
+		if (chunk->used - old_size + new_size <= chunk->size) {
+			chunk->used = chunk->used - old_size + new_size;
+			state.in_use = state.in_use - old_size + new_size;
+			if (state.in_use > state.stats.high_water) {
+				state.stats.high_water = state.in_use;
+			}
+			header->size = p_bytes;
+			return p_memory;
+		}
+	}
+
+	void *mem = alloc(p_bytes);
+	ERR_FAIL_COND_V(!mem, nullptr);
+	memcpy(mem, p_memory, MIN(size_t(header->size), p_bytes));
+	free(p_memory);
+	return mem;
+}
+
+void ThreadArena::free(void *p_memory) {
+	ERR_FAIL_COND(p_memory == nullptr);
+
+	Header *header = ((Header *)p_memory) - 1;
+
+	if (header->kind == KIND_HEAP) {
+		Memory::free_static(header, false);
+		return;
+	}
+
+#ifdef DEBUG_ENABLED
+	CRASH_COND_MSG(header->kind != KIND_ARENA || !owns(header) || !_is_scope_open(header->scope), "Freeing arena memory whose ArenaScope was closed, or which belongs to another thread.");
+#endif
+
+	// Only the most recent allocation of the innermost scope can be returned
+	// before the scope closes.
+	Chunk *chunk = state.current;
+	if (!chunk || !state.scope || header->scope != state.scope->serial) {
+		return;
+	}
+	size_t size = sizeof(Header) + ARENA_ALIGNED(header->size);
+	if (((uint8_t *)header) + size == chunk->data() + chunk->used) {
+		chunk->used -= size;
+		state.in_use -= size;
+	}
+}
+
+bool ThreadArena::_is_scope_open(uint32_t p_serial) {
+	for (const ArenaScope *scope = state.scope; scope; scope = scope->prev) {
+		if (scope->serial == p_serial) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ThreadArena::owns(const void *p_memory) {
+	for (Chunk *chunk = state.current; chunk; chunk = chunk->prev) {
+		if (p_memory >= chunk->data() && p_memory < chunk->data() + chunk->used) {
+			return true;
+		}
+	}
+	return false;
+}
+
+ThreadArena::Mark ThreadArena::get_mark() {
+	Mark mark;
+	mark.chunk = state.current;
+	mark.used = state.current ? state.current->used : 0;
+	mark.in_use = state.in_use;
+	return mark;
+}
+
+void ThreadArena::rewind(const Mark &p_mark) {
+	while (state.current && state.current != p_mark.chunk) {
+		Chunk *chunk = state.current;
+		state.current = chunk->prev;
+		_release_chunk(chunk);
+	}
+	if (state.current) {
+		state.current->used = p_mark.used;
+	}
+	state.in_use = p_mark.in_use;
+}
+
+void ThreadArena::frame_reset() {
+	if (state.scope_depth > 0) {
+		// Nested main loop iterations (e.g. progress dialogs) may run inside a scope.
+		return;
+	}
+
+	rewind(Mark());
+	while (state.spare_count > 1) {
+		Chunk *chunk = state.spare;
+		state.spare = chunk->prev;
+		state.spare_count--;
+		Memory::free_static(chunk, false);
+		state.stats.chunks--;
+	}
+}
+
+ArenaScope::ArenaScope(MemoryCounters *p_counters) {
+	mark = ThreadArena::get_mark();
+	prev_counters = ThreadArena::counters;
+	if (p_counters) {
+		ThreadArena::counters = p_counters;
+	}
+	ThreadArena::state.scope_depth++;
+
+	// Serial 0 marks heap allocations.
+	if (++ThreadArena::state.last_scope_serial == 0) {
+		ThreadArena::state.last_scope_serial = 1;
+	}
+	serial = ThreadArena::state.last_scope_serial;
+	prev = ThreadArena::state.scope;
+	ThreadArena::state.scope = this;
+}
+
+ArenaScope::~ArenaScope() {
+	ThreadArena::state.scope = prev;
+	ThreadArena::state.scope_depth--;
+	ThreadArena::counters = prev_counters;
+	ThreadArena::rewind(mark);
+}
@@ -0,0 +1,207 @@
+/*************************************************************************/
+/*  arena_allocator.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef ARENA_ALLOCATOR_H
+#define ARENA_ALLOCATOR_H
+
+#include "core/os/memory.h"
+#include "core/templates/safe_refcount.h"
+
+// Named set of allocation counters. While an ArenaScope referencing a counter
+// set is active on a thread, every arena or small block pool allocation and
+// every allocation that still reaches Memory::alloc_static on that thread is
+// attributed to it.
+// Instances are meant to be static; they register themselves on construction.
+class MemoryCounters {
+	const char *name = nullptr;
+	MemoryCounters *next = nullptr;
+
+	static MemoryCounters *first;
+
+public:
+	SafeNumeric<uint64_t> heap_allocs;
+	SafeNumeric<uint64_t> heap_bytes;
+	SafeNumeric<uint64_t> arena_allocs;
+	SafeNumeric<uint64_t> arena_bytes;
+	SafeNumeric<uint64_t> pool_allocs;
+	SafeNumeric<uint64_t> pool_bytes;
+
+	_FORCE_INLINE_ const char *get_name() const { return name; }
+	_FORCE_INLINE_ MemoryCounters *get_next() const { return next; }
+	static MemoryCounters *get_first() { return first; }
+
+	void reset();
+	static void print_all();
+
+	MemoryCounters(const char *p_name);
+};
+
+class ArenaScope;
+
+// Per-thread bump allocator with scope and frame reset semantics.
+//
+// Allocations are served from the calling thread's arena only while an
+// ArenaScope is open on that thread; otherwise they fall back to the heap, so
+// containers using ArenaAllocator remain valid outside of scopes. Freeing is a
+// no-op except for the most recent allocation, which lets growing containers
+// reallocate in place. All memory handed out inside a scope is reclaimed when
+// the scope closes, so arena-backed containers must not outlive their scope.
+// A container growing inside a nested scope moves to the heap instead, as the
+// nested scope would reclaim the new buffer; debug builds crash when a buffer
+// is reallocated or freed after its scope closed.
+class ThreadArena {
+public:
+	enum {
+		CHUNK_SIZE = 64 * 1024,
+		ALIGN = 16,
+		MAX_SPARE_CHUNKS = 4,
+	};
+
+	struct Stats {
+		uint64_t allocs = 0;
+		uint64_t bytes = 0;
+		uint64_t heap_fallbacks = 0;
+		uint64_t chunks = 0;
+		uint64_t high_water = 0;
+	};
+
+private:
+	struct alignas(ALIGN) Chunk {
+		Chunk *prev = nullptr;
+		size_t size = 0; // Usable bytes after the header.
+		size_t used = 0;
+		_FORCE_INLINE_ uint8_t *data() { return ((uint8_t *)this) + sizeof(Chunk); }
+	};
+
+	struct Header {
+		uint64_t size;
+		uint32_t kind;
+		uint32_t scope; // Serial of the scope the allocation belongs to, 0 for heap.
+	};
+
+	enum {
+		KIND_ARENA = 0xA4E7A001,
+		KIND_HEAP = 0xA4E7A002,
+	};
+
+	struct ThreadState {
+		Chunk *current = nullptr;
+		Chunk *spare = nullptr;
+		uint32_t spare_count = 0;
+		uint32_t scope_depth = 0;
+		uint32_t last_scope_serial = 0;
+		ArenaScope *scope = nullptr; // Innermost open scope.
+		size_t in_use = 0;
+		Stats stats;
+
+		~ThreadState();
+	};
+
+	static thread_local ThreadState state;
+	// Kept apart from the state so Memory can query it without going through
+	// the TLS initialization guard, even during thread teardown.
+	static thread_local MemoryCounters *counters;
+
+	static_assert(sizeof(Header) == ALIGN, "Arena header must keep allocations aligned.");
+	static_assert(sizeof(Chunk) % ALIGN == 0, "Arena chunk header must keep allocations aligned.");
+
+	static Chunk *_acquire_chunk(size_t p_min_size);
+	static void _release_chunk(Chunk *p_chunk);
+	static void *_alloc_heap(size_t p_bytes);
+	static bool _is_scope_open(uint32_t p_serial);
+
+	friend class ArenaScope;
+
+public:
+	struct Mark {
+		void *chunk = nullptr;
+		size_t used = 0;
+		size_t in_use = 0;
+	};
+
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_memory, size_t p_bytes);
+	static void free(void *p_memory);
+
+	// Returns true if the pointer was served from this thread's arena.
+	static bool owns(const void *p_memory);
+	static bool is_active() { return state.scope_depth > 0; }
+
+	static Mark get_mark();
+	static void rewind(const Mark &p_mark);
+
+	// Reclaims everything allocated on this thread's arena and gives back all
+	// spare chunks but one. Called once per frame by the main loop; worker
+	// threads call it when they go idle. Does nothing while a scope is open.
+	static void frame_reset();
+
+	static Stats get_stats() { return state.stats; }
+	static MemoryCounters *get_counters() { return counters; }
+};
+
+// Opens an arena scope on the current thread. Everything allocated through
+// ThreadArena while the scope is alive is released when it goes out of scope.
+// Optionally attributes all allocations made meanwhile to a counter set.
+class ArenaScope {
+	ThreadArena::Mark mark;
+	MemoryCounters *prev_counters = nullptr;
+	ArenaScope *prev = nullptr;
+	uint32_t serial = 0;
+
+	friend class ThreadArena;
+
+public:
+	ArenaScope(MemoryCounters *p_counters = nullptr);
+	~ArenaScope();
+};
+
+// Allocator adapter for LocalVector and other containers taking a static allocator.
+class ArenaAllocator {
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return ThreadArena::alloc(p_memory); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return ThreadArena::realloc(p_ptr, p_memory); }
+	_FORCE_INLINE_ static void free(void *p_ptr) { ThreadArena::free(p_ptr); }
+};
+
+// Allocator adapter for HashMap and other containers taking a typed allocator.
+template <class T>
+class ArenaTypedAllocator {
+public:
+	template <class... Args>
+	_FORCE_INLINE_ T *new_allocation(const Args &&...p_args) {
+		return memnew_placement(ThreadArena::alloc(sizeof(T)), T(p_args...));
+	}
+	_FORCE_INLINE_ void delete_allocation(T *p_allocation) {
+		p_allocation->~T();
+		ThreadArena::free(p_allocation);
+	}
+};
+
+#endif // ARENA_ALLOCATOR_H
@@ -31,6 +31,7 @@
 #include "memory.h"
 
 #include "core/error/error_macros.h"
+#include "core/os/arena_allocator.h"
 #include "core/templates/safe_refcount.h"
 
 #include <stdio.h>
@@ -78,6 +79,14 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 
 	alloc_count.increment();
 
+#ifdef DEBUG_ENABLED
+	MemoryCounters *counters = ThreadArena::get_counters();
+	if (counters) {
+		counters->heap_allocs.increment();
+		counters->heap_bytes.add(p_bytes);
+	}
+#endif
+
 	if (prepad) {
 		uint64_t *s = (uint64_t *)mem;
 		*s = p_bytes;
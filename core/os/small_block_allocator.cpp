@@ -0,0 +1,186 @@
+/*************************************************************************/
+/*  small_block_allocator.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "small_block_allocator.h"
+
+#include "core/os/arena_allocator.h"
+
+#include <stdlib.h>
+
+SmallBlockAllocator::SizeClass SmallBlockAllocator::size_classes[SmallBlockAllocator::CLASS_COUNT];
+thread_local SmallBlockAllocator::ThreadCache SmallBlockAllocator::cache;
+thread_local bool SmallBlockAllocator::cache_released = false;
+
+SmallBlockAllocator::ThreadCache::~ThreadCache() {
+	for (int i = 0; i < CLASS_COUNT; i++) {
+		if (!blocks[i]) {
+			continue;
+		}
+		FreeBlock *last = blocks[i];
+		while (last->next) {
+			last = last->next;
+		}
+		_give(i, blocks[i], last, count[i]);
+		blocks[i] = nullptr;
+		count[i] = 0;
+	}
+	cache_released = true;
+}
+
+SmallBlockAllocator::FreeBlock *SmallBlockAllocator::_take(int p_class, uint32_t p_count, uint32_t &r_taken) {
+	SizeClass &sc = size_classes[p_class];
+	const size_t block_size = _get_block_size(p_class);
+	FreeBlock *first = nullptr;
+	r_taken = 0;
+
+	sc.lock.lock();
+
+	while (r_taken < p_count && sc.free_list) {
+		FreeBlock *block = sc.free_list;
+		sc.free_list = block->next;
+		sc.free_count--;
+		block->next = first;
+		first = block;
+		r_taken++;
+	}
+
+	while (r_taken < p_count) {
+		if (sc.slab_pos + block_size > sc.slab_end) {
+			// Slabs are never given back, freed blocks are recycled through the free
+			// lists. They are not reported as static memory, the blocks in use are.
+			uint8_t *slab = (uint8_t *)malloc(SLAB_SIZE);
+			if (!slab) {
+				break;
+			}
+			sc.slab_pos = slab;
+			sc.slab_end = slab + SLAB_SIZE;
+			sc.slabs++;
+		}
+		FreeBlock *block = (FreeBlock *)sc.slab_pos;
+		sc.slab_pos += block_size;
+		block->next = first;
+		first = block;
+		r_taken++;
+	}
+
+	sc.lock.unlock();
+
+	return first;
+}
+
+void SmallBlockAllocator::_give(int p_class, FreeBlock *p_first, FreeBlock *p_last, uint32_t p_count) {
+	SizeClass &sc = size_classes[p_class];
+
+	sc.lock.lock();
+	p_last->next = sc.free_list;
+	sc.free_list = p_first;
+	sc.free_count += p_count;
+	sc.lock.unlock();
+}
+
+void *SmallBlockAllocator::alloc(size_t p_size) {
+	const int size_class = _get_class(p_size);
+	FreeBlock *block = nullptr;
+
+	if (likely(!cache_released)) {
+		ThreadCache &tc = cache;
+		if (unlikely(!tc.blocks[size_class])) {
+			tc.blocks[size_class] = _take(size_class, CACHE_SIZE / 2, tc.count[size_class]);
+			ERR_FAIL_COND_V(!tc.blocks[size_class], nullptr);
+		}
+		block = tc.blocks[size_class];
+		tc.blocks[size_class] = block->next;
+		tc.count[size_class]--;
+	} else {
+		uint32_t taken = 0;
+		block = _take(size_class, 1, taken);
+		ERR_FAIL_COND_V(!block, nullptr);
+	}
+
+#ifdef DEBUG_ENABLED
+	uint64_t new_mem_usage = Memory::mem_usage.add(get_capacity(p_size));
+	Memory::max_usage.exchange_if_greater(new_mem_usage);
+
+	MemoryCounters *counters = ThreadArena::get_counters();
+	if (counters) {
+		counters->pool_allocs.increment();
+		counters->pool_bytes.add(p_size);
+	}
+#endif
+
+	return ((uint8_t *)block) + PAD_ALIGN;
+}
+
+void SmallBlockAllocator::free(void *p_ptr, size_t p_size) {
+	ERR_FAIL_COND(p_ptr == nullptr);
+
+	const int size_class = _get_class(p_size);
+	FreeBlock *block = (FreeBlock *)(((uint8_t *)p_ptr) - PAD_ALIGN);
+
+#ifdef DEBUG_ENABLED
+	Memory::mem_usage.sub(get_capacity(p_size));
+#endif
+
+	if (unlikely(cache_released)) {
+		_give(size_class, block, block, 1);
+		return;
+	}
+
+	ThreadCache &tc = cache;
+	block->next = tc.blocks[size_class];
+	tc.blocks[size_class] = block;
+	tc.count[size_class]++;
+
+	if (unlikely(tc.count[size_class] > CACHE_SIZE)) {
+		// Hand half of the cache back, so blocks freed here can be reused by the
+		// threads allocating them.
+		FreeBlock *first = tc.blocks[size_class];
+		FreeBlock *last = first;
+		for (uint32_t i = 1; i < CACHE_SIZE / 2; i++) {
+			last = last->next;
+		}
+		tc.blocks[size_class] = last->next;
+		tc.count[size_class] -= CACHE_SIZE / 2;
+		_give(size_class, first, last, CACHE_SIZE / 2);
+	}
+}
+
+SmallBlockAllocator::Stats SmallBlockAllocator::get_stats() {
+	Stats stats;
+	for (int i = 0; i < CLASS_COUNT; i++) {
+		SizeClass &sc = size_classes[i];
+		sc.lock.lock();
+		stats.slabs += sc.slabs;
+		stats.slab_bytes += uint64_t(sc.slabs) * SLAB_SIZE;
+		stats.free_blocks += sc.free_count;
+		sc.lock.unlock();
+	}
+	return stats;
+}
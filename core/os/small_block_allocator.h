@@ -0,0 +1,110 @@
+/*************************************************************************/
+/*  small_block_allocator.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SMALL_BLOCK_ALLOCATOR_H
+#define SMALL_BLOCK_ALLOCATOR_H
+
+#include "core/os/memory.h"
+#include "core/os/spin_lock.h"
+
+// Pooled allocator for the small payloads that dominate CowData traffic, such
+// as short Strings and Vectors of a few elements.
+//
+// Blocks are handed out with a PAD_ALIGN prefix, exactly like
+// Memory::alloc_static(size, true), so callers can keep their headers in front
+// of the data. Blocks are grouped in power of two size classes carved from
+// shared slabs, with a per-thread cache in front so the common alloc/free pair
+// neither locks nor reaches malloc. Blocks may be freed from any thread. The
+// caller must pass the same size to free() that it passed to alloc().
+class SmallBlockAllocator {
+public:
+	enum {
+		MIN_SIZE = 16,
+		MAX_SIZE = 128,
+		CLASS_COUNT = 4,
+		SLAB_SIZE = 64 * 1024,
+		CACHE_SIZE = 64,
+	};
+
+	struct Stats {
+		uint64_t slabs = 0;
+		uint64_t slab_bytes = 0;
+		uint64_t free_blocks = 0;
+	};
+
+private:
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	struct SizeClass {
+		SpinLock lock;
+		FreeBlock *free_list = nullptr;
+		uint32_t free_count = 0;
+		uint8_t *slab_pos = nullptr;
+		uint8_t *slab_end = nullptr;
+		uint32_t slabs = 0;
+	};
+
+	struct ThreadCache {
+		FreeBlock *blocks[CLASS_COUNT] = {};
+		uint32_t count[CLASS_COUNT] = {};
+
+		~ThreadCache();
+	};
+
+	static SizeClass size_classes[CLASS_COUNT];
+	static thread_local ThreadCache cache;
+	// Trivially destructible, so it can still be checked while the thread (or
+	// the process) is being torn down and the cache is gone.
+	static thread_local bool cache_released;
+
+	static _FORCE_INLINE_ int _get_class(size_t p_size) {
+		return p_size <= 16 ? 0 : (p_size <= 32 ? 1 : (p_size <= 64 ? 2 : 3));
+	}
+	static _FORCE_INLINE_ size_t _get_block_size(int p_class) {
+		return PAD_ALIGN + (size_t(MIN_SIZE) << p_class);
+	}
+
+	static FreeBlock *_take(int p_class, uint32_t p_count, uint32_t &r_taken);
+	static void _give(int p_class, FreeBlock *p_first, FreeBlock *p_last, uint32_t p_count);
+
+public:
+	_FORCE_INLINE_ static bool is_small(size_t p_size) { return p_size <= MAX_SIZE; }
+	// Usable bytes of the block serving an allocation of the given size.
+	_FORCE_INLINE_ static size_t get_capacity(size_t p_size) { return size_t(MIN_SIZE) << _get_class(p_size); }
+
+	static void *alloc(size_t p_size);
+	static void free(void *p_ptr, size_t p_size);
+
+	static Stats get_stats();
+};
+
+#endif // SMALL_BLOCK_ALLOCATOR_H
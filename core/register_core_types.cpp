@@ -45,6 +45,7 @@
 #include "core/input/shortcut.h"
 #include "core/io/config_file.h"
 #include "core/io/dtls_server.h"
+#include "core/io/file_access_async.h"
 #include "core/io/http_client.h"
 #include "core/io/image_loader.h"
 #include "core/io/json.h"
@@ -56,12 +57,14 @@
 #include "core/io/packet_peer_udp.h"
 #include "core/io/pck_packer.h"
 #include "core/io/resource_format_binary.h"
+#include "core/io/resource_import_cache.h"
 #include "core/io/resource_importer.h"
 #include "core/io/resource_uid.h"
 #include "core/io/stream_peer_ssl.h"
 #include "core/io/tcp_server.h"
 #include "core/io/translation_loader_po.h"
 #include "core/io/udp_server.h"
+#include "core/io/variant_schema.h"
 #include "core/io/xml_parser.h"
 #include "core/math/a_star.h"
 #include "core/math/expression.h"
@@ -74,6 +77,7 @@
 #include "core/object/class_db.h"
 #include "core/object/script_language_extension.h"
 #include "core/object/undo_redo.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/main_loop.h"
 #include "core/os/time.h"
 #include "core/string/optimized_translation.h"
@@ -110,6 +114,8 @@ extern void unregister_global_constants();
 
 static ResourceUID *resource_uid = nullptr;
 
+static WorkerThreadPool *worker_thread_pool = nullptr;
+
 static bool _is_core_extensions_registered = false;
 
 void register_core_types() {
@@ -121,6 +127,9 @@ void register_core_types() {
 	StringName::setup();
 	ResourceLoader::initialize();
 
+	worker_thread_pool = memnew(WorkerThreadPool);
+	FileAccessAsync::initialize();
+
 	register_global_constants();
 
 	Variant::register_types();
@@ -227,6 +236,8 @@ void register_core_types() {
 
 	GDREGISTER_CLASS(XMLParser);
 	GDREGISTER_CLASS(JSON);
+	GDREGISTER_CLASS(JSONReader);
+	GDREGISTER_CLASS(JSONWriter);
 
 	GDREGISTER_CLASS(ConfigFile);
 
@@ -237,9 +248,11 @@ void register_core_types() {
 	GDREGISTER_CLASS(AStar3D);
 	GDREGISTER_CLASS(AStar2D);
 	GDREGISTER_CLASS(EncodedObjectAsID);
+	GDREGISTER_CLASS(VariantSchema);
 	GDREGISTER_CLASS(RandomNumberGenerator);
 
 	GDREGISTER_ABSTRACT_CLASS(ResourceImporter);
+	GDREGISTER_CLASS(ResourceImportCache);
 
 	GDREGISTER_CLASS(NativeExtension);
 
@@ -301,6 +314,7 @@ void register_core_singletons() {
 	GDREGISTER_CLASS(Expression);
 	GDREGISTER_CLASS(core_bind::EngineDebugger);
 	GDREGISTER_CLASS(Time);
+	GDREGISTER_ABSTRACT_CLASS(WorkerThreadPool);
 
 	Engine::get_singleton()->add_singleton(Engine::Singleton("ProjectSettings", ProjectSettings::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("IP", IP::get_singleton(), "IP"));
@@ -319,6 +333,7 @@ void register_core_singletons() {
 	Engine::get_singleton()->add_singleton(Engine::Singleton("Time", Time::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("NativeExtensionManager", NativeExtensionManager::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("ResourceUID", ResourceUID::get_singleton()));
+	Engine::get_singleton()->add_singleton(Engine::Singleton("WorkerThreadPool", worker_thread_pool));
 }
 
 void register_core_extensions() {
@@ -336,6 +351,9 @@ void unregister_core_extensions() {
 }
 
 void unregister_core_types() {
+	FileAccessAsync::finalize();
+	memdelete(worker_thread_pool);
+
 	memdelete(native_extension_manager);
 
 	memdelete(resource_uid);
@@ -386,6 +404,7 @@ void unregister_core_types() {
 
 	unregister_global_constants();
 
+	Callable::clear_call_cache();
 	ClassDB::cleanup();
 	ResourceCache::clear();
 	CoreStringNames::free();
@@ -40,18 +40,45 @@ StaticCString StaticCString::create(const char *p_ptr) {
 }
 
 StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+StringName::_Shard StringName::_shards[STRING_TABLE_SHARD_COUNT];
 
 StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex StringName::mutex;
 
 #ifdef DEBUG_ENABLED
 bool StringName::debug_stringname = false;
 #endif
 
+bool StringName::_Data::name_equals(const char *p_name) const {
+	if (cname) {
+		return strcmp(cname, p_name) == 0;
+	}
+	return name == p_name;
+}
+
+bool StringName::_Data::name_equals(const char32_t *p_name) const {
+	if (!cname) {
+		return name == p_name;
+	}
+	// Same per-character conversion as String::copy_from(const char *).
+	const char *c = cname;
+	while (*c && *p_name) {
+		if (char32_t(uint8_t(*c)) != *p_name) {
+			return false;
+		}
+		c++;
+		p_name++;
+	}
+	return *c == 0 && *p_name == 0;
+}
+
+bool StringName::_Data::name_equals(const String &p_name) const {
+	return cname ? p_name == cname : p_name == name;
+}
+
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
@@ -61,7 +88,8 @@ void StringName::setup() {
 }
 
 void StringName::cleanup() {
-	MutexLock lock(mutex);
+	// Called on shutdown, once no other thread can be interning names anymore,
+	// so the shard locks are not taken (printing below may create StringNames).
 
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
@@ -80,10 +108,10 @@ void StringName::cleanup() {
 		int unreferenced_stringnames = 0;
 		int rarely_referenced_stringnames = 0;
 		for (int i = 0; i < data.size(); i++) {
-			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references));
-			if (data[i]->debug_references == 0) {
+			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references.get()));
+			if (data[i]->debug_references.get() == 0) {
 				unreferenced_stringnames += 1;
-			} else if (data[i]->debug_references < 5) {
+			} else if (data[i]->debug_references.get() < 5) {
 				rarely_referenced_stringnames += 1;
 			}
 		}
@@ -92,6 +120,11 @@ void StringName::cleanup() {
 		print_line(vformat("Out of %d StringNames, %d StringNames were rarely referenced during this run (1-4 times) (%.2f%%).", data.size(), rarely_referenced_stringnames, rarely_referenced_stringnames / float(data.size()) * 100));
 	}
 #endif
+	if (OS::get_singleton() && OS::get_singleton()->is_stdout_verbose()) {
+		TableStats stats = get_table_stats();
+		print_line(vformat("StringName: %d names in %d buckets (longest chain: %d), %d inserts, %d lock contentions.", stats.entries, stats.buckets_used, stats.longest_chain, stats.inserts, stats.lock_contentions));
+	}
+
 	int lost_strings = 0;
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
 		while (_table[i]) {
@@ -112,6 +145,9 @@ void StringName::cleanup() {
 			memdelete(d);
 		}
 	}
+	for (int i = 0; i < STRING_TABLE_SHARD_COUNT; i++) {
+		_shards[i].entries.set(0);
+	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
@@ -122,7 +158,8 @@ void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		_Shard &shard = _get_shard(_data->idx);
+		shard.write_lock();
 
 		if (_data->static_count.get() > 0) {
 			if (_data->cname) {
@@ -143,12 +180,124 @@ void StringName::unref() {
 		if (_data->next) {
 			_data->next->prev = _data->prev;
 		}
+		shard.entries.decrement();
+		shard.write_unlock();
+
+		// Nobody else can reach it anymore once unlinked.
 		memdelete(_data);
 	}
 
 	_data = nullptr;
 }
 
+// Must be called with the shard of p_idx locked (for reading or writing).
+// Entries whose refcount already dropped to zero are being removed by another
+// thread and are skipped, so a new entry gets created for the same name.
+template <class T>
+StringName::_Data *StringName::_find_and_ref(uint32_t p_idx, uint32_t p_hash, const T &p_name) {
+	_Data *d = _table[p_idx];
+	while (d) {
+		// compare hash first
+		if (d->hash == p_hash && d->name_equals(p_name) && d->refcount.ref()) {
+			return d;
+		}
+		d = d->next;
+	}
+	return nullptr;
+}
+
+template <class T>
+bool StringName::_intern_existing(uint32_t p_idx, uint32_t p_hash, const T &p_name, bool p_static) {
+	_data = _find_and_ref(p_idx, p_hash, p_name);
+	if (!_data) {
+		return false;
+	}
+
+	// exists
+	if (p_static) {
+		_data->static_count.increment();
+	}
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		_data->debug_references.increment();
+	}
+#endif
+	return true;
+}
+
+// Links _data (with its name already set) at the head of its bucket, the shard
+// must be write locked.
+void StringName::_insert(uint32_t p_idx, uint32_t p_hash, bool p_static) {
+	_data->refcount.init();
+	_data->static_count.set(p_static ? 1 : 0);
+	_data->hash = p_hash;
+	_data->idx = p_idx;
+	_data->next = _table[p_idx];
+	_data->prev = nullptr;
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		// Keep in memory, force static.
+		_data->refcount.ref();
+		_data->static_count.increment();
+	}
+#endif
+	if (_table[p_idx]) {
+		_table[p_idx]->prev = _data;
+	}
+	_table[p_idx] = _data;
+
+	_Shard &shard = _get_shard(p_idx);
+	shard.entries.increment();
+	shard.inserts.increment();
+}
+
+template <class T>
+StringName StringName::_search(const T &p_name, uint32_t p_hash, bool p_count_reference) {
+	uint32_t idx = p_hash & STRING_TABLE_MASK;
+	_Shard &shard = _get_shard(idx);
+
+	shard.read_lock();
+	_Data *d = _find_and_ref(idx, p_hash, p_name);
+	shard.read_unlock();
+
+	if (!d) {
+		return StringName(); //does not exist
+	}
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname) && p_count_reference) {
+		d->debug_references.increment();
+	}
+#endif
+	return StringName(d);
+}
+
+StringName::TableStats StringName::get_table_stats() {
+	TableStats stats;
+	const uint32_t buckets_per_shard = STRING_TABLE_LEN / STRING_TABLE_SHARD_COUNT;
+
+	for (uint32_t i = 0; i < STRING_TABLE_SHARD_COUNT; i++) {
+		_Shard &shard = _shards[i];
+		stats.inserts += shard.inserts.get();
+		stats.lock_contentions += shard.contentions.get();
+
+		shard.read_lock();
+		stats.entries += shard.entries.get();
+		for (uint32_t j = i * buckets_per_shard; j < (i + 1) * buckets_per_shard; j++) {
+			uint32_t chain = 0;
+			for (const _Data *d = _table[j]; d; d = d->next) {
+				chain++;
+			}
+			if (chain) {
+				stats.buckets_used++;
+				stats.longest_chain = MAX(stats.longest_chain, chain);
+			}
+		}
+		shard.read_unlock();
+	}
+
+	return stats;
+}
+
 bool StringName::operator==(const String &p_name) const {
 	if (!_data) {
 		return (p_name.length() == 0);
@@ -206,59 +355,25 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
+	_Shard &shard = _get_shard(idx);
 
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-		}
-
+	shard.read_lock();
+	bool found = _intern_existing(idx, hash, p_name, p_static);
+	shard.read_unlock();
+	if (found) {
 		return;
 	}
 
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
+	shard.write_lock();
+	// Check again, another thread may have added it while unlocked.
+	if (!_intern_existing(idx, hash, p_name, p_static)) {
+		_data = memnew(_Data);
+		_data->name = p_name;
+		_insert(idx, hash, p_static);
 	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	shard.write_unlock();
 }
 
 StringName::StringName(const StaticCString &p_static_string, bool p_static) {
@@ -268,57 +383,24 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_static_string.ptr);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
+	_Shard &shard = _get_shard(idx);
 
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-			return;
-		}
+	shard.read_lock();
+	bool found = _intern_existing(idx, hash, p_static_string.ptr, p_static);
+	shard.read_unlock();
+	if (found) {
+		return;
 	}
 
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
+	shard.write_lock();
+	if (!_intern_existing(idx, hash, p_static_string.ptr, p_static)) {
+		_data = memnew(_Data);
+		_data->cname = p_static_string.ptr;
+		_insert(idx, hash, p_static);
 	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	shard.write_unlock();
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -330,56 +412,24 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
 	uint32_t idx = hash & STRING_TABLE_MASK;
+	_Shard &shard = _get_shard(idx);
 
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
+	shard.read_lock();
+	bool found = _intern_existing(idx, hash, p_name, p_static);
+	shard.read_unlock();
+	if (found) {
+		return;
 	}
-#endif
 
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+	shard.write_lock();
+	if (!_intern_existing(idx, hash, p_name, p_static)) {
+		_data = memnew(_Data);
+		_data->name = p_name;
+		_insert(idx, hash, p_static);
 	}
-	_table[idx] = _data;
+	shard.write_unlock();
 }
 
 StringName StringName::search(const char *p_name) {
@@ -390,32 +440,7 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-
-		return StringName(_data);
-	}
-
-	return StringName(); //does not exist
+	return _search(p_name, String::hash(p_name), true);
 }
 
 StringName StringName::search(const char32_t *p_name) {
@@ -426,58 +451,13 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
-	}
-
-	return StringName(); //does not exist
+	return _search(p_name, String::hash(p_name), false);
 }
 
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return StringName(_data);
-	}
-
-	return StringName(); //does not exist
+	return _search(p_name, p_name.hash(), true);
 }
 
 bool operator==(const String &p_name, const StringName &p_string_name) {
@@ -32,6 +32,7 @@
 #define STRING_NAME_H
 
 #include "core/os/mutex.h"
+#include "core/os/rw_lock.h"
 #include "core/string/ustring.h"
 #include "core/templates/safe_refcount.h"
 
@@ -48,7 +49,9 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARD_COUNT = 1 << STRING_TABLE_SHARD_BITS,
 	};
 
 	struct _Data {
@@ -57,9 +60,12 @@ class StringName {
 		const char *cname = nullptr;
 		String name;
 #ifdef DEBUG_ENABLED
-		uint32_t debug_references = 0;
+		SafeNumeric<uint32_t> debug_references;
 #endif
 		String get_name() const { return cname ? String(cname) : name; }
+		bool name_equals(const char *p_name) const;
+		bool name_equals(const char32_t *p_name) const;
+		bool name_equals(const String &p_name) const;
 		int idx = 0;
 		uint32_t hash = 0;
 		_Data *prev = nullptr;
@@ -69,6 +75,38 @@ class StringName {
 
 	static _Data *_table[STRING_TABLE_LEN];
 
+	// The table is split in shards, each guarding a contiguous range of buckets
+	// with its own lock. Looking up names that are already interned only takes
+	// a read lock, so threads only serialize when inserting or removing names
+	// that land in the same shard.
+	struct alignas(64) _Shard {
+		RWLock lock;
+		SafeNumeric<uint32_t> entries;
+		SafeNumeric<uint64_t> inserts;
+		SafeNumeric<uint64_t> contentions;
+
+		_FORCE_INLINE_ void read_lock() {
+			if (unlikely(lock.read_try_lock() != OK)) {
+				contentions.increment();
+				lock.read_lock();
+			}
+		}
+		_FORCE_INLINE_ void read_unlock() { lock.read_unlock(); }
+		_FORCE_INLINE_ void write_lock() {
+			if (unlikely(lock.write_try_lock() != OK)) {
+				contentions.increment();
+				lock.write_lock();
+			}
+		}
+		_FORCE_INLINE_ void write_unlock() { lock.write_unlock(); }
+	};
+
+	static _Shard _shards[STRING_TABLE_SHARD_COUNT];
+
+	static _FORCE_INLINE_ _Shard &_get_shard(uint32_t p_idx) {
+		return _shards[p_idx >> (STRING_TABLE_BITS - STRING_TABLE_SHARD_BITS)];
+	}
+
 	_Data *_data = nullptr;
 
 	union _HashUnion {
@@ -76,18 +114,25 @@ class StringName {
 		uint32_t hash;
 	};
 
+	template <class T>
+	static _Data *_find_and_ref(uint32_t p_idx, uint32_t p_hash, const T &p_name);
+	template <class T>
+	bool _intern_existing(uint32_t p_idx, uint32_t p_hash, const T &p_name, bool p_static);
+	void _insert(uint32_t p_idx, uint32_t p_hash, bool p_static);
+	template <class T>
+	static StringName _search(const T &p_name, uint32_t p_hash, bool p_count_reference);
+
 	void unref();
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
 	static void setup();
 	static void cleanup();
 	static bool configured;
 #ifdef DEBUG_ENABLED
 	struct DebugSortReferences {
 		bool operator()(const _Data *p_left, const _Data *p_right) const {
-			return p_left->debug_references > p_right->debug_references;
+			return p_left->debug_references.get() > p_right->debug_references.get();
 		}
 	};
 
@@ -149,6 +194,18 @@ public:
 	static StringName search(const char32_t *p_name);
 	static StringName search(const String &p_name);
 
+	struct TableStats {
+		uint32_t entries = 0;
+		uint32_t buckets_used = 0;
+		uint32_t longest_chain = 0;
+		uint64_t inserts = 0;
+		uint64_t lock_contentions = 0;
+	};
+
+	// Snapshot of the intern table occupancy, plus how many names were inserted
+	// and how many times a thread had to wait for a shard lock since startup.
+	static TableStats get_table_stats();
+
 	struct AlphCompare {
 		_FORCE_INLINE_ bool operator()(const StringName &l, const StringName &r) const {
 			const char *l_cname = l._data ? l._data->cname : "";
@@ -0,0 +1,589 @@
+/*************************************************************************/
+/*  compact_hash_map.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef COMPACT_HASH_MAP_H
+#define COMPACT_HASH_MAP_H
+
+#include "core/math/math_funcs.h"
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/pair.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * An insertion ordered HashMap with a compact memory layout.
+ *
+ * Entries are stored inplace in slot blocks that are never moved: the first
+ * block holds SMALL_SIZE entries and every further block doubles the capacity.
+ * An order array lists the slots in insertion order, and a separate table of
+ * 32-bit slot indices is used for lookups (with linear probing). Up to
+ * SMALL_SIZE entries no index table is allocated at all, lookups just scan the
+ * entries comparing hashes first.
+ *
+ * Compared to HashMap, there is no allocation per element: a map with up to
+ * SMALL_SIZE elements uses two allocations. Erased slots are reused by later
+ * insertions, and holes in the order array are compacted when it fills up, so
+ * erasing (also while iterating) does not move other elements.
+ *
+ * As with HashMap, pointers to keys and values stay valid until the element
+ * is erased or the map is cleared, also when inserting new keys. Iteration
+ * order is the insertion order.
+ *
+ * The assignment operator copy the pairs from one map to the other.
+ */
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class CompactHashMap {
+public:
+	static constexpr uint32_t SMALL_SIZE = 8;
+
+private:
+	static constexpr uint32_t DELETED_HASH = 0;
+	static constexpr uint32_t EMPTY_INDEX = UINT32_MAX;
+
+	struct Entry {
+		KeyValue<TKey, TValue> data;
+		uint32_t hash = DELETED_HASH;
+		uint32_t order_pos = 0; // Next erased slot once the entry is erased.
+		Entry(const TKey &p_key, const TValue &p_value, uint32_t p_hash, uint32_t p_order_pos) :
+				data(p_key, p_value),
+				hash(p_hash),
+				order_pos(p_order_pos) {}
+	};
+
+	// Block 0 has SMALL_SIZE slots, block N has SMALL_SIZE << (N - 1).
+	// The block table and the order array share a single allocation.
+	Entry **blocks = nullptr;
+	uint32_t *order = nullptr;
+	uint32_t *indices = nullptr;
+
+	uint32_t block_count = 0;
+	uint32_t capacity = 0; // Allocated slots.
+	uint32_t slots_used = 0; // Slots handed out at least once.
+	uint32_t free_slot = EMPTY_INDEX; // Last erased slot, erased slots are linked through order_pos.
+	uint32_t order_used = 0; // Order positions in use, including erased ones.
+	uint32_t num_elements = 0;
+	uint32_t index_used = 0; // Index slots in use, including tombstones.
+	uint32_t index_mask = 0;
+
+	static _FORCE_INLINE_ uint32_t _clz(uint32_t p_value) {
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_clz(p_value);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, p_value);
+		return 31 - index;
+#else
+		uint32_t count = 0;
+		while (!(p_value & 0x80000000)) {
+			p_value <<= 1;
+			count++;
+		}
+		return count;
+#endif
+	}
+
+	_FORCE_INLINE_ Entry &_get_entry(uint32_t p_slot) const {
+		if (p_slot < SMALL_SIZE) {
+			return blocks[0][p_slot];
+		}
+		const uint32_t block = 32 - _clz(p_slot / SMALL_SIZE);
+		return blocks[block][p_slot - (SMALL_SIZE << (block - 1))];
+	}
+
+	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
+		uint32_t hash = Hasher::hash(p_key);
+
+		if (unlikely(hash == DELETED_HASH)) {
+			hash = DELETED_HASH + 1;
+		}
+
+		return hash;
+	}
+
+	_FORCE_INLINE_ bool _lookup_slot(const TKey &p_key, uint32_t p_hash, uint32_t &r_slot) const {
+		if (indices == nullptr) {
+			const Entry *entries = blocks[0];
+			for (uint32_t i = 0; i < slots_used; i++) {
+				if (entries[i].hash == p_hash && Comparator::compare(entries[i].data.key, p_key)) {
+					r_slot = i;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Index slots of erased entries keep pointing to them. Their hash never
+		// matches, or they were reused by another key which gets compared as
+		// usual, so they act as tombstones until the next rebuild.
+		uint32_t pos = p_hash & index_mask;
+		while (indices[pos] != EMPTY_INDEX) {
+			const Entry &e = _get_entry(indices[pos]);
+			if (e.hash == p_hash && Comparator::compare(e.data.key, p_key)) {
+				r_slot = indices[pos];
+				return true;
+			}
+			pos = (pos + 1) & index_mask;
+		}
+		return false;
+	}
+
+	_FORCE_INLINE_ bool _lookup_slot(const TKey &p_key, uint32_t &r_slot) const {
+		if (num_elements == 0) {
+			return false;
+		}
+		return _lookup_slot(p_key, _hash(p_key), r_slot);
+	}
+
+	void _rebuild_index() {
+		// Keep the index table at most 2/3 full.
+		const uint32_t index_size = next_power_of_2(capacity + capacity / 2);
+		if (index_size != index_mask + 1 || indices == nullptr) {
+			if (indices != nullptr) {
+				Memory::free_static(indices);
+			}
+			indices = static_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * index_size));
+			index_mask = index_size - 1;
+		}
+		memset(indices, 0xFF, sizeof(uint32_t) * index_size);
+		index_used = 0;
+
+		for (uint32_t i = 0; i < order_used; i++) {
+			if (order[i] != EMPTY_INDEX) {
+				_index_insert(_get_entry(order[i]).hash, order[i]);
+			}
+		}
+	}
+
+	_FORCE_INLINE_ void _index_insert(uint32_t p_hash, uint32_t p_slot) {
+		if (unlikely((index_used + 1) * 3 > (index_mask + 1) * 2)) {
+			_rebuild_index(); // Too many tombstones.
+		}
+		uint32_t pos = p_hash & index_mask;
+		while (indices[pos] != EMPTY_INDEX) {
+			pos = (pos + 1) & index_mask;
+		}
+		indices[pos] = p_slot;
+		index_used++;
+	}
+
+	// Adds a block of slots. Existing entries are never moved, only the block
+	// table, the order array and the index table get reallocated.
+	void _add_block() {
+		const uint32_t block_size = block_count == 0 ? SMALL_SIZE : SMALL_SIZE << (block_count - 1);
+		const uint32_t new_capacity = capacity + block_size;
+
+		Entry **new_blocks = static_cast<Entry **>(Memory::alloc_static(sizeof(Entry *) * (block_count + 1) + sizeof(uint32_t) * new_capacity));
+		uint32_t *new_order = reinterpret_cast<uint32_t *>(new_blocks + block_count + 1);
+		if (blocks != nullptr) {
+			memcpy(new_blocks, blocks, sizeof(Entry *) * block_count);
+			memcpy(new_order, order, sizeof(uint32_t) * order_used);
+			Memory::free_static(blocks);
+		}
+		new_blocks[block_count] = static_cast<Entry *>(Memory::alloc_static(sizeof(Entry) * block_size));
+
+		blocks = new_blocks;
+		order = new_order;
+		block_count++;
+		capacity = new_capacity;
+
+		if (capacity > SMALL_SIZE) {
+			_rebuild_index();
+		}
+	}
+
+	// Drops erased positions from the order array. Only the order array and the
+	// order_pos of live entries change.
+	void _compact_order() {
+		uint32_t new_used = 0;
+		for (uint32_t i = 0; i < order_used; i++) {
+			if (order[i] != EMPTY_INDEX) {
+				_get_entry(order[i]).order_pos = new_used;
+				order[new_used++] = order[i];
+			}
+		}
+		order_used = new_used;
+	}
+
+	uint32_t _insert(const TKey &p_key, const TValue &p_value) {
+		const uint32_t hash = _hash(p_key);
+		uint32_t slot = 0;
+		if (num_elements && _lookup_slot(p_key, hash, slot)) {
+			_get_entry(slot).data.value = p_value;
+			return slot;
+		}
+
+		if (unlikely(order_used == capacity)) {
+			// Grow unless enough erased positions can be reclaimed.
+			if (num_elements + 1 > capacity / 2) {
+				_add_block();
+			} else {
+				_compact_order();
+			}
+		}
+
+		if (free_slot != EMPTY_INDEX) {
+			slot = free_slot;
+			free_slot = _get_entry(slot).order_pos;
+		} else {
+			slot = slots_used++;
+		}
+
+		const uint32_t pos = order_used;
+		memnew_placement(&_get_entry(slot), Entry(p_key, p_value, hash, pos));
+		if (indices) {
+			_index_insert(hash, slot); // May rebuild from the order array, so insert first.
+		}
+		order[pos] = slot;
+		order_used++;
+		num_elements++;
+		return slot;
+	}
+
+	_FORCE_INLINE_ uint32_t _next_live(uint32_t p_pos) const {
+		while (p_pos < order_used && order[p_pos] == EMPTY_INDEX) {
+			p_pos++;
+		}
+		return MIN(p_pos, order_used); // Erasing may have shrunk the array while iterating.
+	}
+
+	_FORCE_INLINE_ uint32_t _prev_live(uint32_t p_pos) const {
+		while (p_pos > 0) {
+			p_pos--;
+			if (p_pos < order_used && order[p_pos] != EMPTY_INDEX) {
+				return p_pos;
+			}
+		}
+		return order_used;
+	}
+
+	// Order position of the live entry at p_index in iteration order.
+	_FORCE_INLINE_ uint32_t _get_pos_at_index(uint32_t p_index) const {
+		if (p_index >= num_elements) {
+			return order_used;
+		}
+		if (order_used == num_elements) {
+			return p_index; // No holes.
+		}
+		uint32_t pos = _next_live(0);
+		for (uint32_t i = 0; i < p_index; i++) {
+			pos = _next_live(pos + 1);
+		}
+		return pos;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		for (uint32_t i = 0; i < order_used; i++) {
+			if (order[i] != EMPTY_INDEX) {
+				_get_entry(order[i]).~Entry();
+			}
+		}
+		if (indices != nullptr) {
+			memset(indices, 0xFF, sizeof(uint32_t) * (index_mask + 1));
+		}
+		slots_used = 0;
+		free_slot = EMPTY_INDEX;
+		order_used = 0;
+		num_elements = 0;
+		index_used = 0;
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t slot = 0;
+		bool exists = _lookup_slot(p_key, slot);
+		CRASH_COND_MSG(!exists, "CompactHashMap key not found.");
+		return _get_entry(slot).data.value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t slot = 0;
+		bool exists = _lookup_slot(p_key, slot);
+		CRASH_COND_MSG(!exists, "CompactHashMap key not found.");
+		return _get_entry(slot).data.value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t slot = 0;
+		if (_lookup_slot(p_key, slot)) {
+			return &_get_entry(slot).data.value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t slot = 0;
+		if (_lookup_slot(p_key, slot)) {
+			return &_get_entry(slot).data.value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _slot = 0;
+		return _lookup_slot(p_key, _slot);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t slot = 0;
+		if (!_lookup_slot(p_key, slot)) {
+			return false;
+		}
+
+		Entry &e = _get_entry(slot);
+		order[e.order_pos] = EMPTY_INDEX;
+		e.data.~KeyValue();
+		e.hash = DELETED_HASH;
+		e.order_pos = free_slot;
+		free_slot = slot;
+		num_elements--;
+
+		if (num_elements == 0) {
+			clear(); // Reuse everything.
+			return true;
+		}
+		while (order[order_used - 1] == EMPTY_INDEX) {
+			order_used--; // Trailing positions can be reused right away.
+		}
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	void reserve(uint32_t p_new_capacity) {
+		while (capacity < p_new_capacity) {
+			_add_block();
+		}
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return map->_get_entry(map->order[pos]).data;
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &map->_get_entry(map->order[pos]).data; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			pos = map->_next_live(pos + 1);
+			return *this;
+		}
+		_FORCE_INLINE_ ConstIterator &operator--() {
+			pos = map->_prev_live(pos);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return pos == b.pos; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return pos != b.pos; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map && pos < map->order_used;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const CompactHashMap *p_map, uint32_t p_pos) {
+			map = p_map;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ ConstIterator() {}
+
+	private:
+		const CompactHashMap *map = nullptr;
+		uint32_t pos = 0;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return map->_get_entry(map->order[pos]).data;
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &map->_get_entry(map->order[pos]).data; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			pos = map->_next_live(pos + 1);
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			pos = map->_prev_live(pos);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return pos == b.pos; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return pos != b.pos; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map && pos < map->order_used;
+		}
+
+		_FORCE_INLINE_ Iterator(CompactHashMap *p_map, uint32_t p_pos) {
+			map = p_map;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ Iterator() {}
+
+		operator ConstIterator() const {
+			return ConstIterator(map, pos);
+		}
+
+	private:
+		CompactHashMap *map = nullptr;
+		uint32_t pos = 0;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(this, _next_live(0));
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(this, order_used);
+	}
+	_FORCE_INLINE_ Iterator last() {
+		return Iterator(this, _prev_live(order_used));
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		uint32_t slot = 0;
+		if (!_lookup_slot(p_key, slot)) {
+			return end();
+		}
+		return Iterator(this, _get_entry(slot).order_pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(p_iter->key);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(this, _next_live(0));
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(this, order_used);
+	}
+	_FORCE_INLINE_ ConstIterator last() const {
+		return ConstIterator(this, _prev_live(order_used));
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		uint32_t slot = 0;
+		if (!_lookup_slot(p_key, slot)) {
+			return end();
+		}
+		return ConstIterator(this, _get_entry(slot).order_pos);
+	}
+
+	// Element at p_index in insertion order, constant time unless elements were erased.
+	_FORCE_INLINE_ Iterator get_at_index(uint32_t p_index) {
+		return Iterator(this, _get_pos_at_index(p_index));
+	}
+	_FORCE_INLINE_ ConstIterator get_at_index(uint32_t p_index) const {
+		return ConstIterator(this, _get_pos_at_index(p_index));
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t slot = 0;
+		bool exists = _lookup_slot(p_key, slot);
+		CRASH_COND(!exists);
+		return _get_entry(slot).data.value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t slot = 0;
+		if (!_lookup_slot(p_key, slot)) {
+			slot = _insert(p_key, TValue());
+		}
+		return _get_entry(slot).data.value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		return Iterator(this, _get_entry(_insert(p_key, p_value)).order_pos);
+	}
+
+	/* Constructors */
+
+	CompactHashMap(const CompactHashMap &p_other) {
+		if (p_other.num_elements == 0) {
+			return;
+		}
+		reserve(p_other.num_elements);
+
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	void operator=(const CompactHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		if (p_other.num_elements == 0) {
+			return;
+		}
+		reserve(p_other.num_elements);
+
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	CompactHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	CompactHashMap() {}
+
+	~CompactHashMap() {
+		clear();
+
+		for (uint32_t i = 0; i < block_count; i++) {
+			Memory::free_static(blocks[i]);
+		}
+		if (blocks != nullptr) {
+			Memory::free_static(blocks);
+		}
+		if (indices != nullptr) {
+			Memory::free_static(indices);
+		}
+	}
+};
+
+#endif // COMPACT_HASH_MAP_H
@@ -33,6 +33,7 @@
 
 #include "core/error/error_macros.h"
 #include "core/os/memory.h"
+#include "core/os/small_block_allocator.h"
 #include "core/templates/safe_refcount.h"
 
 #include <string.h>
@@ -49,6 +50,16 @@ class VMap;
 SAFE_NUMERIC_TYPE_PUN_GUARANTEES(uint32_t)
 #endif
 
+// Owner of memory that CowData uses without having allocated it, such as part of a
+// memory mapped file (see CowData::adopt()). It's retained once per adoption.
+class CowDataOwner {
+public:
+	virtual void retain() = 0;
+	virtual void release() = 0;
+
+	virtual ~CowDataOwner() {}
+};
+
 // Silence a false positive warning (see GH-52119).
 #if defined(__GNUC__) && !defined(__clang__)
 #pragma GCC diagnostic push
@@ -65,7 +76,15 @@ class CowData {
 	template <class TV, class VV>
 	friend class VMap;
 
+public:
+	// Bytes needed right before adopted data, to hold the owner, refcount and size.
+	static constexpr uint32_t ADOPTED_HEADER_SIZE = 16;
+
 private:
+	// Set in the refcount of adopted data. Since it's never below 2 that way, writing
+	// to adopted data always copies it first.
+	static constexpr uint32_t ADOPTED_REFCOUNT = 0x80000000;
+
 	mutable T *_ptr = nullptr;
 
 	// internal helpers
@@ -111,6 +130,26 @@ private:
 #endif
 	}
 
+	// Small payloads (short strings, vectors of a few elements) are served by
+	// SmallBlockAllocator instead of the heap. Both keep the same prefix layout,
+	// so the rest of CowData doesn't need to know where the memory came from.
+	_FORCE_INLINE_ static uint32_t *_alloc_memory(size_t p_alloc_size) {
+		if (SmallBlockAllocator::is_small(p_alloc_size)) {
+			return (uint32_t *)SmallBlockAllocator::alloc(p_alloc_size);
+		}
+		return (uint32_t *)Memory::alloc_static(p_alloc_size, true);
+	}
+
+	_FORCE_INLINE_ static void _free_memory(void *p_ptr, size_t p_alloc_size) {
+		if (SmallBlockAllocator::is_small(p_alloc_size)) {
+			SmallBlockAllocator::free(p_ptr, p_alloc_size);
+		} else {
+			Memory::free_static(p_ptr, true);
+		}
+	}
+
+	static uint32_t *_realloc_memory(void *p_ptr, size_t p_old_alloc_size, size_t p_alloc_size);
+
 	void _unref(void *p_data);
 	void _ref(const CowData *p_from);
 	void _ref(const CowData &p_from);
@@ -182,6 +221,11 @@ public:
 		return OK;
 	}
 
+	// Uses the p_size elements at p_data as they are, instead of a copy. The
+	// ADOPTED_HEADER_SIZE bytes before p_data must be writable and zero the first time
+	// the data is adopted. Adopting data that is already adopted shares it.
+	void adopt(T *p_data, int p_size, CowDataOwner *p_owner);
+
 	int find(const T &p_val, int p_from = 0) const;
 	int rfind(const T &p_val, int p_from = -1) const;
 	int count(const T &p_val) const;
@@ -199,13 +243,18 @@ void CowData<T>::_unref(void *p_data) {
 
 	SafeNumeric<uint32_t> *refc = _get_refcount();
 
-	if (refc->decrement() > 0) {
+	uint32_t rc = refc->decrement();
+	if (rc > 0) {
+		if (unlikely(rc == ADOPTED_REFCOUNT)) {
+			(*(CowDataOwner **)(refc - 2))->release();
+		}
 		return; // still in use
 	}
 	// clean up
 
+	uint32_t *count = _get_size();
+
 	if (!__has_trivial_destructor(T)) {
-		uint32_t *count = _get_size();
 		T *data = (T *)(count + 1);
 
 		for (uint32_t i = 0; i < *count; ++i) {
@@ -215,7 +264,30 @@ void CowData<T>::_unref(void *p_data) {
 	}
 
 	// free mem
-	Memory::free_static((uint8_t *)p_data, true);
+	_free_memory(p_data, _get_alloc_size(*count));
+}
+
+template <class T>
+uint32_t *CowData<T>::_realloc_memory(void *p_ptr, size_t p_old_alloc_size, size_t p_alloc_size) {
+	const bool old_small = SmallBlockAllocator::is_small(p_old_alloc_size);
+	const bool new_small = SmallBlockAllocator::is_small(p_alloc_size);
+
+	if (!old_small && !new_small) {
+		return (uint32_t *)Memory::realloc_static(p_ptr, p_alloc_size, true);
+	}
+
+	if (old_small && new_small && SmallBlockAllocator::get_capacity(p_old_alloc_size) == SmallBlockAllocator::get_capacity(p_alloc_size)) {
+		return (uint32_t *)p_ptr; // Still fits in the same block.
+	}
+
+	uint32_t *mem = _alloc_memory(p_alloc_size);
+	ERR_FAIL_COND_V(!mem, nullptr);
+
+	// Move the refcount and size along with the elements, as realloc would.
+	memcpy(mem - 2, ((uint32_t *)p_ptr) - 2, 2 * sizeof(uint32_t) + MIN(p_old_alloc_size, p_alloc_size));
+	_free_memory(p_ptr, p_old_alloc_size);
+
+	return mem;
 }
 
 template <class T>
@@ -231,7 +303,7 @@ uint32_t CowData<T>::_copy_on_write() {
 		/* in use by more than me */
 		uint32_t current_size = *_get_size();
 
-		uint32_t *mem_new = (uint32_t *)Memory::alloc_static(_get_alloc_size(current_size), true);
+		uint32_t *mem_new = _alloc_memory(_get_alloc_size(current_size));
 
 		new (mem_new - 2) SafeNumeric<uint32_t>(1); //refcount
 		*(mem_new - 1) = current_size; //size
@@ -284,7 +356,7 @@ Error CowData<T>::resize(int p_size) {
 		if (alloc_size != current_alloc_size) {
 			if (current_size == 0) {
 				// alloc from scratch
-				uint32_t *ptr = (uint32_t *)Memory::alloc_static(alloc_size, true);
+				uint32_t *ptr = _alloc_memory(alloc_size);
 				ERR_FAIL_COND_V(!ptr, ERR_OUT_OF_MEMORY);
 				*(ptr - 1) = 0; //size, currently none
 				new (ptr - 2) SafeNumeric<uint32_t>(1); //refcount
@@ -292,7 +364,7 @@ Error CowData<T>::resize(int p_size) {
 				_ptr = (T *)ptr;
 
 			} else {
-				uint32_t *_ptrnew = (uint32_t *)Memory::realloc_static(_ptr, alloc_size, true);
+				uint32_t *_ptrnew = _realloc_memory(_ptr, current_alloc_size, alloc_size);
 				ERR_FAIL_COND_V(!_ptrnew, ERR_OUT_OF_MEMORY);
 				new (_ptrnew - 2) SafeNumeric<uint32_t>(rc); //refcount
 
@@ -320,7 +392,7 @@ Error CowData<T>::resize(int p_size) {
 		}
 
 		if (alloc_size != current_alloc_size) {
-			uint32_t *_ptrnew = (uint32_t *)Memory::realloc_static(_ptr, alloc_size, true);
+			uint32_t *_ptrnew = _realloc_memory(_ptr, current_alloc_size, alloc_size);
 			ERR_FAIL_COND_V(!_ptrnew, ERR_OUT_OF_MEMORY);
 			new (_ptrnew - 2) SafeNumeric<uint32_t>(rc); //refcount
 
@@ -333,6 +405,42 @@ Error CowData<T>::resize(int p_size) {
 	return OK;
 }
 
+template <class T>
+void CowData<T>::adopt(T *p_data, int p_size, CowDataOwner *p_owner) {
+	static_assert(__has_trivial_destructor(T), "Only trivially destructible types can be adopted.");
+	ERR_FAIL_COND(p_size <= 0 || !p_data || !p_owner);
+	ERR_FAIL_COND(uintptr_t(p_data) % 8 != 0);
+
+	_unref(_ptr);
+	_ptr = nullptr;
+
+	uint32_t *header = (uint32_t *)p_data;
+	SafeNumeric<uint32_t> *refc = (SafeNumeric<uint32_t> *)(header - 2);
+
+	uint32_t rc = refc->get();
+	while (true) {
+		if (rc > ADOPTED_REFCOUNT) {
+			// Already adopted, share it.
+			if (refc->compare_exchange(rc, rc + 1)) {
+				break;
+			}
+			continue;
+		}
+
+		// Never adopted, or released by every copy since.
+		ERR_FAIL_COND(rc != 0 && rc != ADOPTED_REFCOUNT);
+		// Whoever adopts the same memory writes the same values here.
+		*(CowDataOwner **)(header - 4) = p_owner;
+		*(header - 1) = p_size;
+		if (refc->compare_exchange(rc, ADOPTED_REFCOUNT + 1)) {
+			p_owner->retain();
+			break;
+		}
+	}
+
+	_ptr = p_data;
+}
+
 template <class T>
 int CowData<T>::find(const T &p_val, int p_from) const {
 	int ret = -1;
@@ -0,0 +1,528 @@
+/*************************************************************************/
+/*  flat_hash_map.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/pair.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLAT_HASH_MAP_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define FLAT_HASH_MAP_NEON
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * A HashMap implementation that uses open addressing with SIMD probing, as
+ * popularized by "Swiss tables".
+ *
+ * Slots are split in groups of 16. Every slot has a control byte which is either
+ * empty, deleted (a tombstone), or holds 7 bits of the key hash. A lookup loads
+ * the 16 control bytes of a group at once and compares them with SSE2 or NEON
+ * (or a scalar fallback), so only slots whose hash bits match get their keys
+ * compared. Probing stops at the first group containing an empty slot.
+ *
+ * Keys and values are stored inplace, so there is no allocation per element
+ * and no pointer chase on lookup. In exchange, iteration order is unspecified
+ * and changes when the map grows, so use HashMap where insertion order matters.
+ *
+ * Pointers to values are invalidated when the map grows. Erasing does not move
+ * other elements, so it's safe to erase while iterating.
+ *
+ * The assignment operator copy the pairs from one map to the other.
+ */
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashMap {
+public:
+	static constexpr uint32_t GROUP_SIZE = 16;
+	static constexpr uint32_t MIN_CAPACITY = GROUP_SIZE;
+
+private:
+	enum : int8_t {
+		CTRL_EMPTY = -128,
+		CTRL_DELETED = -2,
+		// Full slots store the low 7 bits of the hash, so they are always >= 0.
+	};
+
+	static _FORCE_INLINE_ uint32_t _ctz(uint32_t p_mask) {
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctz(p_mask);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, p_mask);
+		return index;
+#else
+		uint32_t index = 0;
+		while (!(p_mask & 1)) {
+			p_mask >>= 1;
+			index++;
+		}
+		return index;
+#endif
+	}
+
+	// Bit i of the returned masks is set when control byte i of the group matches.
+	static _FORCE_INLINE_ uint32_t _match_byte(const int8_t *p_group, int8_t p_byte) {
+#if defined(FLAT_HASH_MAP_SSE2)
+		const __m128i ctrl = _mm_loadu_si128((const __m128i *)p_group);
+		return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(p_byte))));
+#elif defined(FLAT_HASH_MAP_NEON)
+		static const uint8_t bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+		const uint8x16_t cmp = vceqq_s8(vld1q_s8(p_group), vdupq_n_s8(p_byte));
+		const uint8x16_t masked = vandq_u8(cmp, vld1q_u8(bits));
+		return uint32_t(vaddv_u8(vget_low_u8(masked))) | (uint32_t(vaddv_u8(vget_high_u8(masked))) << 8);
+#else
+		uint32_t mask = 0;
+		for (uint32_t i = 0; i < GROUP_SIZE; i++) {
+			if (p_group[i] == p_byte) {
+				mask |= 1 << i;
+			}
+		}
+		return mask;
+#endif
+	}
+
+	static _FORCE_INLINE_ uint32_t _match_empty_or_deleted(const int8_t *p_group) {
+#if defined(FLAT_HASH_MAP_SSE2)
+		// Only empty and deleted have the sign bit set.
+		return uint32_t(_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)p_group)));
+#elif defined(FLAT_HASH_MAP_NEON)
+		static const uint8_t bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+		const uint8x16_t cmp = vcltq_s8(vld1q_s8(p_group), vdupq_n_s8(0));
+		const uint8x16_t masked = vandq_u8(cmp, vld1q_u8(bits));
+		return uint32_t(vaddv_u8(vget_low_u8(masked))) | (uint32_t(vaddv_u8(vget_high_u8(masked))) << 8);
+#else
+		uint32_t mask = 0;
+		for (uint32_t i = 0; i < GROUP_SIZE; i++) {
+			if (p_group[i] < 0) {
+				mask |= 1 << i;
+			}
+		}
+		return mask;
+#endif
+	}
+
+	typedef KeyValue<TKey, TValue> Slot;
+
+	int8_t *ctrl = nullptr;
+	Slot *slots = nullptr;
+
+	uint32_t capacity = 0; // Always 0 or a power of 2 multiple of GROUP_SIZE.
+	uint32_t num_elements = 0;
+	uint32_t num_deleted = 0;
+
+	static _FORCE_INLINE_ uint32_t _get_max_load(uint32_t p_capacity) {
+		return p_capacity - p_capacity / 8; // 7/8 load factor.
+	}
+
+	static _FORCE_INLINE_ uint32_t _hash(const TKey &p_key) {
+		// Table sizes are powers of 2, so make sure all bits of weaker hashes
+		// (such as the ones of strings) affect the group and control byte.
+		return hash_fmix32(Hasher::hash(p_key));
+	}
+
+	_FORCE_INLINE_ bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
+		if (capacity == 0) {
+			return false; // Failed lookups, no elements.
+		}
+		return _lookup_pos_with_hash(p_key, _hash(p_key), r_pos);
+	}
+
+	_FORCE_INLINE_ bool _lookup_pos_with_hash(const TKey &p_key, uint32_t p_hash, uint32_t &r_pos) const {
+		const int8_t h2 = int8_t(p_hash & 0x7F);
+		const uint32_t group_mask = capacity / GROUP_SIZE - 1;
+		uint32_t group = (p_hash >> 7) & group_mask;
+
+		// Triangular probing over groups, visits every group once since their count is a power of 2.
+		for (uint32_t probe = 1;; probe++) {
+			const int8_t *group_ctrl = ctrl + group * GROUP_SIZE;
+
+			uint32_t mask = _match_byte(group_ctrl, h2);
+			while (mask) {
+				const uint32_t pos = group * GROUP_SIZE + _ctz(mask);
+				if (Comparator::compare(slots[pos].key, p_key)) {
+					r_pos = pos;
+					return true;
+				}
+				mask &= mask - 1;
+			}
+
+			if (_match_byte(group_ctrl, CTRL_EMPTY)) {
+				return false;
+			}
+			group = (group + probe) & group_mask;
+		}
+	}
+
+	// Finds where a key that is not in the map yet would be inserted.
+	_FORCE_INLINE_ uint32_t _find_insert_pos(uint32_t p_hash) const {
+		const uint32_t group_mask = capacity / GROUP_SIZE - 1;
+		uint32_t group = (p_hash >> 7) & group_mask;
+
+		for (uint32_t probe = 1;; probe++) {
+			const uint32_t mask = _match_empty_or_deleted(ctrl + group * GROUP_SIZE);
+			if (mask) {
+				return group * GROUP_SIZE + _ctz(mask);
+			}
+			group = (group + probe) & group_mask;
+		}
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity) {
+		int8_t *old_ctrl = ctrl;
+		Slot *old_slots = slots;
+		uint32_t old_capacity = capacity;
+
+		capacity = p_new_capacity;
+		ctrl = static_cast<int8_t *>(Memory::alloc_static(sizeof(int8_t) * capacity));
+		slots = static_cast<Slot *>(Memory::alloc_static(sizeof(Slot) * capacity));
+		memset(ctrl, CTRL_EMPTY, capacity);
+		num_deleted = 0;
+
+		if (old_ctrl == nullptr) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] < 0) {
+				continue;
+			}
+			const uint32_t hash = _hash(old_slots[i].key);
+			const uint32_t pos = _find_insert_pos(hash);
+			ctrl[pos] = int8_t(hash & 0x7F);
+			memnew_placement(&slots[pos], Slot(old_slots[i].key, old_slots[i].value));
+			old_slots[i].~Slot();
+		}
+
+		Memory::free_static(old_ctrl);
+		Memory::free_static(old_slots);
+	}
+
+	_FORCE_INLINE_ uint32_t _insert(const TKey &p_key, const TValue &p_value) {
+		const uint32_t hash = _hash(p_key);
+		uint32_t pos = 0;
+		if (capacity != 0 && _lookup_pos_with_hash(p_key, hash, pos)) {
+			slots[pos].value = p_value;
+			return pos;
+		}
+
+		if (unlikely(num_elements + num_deleted + 1 > _get_max_load(capacity))) {
+			uint32_t new_capacity = MAX(capacity, MIN_CAPACITY);
+			// Only grow if most slots are really in use, otherwise rehashing is enough to purge tombstones.
+			if (num_elements + 1 > _get_max_load(new_capacity) / 2) {
+				new_capacity *= 2;
+			}
+			_resize_and_rehash(new_capacity);
+		}
+
+		pos = _find_insert_pos(hash);
+		if (ctrl[pos] == CTRL_DELETED) {
+			num_deleted--;
+		}
+		ctrl[pos] = int8_t(hash & 0x7F);
+		memnew_placement(&slots[pos], Slot(p_key, p_value));
+		num_elements++;
+		return pos;
+	}
+
+	_FORCE_INLINE_ uint32_t _next_full(uint32_t p_pos) const {
+		while (p_pos < capacity && ctrl[p_pos] < 0) {
+			p_pos++;
+		}
+		return p_pos;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if (ctrl == nullptr) {
+			return;
+		}
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (ctrl[i] >= 0) {
+				slots[i].~Slot();
+			}
+		}
+		memset(ctrl, CTRL_EMPTY, capacity);
+		num_elements = 0;
+		num_deleted = 0;
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return slots[pos].value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return slots[pos].value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return &slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return &slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _pos = 0;
+		return _lookup_pos(p_key, _pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return false;
+		}
+
+		slots[pos].~Slot();
+		num_elements--;
+
+		// Lookups stop at the first group with an empty slot, so if this group
+		// already has one no probe sequence goes past it and no tombstone is needed.
+		if (_match_byte(ctrl + (pos & ~(GROUP_SIZE - 1)), CTRL_EMPTY)) {
+			ctrl[pos] = CTRL_EMPTY;
+		} else {
+			ctrl[pos] = CTRL_DELETED;
+			num_deleted++;
+		}
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	void reserve(uint32_t p_new_capacity) {
+		uint32_t new_capacity = MAX(capacity, MIN_CAPACITY);
+		while (_get_max_load(new_capacity) < p_new_capacity) {
+			ERR_FAIL_COND_MSG(new_capacity >= (1u << 31), "FlatHashMap capacity overflow.");
+			new_capacity *= 2;
+		}
+		if (new_capacity != capacity) {
+			_resize_and_rehash(new_capacity);
+		}
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return map->slots[pos];
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &map->slots[pos]; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			pos = map->_next_full(pos + 1);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return pos == b.pos; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return pos != b.pos; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map && pos < map->capacity;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const FlatHashMap *p_map, uint32_t p_pos) {
+			map = p_map;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ ConstIterator() {}
+
+	private:
+		const FlatHashMap *map = nullptr;
+		uint32_t pos = 0;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return map->slots[pos];
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &map->slots[pos]; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			pos = map->_next_full(pos + 1);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return pos == b.pos; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return pos != b.pos; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map && pos < map->capacity;
+		}
+
+		_FORCE_INLINE_ Iterator(FlatHashMap *p_map, uint32_t p_pos) {
+			map = p_map;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ Iterator() {}
+
+		operator ConstIterator() const {
+			return ConstIterator(map, pos);
+		}
+
+	private:
+		FlatHashMap *map = nullptr;
+		uint32_t pos = 0;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(this, _next_full(0));
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(this, capacity);
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return end();
+		}
+		return Iterator(this, pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(p_iter->key);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(this, _next_full(0));
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(this, capacity);
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return end();
+		}
+		return ConstIterator(this, pos);
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND(!exists);
+		return slots[pos].value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			pos = _insert(p_key, TValue());
+		}
+		return slots[pos].value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		return Iterator(this, _insert(p_key, p_value));
+	}
+
+	/* Constructors */
+
+	FlatHashMap(const FlatHashMap &p_other) {
+		if (p_other.num_elements == 0) {
+			return;
+		}
+		reserve(p_other.num_elements);
+
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	void operator=(const FlatHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		if (p_other.num_elements == 0) {
+			return;
+		}
+		reserve(p_other.num_elements);
+
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	FlatHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	FlatHashMap() {}
+
+	~FlatHashMap() {
+		clear();
+
+		if (ctrl != nullptr) {
+			Memory::free_static(ctrl);
+			Memory::free_static(slots);
+		}
+	}
+};
+
+#endif // FLAT_HASH_MAP_H
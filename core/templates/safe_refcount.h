@@ -117,6 +117,11 @@ public:
 		}
 	}
 
+	// Sets the value if it's r_expected, otherwise sets r_expected to the current value.
+	_ALWAYS_INLINE_ bool compare_exchange(T &r_expected, T p_value) {
+		return value.compare_exchange_strong(r_expected, p_value, std::memory_order_acq_rel, std::memory_order_acquire);
+	}
+
 	_ALWAYS_INLINE_ T conditional_increment() {
 		while (true) {
 			T c = value.load(std::memory_order_acquire);
@@ -249,6 +254,15 @@ public:
 		return value;
 	}
 
+	_ALWAYS_INLINE_ bool compare_exchange(T &r_expected, T p_value) {
+		if (value == r_expected) {
+			value = p_value;
+			return true;
+		}
+		r_expected = value;
+		return false;
+	}
+
 	_ALWAYS_INLINE_ T conditional_increment() {
 		if (value == 0) {
 			return 0;
@@ -33,20 +33,285 @@
 #include "container_type_validate.h"
 #include "core/object/class_db.h"
 #include "core/object/script_language.h"
+#include "core/os/spin_lock.h"
 #include "core/templates/hashfuncs.h"
 #include "core/templates/search_array.h"
 #include "core/templates/vector.h"
 #include "core/variant/callable.h"
 #include "core/variant/variant.h"
+#include "core/variant/variant_internal.h"
 
 class ArrayPrivate {
 public:
 	SafeRefCount refcount;
 	Vector<Variant> array;
+	// Typed arrays of plain value types (int, float, vectors, colors...) keep
+	// their elements unboxed in `dense`, and only box them at the Variant API
+	// boundary. `dense_type` is NIL whenever `array` is in use instead.
+	Vector<uint8_t> dense;
+	SafeNumeric<uint32_t> dense_type;
+	uint32_t dense_stride = 0;
+	// Boxed copy of `dense`, built the first time a reference to an element is
+	// handed out (operator[]) and kept until the size changes, so references
+	// stay valid like with boxed storage. Once a writable reference was handed
+	// out, `mirror_written` is set and `mirror` has the current values. They are
+	// moved back to `dense` before its layout changes, and only a value of
+	// another type boxes the array for good.
+	mutable Vector<Variant> mirror;
+	mutable SafeFlag has_mirror;
+	bool mirror_written = false;
 	Variant *read_only = nullptr; // If enabled, a pointer is used to a temporary value that is used to return read-only values.
 	ContainerTypeValidate typed;
+
+	_FORCE_INLINE_ bool is_dense() const { return dense_type.get() != Variant::NIL; }
+	_FORCE_INLINE_ int dense_size() const { return dense.size() / dense_stride; }
+
+	// Same as is_dense(), but first moves values written through references
+	// back to `dense`. Needed before changing its layout.
+	_FORCE_INLINE_ bool is_dense_writable() {
+		if (unlikely(mirror_written)) {
+			write_back();
+		}
+		return is_dense();
+	}
+
+	_FORCE_INLINE_ Variant dense_get(int p_idx) const {
+		if (unlikely(mirror_written)) {
+			return mirror[p_idx];
+		}
+		CRASH_BAD_INDEX(p_idx, dense_size());
+		Variant ret;
+		VariantInternal::initialize(&ret, typed.type);
+		memcpy(VariantInternal::get_opaque_pointer(&ret), dense.ptr() + size_t(p_idx) * dense_stride, dense_stride);
+		return ret;
+	}
+
+	// The value must have been validated against the array type.
+	_FORCE_INLINE_ void dense_set(int p_idx, const Variant &p_value) {
+		CRASH_BAD_INDEX(p_idx, dense_size());
+		memcpy(dense.ptrw() + size_t(p_idx) * dense_stride, VariantInternal::get_opaque_pointer(&p_value), dense_stride);
+		if (unlikely(has_mirror.is_set())) {
+			mirror.write[p_idx] = p_value;
+		}
+	}
+
+	_FORCE_INLINE_ bool element_equals(int p_idx, const Variant &p_value) const {
+		return is_dense() ? dense_get(p_idx) == p_value : array[p_idx] == p_value;
+	}
+
+	void dense_insert(int p_pos, const Variant &p_value);
+	void dense_remove(int p_pos);
+	Error dense_resize(int p_new_size);
+	void dense_swap(int p_a, int p_b);
+	void copy_dense(const ArrayPrivate *p_from);
+
+	const Vector<Variant> &get_mirror() const;
+	void write_back();
+	void refresh_mirror();
+	void drop_mirror();
+
+	Vector<Variant> get_boxed() const;
+	void pack();
 };
 
+static uint32_t _get_dense_stride(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::BOOL:
+			return sizeof(bool);
+		case Variant::INT:
+			return sizeof(int64_t);
+		case Variant::FLOAT:
+			return sizeof(double);
+		case Variant::VECTOR2:
+			return sizeof(Vector2);
+		case Variant::VECTOR2I:
+			return sizeof(Vector2i);
+		case Variant::RECT2:
+			return sizeof(Rect2);
+		case Variant::RECT2I:
+			return sizeof(Rect2i);
+		case Variant::VECTOR3:
+			return sizeof(Vector3);
+		case Variant::VECTOR3I:
+			return sizeof(Vector3i);
+		case Variant::PLANE:
+			return sizeof(Plane);
+		case Variant::QUATERNION:
+			return sizeof(Quaternion);
+		case Variant::COLOR:
+			return sizeof(Color);
+		case Variant::RID:
+			return sizeof(RID);
+		default:
+			return 0; // Needs to stay boxed.
+	}
+}
+
+static void _get_default_value(Variant::Type p_type, Variant &r_value) {
+	Callable::CallError ce;
+	Variant::construct(p_type, r_value, nullptr, 0, ce);
+}
+
+void ArrayPrivate::dense_insert(int p_pos, const Variant &p_value) {
+	drop_mirror();
+	const int size = dense_size();
+	dense.resize((size + 1) * dense_stride);
+	uint8_t *w = dense.ptrw();
+	memmove(w + size_t(p_pos + 1) * dense_stride, w + size_t(p_pos) * dense_stride, size_t(size - p_pos) * dense_stride);
+	dense_set(p_pos, p_value);
+}
+
+void ArrayPrivate::dense_remove(int p_pos) {
+	drop_mirror();
+	const int size = dense_size();
+	uint8_t *w = dense.ptrw();
+	memmove(w + size_t(p_pos) * dense_stride, w + size_t(p_pos + 1) * dense_stride, size_t(size - p_pos - 1) * dense_stride);
+	dense.resize((size - 1) * dense_stride);
+}
+
+Error ArrayPrivate::dense_resize(int p_new_size) {
+	ERR_FAIL_COND_V(p_new_size < 0, ERR_INVALID_PARAMETER);
+	drop_mirror();
+	const int size = dense_size();
+	Error err = dense.resize(p_new_size * dense_stride);
+	if (err != OK || p_new_size <= size) {
+		return err;
+	}
+
+	Variant value;
+	_get_default_value(typed.type, value);
+	for (int i = size; i < p_new_size; i++) {
+		dense_set(i, value);
+	}
+	return OK;
+}
+
+void ArrayPrivate::dense_swap(int p_a, int p_b) {
+	uint8_t tmp[sizeof(Variant)];
+	uint8_t *w = dense.ptrw();
+	memcpy(tmp, w + size_t(p_a) * dense_stride, dense_stride);
+	memcpy(w + size_t(p_a) * dense_stride, w + size_t(p_b) * dense_stride, dense_stride);
+	memcpy(w + size_t(p_b) * dense_stride, tmp, dense_stride);
+	if (has_mirror.is_set()) {
+		SWAP(mirror.write[p_a], mirror.write[p_b]);
+	}
+}
+
+// Takes the elements of another unboxed array, as a copy.
+void ArrayPrivate::copy_dense(const ArrayPrivate *p_from) {
+	typed = p_from->typed;
+	dense_stride = p_from->dense_stride;
+	dense = p_from->dense;
+	dense_type.set(p_from->dense_type.get());
+	if (p_from->mirror_written) {
+		// Some values are only in the mirror of the other array.
+		mirror = p_from->mirror;
+		mirror_written = true;
+		has_mirror.set();
+		write_back();
+		drop_mirror();
+	}
+}
+
+Vector<Variant> ArrayPrivate::get_boxed() const {
+	if (!is_dense()) {
+		return array;
+	}
+	if (mirror_written) {
+		return mirror;
+	}
+	Vector<Variant> boxed;
+	const int size = dense_size();
+	boxed.resize(size);
+	Variant *w = boxed.ptrw();
+	for (int i = 0; i < size; i++) {
+		w[i] = dense_get(i);
+	}
+	return boxed;
+}
+
+void ArrayPrivate::pack() {
+	mirror_written = false;
+	drop_mirror();
+	const int size = array.size();
+	dense.resize(size * dense_stride);
+
+	Variant default_value;
+	for (int i = 0; i < size; i++) {
+		const Variant &value = array[i];
+		if (value.get_type() == typed.type) {
+			dense_set(i, value);
+		} else {
+			// Only nil can get here, from resizing while boxed.
+			if (default_value.get_type() == Variant::NIL) {
+				_get_default_value(typed.type, default_value);
+			}
+			dense_set(i, default_value);
+		}
+	}
+
+	array.clear();
+	dense_type.set(typed.type);
+}
+
+// Const element access can build the mirror from several readers at once. It's
+// done once per array until its size changes, a global lock is enough.
+static SpinLock dense_mirror_lock;
+
+const Vector<Variant> &ArrayPrivate::get_mirror() const {
+	if (!has_mirror.is_set()) {
+		dense_mirror_lock.lock();
+		if (!has_mirror.is_set()) {
+			mirror = get_boxed();
+			has_mirror.set();
+		}
+		dense_mirror_lock.unlock();
+	}
+	return mirror;
+}
+
+void ArrayPrivate::write_back() {
+	const int size = mirror.size();
+	for (int i = 0; i < size; i++) {
+		if (mirror[i].get_type() != typed.type) {
+			// Can't be stored unboxed anymore. `array` shares the mirror's
+			// storage, so references handed out stay valid.
+			array = mirror;
+			dense.clear();
+			dense_type.set(Variant::NIL);
+			mirror_written = false;
+			drop_mirror();
+			return;
+		}
+	}
+
+	uint8_t *w = dense.ptrw();
+	for (int i = 0; i < size; i++) {
+		memcpy(w + size_t(i) * dense_stride, VariantInternal::get_opaque_pointer(&mirror[i]), dense_stride);
+	}
+	mirror_written = false;
+}
+
+// Updates the mirror after reordering `dense` in place.
+void ArrayPrivate::refresh_mirror() {
+	if (!has_mirror.is_set()) {
+		return;
+	}
+	const int size = dense_size();
+	Variant *w = mirror.ptrw();
+	for (int i = 0; i < size; i++) {
+		w[i] = dense_get(i);
+	}
+}
+
+void ArrayPrivate::drop_mirror() {
+	DEV_ASSERT(!mirror_written);
+	if (has_mirror.is_set()) {
+		mirror.clear();
+		has_mirror.clear();
+	}
+}
+
 void Array::_ref(const Array &p_from) const {
 	ArrayPrivate *_fp = p_from._p;
 
@@ -59,6 +324,10 @@ void Array::_ref(const Array &p_from) const {
 		_p->refcount.init();
 		_p->array = _fp->array;
 		_p->typed = _fp->typed;
+		if (_fp->is_dense()) {
+			_p->copy_dense(_fp);
+		}
+		_p->dense_stride = _fp->dense_stride;
 		return;
 	}
 
@@ -91,31 +360,46 @@ void Array::_unref() const {
 
 Variant &Array::operator[](int p_idx) {
 	if (unlikely(_p->read_only)) {
-		*_p->read_only = _p->array[p_idx];
+		*_p->read_only = _p->is_dense() ? _p->dense_get(p_idx) : _p->array[p_idx];
 		return *_p->read_only;
 	}
+	if (unlikely(_p->is_dense())) {
+		_p->get_mirror();
+		_p->mirror_written = true;
+		return _p->mirror.write[p_idx];
+	}
 	return _p->array.write[p_idx];
 }
 
 const Variant &Array::operator[](int p_idx) const {
 	if (unlikely(_p->read_only)) {
-		*_p->read_only = _p->array[p_idx];
+		*_p->read_only = _p->is_dense() ? _p->dense_get(p_idx) : _p->array[p_idx];
 		return *_p->read_only;
 	}
+	if (unlikely(_p->is_dense())) {
+		return _p->get_mirror()[p_idx];
+	}
 	return _p->array[p_idx];
 }
 
 int Array::size() const {
-	return _p->array.size();
+	return _p->is_dense() ? _p->dense_size() : _p->array.size();
 }
 
 bool Array::is_empty() const {
-	return _p->array.is_empty();
+	return _p->is_dense() ? _p->dense.is_empty() : _p->array.is_empty();
 }
 
 void Array::clear() {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
 	_p->array.clear();
+	_p->dense.clear();
+	_p->mirror_written = false;
+	_p->drop_mirror();
+	if (_p->dense_stride) {
+		// No element can be referenced anymore, go back to unboxed storage.
+		_p->dense_type.set(_p->typed.type);
+	}
 }
 
 bool Array::operator==(const Array &p_array) const {
@@ -131,10 +415,8 @@ bool Array::recursive_equal(const Array &p_array, int recursion_count) const {
 	if (_p == p_array._p) {
 		return true;
 	}
-	const Vector<Variant> &a1 = _p->array;
-	const Vector<Variant> &a2 = p_array._p->array;
-	const int size = a1.size();
-	if (size != a2.size()) {
+	const int array_size = size();
+	if (array_size != p_array.size()) {
 		return false;
 	}
 
@@ -144,8 +426,19 @@ bool Array::recursive_equal(const Array &p_array, int recursion_count) const {
 		return true;
 	}
 	recursion_count++;
-	for (int i = 0; i < size; i++) {
-		if (!a1[i].hash_compare(a2[i], recursion_count)) {
+	if (!_p->is_dense() && !p_array._p->is_dense()) {
+		const Vector<Variant> &a1 = _p->array;
+		const Vector<Variant> &a2 = p_array._p->array;
+		for (int i = 0; i < array_size; i++) {
+			if (!a1[i].hash_compare(a2[i], recursion_count)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	for (int i = 0; i < array_size; i++) {
+		if (!get(i).hash_compare(p_array.get(i), recursion_count)) {
 			return false;
 		}
 	}
@@ -160,9 +453,11 @@ bool Array::operator<(const Array &p_array) const {
 	int min_cmp = MIN(a_len, b_len);
 
 	for (int i = 0; i < min_cmp; i++) {
-		if (operator[](i) < p_array[i]) {
+		const Variant a = get(i);
+		const Variant b = p_array.get(i);
+		if (a < b) {
 			return true;
-		} else if (p_array[i] < operator[](i)) {
+		} else if (b < a) {
 			return false;
 		}
 	}
@@ -193,6 +488,12 @@ uint32_t Array::recursive_hash(int recursion_count) const {
 	uint32_t h = hash_murmur3_one_32(Variant::ARRAY);
 
 	recursion_count++;
+	if (_p->is_dense()) {
+		for (int i = 0; i < _p->dense_size(); i++) {
+			h = hash_murmur3_one_32(_p->dense_get(i).recursive_hash(recursion_count), h);
+		}
+		return hash_fmix32(h);
+	}
 	for (int i = 0; i < _p->array.size(); i++) {
 		h = hash_murmur3_one_32(_p->array[i].recursive_hash(recursion_count), h);
 	}
@@ -204,7 +505,7 @@ bool Array::_assign(const Array &p_array) {
 		//same type or untyped, just reference, should be fine
 		_ref(p_array);
 	} else if (_p->typed.type == Variant::NIL) { //from typed to untyped, must copy, but this is cheap anyway
-		_p->array = p_array._p->array;
+		_p->array = p_array._p->get_boxed();
 	} else if (p_array._p->typed.type == Variant::NIL) { //from untyped to typed, must try to check if they are all valid
 		if (_p->typed.type == Variant::OBJECT) {
 			//for objects, it needs full validation, either can be converted or fail
@@ -236,6 +537,9 @@ bool Array::_assign(const Array &p_array) {
 			}
 
 			_p->array = new_array;
+			if (_p->dense_stride) {
+				_p->pack();
+			}
 		}
 	} else if (_p->typed.can_reference(p_array._p->typed)) { //same type or compatible
 		_ref(p_array);
@@ -255,72 +559,132 @@ void Array::operator=(const Array &p_array) {
 void Array::push_back(const Variant &p_value) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
 	ERR_FAIL_COND(!_p->typed.validate(p_value, "push_back"));
+	if (_p->is_dense_writable()) {
+		_p->dense_insert(_p->dense_size(), p_value);
+		return;
+	}
 	_p->array.push_back(p_value);
 }
 
 void Array::append_array(const Array &p_array) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	if (_p->is_dense_writable() && p_array._p->dense_type.get() == _p->dense_type.get() && !p_array._p->mirror_written) {
+		// Same unboxed type, nothing to validate.
+		_p->drop_mirror();
+		_p->dense.append_array(p_array._p->dense);
+		return;
+	}
 	for (int i = 0; i < p_array.size(); ++i) {
-		ERR_FAIL_COND(!_p->typed.validate(p_array[i], "append_array"));
+		ERR_FAIL_COND(!_p->typed.validate(p_array.get(i), "append_array"));
 	}
-	_p->array.append_array(p_array._p->array);
+	if (_p->is_dense()) {
+		for (int i = 0; i < p_array.size(); ++i) {
+			_p->dense_insert(_p->dense_size(), p_array.get(i));
+		}
+		return;
+	}
+	_p->array.append_array(p_array._p->get_boxed());
 }
 
 Error Array::resize(int p_new_size) {
 	ERR_FAIL_COND_V_MSG(_p->read_only, ERR_LOCKED, "Array is in read-only state.");
-	return _p->array.resize(p_new_size);
+	if (_p->is_dense_writable()) {
+		return _p->dense_resize(p_new_size);
+	}
+	const int old_size = _p->array.size();
+	Error err = _p->array.resize(p_new_size);
+	if (err == OK && _p->dense_stride && p_new_size > old_size) {
+		// Keep the same behavior as when unboxed.
+		Variant value;
+		_get_default_value(_p->typed.type, value);
+		Variant *w = _p->array.ptrw();
+		for (int i = old_size; i < p_new_size; i++) {
+			w[i] = value;
+		}
+	}
+	return err;
 }
 
 Error Array::insert(int p_pos, const Variant &p_value) {
 	ERR_FAIL_COND_V_MSG(_p->read_only, ERR_LOCKED, "Array is in read-only state.");
 	ERR_FAIL_COND_V(!_p->typed.validate(p_value, "insert"), ERR_INVALID_PARAMETER);
+	if (_p->is_dense_writable()) {
+		ERR_FAIL_INDEX_V(p_pos, _p->dense_size() + 1, ERR_INVALID_PARAMETER);
+		_p->dense_insert(p_pos, p_value);
+		return OK;
+	}
 	return _p->array.insert(p_pos, p_value);
 }
 
 void Array::fill(const Variant &p_value) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
 	ERR_FAIL_COND(!_p->typed.validate(p_value, "fill"));
+	if (_p->is_dense()) {
+		for (int i = 0; i < _p->dense_size(); i++) {
+			_p->dense_set(i, p_value);
+		}
+		return;
+	}
 	_p->array.fill(p_value);
 }
 
 void Array::erase(const Variant &p_value) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
 	ERR_FAIL_COND(!_p->typed.validate(p_value, "erase"));
+	if (_p->is_dense_writable()) {
+		int idx = find(p_value);
+		if (idx >= 0) {
+			_p->dense_remove(idx);
+		}
+		return;
+	}
 	_p->array.erase(p_value);
 }
 
 Variant Array::front() const {
-	ERR_FAIL_COND_V_MSG(_p->array.size() == 0, Variant(), "Can't take value from empty array.");
-	return operator[](0);
+	ERR_FAIL_COND_V_MSG(size() == 0, Variant(), "Can't take value from empty array.");
+	return get(0);
 }
 
 Variant Array::back() const {
-	ERR_FAIL_COND_V_MSG(_p->array.size() == 0, Variant(), "Can't take value from empty array.");
-	return operator[](_p->array.size() - 1);
+	ERR_FAIL_COND_V_MSG(size() == 0, Variant(), "Can't take value from empty array.");
+	return get(size() - 1);
 }
 
 int Array::find(const Variant &p_value, int p_from) const {
 	ERR_FAIL_COND_V(!_p->typed.validate(p_value, "find"), -1);
+	if (_p->is_dense()) {
+		if (p_from < 0) {
+			return -1;
+		}
+		for (int i = p_from; i < _p->dense_size(); i++) {
+			if (_p->dense_get(i) == p_value) {
+				return i;
+			}
+		}
+		return -1;
+	}
 	return _p->array.find(p_value, p_from);
 }
 
 int Array::rfind(const Variant &p_value, int p_from) const {
-	if (_p->array.size() == 0) {
+	const int array_size = size();
+	if (array_size == 0) {
 		return -1;
 	}
 	ERR_FAIL_COND_V(!_p->typed.validate(p_value, "rfind"), -1);
 
 	if (p_from < 0) {
 		// Relative offset from the end
-		p_from = _p->array.size() + p_from;
+		p_from = array_size + p_from;
 	}
-	if (p_from < 0 || p_from >= _p->array.size()) {
+	if (p_from < 0 || p_from >= array_size) {
 		// Limit to array boundaries
-		p_from = _p->array.size() - 1;
+		p_from = array_size - 1;
 	}
 
 	for (int i = p_from; i >= 0; i--) {
-		if (_p->array[i] == p_value) {
+		if (_p->element_equals(i, p_value)) {
 			return i;
 		}
 	}
@@ -335,13 +699,14 @@ int Array::find_last(const Variant &p_value) const {
 
 int Array::count(const Variant &p_value) const {
 	ERR_FAIL_COND_V(!_p->typed.validate(p_value, "count"), 0);
-	if (_p->array.size() == 0) {
+	const int array_size = size();
+	if (array_size == 0) {
 		return 0;
 	}
 
 	int amount = 0;
-	for (int i = 0; i < _p->array.size(); i++) {
-		if (_p->array[i] == p_value) {
+	for (int i = 0; i < array_size; i++) {
+		if (_p->element_equals(i, p_value)) {
 			amount++;
 		}
 	}
@@ -352,11 +717,16 @@ int Array::count(const Variant &p_value) const {
 bool Array::has(const Variant &p_value) const {
 	ERR_FAIL_COND_V(!_p->typed.validate(p_value, "use 'has'"), false);
 
-	return _p->array.find(p_value, 0) != -1;
+	return find(p_value, 0) != -1;
 }
 
 void Array::remove_at(int p_pos) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	if (_p->is_dense_writable()) {
+		ERR_FAIL_INDEX(p_pos, _p->dense_size());
+		_p->dense_remove(p_pos);
+		return;
+	}
 	_p->array.remove_at(p_pos);
 }
 
@@ -364,11 +734,18 @@ void Array::set(int p_idx, const Variant &p_value) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
 	ERR_FAIL_COND(!_p->typed.validate(p_value, "set"));
 
+	if (_p->is_dense()) {
+		_p->dense_set(p_idx, p_value);
+		return;
+	}
 	operator[](p_idx) = p_value;
 }
 
-const Variant &Array::get(int p_idx) const {
-	return operator[](p_idx);
+Variant Array::get(int p_idx) const {
+	if (_p->is_dense()) {
+		return _p->dense_get(p_idx);
+	}
+	return _p->array[p_idx];
 }
 
 Array Array::duplicate(bool p_deep) const {
@@ -383,6 +760,12 @@ Array Array::recursive_duplicate(bool p_deep, int recursion_count) const {
 		return new_arr;
 	}
 
+	if (_p->is_dense()) {
+		// Plain values, a deep copy is the same as a shallow one.
+		new_arr._p->copy_dense(_p);
+		return new_arr;
+	}
+
 	int element_count = size();
 	new_arr.resize(element_count);
 	new_arr._p->typed = _p->typed;
@@ -396,6 +779,10 @@ Array Array::recursive_duplicate(bool p_deep, int recursion_count) const {
 			new_arr[i] = get(i);
 		}
 	}
+	if (_p->dense_stride) {
+		new_arr._p->dense_stride = _p->dense_stride;
+		new_arr._p->pack();
+	}
 
 	return new_arr;
 }
@@ -437,7 +824,8 @@ Array Array::filter(const Callable &p_callable) const {
 
 	const Variant *argptrs[1];
 	for (int i = 0; i < size(); i++) {
-		argptrs[0] = &get(i);
+		const Variant value = get(i);
+		argptrs[0] = &value;
 
 		Variant result;
 		Callable::CallError ce;
@@ -463,7 +851,8 @@ Array Array::map(const Callable &p_callable) const {
 
 	const Variant *argptrs[1];
 	for (int i = 0; i < size(); i++) {
-		argptrs[0] = &get(i);
+		const Variant value = get(i);
+		argptrs[0] = &value;
 
 		Variant result;
 		Callable::CallError ce;
@@ -488,8 +877,9 @@ Variant Array::reduce(const Callable &p_callable, const Variant &p_accum) const
 
 	const Variant *argptrs[2];
 	for (int i = start; i < size(); i++) {
+		const Variant value = get(i);
 		argptrs[0] = &ret;
-		argptrs[1] = &get(i);
+		argptrs[1] = &value;
 
 		Variant result;
 		Callable::CallError ce;
@@ -506,7 +896,8 @@ Variant Array::reduce(const Callable &p_callable, const Variant &p_accum) const
 bool Array::any(const Callable &p_callable) const {
 	const Variant *argptrs[1];
 	for (int i = 0; i < size(); i++) {
-		argptrs[0] = &get(i);
+		const Variant value = get(i);
+		argptrs[0] = &value;
 
 		Variant result;
 		Callable::CallError ce;
@@ -528,7 +919,8 @@ bool Array::any(const Callable &p_callable) const {
 bool Array::all(const Callable &p_callable) const {
 	const Variant *argptrs[1];
 	for (int i = 0; i < size(); i++) {
-		argptrs[0] = &get(i);
+		const Variant value = get(i);
+		argptrs[0] = &value;
 
 		Variant result;
 		Callable::CallError ce;
@@ -561,20 +953,55 @@ struct _ArrayVariantSort {
 
 void Array::sort() {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	if (_p->is_dense_writable()) {
+		// Integers and floats order the same unboxed, the rest goes through Variant comparison.
+		if (_p->typed.type == Variant::INT) {
+			SortArray<int64_t> sorter;
+			sorter.sort((int64_t *)_p->dense.ptrw(), _p->dense_size());
+			_p->refresh_mirror();
+			return;
+		} else if (_p->typed.type == Variant::FLOAT) {
+			SortArray<double> sorter;
+			sorter.sort((double *)_p->dense.ptrw(), _p->dense_size());
+			_p->refresh_mirror();
+			return;
+		}
+		Vector<Variant> boxed = _p->get_boxed();
+		boxed.sort_custom<_ArrayVariantSort>();
+		for (int i = 0; i < boxed.size(); i++) {
+			_p->dense_set(i, boxed[i]);
+		}
+		return;
+	}
 	_p->array.sort_custom<_ArrayVariantSort>();
 }
 
 void Array::sort_custom(const Callable &p_callable) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	if (_p->is_dense_writable()) {
+		Vector<Variant> boxed = _p->get_boxed();
+		boxed.sort_custom<CallableComparator, true>(p_callable);
+		for (int i = 0; i < boxed.size(); i++) {
+			_p->dense_set(i, boxed[i]);
+		}
+		return;
+	}
 	_p->array.sort_custom<CallableComparator, true>(p_callable);
 }
 
 void Array::shuffle() {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
-	const int n = _p->array.size();
+	const int n = size();
 	if (n < 2) {
 		return;
 	}
+	if (_p->is_dense_writable()) {
+		for (int i = n - 1; i >= 1; i--) {
+			const int j = Math::rand() % (i + 1);
+			_p->dense_swap(i, j);
+		}
+		return;
+	}
 	Variant *data = _p->array.ptrw();
 	for (int i = n - 1; i >= 1; i--) {
 		const int j = Math::rand() % (i + 1);
@@ -584,8 +1011,38 @@ void Array::shuffle() {
 	}
 }
 
+template <class Comparator>
+static int _dense_bisect(const ArrayPrivate *p_array, const Variant &p_value, bool p_before, const Comparator &p_compare) {
+	// Same as SearchArray::bisect(), boxing elements as they are compared.
+	int lo = 0;
+	int hi = p_array->dense_size();
+	if (p_before) {
+		while (lo < hi) {
+			const int mid = (lo + hi) / 2;
+			if (p_compare(p_array->dense_get(mid), p_value)) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+	} else {
+		while (lo < hi) {
+			const int mid = (lo + hi) / 2;
+			if (p_compare(p_value, p_array->dense_get(mid))) {
+				hi = mid;
+			} else {
+				lo = mid + 1;
+			}
+		}
+	}
+	return lo;
+}
+
 int Array::bsearch(const Variant &p_value, bool p_before) {
 	ERR_FAIL_COND_V(!_p->typed.validate(p_value, "binary search"), -1);
+	if (_p->is_dense()) {
+		return _dense_bisect(_p, p_value, p_before, _ArrayVariantSort());
+	}
 	SearchArray<Variant, _ArrayVariantSort> avs;
 	return avs.bisect(_p->array.ptrw(), _p->array.size(), p_value, p_before);
 }
@@ -593,26 +1050,40 @@ int Array::bsearch(const Variant &p_value, bool p_before) {
 int Array::bsearch_custom(const Variant &p_value, const Callable &p_callable, bool p_before) {
 	ERR_FAIL_COND_V(!_p->typed.validate(p_value, "custom binary search"), -1);
 
+	if (_p->is_dense()) {
+		return _dense_bisect(_p, p_value, p_before, CallableComparator{ p_callable });
+	}
 	return _p->array.bsearch_custom<CallableComparator>(p_value, p_before, p_callable);
 }
 
 void Array::reverse() {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	if (_p->is_dense_writable()) {
+		const int n = _p->dense_size();
+		for (int i = 0; i < n / 2; i++) {
+			_p->dense_swap(i, n - i - 1);
+		}
+		return;
+	}
 	_p->array.reverse();
 }
 
 void Array::push_front(const Variant &p_value) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
 	ERR_FAIL_COND(!_p->typed.validate(p_value, "push_front"));
+	if (_p->is_dense_writable()) {
+		_p->dense_insert(0, p_value);
+		return;
+	}
 	_p->array.insert(0, p_value);
 }
 
 Variant Array::pop_back() {
 	ERR_FAIL_COND_V_MSG(_p->read_only, Variant(), "Array is in read-only state.");
-	if (!_p->array.is_empty()) {
-		const int n = _p->array.size() - 1;
-		const Variant ret = _p->array.get(n);
-		_p->array.resize(n);
+	if (!is_empty()) {
+		const int n = size() - 1;
+		const Variant ret = get(n);
+		resize(n);
 		return ret;
 	}
 	return Variant();
@@ -620,9 +1091,9 @@ Variant Array::pop_back() {
 
 Variant Array::pop_front() {
 	ERR_FAIL_COND_V_MSG(_p->read_only, Variant(), "Array is in read-only state.");
-	if (!_p->array.is_empty()) {
-		const Variant ret = _p->array.get(0);
-		_p->array.remove_at(0);
+	if (!is_empty()) {
+		const Variant ret = get(0);
+		remove_at(0);
 		return ret;
 	}
 	return Variant();
@@ -630,27 +1101,27 @@ Variant Array::pop_front() {
 
 Variant Array::pop_at(int p_pos) {
 	ERR_FAIL_COND_V_MSG(_p->read_only, Variant(), "Array is in read-only state.");
-	if (_p->array.is_empty()) {
+	if (is_empty()) {
 		// Return `null` without printing an error to mimic `pop_back()` and `pop_front()` behavior.
 		return Variant();
 	}
 
 	if (p_pos < 0) {
 		// Relative offset from the end
-		p_pos = _p->array.size() + p_pos;
+		p_pos = size() + p_pos;
 	}
 
 	ERR_FAIL_INDEX_V_MSG(
 			p_pos,
-			_p->array.size(),
+			size(),
 			Variant(),
 			vformat(
 					"The calculated index %s is out of bounds (the array has %s elements). Leaving the array untouched and returning `null`.",
 					p_pos,
-					_p->array.size()));
+					size()));
 
-	const Variant ret = _p->array.get(p_pos);
-	_p->array.remove_at(p_pos);
+	const Variant ret = get(p_pos);
+	remove_at(p_pos);
 	return ret;
 }
 
@@ -702,6 +1173,10 @@ const void *Array::id() const {
 	return _p;
 }
 
+bool Array::is_unboxed() const {
+	return _p->is_dense();
+}
+
 Array::Array(const Array &p_from, uint32_t p_type, const StringName &p_class_name, const Variant &p_script) {
 	_p = memnew(ArrayPrivate);
 	_p->refcount.init();
@@ -715,7 +1190,7 @@ bool Array::typed_assign(const Array &p_other) {
 
 void Array::set_typed(uint32_t p_type, const StringName &p_class_name, const Variant &p_script) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
-	ERR_FAIL_COND_MSG(_p->array.size() > 0, "Type can only be set when array is empty.");
+	ERR_FAIL_COND_MSG(size() > 0, "Type can only be set when array is empty.");
 	ERR_FAIL_COND_MSG(_p->refcount.get() > 1, "Type can only be set when array has no more than one user.");
 	ERR_FAIL_COND_MSG(_p->typed.type != Variant::NIL, "Type can only be set once.");
 	ERR_FAIL_COND_MSG(p_class_name != StringName() && p_type != Variant::OBJECT, "Class names can only be set for type OBJECT");
@@ -726,6 +1201,11 @@ void Array::set_typed(uint32_t p_type, const StringName &p_class_name, const Var
 	_p->typed.class_name = p_class_name;
 	_p->typed.script = script;
 	_p->typed.where = "TypedArray";
+
+	_p->dense_stride = _get_dense_stride(_p->typed.type);
+	if (_p->dense_stride) {
+		_p->dense_type.set(_p->typed.type);
+	}
 }
 
 bool Array::is_typed() const {
@@ -55,7 +55,7 @@ public:
 	const Variant &operator[](int p_idx) const;
 
 	void set(int p_idx, const Variant &p_value);
-	const Variant &get(int p_idx) const;
+	Variant get(int p_idx) const;
 
 	int size() const;
 	bool is_empty() const;
@@ -120,6 +120,7 @@ public:
 	Variant max() const;
 
 	const void *id() const;
+	bool is_unboxed() const;
 
 	bool typed_assign(const Array &p_other);
 	void set_typed(uint32_t p_type, const StringName &p_class_name, const Variant &p_script);
@@ -31,7 +31,9 @@
 #include "callable.h"
 
 #include "callable_bind.h"
+#include "core/object/class_db.h"
 #include "core/object/message_queue.h"
+#include "core/object/method_handle.h"
 #include "core/object/object.h"
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
@@ -40,6 +42,27 @@ void Callable::call_deferred(const Variant **p_arguments, int p_argcount) const
 	MessageQueue::get_singleton()->push_callablep(*this, p_arguments, p_argcount);
 }
 
+// Callables are too small to cache their method themselves, so calls go
+// through a few handles per thread, picked by method name. A handle can't be
+// given another method while a call through it is still running. Entries are
+// reset when methods are bound or unregistered, as only the main thread's
+// cache is cleared on shutdown.
+struct CallCacheEntry {
+	MethodHandle handle;
+	uint32_t calls_running = 0;
+	uint32_t generation = 0;
+};
+static const uint32_t CALL_CACHE_SIZE = 64;
+static thread_local CallCacheEntry call_cache[CALL_CACHE_SIZE];
+
+void Callable::clear_call_cache() {
+	for (uint32_t i = 0; i < CALL_CACHE_SIZE; i++) {
+		if (call_cache[i].calls_running == 0) {
+			call_cache[i].handle.set_method(StringName());
+		}
+	}
+}
+
 void Callable::call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, CallError &r_call_error) const {
 	if (is_null()) {
 		r_call_error.error = CallError::CALL_ERROR_INSTANCE_IS_NULL;
@@ -59,7 +82,19 @@ void Callable::call(const Variant **p_arguments, int p_argcount, Variant &r_retu
 			return;
 		}
 #endif
-		r_return_value = obj->callp(method, p_arguments, p_argcount, r_call_error);
+		CallCacheEntry &entry = call_cache[method.hash() & (CALL_CACHE_SIZE - 1)];
+		const uint32_t generation = ClassDB::get_method_generation();
+		if (entry.handle.get_method() != method || entry.generation != generation) {
+			if (entry.calls_running > 0) {
+				r_return_value = obj->callp(method, p_arguments, p_argcount, r_call_error);
+				return;
+			}
+			entry.handle.set_method(method);
+			entry.generation = generation;
+		}
+		entry.calls_running++;
+		r_return_value = entry.handle.call(obj, p_arguments, p_argcount, r_call_error);
+		entry.calls_running--;
 	}
 }
 
@@ -104,6 +104,9 @@ public:
 
 	operator String() const;
 
+	// Releases the methods cached for calls made from this thread.
+	static void clear_call_cache();
+
 	Callable(const Object *p_object, const StringName &p_method);
 	Callable(ObjectID p_object, const StringName &p_method);
 	Callable(CallableCustom *p_custom);
@@ -30,7 +30,7 @@
 
 #include "dictionary.h"
 
-#include "core/templates/hash_map.h"
+#include "core/templates/compact_hash_map.h"
 #include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 // required in this order by VariantInternal, do not remove this comment.
@@ -39,10 +39,12 @@
 #include "core/variant/type_info.h"
 #include "core/variant/variant_internal.h"
 
+typedef CompactHashMap<Variant, Variant, VariantHasher, VariantComparator> DictionaryMap;
+
 struct DictionaryPrivate {
 	SafeRefCount refcount;
 	Variant *read_only = nullptr; // If enabled, a pointer is used to a temporary value that is used to return read-only values.
-	HashMap<Variant, Variant, VariantHasher, VariantComparator> variant_map;
+	DictionaryMap variant_map;
 };
 
 void Dictionary::get_key_list(List<Variant> *p_keys) const {
@@ -56,24 +58,24 @@ void Dictionary::get_key_list(List<Variant> *p_keys) const {
 }
 
 Variant Dictionary::get_key_at_index(int p_index) const {
-	int index = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-		if (index == p_index) {
-			return E.key;
-		}
-		index++;
+	if (p_index < 0) {
+		return Variant();
+	}
+	DictionaryMap::ConstIterator E = ((const DictionaryMap *)&_p->variant_map)->get_at_index(p_index);
+	if (E) {
+		return E->key;
 	}
 
 	return Variant();
 }
 
 Variant Dictionary::get_value_at_index(int p_index) const {
-	int index = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-		if (index == p_index) {
-			return E.value;
-		}
-		index++;
+	if (p_index < 0) {
+		return Variant();
+	}
+	DictionaryMap::ConstIterator E = ((const DictionaryMap *)&_p->variant_map)->get_at_index(p_index);
+	if (E) {
+		return E->value;
 	}
 
 	return Variant();
@@ -109,13 +111,13 @@ const Variant &Dictionary::operator[](const Variant &p_key) const {
 }
 
 const Variant *Dictionary::getptr(const Variant &p_key) const {
-	HashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstIterator E;
+	DictionaryMap::ConstIterator E;
 
 	if (p_key.get_type() == Variant::STRING_NAME) {
 		const StringName *sn = VariantInternal::get_string_name(&p_key);
-		E = ((const HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(sn->operator String());
+		E = ((const DictionaryMap *)&_p->variant_map)->find(sn->operator String());
 	} else {
-		E = ((const HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
+		E = ((const DictionaryMap *)&_p->variant_map)->find(p_key);
 	}
 
 	if (!E) {
@@ -125,13 +127,13 @@ const Variant *Dictionary::getptr(const Variant &p_key) const {
 }
 
 Variant *Dictionary::getptr(const Variant &p_key) {
-	HashMap<Variant, Variant, VariantHasher, VariantComparator>::Iterator E;
+	DictionaryMap::Iterator E;
 
 	if (p_key.get_type() == Variant::STRING_NAME) {
 		const StringName *sn = VariantInternal::get_string_name(&p_key);
-		E = ((HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(sn->operator String());
+		E = ((DictionaryMap *)&_p->variant_map)->find(sn->operator String());
 	} else {
-		E = ((HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
+		E = ((DictionaryMap *)&_p->variant_map)->find(p_key);
 	}
 	if (!E) {
 		return nullptr;
@@ -145,13 +147,13 @@ Variant *Dictionary::getptr(const Variant &p_key) {
 }
 
 Variant Dictionary::get_valid(const Variant &p_key) const {
-	HashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstIterator E;
+	DictionaryMap::ConstIterator E;
 
 	if (p_key.get_type() == Variant::STRING_NAME) {
 		const StringName *sn = VariantInternal::get_string_name(&p_key);
-		E = ((const HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(sn->operator String());
+		E = ((const DictionaryMap *)&_p->variant_map)->find(sn->operator String());
 	} else {
-		E = ((const HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
+		E = ((const DictionaryMap *)&_p->variant_map)->find(p_key);
 	}
 
 	if (!E) {
@@ -229,7 +231,7 @@ bool Dictionary::recursive_equal(const Dictionary &p_dictionary, int recursion_c
 	}
 	recursion_count++;
 	for (const KeyValue<Variant, Variant> &this_E : _p->variant_map) {
-		HashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstIterator other_E = ((const HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&p_dictionary._p->variant_map)->find(this_E.key);
+		DictionaryMap::ConstIterator other_E = ((const DictionaryMap *)&p_dictionary._p->variant_map)->find(this_E.key);
 		if (!other_E || !this_E.value.hash_compare(other_E->value, recursion_count)) {
 			return false;
 		}
@@ -351,7 +353,7 @@ const Variant *Dictionary::next(const Variant *p_key) const {
 		}
 		return nullptr;
 	}
-	HashMap<Variant, Variant, VariantHasher, VariantComparator>::Iterator E = _p->variant_map.find(*p_key);
+	DictionaryMap::Iterator E = _p->variant_map.find(*p_key);
 
 	if (!E) {
 		return nullptr;
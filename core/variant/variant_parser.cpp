@@ -35,36 +35,88 @@
 #include "core/os/keyboard.h"
 #include "core/string/string_buffer.h"
 
-char32_t VariantParser::StreamFile::get_char() {
-	return f->get_8();
+char32_t VariantParser::Stream::_get_char_slow() {
+	if (!readahead_enabled) {
+		char32_t c = 0;
+		if (_read_buffer(&c, 1) == 0) {
+			return 0;
+		}
+		return c;
+	}
+
+	readahead_pointer = 0;
+	readahead_filled = _read_buffer(readahead_buffer, READAHEAD_SIZE);
+	if (readahead_filled == 0) {
+		// You need to try to read again when you have reached the end for EOF to be reported.
+		eof = true;
+		return 0;
+	}
+	return readahead_buffer[readahead_pointer++];
+}
+
+void VariantParser::Stream::_clear_readahead() {
+	readahead_pointer = 0;
+	readahead_filled = 0;
+	eof = false;
+}
+
+bool VariantParser::Stream::is_eof() const {
+	if (readahead_enabled) {
+		return eof;
+	}
+	return _is_eof();
+}
+
+uint32_t VariantParser::StreamFile::_read_buffer(char32_t *p_buffer, uint32_t p_num_chars) {
+	// Read the bytes into the same buffer, then widen them from the end.
+	uint8_t *bytes = reinterpret_cast<uint8_t *>(p_buffer);
+	const uint32_t num_read = f->get_buffer(bytes, p_num_chars);
+	for (int i = num_read - 1; i >= 0; i--) {
+		p_buffer[i] = bytes[i];
+	}
+	return num_read;
 }
 
 bool VariantParser::StreamFile::is_utf8() const {
 	return true;
 }
 
-bool VariantParser::StreamFile::is_eof() const {
+bool VariantParser::StreamFile::_is_eof() const {
 	return f->eof_reached();
 }
 
-char32_t VariantParser::StreamString::get_char() {
-	if (pos > s.length()) {
-		return 0;
-	} else if (pos == s.length()) {
-		// You need to try to read again when you have reached the end for EOF to be reported,
-		// so this works the same as files (like StreamFile does)
-		pos++;
-		return 0;
-	} else {
-		return s[pos++];
+uint64_t VariantParser::StreamFile::get_position() const {
+	// Characters are single bytes, including the saved one.
+	return f->get_position() - _get_readahead_size() - (saved ? 1 : 0);
+}
+
+void VariantParser::StreamFile::seek(uint64_t p_position) {
+	f->seek(p_position);
+	_clear_readahead();
+	saved = 0;
+}
+
+uint32_t VariantParser::StreamString::_read_buffer(char32_t *p_buffer, uint32_t p_num_chars) {
+	const int available = MAX(s.length() - pos, 0);
+	if (available >= (int)p_num_chars) {
+		memcpy(p_buffer, s.ptr() + pos, p_num_chars * sizeof(char32_t));
+		pos += p_num_chars;
+		return p_num_chars;
+	}
+
+	if (available) {
+		memcpy(p_buffer, s.ptr() + pos, available * sizeof(char32_t));
 	}
+	// Past the end, so this works the same as files (like StreamFile does).
+	pos += available + 1;
+	return available;
 }
 
 bool VariantParser::StreamString::is_utf8() const {
 	return false;
 }
 
-bool VariantParser::StreamString::is_eof() const {
+bool VariantParser::StreamString::_is_eof() const {
 	return pos > s.length();
 }
 
@@ -217,7 +269,7 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 				[[fallthrough]];
 			}
 			case '"': {
-				String str;
+				StringBuffer<> str;
 				char32_t prev = 0;
 				while (true) {
 					char32_t ch = p_stream->get_char();
@@ -339,15 +391,16 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 					return ERR_PARSE_ERROR;
 				}
 
+				String string = str.as_string();
 				if (p_stream->is_utf8()) {
-					str.parse_utf8(str.ascii(true).get_data());
+					string.parse_utf8(string.ascii(true).get_data());
 				}
 				if (string_name) {
 					r_token.type = TK_STRING_NAME;
-					r_token.value = StringName(str);
+					r_token.value = StringName(string);
 				} else {
 					r_token.type = TK_STRING;
-					r_token.value = str;
+					r_token.value = string;
 				}
 				return OK;
 
@@ -1148,6 +1201,62 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 	}
 }
 
+Error VariantParser::skip_value(Token &token, Stream *p_stream, int &line, String &r_err_str) {
+	int depth = 0;
+	bool arguments = false;
+	while (true) {
+		switch (token.type) {
+			case TK_CURLY_BRACKET_OPEN:
+			case TK_BRACKET_OPEN:
+			case TK_PARENTHESIS_OPEN: {
+				depth++;
+			} break;
+			case TK_CURLY_BRACKET_CLOSE:
+			case TK_BRACKET_CLOSE:
+			case TK_PARENTHESIS_CLOSE: {
+				depth--;
+				if (depth < 0) {
+					r_err_str = "Expected value, got " + String(tk_name[token.type]) + ".";
+					return ERR_PARSE_ERROR;
+				}
+			} break;
+			case TK_IDENTIFIER: {
+				if (depth > 0) {
+					break;
+				}
+				// Constructors, like Vector2(1, 2) or SubResource("1"), are followed
+				// by their arguments. Other identifiers are values by themselves.
+				while (p_stream->saved != 0 && p_stream->saved <= 32) {
+					if (p_stream->saved == '\n') {
+						line++;
+					}
+					p_stream->saved = p_stream->get_char();
+				}
+				arguments = p_stream->saved == '(';
+			} break;
+			case TK_EOF: {
+				r_err_str = "Unexpected EOF while parsing value";
+				return ERR_FILE_CORRUPT;
+			}
+			case TK_ERROR: {
+				return ERR_PARSE_ERROR;
+			}
+			default: {
+			}
+		}
+
+		if (depth == 0 && !arguments) {
+			return OK;
+		}
+		arguments = false;
+
+		Error err = get_token(p_stream, token, line, r_err_str);
+		if (err) {
+			return err;
+		}
+	}
+}
+
 Error VariantParser::_parse_array(Array &array, Stream *p_stream, int &line, String &r_err_str, ResourceParser *p_res_parser) {
 	Token token;
 	bool need_comma = false;
@@ -1376,10 +1485,10 @@ Error VariantParser::parse_tag(Stream *p_stream, int &line, String &r_err_str, T
 	return _parse_tag(token, p_stream, line, r_err_str, r_tag, p_res_parser, p_simple_tag);
 }
 
-Error VariantParser::parse_tag_assign_eof(Stream *p_stream, int &line, String &r_err_str, Tag &r_tag, String &r_assign, Variant &r_value, ResourceParser *p_res_parser, bool p_simple_tag) {
+Error VariantParser::_parse_tag_assign_eof(Stream *p_stream, int &line, String &r_err_str, Tag &r_tag, String &r_assign, Variant *r_value, ResourceParser *p_res_parser, bool p_simple_tag) {
 	//assign..
 	r_assign = "";
-	String what;
+	StringBuffer<> what;
 
 	while (true) {
 		char32_t c;
@@ -1431,15 +1540,19 @@ Error VariantParser::parse_tag_assign_eof(Stream *p_stream, int &line, String &r
 					return ERR_INVALID_DATA;
 				}
 
-				what = tk.value;
+				what = StringBuffer<>();
+				what += String(tk.value);
 
 			} else if (c != '=') {
-				what += String::chr(c);
+				what += c;
 			} else {
-				r_assign = what;
+				r_assign = what.as_string();
 				Token token;
 				get_token(p_stream, token, line, r_err_str);
-				Error err = parse_value(token, r_value, p_stream, line, r_err_str, p_res_parser);
+				if (!r_value) {
+					return skip_value(token, p_stream, line, r_err_str);
+				}
+				Error err = parse_value(token, *r_value, p_stream, line, r_err_str, p_res_parser);
 				return err;
 			}
 		} else if (c == '\n') {
@@ -1448,6 +1561,14 @@ Error VariantParser::parse_tag_assign_eof(Stream *p_stream, int &line, String &r
 	}
 }
 
+Error VariantParser::parse_tag_assign_eof(Stream *p_stream, int &line, String &r_err_str, Tag &r_tag, String &r_assign, Variant &r_value, ResourceParser *p_res_parser, bool p_simple_tag) {
+	return _parse_tag_assign_eof(p_stream, line, r_err_str, r_tag, r_assign, &r_value, p_res_parser, p_simple_tag);
+}
+
+Error VariantParser::skip_tag_assign_eof(Stream *p_stream, int &line, String &r_err_str, Tag &r_tag, String &r_assign, ResourceParser *p_res_parser, bool p_simple_tag) {
+	return _parse_tag_assign_eof(p_stream, line, r_err_str, r_tag, r_assign, nullptr, p_res_parser, p_simple_tag);
+}
+
 Error VariantParser::parse(Stream *p_stream, Variant &r_ret, String &r_err_str, int &r_err_line, ResourceParser *p_res_parser) {
 	Token token;
 	Error err = get_token(p_stream, token, r_err_line, r_err_str);
@@ -1724,7 +1845,7 @@ Error VariantWriter::write(const Variant &p_variant, StoreStringFunc p_store_str
 					if (i > 0) {
 						p_store_string_func(p_store_string_ud, ", ");
 					}
-					write(array[i], p_store_string_func, p_store_string_ud, p_encode_res_func, p_encode_res_ud, recursion_count);
+					write(array.get(i), p_store_string_func, p_store_string_ud, p_encode_res_func, p_encode_res_ud, recursion_count);
 				}
 
 				p_store_string_func(p_store_string_ud, "]");
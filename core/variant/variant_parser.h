@@ -38,33 +38,72 @@
 class VariantParser {
 public:
 	struct Stream {
-		virtual char32_t get_char() = 0;
-		virtual bool is_utf8() const = 0;
-		virtual bool is_eof() const = 0;
-
+	private:
+		enum {
+			READAHEAD_SIZE = 4096,
+		};
+		char32_t readahead_buffer[READAHEAD_SIZE];
+		uint32_t readahead_pointer = 0;
+		uint32_t readahead_filled = 0;
+		bool eof = false;
+
+		char32_t _get_char_slow();
+
+	protected:
+		// Reads up to p_num_chars characters, returns how many were read.
+		virtual uint32_t _read_buffer(char32_t *p_buffer, uint32_t p_num_chars) = 0;
+		virtual bool _is_eof() const = 0;
+
+		_FORCE_INLINE_ uint32_t _get_readahead_size() const { return readahead_filled - readahead_pointer; }
+		void _clear_readahead();
+
+	public:
 		char32_t saved = 0;
+		// Characters are read in chunks, unless disabled. When disabled, what
+		// was read from the underlying file or string is only what was parsed.
+		bool readahead_enabled = true;
+
+		_FORCE_INLINE_ char32_t get_char() {
+			if (likely(readahead_pointer < readahead_filled)) {
+				return readahead_buffer[readahead_pointer++];
+			}
+			return _get_char_slow();
+		}
+		virtual bool is_utf8() const = 0;
+		bool is_eof() const;
 
 		Stream() {}
 		virtual ~Stream() {}
 	};
 
 	struct StreamFile : public Stream {
+	protected:
+		virtual uint32_t _read_buffer(char32_t *p_buffer, uint32_t p_num_chars) override;
+		virtual bool _is_eof() const override;
+
+	public:
 		Ref<FileAccess> f;
 
-		virtual char32_t get_char() override;
 		virtual bool is_utf8() const override;
-		virtual bool is_eof() const override;
+
+		// Position in the file of the next character get_char() returns, which
+		// can be given to seek() to parse from there again.
+		uint64_t get_position() const;
+		void seek(uint64_t p_position);
 
 		StreamFile() {}
 	};
 
 	struct StreamString : public Stream {
+	protected:
+		virtual uint32_t _read_buffer(char32_t *p_buffer, uint32_t p_num_chars) override;
+		virtual bool _is_eof() const override;
+
+	public:
 		String s;
 		int pos = 0;
 
-		virtual char32_t get_char() override;
 		virtual bool is_utf8() const override;
-		virtual bool is_eof() const override;
 
 		StreamString() {}
 	};
@@ -125,12 +164,18 @@ private:
 	static Error _parse_dictionary(Dictionary &object, Stream *p_stream, int &line, String &r_err_str, ResourceParser *p_res_parser = nullptr);
 	static Error _parse_array(Array &array, Stream *p_stream, int &line, String &r_err_str, ResourceParser *p_res_parser = nullptr);
 	static Error _parse_tag(Token &token, Stream *p_stream, int &line, String &r_err_str, Tag &r_tag, ResourceParser *p_res_parser = nullptr, bool p_simple_tag = false);
+	static Error _parse_tag_assign_eof(Stream *p_stream, int &line, String &r_err_str, Tag &r_tag, String &r_assign, Variant *r_value, ResourceParser *p_res_parser, bool p_simple_tag);
 
 public:
 	static Error parse_tag(Stream *p_stream, int &line, String &r_err_str, Tag &r_tag, ResourceParser *p_res_parser = nullptr, bool p_simple_tag = false);
 	static Error parse_tag_assign_eof(Stream *p_stream, int &line, String &r_err_str, Tag &r_tag, String &r_assign, Variant &r_value, ResourceParser *p_res_parser = nullptr, bool p_simple_tag = false);
 
+	// Same as parse_tag_assign_eof(), but skips the value instead of parsing it.
+	static Error skip_tag_assign_eof(Stream *p_stream, int &line, String &r_err_str, Tag &r_tag, String &r_assign, ResourceParser *p_res_parser = nullptr, bool p_simple_tag = false);
+
 	static Error parse_value(Token &token, Variant &value, Stream *p_stream, int &line, String &r_err_str, ResourceParser *p_res_parser = nullptr);
+	// Reads past the value that starts with token, without creating it.
+	static Error skip_value(Token &token, Stream *p_stream, int &line, String &r_err_str);
 	static Error get_token(Stream *p_stream, Token &r_token, int &line, String &r_err_str);
 	static Error parse(Stream *p_stream, Variant &r_ret, String &r_err_str, int &r_err_line, ResourceParser *p_res_parser = nullptr);
 };
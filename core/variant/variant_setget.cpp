@@ -611,7 +611,7 @@ struct VariantIndexedSetGet_Array {
 			*oob = true;
 			return;
 		}
-		*value = (*VariantGetInternalPtr<Array>::get_ptr(base))[index];
+		*value = VariantGetInternalPtr<Array>::get_ptr(base)->get(index);
 		*oob = false;
 	}
 	static void ptr_get(const void *base, int64_t index, void *member) {
@@ -621,7 +621,7 @@ struct VariantIndexedSetGet_Array {
 			index += v.size();
 		}
 		OOB_TEST(index, v.size());
-		PtrToArg<Variant>::encode(v[index], member);
+		PtrToArg<Variant>::encode(v.get(index), member);
 	}
 	static void set(Variant *base, int64_t index, const Variant *value, bool *valid, bool *oob) {
 		if (VariantGetInternalPtr<Array>::get_ptr(base)->is_read_only()) {
@@ -0,0 +1,336 @@
+/*************************************************************************/
+/*  file_access_async_uring.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "file_access_async_uring.h"
+
+#ifdef IO_URING_ENABLED
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int _io_uring_setup(uint32_t p_entries, struct io_uring_params *p_params) {
+#ifdef __NR_io_uring_setup
+	return syscall(__NR_io_uring_setup, p_entries, p_params);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+static int _io_uring_enter(int p_fd, uint32_t p_to_submit, uint32_t p_min_complete, uint32_t p_flags) {
+#ifdef __NR_io_uring_enter
+	return syscall(__NR_io_uring_enter, p_fd, p_to_submit, p_min_complete, p_flags, nullptr, 0);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+Error FileAccessAsyncUring::_push_locked(UringRead *p_read) {
+	const uint32_t tail = *sq_tail; // Only written here.
+	const uint32_t index = tail & *sq_mask;
+
+	struct io_uring_sqe *sqe = &sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = IORING_OP_NOP;
+	sqe->fd = -1;
+	if (p_read) {
+		sqe->opcode = p_read->opcode;
+		sqe->fd = p_read->fd;
+		sqe->user_data = (uint64_t)(uintptr_t)p_read;
+		if (p_read->opcode == IORING_OP_FADVISE) {
+			sqe->off = p_read->os_offset;
+			sqe->len = MIN(p_read->length, (uint64_t)UINT32_MAX);
+			sqe->fadvise_advice = POSIX_FADV_WILLNEED;
+		} else {
+			// Also continues short reads.
+			p_read->iov.iov_base = p_read->buffer + p_read->read;
+			p_read->iov.iov_len = p_read->length - p_read->read;
+			sqe->off = p_read->os_offset + p_read->read;
+			sqe->addr = (uint64_t)(uintptr_t)&p_read->iov;
+			sqe->len = 1;
+		}
+	}
+	sq_array[index] = index;
+	__atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	int ret;
+	do {
+		ret = _io_uring_enter(ring_fd, 1, 0, 0);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret < 1) {
+		// Not consumed, the kernel only reads the queue when entered.
+		__atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+		ERR_FAIL_V_MSG(ERR_BUSY, "Cannot submit read to io_uring: " + String(strerror(errno)) + ".");
+	}
+	return OK;
+}
+
+Error FileAccessAsyncUring::_push(UringRead *p_read) {
+	MutexLock lock(submit_mutex);
+	return _push_locked(p_read);
+}
+
+void FileAccessAsyncUring::_release_file(UringRead *p_read) {
+	OpenFile *file = open_files.getptr(p_read->os_path);
+	ERR_FAIL_COND(!file);
+	file->refcount--;
+	if (file->refcount == 0) {
+		::close(file->fd);
+		open_files.erase(p_read->os_path);
+	}
+	p_read->fd = -1;
+}
+
+void FileAccessAsyncUring::_complete(UringRead *p_read, Status p_status) {
+	List<UringRead *> failed;
+	{
+		MutexLock lock(submit_mutex);
+		_release_file(p_read);
+		in_flight--;
+
+		while (!queued.is_empty() && in_flight < sq_entries) {
+			UringRead *next = queued.front()->get();
+			queued.pop_front();
+			if (_push_locked(next) == OK) {
+				in_flight++;
+			} else {
+				_release_file(next);
+				failed.push_back(next);
+			}
+		}
+	}
+
+	// The reads may be released as soon as they are finished.
+	_finish(p_read, p_status);
+	for (UringRead *E : failed) {
+		_finish(E, STATUS_FAILED);
+	}
+}
+
+bool FileAccessAsyncUring::_process_completion(const struct io_uring_cqe &p_cqe) {
+	if (p_cqe.user_data == 0) {
+		return false; // Asked to exit.
+	}
+
+	UringRead *r = (UringRead *)(uintptr_t)p_cqe.user_data;
+	if (p_cqe.res < 0) {
+		if ((p_cqe.res == -EINTR || p_cqe.res == -EAGAIN) && _push(r) == OK) {
+			return true;
+		}
+		_complete(r, STATUS_FAILED);
+		return true;
+	}
+
+	if (r->opcode == IORING_OP_FADVISE) {
+		_complete(r, STATUS_DONE);
+		return true;
+	}
+
+	r->read += p_cqe.res;
+	if (p_cqe.res > 0 && r->read < r->length) {
+		if (_push(r) != OK) {
+			_complete(r, STATUS_FAILED);
+		}
+		return true;
+	}
+
+	// Done, or the end of the file was reached.
+	_complete(r, STATUS_DONE);
+	return true;
+}
+
+void FileAccessAsyncUring::_completion_thread_func(void *p_userdata) {
+	FileAccessAsyncUring *self = (FileAccessAsyncUring *)p_userdata;
+
+	bool exit = false;
+	while (!exit) {
+		if (_io_uring_enter(self->ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+			ERR_PRINT("Cannot wait for io_uring completions: " + String(strerror(errno)) + ".");
+			break;
+		}
+
+		uint32_t head = *self->cq_head;
+		const uint32_t tail = __atomic_load_n(self->cq_tail, __ATOMIC_ACQUIRE);
+		while (head != tail) {
+			const struct io_uring_cqe cqe = self->cqes[head & *self->cq_mask];
+			head++;
+			// Free the entry first, processing it may submit more reads.
+			__atomic_store_n(self->cq_head, head, __ATOMIC_RELEASE);
+			if (!self->_process_completion(cqe)) {
+				exit = true;
+			}
+		}
+	}
+}
+
+bool FileAccessAsyncUring::_locate(UringRead *p_read) {
+	uint64_t offset = 0;
+	uint64_t size = 0;
+	if (!_get_os_location(p_read->path, p_read->os_path, offset, size)) {
+		return false;
+	}
+
+	if (size != UINT64_MAX) {
+		// Don't read past the end of the file in the pack.
+		p_read->length = p_read->offset < size ? MIN(p_read->length, size - p_read->offset) : 0;
+	}
+	p_read->os_offset = offset + p_read->offset;
+	return true;
+}
+
+Error FileAccessAsyncUring::_enqueue(UringRead *p_read) {
+	if (p_read->length == 0) {
+		_finish(p_read, STATUS_DONE);
+		return OK;
+	}
+
+	MutexLock lock(submit_mutex);
+
+	OpenFile *file = open_files.getptr(p_read->os_path);
+	if (!file) {
+		const int fd = ::open(p_read->os_path.utf8().get_data(), O_RDONLY | O_CLOEXEC);
+		if (fd == -1) {
+			_finish(p_read, STATUS_FAILED);
+			return OK;
+		}
+		OpenFile new_file;
+		new_file.fd = fd;
+		file = &open_files.insert(p_read->os_path, new_file)->value;
+	}
+	file->refcount++;
+	p_read->fd = file->fd;
+
+	if (in_flight >= sq_entries) {
+		queued.push_back(p_read);
+		return OK;
+	}
+
+	Error err = _push_locked(p_read);
+	if (err != OK) {
+		_release_file(p_read);
+		return err;
+	}
+	in_flight++;
+	return OK;
+}
+
+Error FileAccessAsyncUring::_submit(Read *p_read) {
+	UringRead *r = static_cast<UringRead *>(p_read);
+	if (!_locate(r)) {
+		return FileAccessAsync::_submit(p_read);
+	}
+	return _enqueue(r);
+}
+
+Error FileAccessAsyncUring::_submit_prefetch(Read *p_read) {
+	UringRead *r = static_cast<UringRead *>(p_read);
+	if (!_locate(r)) {
+		return ERR_UNAVAILABLE; // Only readable through FileAccess.
+	}
+	r->opcode = IORING_OP_FADVISE;
+	return _enqueue(r);
+}
+
+Error FileAccessAsyncUring::_initialize() {
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	ring_fd = _io_uring_setup(QUEUE_ENTRIES, &params);
+	if (ring_fd < 0) {
+		// Not supported by the kernel, or not allowed.
+		ring_fd = -1;
+		return ERR_UNAVAILABLE;
+	}
+
+	sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+	if (single_mmap) {
+		sq_ring_size = MAX(sq_ring_size, cq_ring_size);
+		cq_ring_size = sq_ring_size;
+	}
+
+	void *ptr = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+	ERR_FAIL_COND_V(ptr == MAP_FAILED, ERR_UNAVAILABLE);
+	sq_ring = (uint8_t *)ptr;
+
+	if (single_mmap) {
+		cq_ring = sq_ring;
+	} else {
+		ptr = mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+		ERR_FAIL_COND_V(ptr == MAP_FAILED, ERR_UNAVAILABLE);
+		cq_ring = (uint8_t *)ptr;
+	}
+
+	sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	ptr = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+	ERR_FAIL_COND_V(ptr == MAP_FAILED, ERR_UNAVAILABLE);
+	sqes = (struct io_uring_sqe *)ptr;
+
+	sq_head = (uint32_t *)(sq_ring + params.sq_off.head);
+	sq_tail = (uint32_t *)(sq_ring + params.sq_off.tail);
+	sq_mask = (uint32_t *)(sq_ring + params.sq_off.ring_mask);
+	sq_array = (uint32_t *)(sq_ring + params.sq_off.array);
+	sq_entries = params.sq_entries;
+	cq_head = (uint32_t *)(cq_ring + params.cq_off.head);
+	cq_tail = (uint32_t *)(cq_ring + params.cq_off.tail);
+	cq_mask = (uint32_t *)(cq_ring + params.cq_off.ring_mask);
+	cqes = (struct io_uring_cqe *)(cq_ring + params.cq_off.cqes);
+
+	completion_thread.start(_completion_thread_func, this);
+	return OK;
+}
+
+FileAccessAsyncUring::~FileAccessAsyncUring() {
+	if (completion_thread.is_started()) {
+		_push(nullptr);
+		completion_thread.wait_to_finish();
+	}
+
+	if (sqes) {
+		munmap(sqes, sqes_size);
+	}
+	if (cq_ring && cq_ring != sq_ring) {
+		munmap(cq_ring, cq_ring_size);
+	}
+	if (sq_ring) {
+		munmap(sq_ring, sq_ring_size);
+	}
+	if (ring_fd != -1) {
+		::close(ring_fd);
+	}
+}
+
+#endif // IO_URING_ENABLED
@@ -0,0 +1,131 @@
+/*************************************************************************/
+/*  file_access_async_uring.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_ACCESS_ASYNC_URING_H
+#define FILE_ACCESS_ASYNC_URING_H
+
+#include "core/io/file_access_async.h"
+
+// Needs kernel headers from Linux 5.6 or later, for IORING_OP_FADVISE. Android
+// apps can't use io_uring. Otherwise the threaded reads of FileAccessAsync are
+// used.
+#if defined(UNIX_ENABLED) && defined(__linux__) && !defined(__ANDROID__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>) && __has_include(<linux/version.h>)
+#include <linux/version.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 6, 0)
+#define IO_URING_ENABLED
+#endif
+#endif
+#endif
+
+#ifdef IO_URING_ENABLED
+
+#include "core/os/thread.h"
+#include "core/templates/list.h"
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+// Reads files with io_uring: reads are queued to the kernel, and a single
+// thread waits for all of them to complete. Files that can't be read directly
+// (such as encrypted files in packs) are read on the WorkerThreadPool instead.
+// Prefetching is done with IORING_OP_FADVISE, so the kernel reads ahead into
+// the page cache.
+class FileAccessAsyncUring : public FileAccessAsync {
+	static constexpr uint32_t QUEUE_ENTRIES = 64;
+
+	struct UringRead : public Read {
+		uint8_t opcode = IORING_OP_READV; // Or IORING_OP_FADVISE to prefetch.
+		String os_path;
+		int fd = -1;
+		uint64_t os_offset = 0;
+		struct iovec iov;
+	};
+
+	struct OpenFile {
+		int fd = -1;
+		uint32_t refcount = 0;
+	};
+
+	int ring_fd = -1;
+
+	uint8_t *sq_ring = nullptr;
+	size_t sq_ring_size = 0;
+	uint8_t *cq_ring = nullptr;
+	size_t cq_ring_size = 0;
+	struct io_uring_sqe *sqes = nullptr;
+	size_t sqes_size = 0;
+
+	uint32_t *sq_head = nullptr;
+	uint32_t *sq_tail = nullptr;
+	uint32_t *sq_mask = nullptr;
+	uint32_t *sq_array = nullptr;
+	uint32_t sq_entries = 0;
+	uint32_t *cq_head = nullptr;
+	uint32_t *cq_tail = nullptr;
+	uint32_t *cq_mask = nullptr;
+	struct io_uring_cqe *cqes = nullptr;
+
+	// Guards the submission queue and everything below.
+	Mutex submit_mutex;
+	HashMap<String, OpenFile> open_files;
+	List<UringRead *> queued; // Waiting for the queue to have room.
+	uint32_t in_flight = 0;
+
+	Thread completion_thread;
+
+	// A nullptr read pushes a no-op, to wake up the completion thread.
+	Error _push(UringRead *p_read);
+	Error _push_locked(UringRead *p_read);
+	// Where p_read is on the OS filesystem, false if not readable directly.
+	bool _locate(UringRead *p_read);
+	Error _enqueue(UringRead *p_read);
+	void _release_file(UringRead *p_read);
+	void _complete(UringRead *p_read, Status p_status);
+	bool _process_completion(const struct io_uring_cqe &p_cqe);
+
+	static void _completion_thread_func(void *p_userdata);
+
+protected:
+	virtual Read *_create_read() override { return memnew(UringRead); }
+	virtual Error _submit(Read *p_read) override;
+	virtual Error _submit_prefetch(Read *p_read) override;
+	virtual Error _initialize() override;
+
+public:
+	virtual bool uses_threads() const override { return false; }
+
+	FileAccessAsyncUring() {}
+	virtual ~FileAccessAsyncUring();
+};
+
+#endif // IO_URING_ENABLED
+
+#endif // FILE_ACCESS_ASYNC_URING_H
@@ -0,0 +1,234 @@
+/*************************************************************************/
+/*  file_access_unix_mapped.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "file_access_unix_mapped.h"
+
+#if defined(UNIX_ENABLED)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Error FileAccessUnixMapped::_open(const String &p_path, int p_mode_flags) {
+	_close();
+
+	ERR_FAIL_COND_V_MSG(p_mode_flags != READ, ERR_UNAVAILABLE, "Memory mapped files can only be opened for reading.");
+
+	path_src = p_path;
+	path = fix_path(p_path);
+
+	int fd = ::open(path.utf8().get_data(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		return errno == ENOENT ? ERR_FILE_NOT_FOUND : ERR_FILE_CANT_OPEN;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		::close(fd);
+		return ERR_FILE_CANT_OPEN;
+	}
+
+	length = st.st_size;
+	if (length > 0) {
+		// Pages are only copied when written to, which only happens to the headers of
+		// adopted arrays. Fall back to read-only if the system won't commit that much.
+		void *mem = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if (mem != MAP_FAILED) {
+			mapping = memnew(Mapping);
+			mapping->data = (uint8_t *)mem;
+			mapping->length = length;
+			mapping->refcount.init();
+		} else {
+			mem = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		if (mem == MAP_FAILED) {
+			::close(fd);
+			length = 0;
+			return ERR_FILE_CANT_OPEN;
+		}
+		data = (const uint8_t *)mem;
+	}
+
+	// The mapping keeps the file referenced.
+	::close(fd);
+
+	pos = 0;
+	eof = false;
+	opened = true;
+	return OK;
+}
+
+void FileAccessUnixMapped::Mapping::retain() {
+	refcount.ref();
+}
+
+void FileAccessUnixMapped::Mapping::release() {
+	if (refcount.unref()) {
+		munmap(data, length);
+		memdelete(this);
+	}
+}
+
+void FileAccessUnixMapped::_close() {
+	if (mapping) {
+		mapping->release();
+		mapping = nullptr;
+	} else if (data) {
+		munmap((void *)data, length);
+	}
+	data = nullptr;
+	length = 0;
+	opened = false;
+}
+
+void FileAccessUnixMapped::_set_mapping_hint(MappingHint p_hint) {
+	if (!data) {
+		return;
+	}
+
+	int advice = MADV_NORMAL;
+	switch (p_hint) {
+		case MAPPING_HINT_NORMAL: {
+			advice = MADV_NORMAL;
+		} break;
+		case MAPPING_HINT_SEQUENTIAL: {
+			advice = MADV_SEQUENTIAL;
+		} break;
+		case MAPPING_HINT_RANDOM: {
+			advice = MADV_RANDOM;
+		} break;
+	}
+	madvise((void *)data, length, advice);
+}
+
+bool FileAccessUnixMapped::is_open() const {
+	return opened;
+}
+
+String FileAccessUnixMapped::get_path() const {
+	return path_src;
+}
+
+String FileAccessUnixMapped::get_path_absolute() const {
+	return path;
+}
+
+void FileAccessUnixMapped::seek(uint64_t p_position) {
+	ERR_FAIL_COND_MSG(!opened, "File must be opened before use.");
+
+	eof = p_position > length;
+	pos = MIN(p_position, length);
+}
+
+void FileAccessUnixMapped::seek_end(int64_t p_position) {
+	ERR_FAIL_COND_MSG(!opened, "File must be opened before use.");
+	ERR_FAIL_COND(p_position > 0 || (uint64_t)-p_position > length);
+
+	seek(length + p_position);
+}
+
+uint64_t FileAccessUnixMapped::get_position() const {
+	ERR_FAIL_COND_V_MSG(!opened, 0, "File must be opened before use.");
+	return pos;
+}
+
+uint64_t FileAccessUnixMapped::get_length() const {
+	ERR_FAIL_COND_V_MSG(!opened, 0, "File must be opened before use.");
+	return length;
+}
+
+bool FileAccessUnixMapped::eof_reached() const {
+	return eof;
+}
+
+uint8_t FileAccessUnixMapped::get_8() const {
+	ERR_FAIL_COND_V_MSG(!opened, 0, "File must be opened before use.");
+	if (pos >= length) {
+		eof = true;
+		return 0;
+	}
+	return data[pos++];
+}
+
+uint64_t FileAccessUnixMapped::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
+	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
+	ERR_FAIL_COND_V_MSG(!opened, -1, "File must be opened before use.");
+
+	uint64_t to_read = p_length;
+	if (to_read > length - pos) {
+		eof = true;
+		to_read = length - pos;
+	}
+	if (to_read > 0) {
+		memcpy(p_dst, data + pos, to_read);
+		pos += to_read;
+	}
+	return to_read;
+}
+
+const uint8_t *FileAccessUnixMapped::get_buffer_view(uint64_t p_length) const {
+	ERR_FAIL_COND_V_MSG(!opened, nullptr, "File must be opened before use.");
+
+	if (p_length > length - pos) {
+		return nullptr;
+	}
+	const uint8_t *view = data + pos;
+	pos += p_length;
+	return view;
+}
+
+CowDataOwner *FileAccessUnixMapped::get_buffer_view_owner() const {
+	return mapping;
+}
+
+Error FileAccessUnixMapped::get_error() const {
+	return eof ? ERR_FILE_EOF : OK;
+}
+
+void FileAccessUnixMapped::flush() {
+	ERR_FAIL_MSG("Memory mapped files are read-only.");
+}
+
+void FileAccessUnixMapped::store_8(uint8_t p_dest) {
+	ERR_FAIL_MSG("Memory mapped files are read-only.");
+}
+
+void FileAccessUnixMapped::store_buffer(const uint8_t *p_src, uint64_t p_length) {
+	ERR_FAIL_MSG("Memory mapped files are read-only.");
+}
+
+FileAccessUnixMapped::~FileAccessUnixMapped() {
+	_close();
+}
+
+#endif // UNIX_ENABLED
@@ -0,0 +1,97 @@
+/*************************************************************************/
+/*  file_access_unix_mapped.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_ACCESS_UNIX_MAPPED_H
+#define FILE_ACCESS_UNIX_MAPPED_H
+
+#include "drivers/unix/file_access_unix.h"
+
+#if defined(UNIX_ENABLED)
+
+// Read-only file access that maps the whole file in memory, so reading doesn't
+// go through a system call or the stdio buffer, and get_buffer_view() can hand
+// out pointers into the file. The file must not be truncated while mapped.
+class FileAccessUnixMapped : public FileAccessUnix {
+	// Outlives the file access if data was adopted from it.
+	struct Mapping : public CowDataOwner {
+		SafeRefCount refcount;
+		uint8_t *data = nullptr;
+		uint64_t length = 0;
+
+		virtual void retain() override;
+		virtual void release() override;
+	};
+
+	Mapping *mapping = nullptr; // Only if it could be mapped writable (copy on write).
+	const uint8_t *data = nullptr;
+	uint64_t length = 0;
+	mutable uint64_t pos = 0;
+	mutable bool eof = false;
+	bool opened = false;
+	String path;
+	String path_src;
+
+	void _close();
+
+protected:
+	virtual void _set_mapping_hint(MappingHint p_hint) override;
+
+public:
+	virtual Error _open(const String &p_path, int p_mode_flags) override;
+	virtual bool is_open() const override;
+
+	virtual String get_path() const override;
+	virtual String get_path_absolute() const override;
+
+	virtual void seek(uint64_t p_position) override;
+	virtual void seek_end(int64_t p_position = 0) override;
+	virtual uint64_t get_position() const override;
+	virtual uint64_t get_length() const override;
+
+	virtual bool eof_reached() const override;
+
+	virtual uint8_t get_8() const override;
+	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual const uint8_t *get_buffer_view(uint64_t p_length) const override;
+	virtual CowDataOwner *get_buffer_view_owner() const override;
+
+	virtual Error get_error() const override;
+
+	virtual void flush() override;
+	virtual void store_8(uint8_t p_dest) override;
+	virtual void store_buffer(const uint8_t *p_src, uint64_t p_length) override;
+
+	FileAccessUnixMapped() {}
+	virtual ~FileAccessUnixMapped();
+};
+
+#endif // UNIX_ENABLED
+
+#endif // FILE_ACCESS_UNIX_MAPPED_H
@@ -36,7 +36,9 @@
 #include "core/debugger/engine_debugger.h"
 #include "core/debugger/script_debugger.h"
 #include "drivers/unix/dir_access_unix.h"
+#include "drivers/unix/file_access_async_uring.h"
 #include "drivers/unix/file_access_unix.h"
+#include "drivers/unix/file_access_unix_mapped.h"
 #include "drivers/unix/net_socket_posix.h"
 #include "drivers/unix/thread_posix.h"
 #include "servers/rendering_server.h"
@@ -138,6 +140,12 @@ void OS_Unix::initialize_core() {
 	FileAccess::make_default<FileAccessUnix>(FileAccess::ACCESS_RESOURCES);
 	FileAccess::make_default<FileAccessUnix>(FileAccess::ACCESS_USERDATA);
 	FileAccess::make_default<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+	FileAccess::make_default_mapped<FileAccessUnixMapped>(FileAccess::ACCESS_RESOURCES);
+	FileAccess::make_default_mapped<FileAccessUnixMapped>(FileAccess::ACCESS_USERDATA);
+	FileAccess::make_default_mapped<FileAccessUnixMapped>(FileAccess::ACCESS_FILESYSTEM);
+#ifdef IO_URING_ENABLED
+	FileAccessAsync::make_default<FileAccessAsyncUring>();
+#endif
 	DirAccess::make_default<DirAccessUnix>(DirAccess::ACCESS_RESOURCES);
 	DirAccess::make_default<DirAccessUnix>(DirAccess::ACCESS_USERDATA);
 	DirAccess::make_default<DirAccessUnix>(DirAccess::ACCESS_FILESYSTEM);
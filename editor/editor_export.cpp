@@ -36,8 +36,11 @@
 #include "core/io/config_file.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/file_access_memory.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/io/marshalls.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/io/zip_io.h"
@@ -63,6 +66,36 @@ static int _get_pad(int p_alignment, int p_n) {
 
 #define PCK_PADDING 16
 
+// Small compressed resources gain the most from a dictionary. They are held in
+// memory until the dictionary is trained on them.
+#define ZSTD_DICTIONARY_MAX_RESOURCE_SIZE (128 * 1024)
+#define ZSTD_DICTIONARY_MAX_HELD_SIZE (64 * 1024 * 1024)
+
+// Contents of a resource compressed with Zstandard and no dictionary, empty for anything else.
+static Vector<uint8_t> _decompress_resource(const Vector<uint8_t> &p_data) {
+	if (p_data.size() < 8 || memcmp(p_data.ptr(), "RSCC", 4) != 0 || decode_uint32(p_data.ptr() + 4) != Compression::MODE_ZSTD) {
+		return Vector<uint8_t>();
+	}
+
+	Ref<FileAccessMemory> fm;
+	fm.instantiate();
+	fm->open_custom(p_data.ptr(), p_data.size());
+	fm->seek(4);
+	Ref<FileAccessCompressed> fac;
+	fac.instantiate();
+	fac->configure("RSCC");
+	if (fac->open_after_magic(fm) != OK) {
+		return Vector<uint8_t>();
+	}
+
+	Vector<uint8_t> data;
+	data.resize(fac->get_length());
+	if (fac->get_buffer(data.ptrw(), data.size()) != uint64_t(data.size())) {
+		return Vector<uint8_t>();
+	}
+	return data;
+}
+
 bool EditorExportPreset::_set(const StringName &p_name, const Variant &p_value) {
 	if (values.has(p_name)) {
 		values[p_name] = p_value;
@@ -385,6 +418,25 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 
 	PackData *pd = (PackData *)p_userdata;
 
+	if (pd->hold_compressed_resources && p_data.size() <= ZSTD_DICTIONARY_MAX_RESOURCE_SIZE) {
+		Vector<uint8_t> data = _decompress_resource(p_data);
+		if (!data.is_empty() && pd->held_size + data.size() <= ZSTD_DICTIONARY_MAX_HELD_SIZE) {
+			HeldResource held;
+			held.path = p_path;
+			held.data = data;
+			held.enc_in_filters = p_enc_in_filters;
+			held.enc_ex_filters = p_enc_ex_filters;
+			held.key = p_key;
+			pd->held_size += data.size();
+			pd->held_resources.push_back(held);
+
+			if (pd->ep->step(TTR("Storing File:") + " " + p_path, 2 + p_file * 100 / p_total, false)) {
+				return ERR_SKIP;
+			}
+			return OK;
+		}
+	}
+
 	SavedData sd;
 	sd.path_utf8 = p_path.utf8();
 	sd.ofs = pd->f->get_position();
@@ -1203,6 +1255,51 @@ Error EditorExportPlatform::_add_shared_object(void *p_userdata, const SharedObj
 	return OK;
 }
 
+Error EditorExportPlatform::_save_held_resources(PackData *p_pack_data, int p_dictionary_size) {
+	p_pack_data->hold_compressed_resources = false;
+
+	Vector<Vector<uint8_t>> samples;
+	for (const HeldResource &held : p_pack_data->held_resources) {
+		samples.push_back(held.data);
+	}
+	const Vector<uint8_t> dictionary = Compression::train_zstd_dictionary(samples, p_dictionary_size);
+	samples.clear();
+
+	const int total = p_pack_data->held_resources.size() + 1;
+	uint32_t dictionary_id = 0;
+	Error err = OK;
+	if (!dictionary.is_empty()) {
+		// Loading the pack adds the dictionary, it can't be encrypted.
+		dictionary_id = Compression::add_zstd_dictionary(dictionary);
+		err = _save_pack_file(p_pack_data, PackedData::ZSTD_DICTIONARY_PATH, dictionary, 0, total, Vector<String>(), Vector<String>(), Vector<uint8_t>());
+	}
+
+	// Compress the resources again, with the dictionary if there is one.
+	const String tmp_path = EditorPaths::get_singleton()->get_cache_dir().plus_file("packtmp_resource");
+	for (int i = 0; i < p_pack_data->held_resources.size() && err == OK; i++) {
+		const HeldResource &held = p_pack_data->held_resources[i];
+		{
+			Ref<FileAccessCompressed> fac;
+			fac.instantiate();
+			fac->configure("RSCC", Compression::MODE_ZSTD, 0, dictionary_id);
+			err = fac->_open(tmp_path, FileAccess::WRITE);
+			if (err != OK) {
+				break;
+			}
+			fac->store_buffer(held.data.ptr(), held.data.size());
+		}
+		err = _save_pack_file(p_pack_data, held.path, FileAccess::get_file_as_array(tmp_path), i + 1, total, held.enc_in_filters, held.enc_ex_filters, held.key);
+	}
+	DirAccess::remove_file_or_error(tmp_path);
+
+	if (dictionary_id != 0) {
+		Compression::remove_zstd_dictionary(dictionary_id);
+	}
+	p_pack_data->held_resources.clear();
+	p_pack_data->held_size = 0;
+	return err;
+}
+
 Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, bool p_debug, const String &p_path, Vector<SharedObject> *p_so_files, bool p_embed, int64_t *r_embedded_start, int64_t *r_embedded_size) {
 	EditorProgress ep("savepack", TTR("Packing"), 102, true);
 
@@ -1221,8 +1318,13 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 	pd.ep = &ep;
 	pd.f = ftmp;
 	pd.so_files = p_so_files;
+	const int dictionary_size = GLOBAL_GET("compression/formats/zstd/pack_dictionary_size");
+	pd.hold_compressed_resources = dictionary_size > 0;
 
 	Error err = export_project_files(p_preset, p_debug, _save_pack_file, &pd, _add_shared_object);
+	if (err == OK && !pd.held_resources.is_empty()) {
+		err = _save_held_resources(&pd, dictionary_size);
+	}
 
 	// Close temp file.
 	pd.f.unref();
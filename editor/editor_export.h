@@ -197,11 +197,23 @@ private:
 		}
 	};
 
+	// Compressed resource held back until the pack's Zstandard dictionary is trained.
+	struct HeldResource {
+		String path;
+		Vector<uint8_t> data; // Decompressed.
+		Vector<String> enc_in_filters;
+		Vector<String> enc_ex_filters;
+		Vector<uint8_t> key;
+	};
+
 	struct PackData {
 		Ref<FileAccess> f;
 		Vector<SavedData> file_ofs;
 		EditorProgress *ep = nullptr;
 		Vector<SharedObject> *so_files = nullptr;
+		bool hold_compressed_resources = false;
+		Vector<HeldResource> held_resources;
+		uint64_t held_size = 0;
 	};
 
 	struct ZipData {
@@ -221,6 +233,7 @@ private:
 
 	void gen_debug_flags(Vector<String> &r_flags, int p_flags);
 	static Error _save_pack_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total, const Vector<String> &p_enc_in_filters, const Vector<String> &p_enc_ex_filters, const Vector<uint8_t> &p_key);
+	static Error _save_held_resources(PackData *p_pack_data, int p_dictionary_size);
 	static Error _save_zip_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total, const Vector<String> &p_enc_in_filters, const Vector<String> &p_enc_ex_filters, const Vector<uint8_t> &p_key);
 
 	void _edit_files_with_filter(Ref<DirAccess> &da, const Vector<String> &p_filters, HashSet<String> &r_list, bool exclude);
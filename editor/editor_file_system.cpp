@@ -1911,7 +1911,14 @@ void EditorFileSystem::_reimport_file(const String &p_file, const HashMap<String
 	List<String> import_variants;
 	List<String> gen_files;
 	Variant metadata;
-	Error err = importer->import(p_file, base_path, params, &import_variants, &gen_files, &metadata);
+
+	Error err;
+	Ref<ResourceImportCache> cache = import_cache;
+	if (cache.is_valid()) {
+		err = cache->import(importer, p_file, base_path, params, &import_variants, &gen_files, &metadata);
+	} else {
+		err = importer->import(p_file, base_path, params, &import_variants, &gen_files, &metadata);
+	}
 
 	if (err != OK) {
 		ERR_PRINT("Error importing '" + p_file + "'.");
@@ -2063,6 +2070,30 @@ void EditorFileSystem::_find_group_files(EditorFileSystemDirectory *efd, HashMap
 	}
 }
 
+void EditorFileSystem::_update_import_cache() {
+	if (custom_import_cache.is_valid()) {
+		import_cache = custom_import_cache;
+		return;
+	}
+
+	const String cache_path = EDITOR_GET("filesystem/import/cache_path");
+	if (cache_path.is_empty()) {
+		import_cache.unref();
+	} else if (import_cache.is_null() || import_cache->get_directory() != cache_path) {
+		import_cache.instantiate();
+		import_cache->set_directory(cache_path);
+	}
+}
+
+void EditorFileSystem::set_import_cache(const Ref<ResourceImportCache> &p_cache) {
+	custom_import_cache = p_cache;
+	_update_import_cache();
+}
+
+Ref<ResourceImportCache> EditorFileSystem::get_import_cache() const {
+	return import_cache;
+}
+
 void EditorFileSystem::reimport_file_with_custom_parameters(const String &p_file, const String &p_importer, const HashMap<StringName, Variant> &p_custom_params) {
 	_reimport_file(p_file, &p_custom_params, p_importer);
 }
@@ -2116,6 +2147,11 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 
 	reimport_files.sort();
 
+	_update_import_cache();
+	if (import_cache.is_valid()) {
+		import_cache->reset_stats();
+	}
+
 	bool use_threads = GLOBAL_GET("editor/import/use_multiple_threads");
 
 	int from = 0;
@@ -2174,6 +2210,13 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 		}
 	}
 
+	if (import_cache.is_valid() && import_cache->get_hits() + import_cache->get_misses() > 0) {
+		// One line per pass in the output log, so the effect of the cache shows without verbose output.
+		const uint32_t hits = import_cache->get_hits();
+		const uint32_t misses = import_cache->get_misses();
+		print_line(vformat("Import cache: %d of %d files restored from the cache, %d imported.", hits, hits + misses, misses));
+	}
+
 	ResourceUID::get_singleton()->update_cache(); //after reimporting, update the cache
 
 	_save_filesystem_cache();
@@ -2372,6 +2415,8 @@ void EditorFileSystem::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_file_type", "path"), &EditorFileSystem::get_file_type);
 	ClassDB::bind_method(D_METHOD("update_script_classes"), &EditorFileSystem::update_script_classes);
 	ClassDB::bind_method(D_METHOD("reimport_files", "files"), &EditorFileSystem::reimport_files);
+	ClassDB::bind_method(D_METHOD("set_import_cache", "cache"), &EditorFileSystem::set_import_cache);
+	ClassDB::bind_method(D_METHOD("get_import_cache"), &EditorFileSystem::get_import_cache);
 
 	ADD_SIGNAL(MethodInfo("filesystem_changed"));
 	ADD_SIGNAL(MethodInfo("sources_changed", PropertyInfo(Variant::BOOL, "exist")));
@@ -32,6 +32,7 @@
 #define EDITOR_FILE_SYSTEM_H
 
 #include "core/io/dir_access.h"
+#include "core/io/resource_import_cache.h"
 #include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/templates/hash_set.h"
@@ -277,6 +278,11 @@ class EditorFileSystem : public Node {
 
 	ThreadWorkPool import_threads;
 
+	// Set from the editor settings, unless a cache was given with set_import_cache().
+	Ref<ResourceImportCache> import_cache;
+	Ref<ResourceImportCache> custom_import_cache;
+	void _update_import_cache();
+
 	struct ImportThreadData {
 		const ImportFile *reimport_files;
 		int reimport_from;
@@ -314,6 +320,9 @@ public:
 
 	void reimport_files(const Vector<String> &p_files);
 
+	void set_import_cache(const Ref<ResourceImportCache> &p_cache);
+	Ref<ResourceImportCache> get_import_cache() const;
+
 	void reimport_file_with_custom_parameters(const String &p_file, const String &p_importer, const HashMap<StringName, Variant> &p_custom_params);
 
 	void update_script_classes();
@@ -46,6 +46,8 @@
 #include "core/io/ip.h"
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/arena_allocator.h"
 #include "core/os/os.h"
 #include "core/os/time.h"
 #include "core/register_core_types.h"
@@ -406,6 +408,8 @@ Error Main::test_setup() {
 
 	globals = memnew(ProjectSettings);
 
+	WorkerThreadPool::get_singleton()->init();
+
 	GLOBAL_DEF("debug/settings/crash_handler/message",
 			String("Please include this when reporting the bug on https://github.com/godotengine/godot/issues"));
 	GLOBAL_DEF_RST("rendering/occlusion_culling/bvh_build_quality", 2);
@@ -1237,6 +1241,15 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 	// Initialize user data dir.
 	OS::get_singleton()->ensure_user_data_dir();
 
+	// Start the engine-wide worker threads, shared by all servers and scripts.
+	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("threading/worker_pool/max_threads",
+			PropertyInfo(Variant::INT,
+					"threading/worker_pool/max_threads",
+					PROPERTY_HINT_RANGE,
+					"-1,256,1,or_greater"));
+	WorkerThreadPool::get_singleton()->init(GLOBAL_GET("threading/worker_pool/max_threads"));
+
 	initialize_modules(MODULE_INITIALIZATION_LEVEL_CORE);
 	register_core_extensions(); // core extensions must be registered after globals setup and before display
 
@@ -2769,6 +2782,8 @@ bool Main::iteration() {
 
 	iterating++;
 
+	ThreadArena::frame_reset();
+
 	const uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 	Engine::get_singleton()->_frame_ticks = ticks;
 	main_timer_sync.set_cpu_ticks_usec(ticks);
@@ -3083,6 +3098,10 @@ void Main::cleanup(bool p_force) {
 	message_queue->flush();
 	memdelete(message_queue);
 
+	if (OS::get_singleton()->is_stdout_verbose()) {
+		MemoryCounters::print_all();
+	}
+
 	unregister_core_driver_types();
 	unregister_core_extensions();
 	uninitialize_modules(MODULE_INITIALIZATION_LEVEL_CORE);
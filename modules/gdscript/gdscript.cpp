@@ -40,8 +40,10 @@
 #include "core/io/file_access_encrypted.h"
 #include "core/os/os.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_byte_code_cache.h"
 #include "gdscript_cache.h"
 #include "gdscript_compiler.h"
+#include "gdscript_inline_cache.h"
 #include "gdscript_parser.h"
 #include "gdscript_rpc_callable.h"
 #include "gdscript_warning.h"
@@ -886,10 +888,17 @@ Error GDScript::reload(bool p_keep_state) {
 		ERR_FAIL_V(ERR_PARSE_ERROR);
 	}
 
-	bool can_run = ScriptServer::is_scripting_enabled() || parser.is_tool();
+	return _compile(parser, p_keep_state);
+}
+
+Error GDScript::_compile(GDScriptParser &p_parser, bool p_keep_state) {
+	valid = false;
+	bool can_run = ScriptServer::is_scripting_enabled() || p_parser.is_tool();
 
 	GDScriptCompiler compiler;
-	err = compiler.compile(&parser, this, p_keep_state);
+	Error err = compiler.compile(&p_parser, this, p_keep_state);
+	// Functions and members were replaced, even if compilation failed.
+	GDScriptInlineCache::invalidate();
 
 #ifdef TOOLS_ENABLED
 	_update_doc();
@@ -907,7 +916,7 @@ Error GDScript::reload(bool p_keep_state) {
 		}
 	}
 #ifdef DEBUG_ENABLED
-	for (const GDScriptWarning &warning : parser.get_warnings()) {
+	for (const GDScriptWarning &warning : p_parser.get_warnings()) {
 		if (EngineDebugger::is_active()) {
 			Vector<ScriptLanguage::StackInfo> si;
 			EngineDebugger::get_script_debugger()->send_error("", get_path(), warning.start_line, warning.get_name(), warning.get_message(), false, ERR_HANDLER_WARNING, si);
@@ -1020,12 +1029,23 @@ void GDScript::_bind_methods() {
 }
 
 Vector<uint8_t> GDScript::get_as_byte_code() const {
-	return Vector<uint8_t>();
+	Vector<uint8_t> byte_code;
+	if (GDScriptByteCodeCache::save(this, byte_code) != OK) {
+		return Vector<uint8_t>();
+	}
+	return byte_code;
 };
 
-// TODO: Fully remove this. There's not this kind of "bytecode" anymore.
 Error GDScript::load_byte_code(const String &p_path) {
-	return ERR_COMPILATION_FAILED;
+	if (!FileAccess::exists(p_path)) {
+		return ERR_FILE_NOT_FOUND;
+	}
+	Error err = OK;
+	Vector<uint8_t> byte_code = FileAccess::get_file_as_array(p_path, &err);
+	if (err != OK) {
+		return err;
+	}
+	return GDScriptByteCodeCache::load(byte_code, this);
 }
 
 Error GDScript::load_source_code(const String &p_path) {
@@ -1262,6 +1282,9 @@ GDScript::~GDScript() {
 		memdelete(implicit_ready);
 	}
 
+	// Another script could be allocated at the same address.
+	GDScriptInlineCache::invalidate();
+
 	if (GDScriptCache::singleton) { // Cache may have been already destroyed at engine shutdown.
 		GDScriptCache::remove_script(get_path());
 	}
@@ -2013,6 +2036,12 @@ void GDScriptLanguage::reload_tool_script(const Ref<Script> &p_script, bool p_so
 void GDScriptLanguage::frame() {
 	calls = 0;
 
+	if (unlikely(!startup_finished)) {
+		// The main scene and the autoloads are loaded by the first frame.
+		GDScriptCache::finish_startup();
+		startup_finished = true;
+	}
+
 #ifdef DEBUG_ENABLED
 	if (profiling) {
 		MutexLock lock(this->lock);
@@ -2250,6 +2279,11 @@ GDScriptLanguage::GDScriptLanguage() {
 		_call_stack = nullptr;
 	}
 
+	GDScriptJIT::initialize();
+	GDScriptJIT::set_enabled(GLOBAL_DEF("gdscript/jit/enabled", false));
+	GDScriptJIT::set_hot_threshold(GLOBAL_DEF("gdscript/jit/hot_threshold", 1000));
+	ProjectSettings::get_singleton()->set_custom_property_info("gdscript/jit/hot_threshold", PropertyInfo(Variant::INT, "gdscript/jit/hot_threshold", PROPERTY_HINT_RANGE, "0,100000,1,or_greater"));
+
 #ifdef DEBUG_ENABLED
 	GLOBAL_DEF("debug/gdscript/warnings/enable", true);
 	GLOBAL_DEF("debug/gdscript/warnings/treat_warnings_as_errors", false);
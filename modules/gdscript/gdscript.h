@@ -40,6 +40,8 @@
 #include "core/templates/rb_set.h"
 #include "gdscript_function.h"
 
+class GDScriptParser;
+
 class GDScriptNativeClass : public RefCounted {
 	GDCLASS(GDScriptNativeClass, RefCounted);
 
@@ -73,6 +75,9 @@ class GDScript : public Script {
 	friend class GDScriptFunction;
 	friend class GDScriptAnalyzer;
 	friend class GDScriptCompiler;
+	friend class GDScriptByteCodeCache;
+	friend class GDScriptCache;
+	friend class GDScriptInlineCache;
 	friend class GDScriptLanguage;
 	friend struct GDScriptUtilityFunctionsDefinitions;
 
@@ -156,6 +161,8 @@ class GDScript : public Script {
 
 	void _save_orphaned_subclasses();
 	void _init_rpc_methods_properties();
+	// Compiles an analyzed parse tree of this script, the last step of reload().
+	Error _compile(GDScriptParser &p_parser, bool p_keep_state);
 
 	void _get_script_property_list(List<PropertyInfo> *r_list, bool p_include_base) const;
 	void _get_script_method_list(List<MethodInfo> *r_list, bool p_include_base) const;
@@ -266,6 +273,7 @@ class GDScriptInstance : public ScriptInstance {
 	friend class GDScriptLambdaCallable;
 	friend class GDScriptLambdaSelfCallable;
 	friend class GDScriptCompiler;
+	friend class GDScriptInlineCache;
 	friend struct GDScriptUtilityFunctionsDefinitions;
 
 	ObjectID owner_id;
@@ -349,6 +357,7 @@ class GDScriptLanguage : public ScriptLanguage {
 	SelfList<GDScriptFunction>::List function_list;
 	bool profiling;
 	uint64_t script_frame_time;
+	bool startup_finished = false;
 
 	HashMap<String, ObjectID> orphan_subclasses;
 
@@ -0,0 +1,1721 @@
+/*************************************************************************/
+/*  gdscript_byte_code_cache.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+
+#include "gdscript_byte_code_cache.h"
+
+#include "core/config/project_settings.h"
+#include "core/debugger/engine_debugger.h"
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/os/mutex.h"
+#include "core/version.h"
+#include "gdscript.h"
+#include "gdscript_cache.h"
+#include "gdscript_function.h"
+#include "gdscript_inline_cache.h"
+#include "gdscript_utility_functions.h"
+
+static const uint8_t byte_code_magic[4] = { 'G', 'D', 'B', 'C' };
+static const int byte_code_header_size = 8; // Magic and format version.
+
+// Constants are objects the bytecode refers to by name or path.
+enum ValueKind {
+	VALUE_PLAIN,
+	VALUE_SCRIPT,
+	VALUE_GLOBAL,
+	VALUE_RESOURCE,
+	VALUE_ARRAY,
+	VALUE_DICTIONARY,
+};
+
+static String _get_engine_version() {
+	return String(VERSION_FULL_BUILD) + "." + String(VERSION_HASH);
+}
+
+static bool _is_debug_build() {
+#ifdef DEBUG_ENABLED
+	return true;
+#else
+	return false;
+#endif
+}
+
+template <class T>
+static _FORCE_INLINE_ uint64_t _function_key(T p_function) {
+	return (uint64_t)(uintptr_t)p_function;
+}
+
+// What the validated functions the bytecode calls were looked up with, so
+// they can be looked up again. Only needed to save bytecode, so they are
+// listed the first time something is saved.
+struct FunctionSymbol {
+	int type = 0;
+	int index = 0; // Operator, or constructor.
+	int right_type = 0;
+	String name;
+};
+
+struct FunctionSymbols {
+	HashMap<uint64_t, FunctionSymbol> operators;
+	HashMap<uint64_t, FunctionSymbol> setters;
+	HashMap<uint64_t, FunctionSymbol> getters;
+	HashMap<uint64_t, FunctionSymbol> keyed_setters;
+	HashMap<uint64_t, FunctionSymbol> keyed_getters;
+	HashMap<uint64_t, FunctionSymbol> indexed_setters;
+	HashMap<uint64_t, FunctionSymbol> indexed_getters;
+	HashMap<uint64_t, FunctionSymbol> builtin_methods;
+	HashMap<uint64_t, FunctionSymbol> constructors;
+	HashMap<uint64_t, FunctionSymbol> utilities;
+	HashMap<uint64_t, FunctionSymbol> gds_utilities;
+};
+
+static FunctionSymbol _make_symbol(int p_type, int p_index = 0, int p_right_type = 0, const String &p_name = String()) {
+	FunctionSymbol symbol;
+	symbol.type = p_type;
+	symbol.index = p_index;
+	symbol.right_type = p_right_type;
+	symbol.name = p_name;
+	return symbol;
+}
+
+static const FunctionSymbols &_get_function_symbols() {
+	static Mutex mutex;
+	static FunctionSymbols symbols;
+	static bool listed = false;
+
+	MutexLock lock(mutex);
+	if (listed) {
+		return symbols;
+	}
+
+	for (int op = 0; op < Variant::OP_MAX; op++) {
+		for (int a = 0; a < Variant::VARIANT_MAX; a++) {
+			for (int b = 0; b < Variant::VARIANT_MAX; b++) {
+				Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator((Variant::Operator)op, (Variant::Type)a, (Variant::Type)b);
+				if (evaluator) {
+					symbols.operators.insert(_function_key(evaluator), _make_symbol(a, op, b));
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < Variant::VARIANT_MAX; i++) {
+		const Variant::Type type = (Variant::Type)i;
+
+		List<StringName> members;
+		Variant::get_member_list(type, &members);
+		for (const StringName &E : members) {
+			Variant::ValidatedSetter setter = Variant::get_member_validated_setter(type, E);
+			if (setter) {
+				symbols.setters.insert(_function_key(setter), _make_symbol(i, 0, 0, E));
+			}
+			Variant::ValidatedGetter getter = Variant::get_member_validated_getter(type, E);
+			if (getter) {
+				symbols.getters.insert(_function_key(getter), _make_symbol(i, 0, 0, E));
+			}
+		}
+
+		Variant::ValidatedKeyedSetter keyed_setter = Variant::get_member_validated_keyed_setter(type);
+		if (keyed_setter) {
+			symbols.keyed_setters.insert(_function_key(keyed_setter), _make_symbol(i));
+		}
+		Variant::ValidatedKeyedGetter keyed_getter = Variant::get_member_validated_keyed_getter(type);
+		if (keyed_getter) {
+			symbols.keyed_getters.insert(_function_key(keyed_getter), _make_symbol(i));
+		}
+		Variant::ValidatedIndexedSetter indexed_setter = Variant::get_member_validated_indexed_setter(type);
+		if (indexed_setter) {
+			symbols.indexed_setters.insert(_function_key(indexed_setter), _make_symbol(i));
+		}
+		Variant::ValidatedIndexedGetter indexed_getter = Variant::get_member_validated_indexed_getter(type);
+		if (indexed_getter) {
+			symbols.indexed_getters.insert(_function_key(indexed_getter), _make_symbol(i));
+		}
+
+		List<StringName> methods;
+		Variant::get_builtin_method_list(type, &methods);
+		for (const StringName &E : methods) {
+			Variant::ValidatedBuiltInMethod method = Variant::get_validated_builtin_method(type, E);
+			if (method) {
+				symbols.builtin_methods.insert(_function_key(method), _make_symbol(i, 0, 0, E));
+			}
+		}
+
+		for (int j = 0; j < Variant::get_constructor_count(type); j++) {
+			Variant::ValidatedConstructor constructor = Variant::get_validated_constructor(type, j);
+			if (constructor) {
+				symbols.constructors.insert(_function_key(constructor), _make_symbol(i, j));
+			}
+		}
+	}
+
+	List<StringName> utilities;
+	Variant::get_utility_function_list(&utilities);
+	for (const StringName &E : utilities) {
+		Variant::ValidatedUtilityFunction utility = Variant::get_validated_utility_function(E);
+		if (utility) {
+			symbols.utilities.insert(_function_key(utility), _make_symbol(0, 0, 0, E));
+		}
+	}
+
+	List<StringName> gds_utilities;
+	GDScriptUtilityFunctions::get_function_list(&gds_utilities);
+	for (const StringName &E : gds_utilities) {
+		GDScriptUtilityFunctions::FunctionPtr utility = GDScriptUtilityFunctions::get_function(E);
+		if (utility) {
+			symbols.gds_utilities.insert(_function_key(utility), _make_symbol(0, 0, 0, E));
+		}
+	}
+
+	listed = true;
+	return symbols;
+}
+
+static _FORCE_INLINE_ bool _is_variant_type(int p_type) {
+	return p_type >= 0 && p_type < Variant::VARIANT_MAX;
+}
+
+/* Saving */
+
+struct GDScriptByteCodeCache::Writer {
+	String path;
+	String error;
+
+	void fail(const String &p_error) {
+		if (error.is_empty()) {
+			error = p_error;
+		}
+	}
+
+	Variant write_script(const Script *p_script);
+	Variant write_value(const Variant &p_value);
+	Variant write_data_type(const GDScriptDataType &p_type);
+	Dictionary write_function(const GDScriptFunction *p_function);
+	Dictionary write_class(const GDScript *p_script);
+};
+
+Variant GDScriptByteCodeCache::Writer::write_script(const Script *p_script) {
+	const GDScript *script = Object::cast_to<GDScript>(p_script);
+	if (!script) {
+		fail("it refers to a script that isn't a GDScript");
+		return Variant();
+	}
+
+	PackedStringArray names;
+	while (script->_owner) {
+		names.insert(0, script->name);
+		script = script->_owner;
+	}
+	if (script->path.is_empty() || script->path.contains("::")) {
+		fail("it refers to a built-in script");
+		return Variant();
+	}
+
+	Array data;
+	data.push_back(script->path);
+	data.push_back(names);
+	return data;
+}
+
+Variant GDScriptByteCodeCache::Writer::write_value(const Variant &p_value) {
+	Array data;
+	switch (p_value.get_type()) {
+		case Variant::OBJECT: {
+			Object *object = p_value.get_validated_object();
+			if (!object) {
+				data.push_back(VALUE_PLAIN);
+				data.push_back(Variant());
+				break;
+			}
+
+			if (Object::cast_to<GDScript>(object)) {
+				data.push_back(VALUE_SCRIPT);
+				data.push_back(write_script(Object::cast_to<GDScript>(object)));
+				break;
+			}
+
+			// Native classes and singletons.
+			const Variant *globals = GDScriptLanguage::get_singleton()->get_global_array();
+			for (const KeyValue<StringName, int> &E : GDScriptLanguage::get_singleton()->get_global_map()) {
+				if (globals[E.value].get_type() == Variant::OBJECT && globals[E.value].get_validated_object() == object) {
+					data.push_back(VALUE_GLOBAL);
+					data.push_back(String(E.key));
+					break;
+				}
+			}
+			if (!data.is_empty()) {
+				break;
+			}
+
+			Resource *resource = Object::cast_to<Resource>(object);
+			if (resource && !resource->get_path().is_empty() && !resource->get_path().contains("::")) {
+				data.push_back(VALUE_RESOURCE);
+				data.push_back(resource->get_path());
+				data.push_back(resource->get_class());
+				break;
+			}
+
+			fail(vformat("it has a constant of class '%s' that isn't a resource file", object->get_class()));
+		} break;
+		case Variant::ARRAY: {
+			const Array array = p_value;
+			Array elements;
+			for (int i = 0; i < array.size(); i++) {
+				elements.push_back(write_value(array[i]));
+			}
+			data.push_back(VALUE_ARRAY);
+			data.push_back(array.get_typed_builtin());
+			data.push_back(String(array.get_typed_class_name()));
+			const Ref<Script> typed_script = array.get_typed_script();
+			data.push_back(typed_script.is_valid() ? write_script(typed_script.ptr()) : Variant());
+			data.push_back(elements);
+		} break;
+		case Variant::DICTIONARY: {
+			const Dictionary dictionary = p_value;
+			Array pairs;
+			List<Variant> keys;
+			dictionary.get_key_list(&keys);
+			for (const Variant &E : keys) {
+				pairs.push_back(write_value(E));
+				pairs.push_back(write_value(dictionary[E]));
+			}
+			data.push_back(VALUE_DICTIONARY);
+			data.push_back(pairs);
+		} break;
+		case Variant::RID:
+		case Variant::CALLABLE:
+		case Variant::SIGNAL: {
+			fail(vformat("it has a constant of type %s", Variant::get_type_name(p_value.get_type())));
+		} break;
+		default: {
+			data.push_back(VALUE_PLAIN);
+			data.push_back(p_value);
+		} break;
+	}
+	return data;
+}
+
+Variant GDScriptByteCodeCache::Writer::write_data_type(const GDScriptDataType &p_type) {
+	Array data;
+	data.push_back(p_type.kind);
+	data.push_back(p_type.has_type);
+	data.push_back(p_type.builtin_type);
+	data.push_back(String(p_type.native_type));
+	if (p_type.script_type && (p_type.kind == GDScriptDataType::SCRIPT || p_type.kind == GDScriptDataType::GDSCRIPT)) {
+		data.push_back(write_script(p_type.script_type));
+		// Types of the class they are in don't hold a reference to it.
+		data.push_back(p_type.script_type_ref.is_valid());
+	} else {
+		data.push_back(Variant());
+		data.push_back(false);
+	}
+	data.push_back(p_type.has_container_element_type() ? write_data_type(p_type.get_container_element_type()) : Variant());
+	return data;
+}
+
+Dictionary GDScriptByteCodeCache::Writer::write_function(const GDScriptFunction *p_function) {
+	const FunctionSymbols &symbols = _get_function_symbols();
+
+	Dictionary data;
+	data["name"] = String(p_function->name);
+	data["source"] = String(p_function->source);
+	data["static"] = p_function->_static;
+	data["initial_line"] = p_function->_initial_line;
+	data["argument_count"] = p_function->_argument_count;
+	data["stack_size"] = p_function->_stack_size;
+	data["instruction_args_size"] = p_function->_instruction_args_size;
+	data["ptrcall_args_size"] = p_function->_ptrcall_args_size;
+	data["inline_cache_count"] = p_function->_inline_cache_count;
+
+	Array rpc;
+	rpc.push_back(String(p_function->rpc_config.name));
+	rpc.push_back(p_function->rpc_config.rpc_mode);
+	rpc.push_back(p_function->rpc_config.call_local);
+	rpc.push_back(p_function->rpc_config.transfer_mode);
+	rpc.push_back(p_function->rpc_config.channel);
+	data["rpc"] = rpc;
+
+	Array argument_types;
+	for (int i = 0; i < p_function->argument_types.size(); i++) {
+		argument_types.push_back(write_data_type(p_function->argument_types[i]));
+	}
+	data["argument_types"] = argument_types;
+	data["return_type"] = write_data_type(p_function->return_type);
+
+	data["code"] = PackedInt32Array(p_function->code);
+	data["default_arguments"] = PackedInt32Array(p_function->default_arguments);
+
+	Array constants;
+	for (int i = 0; i < p_function->constants.size(); i++) {
+		constants.push_back(write_value(p_function->constants[i]));
+	}
+	data["constants"] = constants;
+
+	PackedStringArray global_names;
+	for (int i = 0; i < p_function->global_names.size(); i++) {
+		global_names.push_back(p_function->global_names[i]);
+	}
+	data["global_names"] = global_names;
+
+	PackedInt32Array operators;
+	for (int i = 0; i < p_function->operator_funcs.size(); i++) {
+		const FunctionSymbol *symbol = symbols.operators.getptr(_function_key(p_function->operator_funcs[i]));
+		if (!symbol) {
+			fail("it uses an unknown operator");
+			break;
+		}
+		operators.push_back(symbol->index);
+		operators.push_back(symbol->type);
+		operators.push_back(symbol->right_type);
+	}
+	data["operators"] = operators;
+
+	Array setters;
+	for (int i = 0; i < p_function->setters.size(); i++) {
+		const FunctionSymbol *symbol = symbols.setters.getptr(_function_key(p_function->setters[i]));
+		if (!symbol) {
+			fail("it uses an unknown setter");
+			break;
+		}
+		setters.push_back(symbol->type);
+		setters.push_back(symbol->name);
+	}
+	data["setters"] = setters;
+
+	Array getters;
+	for (int i = 0; i < p_function->getters.size(); i++) {
+		const FunctionSymbol *symbol = symbols.getters.getptr(_function_key(p_function->getters[i]));
+		if (!symbol) {
+			fail("it uses an unknown getter");
+			break;
+		}
+		getters.push_back(symbol->type);
+		getters.push_back(symbol->name);
+	}
+	data["getters"] = getters;
+
+#define WRITE_TYPE_FUNCTIONS(m_table)                                                        \
+	{                                                                                        \
+		PackedInt32Array types;                                                              \
+		for (int i = 0; i < p_function->m_table.size(); i++) {                               \
+			const FunctionSymbol *symbol = symbols.m_table.getptr(_function_key(p_function->m_table[i])); \
+			if (!symbol) {                                                                   \
+				fail("it uses an unknown " #m_table " function");                            \
+				break;                                                                       \
+			}                                                                                \
+			types.push_back(symbol->type);                                                   \
+		}                                                                                    \
+		data[#m_table] = types;                                                              \
+	}
+
+	WRITE_TYPE_FUNCTIONS(keyed_setters);
+	WRITE_TYPE_FUNCTIONS(keyed_getters);
+	WRITE_TYPE_FUNCTIONS(indexed_setters);
+	WRITE_TYPE_FUNCTIONS(indexed_getters);
+
+#undef WRITE_TYPE_FUNCTIONS
+
+	Array builtin_methods;
+	for (int i = 0; i < p_function->builtin_methods.size(); i++) {
+		const FunctionSymbol *symbol = symbols.builtin_methods.getptr(_function_key(p_function->builtin_methods[i]));
+		if (!symbol) {
+			fail("it uses an unknown built-in method");
+			break;
+		}
+		builtin_methods.push_back(symbol->type);
+		builtin_methods.push_back(symbol->name);
+	}
+	data["builtin_methods"] = builtin_methods;
+
+	PackedInt32Array constructors;
+	for (int i = 0; i < p_function->constructors.size(); i++) {
+		const FunctionSymbol *symbol = symbols.constructors.getptr(_function_key(p_function->constructors[i]));
+		if (!symbol) {
+			fail("it uses an unknown constructor");
+			break;
+		}
+		constructors.push_back(symbol->type);
+		constructors.push_back(symbol->index);
+	}
+	data["constructors"] = constructors;
+
+	PackedStringArray utilities;
+	for (int i = 0; i < p_function->utilities.size(); i++) {
+		const FunctionSymbol *symbol = symbols.utilities.getptr(_function_key(p_function->utilities[i]));
+		if (!symbol) {
+			fail("it uses an unknown utility function");
+			break;
+		}
+		utilities.push_back(symbol->name);
+	}
+	data["utilities"] = utilities;
+
+	PackedStringArray gds_utilities;
+	for (int i = 0; i < p_function->gds_utilities.size(); i++) {
+		const FunctionSymbol *symbol = symbols.gds_utilities.getptr(_function_key(p_function->gds_utilities[i]));
+		if (!symbol) {
+			fail("it uses an unknown GDScript utility function");
+			break;
+		}
+		gds_utilities.push_back(symbol->name);
+	}
+	data["gds_utilities"] = gds_utilities;
+
+	PackedStringArray methods;
+	for (int i = 0; i < p_function->methods.size(); i++) {
+		const MethodBind *method = p_function->methods[i];
+		if (ClassDB::get_method(method->get_instance_class(), method->get_name()) != method) {
+			fail(vformat("it uses the method '%s' of '%s', which can't be found again", method->get_name(), method->get_instance_class()));
+			break;
+		}
+		methods.push_back(method->get_instance_class());
+		methods.push_back(method->get_name());
+	}
+	data["methods"] = methods;
+
+	Array lambdas;
+	for (int i = 0; i < p_function->lambdas.size(); i++) {
+		lambdas.push_back(write_function(p_function->lambdas[i]));
+	}
+	data["lambdas"] = lambdas;
+
+	PackedInt32Array temporary_slots;
+	for (const KeyValue<int, Variant::Type> &E : p_function->temporary_slots) {
+		temporary_slots.push_back(E.key);
+		temporary_slots.push_back(E.value);
+	}
+	data["temporary_slots"] = temporary_slots;
+
+	Array stack_debug;
+	for (const GDScriptFunction::StackDebug &E : p_function->stack_debug) {
+		stack_debug.push_back(E.line);
+		stack_debug.push_back(E.pos);
+		stack_debug.push_back(E.added);
+		stack_debug.push_back(String(E.identifier));
+	}
+	data["stack_debug"] = stack_debug;
+
+#ifdef TOOLS_ENABLED
+	PackedStringArray argument_names;
+	for (int i = 0; i < p_function->arg_names.size(); i++) {
+		argument_names.push_back(p_function->arg_names[i]);
+	}
+	data["argument_names"] = argument_names;
+
+	Array default_argument_values;
+	for (int i = 0; i < p_function->default_arg_values.size(); i++) {
+		default_argument_values.push_back(write_value(p_function->default_arg_values[i]));
+	}
+	data["default_argument_values"] = default_argument_values;
+#endif
+
+#ifdef DEBUG_ENABLED
+	data["signature"] = String(p_function->profile.signature);
+#endif
+
+	return data;
+}
+
+Dictionary GDScriptByteCodeCache::Writer::write_class(const GDScript *p_script) {
+	Dictionary data;
+	data["name"] = p_script->name;
+	data["tool"] = p_script->tool;
+
+	if (p_script->base.is_valid()) {
+		data["base"] = write_script(p_script->base.ptr());
+	} else if (p_script->native.is_valid()) {
+		data["native"] = String(p_script->native->get_name());
+	} else {
+		fail("a class has no base");
+	}
+
+	Array members;
+	for (const StringName &E : p_script->members) {
+		const GDScript::MemberInfo &info = p_script->member_indices[E];
+		members.push_back(String(E));
+		members.push_back(info.index);
+		members.push_back(String(info.setter));
+		members.push_back(String(info.getter));
+		members.push_back(write_data_type(info.data_type));
+		members.push_back(Dictionary(p_script->member_info[E]));
+	}
+	data["members"] = members;
+
+	Array constants;
+	for (const KeyValue<StringName, Variant> &E : p_script->constants) {
+		constants.push_back(String(E.key));
+		constants.push_back(write_value(E.value));
+	}
+	data["constants"] = constants;
+
+	Array signals;
+	for (const KeyValue<StringName, Vector<StringName>> &E : p_script->_signals) {
+		PackedStringArray arguments;
+		for (int i = 0; i < E.value.size(); i++) {
+			arguments.push_back(E.value[i]);
+		}
+		signals.push_back(String(E.key));
+		signals.push_back(arguments);
+	}
+	data["signals"] = signals;
+
+	Array functions;
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		functions.push_back(write_function(E.value));
+	}
+	data["functions"] = functions;
+	if (p_script->implicit_initializer) {
+		data["implicit_initializer"] = write_function(p_script->implicit_initializer);
+	}
+	if (p_script->implicit_ready) {
+		data["implicit_ready"] = write_function(p_script->implicit_ready);
+	}
+
+	Array subclasses;
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		subclasses.push_back(String(E.key));
+		subclasses.push_back(write_class(E.value.ptr()));
+	}
+	data["subclasses"] = subclasses;
+
+	return data;
+}
+
+Error GDScriptByteCodeCache::save(const GDScript *p_script, Vector<uint8_t> &r_buffer) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(p_script->_owner, ERR_INVALID_PARAMETER, "Only the bytecode of whole scripts can be saved, not of their inner classes.");
+
+	Writer writer;
+	writer.path = p_script->path;
+	if (!p_script->is_valid() || writer.path.is_empty() || writer.path.contains("::")) {
+		return ERR_UNAVAILABLE;
+	}
+
+	Dictionary root;
+	root["engine"] = _get_engine_version();
+	root["debug"] = _is_debug_build();
+	root["debugger"] = EngineDebugger::is_active();
+	root["opcodes"] = GDScriptFunction::OPCODE_END;
+
+	{
+		MutexLock lock(GDScriptCache::singleton->lock);
+
+		const HashSet<String> *dependencies = GDScriptCache::singleton->compiled_dependencies.getptr(writer.path);
+		if (!dependencies) {
+			writer.fail("it wasn't compiled by the script cache");
+		} else {
+			PackedStringArray direct_dependencies;
+			for (const String &E : *dependencies) {
+				direct_dependencies.push_back(E);
+			}
+			root["dependencies"] = direct_dependencies;
+		}
+
+		if (p_script->source.md5_text() != GDScriptCache::get_source_hash(writer.path)) {
+			writer.fail("its source changed since it was compiled");
+		}
+
+		// The sources of everything it depends on, even through other
+		// scripts: a base class changing moves members of its inheriters.
+		Dictionary sources;
+		List<String> to_visit;
+		to_visit.push_back(writer.path);
+		while (writer.error.is_empty() && !to_visit.is_empty()) {
+			const String script_path = to_visit.front()->get();
+			to_visit.pop_front();
+			if (sources.has(script_path)) {
+				continue;
+			}
+
+			const String source_hash = GDScriptCache::get_source_hash(script_path);
+			const HashSet<String> *script_dependencies = GDScriptCache::singleton->compiled_dependencies.getptr(script_path);
+			if (source_hash.is_empty() || !script_dependencies) {
+				writer.fail(vformat("the script '%s' it depends on isn't compiled", script_path));
+				break;
+			}
+			sources[script_path] = source_hash;
+			for (const String &E : *script_dependencies) {
+				to_visit.push_back(E);
+			}
+		}
+		root["sources"] = sources;
+	}
+
+	// Autoloads are the only globals the bytecode uses by index.
+	Dictionary globals;
+	const HashMap<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+	for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : ProjectSettings::get_singleton()->get_autoload_list()) {
+		if (E.value.is_singleton && global_map.has(E.key)) {
+			globals[String(E.key)] = global_map[E.key];
+		}
+	}
+	root["globals"] = globals;
+
+	if (writer.error.is_empty()) {
+		root["class"] = writer.write_class(p_script);
+	}
+
+	if (!writer.error.is_empty()) {
+		print_verbose(vformat("GDScript: Can't save the bytecode of '%s', as %s.", writer.path, writer.error));
+		return ERR_UNAVAILABLE;
+	}
+
+	int len = 0;
+	Error err = encode_variant(root, nullptr, len);
+	ERR_FAIL_COND_V(err != OK, err);
+	r_buffer.resize(byte_code_header_size + len);
+	uint8_t *w = r_buffer.ptrw();
+	memcpy(w, byte_code_magic, 4);
+	encode_uint32(FORMAT_VERSION, w + 4);
+	return encode_variant(root, w + byte_code_header_size, len);
+}
+
+/* Loading */
+
+struct GDScriptByteCodeCache::Reader {
+	GDScript *main_script = nullptr;
+	String path;
+	HashMap<GDScript *, Dictionary> classes;
+	HashSet<GDScript *> read_classes;
+	HashSet<GDScript *> reading_classes;
+	String error;
+
+	bool fail(const String &p_error) {
+		if (error.is_empty()) {
+			error = p_error;
+		}
+		return false;
+	}
+
+	static void clear_class(GDScript *p_script);
+	static GDScript *find_class(GDScript *p_script, const PackedStringArray &p_names);
+
+	void make_classes(GDScript *p_script, const Dictionary &p_data);
+	Ref<GDScript> read_script(const Variant &p_data, bool p_compiled = false);
+	bool read_value(const Variant &p_data, Variant &r_value);
+	bool read_data_type(const Variant &p_data, GDScriptDataType &r_type);
+	GDScriptFunction *read_function(const Dictionary &p_data, GDScript *p_script);
+	bool check_code(const GDScriptFunction *p_function, int p_member_count);
+	bool read_class(GDScript *p_script);
+};
+
+// Clears what the compiler would, for classes loaded again.
+void GDScriptByteCodeCache::Reader::clear_class(GDScript *p_script) {
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		memdelete(E.value);
+	}
+	if (p_script->implicit_initializer) {
+		memdelete(p_script->implicit_initializer);
+	}
+	if (p_script->implicit_ready) {
+		memdelete(p_script->implicit_ready);
+	}
+	p_script->member_functions.clear();
+	p_script->member_indices.clear();
+	p_script->member_info.clear();
+	p_script->members.clear();
+	p_script->constants.clear();
+	p_script->_signals.clear();
+	p_script->initializer = nullptr;
+	p_script->implicit_initializer = nullptr;
+	p_script->implicit_ready = nullptr;
+	p_script->native = Ref<GDScriptNativeClass>();
+	p_script->base = Ref<GDScript>();
+	p_script->_base = nullptr;
+	p_script->valid = false;
+}
+
+GDScript *GDScriptByteCodeCache::Reader::find_class(GDScript *p_script, const PackedStringArray &p_names) {
+	GDScript *script = p_script;
+	for (int i = 0; i < p_names.size(); i++) {
+		HashMap<StringName, Ref<GDScript>>::Iterator E = script->subclasses.find(p_names[i]);
+		if (!E) {
+			return nullptr;
+		}
+		script = E->value.ptr();
+	}
+	return script;
+}
+
+// Creates the inner classes first, as any class can refer to any other one.
+void GDScriptByteCodeCache::Reader::make_classes(GDScript *p_script, const Dictionary &p_data) {
+	clear_class(p_script);
+	p_script->subclasses.clear();
+	p_script->name = p_data.get("name", String());
+	classes[p_script] = p_data;
+
+	const Array subclasses = p_data.get("subclasses", Array());
+	for (int i = 0; i + 1 < subclasses.size(); i += 2) {
+		const StringName name = subclasses[i];
+		const String fully_qualified_name = p_script->fully_qualified_name + "::" + name;
+
+		Ref<GDScript> subclass = GDScriptLanguage::get_singleton()->get_orphan_subclass(fully_qualified_name);
+		if (subclass.is_null()) {
+			subclass.instantiate();
+		}
+		subclass->_owner = p_script;
+		subclass->fully_qualified_name = fully_qualified_name;
+		p_script->subclasses.insert(name, subclass);
+
+		make_classes(subclass.ptr(), subclasses[i + 1]);
+	}
+}
+
+Ref<GDScript> GDScriptByteCodeCache::Reader::read_script(const Variant &p_data, bool p_compiled) {
+	const Array data = p_data;
+	if (data.size() != 2) {
+		fail("a script reference is invalid");
+		return Ref<GDScript>();
+	}
+	const String script_path = data[0];
+	const PackedStringArray names = data[1];
+
+	GDScript *script = nullptr;
+	if (script_path == path) {
+		script = find_class(main_script, names);
+	} else {
+		// Like the compiler, only base classes need to be compiled already,
+		// other scripts are once this one is. But their inner classes only
+		// exist once they are.
+		Ref<GDScript> root = GDScriptCache::get_shallow_script(script_path, path);
+		script = find_class(root.ptr(), names);
+		if (p_compiled || !script) {
+			if (!GDScriptCache::singleton->full_gdscript_cache.has(script_path)) {
+				if (GDScriptCache::singleton->loading.has(script_path)) {
+					fail(vformat("the script '%s' is still being compiled", script_path));
+					return Ref<GDScript>();
+				}
+				Error err = OK;
+				root = GDScriptCache::get_full_script(script_path, err, path);
+				if (err != OK || root.is_null() || !root->is_valid()) {
+					fail(vformat("the script '%s' can't be compiled", script_path));
+					return Ref<GDScript>();
+				}
+			}
+			script = find_class(root.ptr(), names);
+		}
+	}
+
+	if (!script) {
+		fail(vformat("the class '%s' of '%s' doesn't exist", String("::").join(names), script_path));
+		return Ref<GDScript>();
+	}
+	return Ref<GDScript>(script);
+}
+
+bool GDScriptByteCodeCache::Reader::read_value(const Variant &p_data, Variant &r_value) {
+	const Array data = p_data;
+	if (data.size() < 2) {
+		return fail("a constant is invalid");
+	}
+
+	switch ((int)data[0]) {
+		case VALUE_PLAIN: {
+			r_value = data[1];
+		} break;
+		case VALUE_SCRIPT: {
+			Ref<GDScript> script = read_script(data[1]);
+			if (script.is_null()) {
+				return false;
+			}
+			r_value = script;
+		} break;
+		case VALUE_GLOBAL: {
+			const int *index = GDScriptLanguage::get_singleton()->get_global_map().getptr(StringName(data[1]));
+			if (!index) {
+				return fail(vformat("the global '%s' doesn't exist", data[1]));
+			}
+			r_value = GDScriptLanguage::get_singleton()->get_global_array()[*index];
+		} break;
+		case VALUE_RESOURCE: {
+			if (data.size() != 3) {
+				return fail("a constant is invalid");
+			}
+			Ref<Resource> resource = ResourceLoader::load(data[1], data[2]);
+			if (resource.is_null()) {
+				return fail(vformat("the resource '%s' can't be loaded", data[1]));
+			}
+			r_value = resource;
+		} break;
+		case VALUE_ARRAY: {
+			if (data.size() != 5 || !_is_variant_type(data[1])) {
+				return fail("a constant is invalid");
+			}
+			Array array;
+			Variant typed_script;
+			if (data[3].get_type() != Variant::NIL) {
+				Ref<GDScript> script = read_script(data[3]);
+				if (script.is_null()) {
+					return false;
+				}
+				typed_script = script;
+			}
+			if ((int)data[1] != Variant::NIL) {
+				array.set_typed(data[1], data[2], typed_script);
+			}
+			const Array elements = data[4];
+			for (int i = 0; i < elements.size(); i++) {
+				Variant element;
+				if (!read_value(elements[i], element)) {
+					return false;
+				}
+				array.push_back(element);
+			}
+			r_value = array;
+		} break;
+		case VALUE_DICTIONARY: {
+			Dictionary dictionary;
+			const Array pairs = data[1];
+			for (int i = 0; i + 1 < pairs.size(); i += 2) {
+				Variant key;
+				Variant value;
+				if (!read_value(pairs[i], key) || !read_value(pairs[i + 1], value)) {
+					return false;
+				}
+				dictionary[key] = value;
+			}
+			r_value = dictionary;
+		} break;
+		default: {
+			return fail("a constant is invalid");
+		}
+	}
+	return true;
+}
+
+bool GDScriptByteCodeCache::Reader::read_data_type(const Variant &p_data, GDScriptDataType &r_type) {
+	const Array data = p_data;
+	if (data.size() != 7 || (int)data[0] < GDScriptDataType::UNINITIALIZED || (int)data[0] > GDScriptDataType::GDSCRIPT || !_is_variant_type(data[2])) {
+		return fail("a type is invalid");
+	}
+
+	r_type.kind = (GDScriptDataType::Kind)(int)data[0];
+	r_type.has_type = data[1];
+	r_type.builtin_type = (Variant::Type)(int)data[2];
+	r_type.native_type = data[3];
+	if (data[4].get_type() != Variant::NIL) {
+		Ref<GDScript> script = read_script(data[4]);
+		if (script.is_null()) {
+			return false;
+		}
+		r_type.script_type = script.ptr();
+		if (data[5]) {
+			r_type.script_type_ref = script;
+		}
+	}
+	if (data[6].get_type() != Variant::NIL) {
+		GDScriptDataType element_type;
+		if (!read_data_type(data[6], element_type)) {
+			return false;
+		}
+		r_type.set_container_element_type(element_type);
+	}
+	return true;
+}
+
+GDScriptFunction *GDScriptByteCodeCache::Reader::read_function(const Dictionary &p_data, GDScript *p_script) {
+	GDScriptFunction *function = memnew(GDScriptFunction);
+	function->_script = p_script;
+	function->name = p_data.get("name", String());
+	function->source = p_data.get("source", String());
+#ifdef DEBUG_ENABLED
+	function->func_cname = (String(function->source) + " - " + String(function->name)).utf8();
+	function->_func_cname = function->func_cname.get_data();
+	function->profile.signature = p_data.get("signature", String());
+#endif
+
+	function->_static = p_data.get("static", false);
+	function->_initial_line = p_data.get("initial_line", 0);
+	function->_argument_count = p_data.get("argument_count", 0);
+	function->_stack_size = p_data.get("stack_size", 0);
+	function->_instruction_args_size = p_data.get("instruction_args_size", 0);
+	function->_ptrcall_args_size = p_data.get("ptrcall_args_size", 0);
+	function->_set_inline_cache_count(p_data.get("inline_cache_count", 0));
+
+	const Array rpc = p_data.get("rpc", Array());
+	if (rpc.size() == 5) {
+		function->rpc_config.name = rpc[0];
+		function->rpc_config.rpc_mode = (Multiplayer::RPCMode)(int)rpc[1];
+		function->rpc_config.call_local = rpc[2];
+		function->rpc_config.transfer_mode = (Multiplayer::TransferMode)(int)rpc[3];
+		function->rpc_config.channel = rpc[4];
+	}
+
+	bool ok = true;
+
+	const Array argument_types = p_data.get("argument_types", Array());
+	function->argument_types.resize(argument_types.size());
+	for (int i = 0; ok && i < argument_types.size(); i++) {
+		ok = read_data_type(argument_types[i], function->argument_types.write[i]);
+	}
+	ok = ok && read_data_type(p_data.get("return_type", Variant()), function->return_type);
+
+	function->code = PackedInt32Array(p_data.get("code", PackedInt32Array()));
+	function->default_arguments = PackedInt32Array(p_data.get("default_arguments", PackedInt32Array()));
+	if (function->code.is_empty() || function->_stack_size <= GDScriptFunction::ADDR_STACK_NIL) {
+		ok = fail("a function is invalid");
+	}
+
+	const Array constants = p_data.get("constants", Array());
+	function->constants.resize(constants.size());
+	for (int i = 0; ok && i < constants.size(); i++) {
+		ok = read_value(constants[i], function->constants.write[i]);
+	}
+
+	const PackedStringArray global_names = p_data.get("global_names", PackedStringArray());
+	for (int i = 0; i < global_names.size(); i++) {
+		function->global_names.push_back(global_names[i]);
+	}
+
+	const PackedInt32Array operators = p_data.get("operators", PackedInt32Array());
+	for (int i = 0; ok && i + 2 < operators.size(); i += 3) {
+		Variant::ValidatedOperatorEvaluator evaluator = nullptr;
+		if (operators[i] >= 0 && operators[i] < Variant::OP_MAX && _is_variant_type(operators[i + 1]) && _is_variant_type(operators[i + 2])) {
+			evaluator = Variant::get_validated_operator_evaluator((Variant::Operator)operators[i], (Variant::Type)operators[i + 1], (Variant::Type)operators[i + 2]);
+		}
+		if (!evaluator) {
+			ok = fail("an operator doesn't exist");
+			break;
+		}
+		function->operator_funcs.push_back(evaluator);
+	}
+
+	const Array setters = p_data.get("setters", Array());
+	for (int i = 0; ok && i + 1 < setters.size(); i += 2) {
+		Variant::ValidatedSetter setter = _is_variant_type(setters[i]) ? Variant::get_member_validated_setter((Variant::Type)(int)setters[i], setters[i + 1]) : nullptr;
+		if (!setter) {
+			ok = fail(vformat("the setter of '%s' doesn't exist", setters[i + 1]));
+			break;
+		}
+		function->setters.push_back(setter);
+	}
+
+	const Array getters = p_data.get("getters", Array());
+	for (int i = 0; ok && i + 1 < getters.size(); i += 2) {
+		Variant::ValidatedGetter getter = _is_variant_type(getters[i]) ? Variant::get_member_validated_getter((Variant::Type)(int)getters[i], getters[i + 1]) : nullptr;
+		if (!getter) {
+			ok = fail(vformat("the getter of '%s' doesn't exist", getters[i + 1]));
+			break;
+		}
+		function->getters.push_back(getter);
+	}
+
+#define READ_TYPE_FUNCTIONS(m_table, m_lookup)                                               \
+	{                                                                                        \
+		const PackedInt32Array types = p_data.get(#m_table, PackedInt32Array());             \
+		for (int i = 0; ok && i < types.size(); i++) {                                       \
+			if (!_is_variant_type(types[i]) || !Variant::m_lookup((Variant::Type)types[i])) { \
+				ok = fail("a " #m_table " function doesn't exist");                          \
+				break;                                                                       \
+			}                                                                                \
+			function->m_table.push_back(Variant::m_lookup((Variant::Type)types[i]));         \
+		}                                                                                    \
+	}
+
+	READ_TYPE_FUNCTIONS(keyed_setters, get_member_validated_keyed_setter);
+	READ_TYPE_FUNCTIONS(keyed_getters, get_member_validated_keyed_getter);
+	READ_TYPE_FUNCTIONS(indexed_setters, get_member_validated_indexed_setter);
+	READ_TYPE_FUNCTIONS(indexed_getters, get_member_validated_indexed_getter);
+
+#undef READ_TYPE_FUNCTIONS
+
+	const Array builtin_methods = p_data.get("builtin_methods", Array());
+	for (int i = 0; ok && i + 1 < builtin_methods.size(); i += 2) {
+		Variant::ValidatedBuiltInMethod method = _is_variant_type(builtin_methods[i]) ? Variant::get_validated_builtin_method((Variant::Type)(int)builtin_methods[i], builtin_methods[i + 1]) : nullptr;
+		if (!method) {
+			ok = fail(vformat("the built-in method '%s' doesn't exist", builtin_methods[i + 1]));
+			break;
+		}
+		function->builtin_methods.push_back(method);
+	}
+
+	const PackedInt32Array constructors = p_data.get("constructors", PackedInt32Array());
+	for (int i = 0; ok && i + 1 < constructors.size(); i += 2) {
+		Variant::ValidatedConstructor constructor = nullptr;
+		if (_is_variant_type(constructors[i]) && constructors[i + 1] >= 0 && constructors[i + 1] < Variant::get_constructor_count((Variant::Type)constructors[i])) {
+			constructor = Variant::get_validated_constructor((Variant::Type)constructors[i], constructors[i + 1]);
+		}
+		if (!constructor) {
+			ok = fail("a constructor doesn't exist");
+			break;
+		}
+		function->constructors.push_back(constructor);
+	}
+
+	const PackedStringArray utilities = p_data.get("utilities", PackedStringArray());
+	for (int i = 0; ok && i < utilities.size(); i++) {
+		Variant::ValidatedUtilityFunction utility = Variant::get_validated_utility_function(utilities[i]);
+		if (!utility) {
+			ok = fail(vformat("the utility function '%s' doesn't exist", utilities[i]));
+			break;
+		}
+		function->utilities.push_back(utility);
+	}
+
+	const PackedStringArray gds_utilities = p_data.get("gds_utilities", PackedStringArray());
+	for (int i = 0; ok && i < gds_utilities.size(); i++) {
+		GDScriptUtilityFunctions::FunctionPtr utility = GDScriptUtilityFunctions::get_function(gds_utilities[i]);
+		if (!utility) {
+			ok = fail(vformat("the utility function '%s' doesn't exist", gds_utilities[i]));
+			break;
+		}
+		function->gds_utilities.push_back(utility);
+	}
+
+	const PackedStringArray methods = p_data.get("methods", PackedStringArray());
+	for (int i = 0; ok && i + 1 < methods.size(); i += 2) {
+		MethodBind *method = ClassDB::get_method(methods[i], methods[i + 1]);
+		if (!method) {
+			ok = fail(vformat("the method '%s' of '%s' doesn't exist", methods[i + 1], methods[i]));
+			break;
+		}
+		function->methods.push_back(method);
+	}
+
+	const Array lambdas = p_data.get("lambdas", Array());
+	for (int i = 0; ok && i < lambdas.size(); i++) {
+		GDScriptFunction *lambda = read_function(lambdas[i], p_script);
+		if (!lambda) {
+			ok = false;
+			break;
+		}
+		function->lambdas.push_back(lambda);
+	}
+
+	const PackedInt32Array temporary_slots = p_data.get("temporary_slots", PackedInt32Array());
+	for (int i = 0; i + 1 < temporary_slots.size(); i += 2) {
+		if (_is_variant_type(temporary_slots[i + 1])) {
+			function->temporary_slots[temporary_slots[i]] = (Variant::Type)temporary_slots[i + 1];
+		}
+	}
+
+	const Array stack_debug = p_data.get("stack_debug", Array());
+	for (int i = 0; i + 3 < stack_debug.size(); i += 4) {
+		GDScriptFunction::StackDebug sd;
+		sd.line = stack_debug[i];
+		sd.pos = stack_debug[i + 1];
+		sd.added = stack_debug[i + 2];
+		sd.identifier = stack_debug[i + 3];
+		function->stack_debug.push_back(sd);
+	}
+
+#ifdef TOOLS_ENABLED
+	// Only saved by builds with tools.
+	if (!p_data.has("argument_names")) {
+		ok = fail("it was saved without argument names");
+	}
+	const PackedStringArray argument_names = p_data.get("argument_names", PackedStringArray());
+	for (int i = 0; i < argument_names.size(); i++) {
+		function->arg_names.push_back(argument_names[i]);
+	}
+	const Array default_argument_values = p_data.get("default_argument_values", Array());
+	function->default_arg_values.resize(default_argument_values.size());
+	for (int i = 0; ok && i < default_argument_values.size(); i++) {
+		ok = read_value(default_argument_values[i], function->default_arg_values.write[i]);
+	}
+#endif
+
+	ok = ok && check_code(function, function->_static ? 0 : p_script->member_indices.size());
+
+	if (!ok) {
+		memdelete(function);
+		return nullptr;
+	}
+
+	// Same as GDScriptByteCodeGenerator::write_end().
+	function->_code_ptr = function->code.ptr();
+	function->_code_size = function->code.size();
+	function->_constants_ptr = function->constants.ptrw();
+	function->_constant_count = function->constants.size();
+	function->_global_names_ptr = function->global_names.ptr();
+	function->_global_names_count = function->global_names.size();
+	function->_default_arg_ptr = function->default_arguments.ptr();
+	function->_default_arg_count = function->default_arguments.is_empty() ? 0 : function->default_arguments.size() - 1;
+	function->_operator_funcs_ptr = function->operator_funcs.ptr();
+	function->_operator_funcs_count = function->operator_funcs.size();
+	function->_setters_ptr = function->setters.ptr();
+	function->_setters_count = function->setters.size();
+	function->_getters_ptr = function->getters.ptr();
+	function->_getters_count = function->getters.size();
+	function->_keyed_setters_ptr = function->keyed_setters.ptr();
+	function->_keyed_setters_count = function->keyed_setters.size();
+	function->_keyed_getters_ptr = function->keyed_getters.ptr();
+	function->_keyed_getters_count = function->keyed_getters.size();
+	function->_indexed_setters_ptr = function->indexed_setters.ptr();
+	function->_indexed_setters_count = function->indexed_setters.size();
+	function->_indexed_getters_ptr = function->indexed_getters.ptr();
+	function->_indexed_getters_count = function->indexed_getters.size();
+	function->_builtin_methods_ptr = function->builtin_methods.ptr();
+	function->_builtin_methods_count = function->builtin_methods.size();
+	function->_constructors_ptr = function->constructors.ptr();
+	function->_constructors_count = function->constructors.size();
+	function->_utilities_ptr = function->utilities.ptr();
+	function->_utilities_count = function->utilities.size();
+	function->_gds_utilities_ptr = function->gds_utilities.ptr();
+	function->_gds_utilities_count = function->gds_utilities.size();
+	function->_methods_ptr = function->methods.ptrw();
+	function->_methods_count = function->methods.size();
+	function->_lambdas_ptr = function->lambdas.ptrw();
+	function->_lambdas_count = function->lambdas.size();
+
+	return function;
+}
+
+// The VM only checks operands in debug builds, trusting them to come from the
+// compiler. Walk the whole code instead, so a damaged cache file can't make it
+// read or jump out of bounds.
+bool GDScriptByteCodeCache::Reader::check_code(const GDScriptFunction *p_function, int p_member_count) {
+	typedef GDScriptFunction F;
+
+	const int *code = p_function->code.ptr();
+	const int code_size = p_function->code.size();
+	const int fixed_stack_size = F::ADDR_STACK_NIL + 1;
+
+	if (p_function->_argument_count < 0 || p_function->_argument_count > p_function->argument_types.size() || p_function->_argument_count > p_function->_stack_size - fixed_stack_size || p_function->_instruction_args_size < 0 || p_function->_ptrcall_args_size < 0) {
+		return fail("a function is invalid");
+	}
+	for (const KeyValue<int, Variant::Type> &E : p_function->temporary_slots) {
+		if (E.key < fixed_stack_size || E.key >= p_function->_stack_size) {
+			return fail("a function is invalid");
+		}
+	}
+
+	LocalVector<bool> starts;
+	starts.resize(code_size);
+	for (int i = 0; i < code_size; i++) {
+		starts[i] = false;
+	}
+	LocalVector<int> targets;
+	for (int i = 0; i < p_function->default_arguments.size(); i++) {
+		targets.push_back(p_function->default_arguments[i]);
+	}
+
+	const String invalid = vformat("the code of '%s' is invalid", p_function->name);
+	int opcode = -1;
+	for (int ip = 0; ip < code_size;) {
+		starts[ip] = true;
+		opcode = code[ip] & F::INSTR_MASK;
+		const int arg_count = (code[ip] & F::INSTR_ARGS_MASK) >> F::INSTR_BITS;
+		if (arg_count < 0 || arg_count > p_function->_instruction_args_size || arg_count >= code_size - ip) {
+			return fail(invalid);
+		}
+
+		// Addresses come first, the VM resolves them before running each instruction.
+		for (int i = ip + 1; i <= ip + arg_count; i++) {
+			const int address = code[i] & F::ADDR_MASK;
+			int count = 0;
+			switch ((code[i] & F::ADDR_TYPE_MASK) >> F::ADDR_BITS) {
+				case F::ADDR_TYPE_STACK: {
+					count = p_function->_stack_size;
+				} break;
+				case F::ADDR_TYPE_CONSTANT: {
+					count = p_function->constants.size();
+				} break;
+				case F::ADDR_TYPE_MEMBER: {
+					count = p_member_count;
+				} break;
+			}
+			if (address >= count) {
+				return fail(invalid);
+			}
+		}
+
+		const int operands = ip + 1 + arg_count;
+		int fixed_arg_count = -1; // For instructions that don't take a variable amount of addresses.
+		int operand_count = 0;
+
+// Operands that follow the addresses, -1 past the end of the code.
+#define OPERAND(m_index) (operands + (m_index) < code_size ? code[operands + (m_index)] : -1)
+#define CHECK_INDEX(m_index, m_count)                                 \
+	if (OPERAND(m_index) < 0 || OPERAND(m_index) >= (int)(m_count)) { \
+		return fail(invalid);                                         \
+	}
+#define CHECK_TYPE(m_index)                    \
+	if (!_is_variant_type(OPERAND(m_index))) { \
+		return fail(invalid);                  \
+	}
+// Arguments, and the addresses the VM reads after them.
+#define CHECK_ARGUMENTS(m_index, m_per_argument, m_extra)                                                                      \
+	if (OPERAND(m_index) < 0 || OPERAND(m_index) > arg_count || OPERAND(m_index) * (m_per_argument) + (m_extra) > arg_count) { \
+		return fail(invalid);                                                                                                  \
+	}
+
+		switch (opcode) {
+			case F::OPCODE_OPERATOR: {
+				fixed_arg_count = 3;
+				operand_count = 1;
+				CHECK_INDEX(0, Variant::OP_MAX);
+			} break;
+			case F::OPCODE_EXTENDS_TEST:
+			case F::OPCODE_SET_KEYED:
+			case F::OPCODE_GET_KEYED:
+			case F::OPCODE_ASSIGN_TYPED_NATIVE:
+			case F::OPCODE_ASSIGN_TYPED_SCRIPT:
+			case F::OPCODE_CAST_TO_NATIVE:
+			case F::OPCODE_CAST_TO_SCRIPT: {
+				fixed_arg_count = 3;
+			} break;
+			case F::OPCODE_IS_BUILTIN:
+			case F::OPCODE_ASSIGN_TYPED_BUILTIN:
+			case F::OPCODE_CAST_TO_BUILTIN: {
+				fixed_arg_count = 2;
+				operand_count = 1;
+				CHECK_TYPE(0);
+			} break;
+			case F::OPCODE_SET_KEYED_VALIDATED: {
+				fixed_arg_count = 3;
+				operand_count = 1;
+				CHECK_INDEX(0, p_function->keyed_setters.size());
+			} break;
+			case F::OPCODE_GET_KEYED_VALIDATED: {
+				fixed_arg_count = 3;
+				operand_count = 1;
+				CHECK_INDEX(0, p_function->keyed_getters.size());
+			} break;
+			case F::OPCODE_SET_INDEXED_VALIDATED: {
+				fixed_arg_count = 3;
+				operand_count = 1;
+				CHECK_INDEX(0, p_function->indexed_setters.size());
+			} break;
+			case F::OPCODE_GET_INDEXED_VALIDATED: {
+				fixed_arg_count = 3;
+				operand_count = 1;
+				CHECK_INDEX(0, p_function->indexed_getters.size());
+			} break;
+			case F::OPCODE_SET_NAMED:
+			case F::OPCODE_GET_NAMED: {
+				fixed_arg_count = 2;
+				operand_count = 2;
+				CHECK_INDEX(0, p_function->global_names.size());
+				CHECK_INDEX(1, p_function->_inline_cache_count);
+			} break;
+			case F::OPCODE_SET_NAMED_VALIDATED: {
+				fixed_arg_count = 2;
+				operand_count = 1;
+				CHECK_INDEX(0, p_function->setters.size());
+			} break;
+			case F::OPCODE_GET_NAMED_VALIDATED: {
+				fixed_arg_count = 2;
+				operand_count = 1;
+				CHECK_INDEX(0, p_function->getters.size());
+			} break;
+			case F::OPCODE_SET_MEMBER:
+			case F::OPCODE_GET_MEMBER:
+			case F::OPCODE_STORE_NAMED_GLOBAL: {
+				fixed_arg_count = 1;
+				operand_count = 1;
+				CHECK_INDEX(0, p_function->global_names.size());
+			} break;
+			case F::OPCODE_STORE_GLOBAL: {
+				fixed_arg_count = 1;
+				operand_count = 1;
+				CHECK_INDEX(0, GDScriptLanguage::get_singleton()->get_global_array_size());
+			} break;
+			case F::OPCODE_ASSIGN:
+			case F::OPCODE_ASSIGN_TYPED_ARRAY:
+			case F::OPCODE_RETURN_TYPED_NATIVE:
+			case F::OPCODE_RETURN_TYPED_SCRIPT:
+			case F::OPCODE_ASSERT: {
+				fixed_arg_count = 2;
+			} break;
+			case F::OPCODE_ASSIGN_TRUE:
+			case F::OPCODE_ASSIGN_FALSE:
+			case F::OPCODE_AWAIT_RESUME:
+			case F::OPCODE_RETURN: {
+				fixed_arg_count = 1;
+			} break;
+			case F::OPCODE_AWAIT: {
+				// Resuming reads the address of the next instruction.
+				fixed_arg_count = 1;
+				if (operands >= code_size || (code[operands] & F::INSTR_MASK) != F::OPCODE_AWAIT_RESUME) {
+					return fail(invalid);
+				}
+			} break;
+			case F::OPCODE_CONSTRUCT: {
+				operand_count = 2;
+				CHECK_ARGUMENTS(0, 1, 1);
+				CHECK_TYPE(1);
+			} break;
+			case F::OPCODE_CONSTRUCT_VALIDATED: {
+				operand_count = 2;
+				CHECK_ARGUMENTS(0, 1, 1);
+				CHECK_INDEX(1, p_function->constructors.size());
+			} break;
+			case F::OPCODE_CONSTRUCT_ARRAY: {
+				operand_count = 1;
+				CHECK_ARGUMENTS(0, 1, 1);
+			} break;
+			case F::OPCODE_CONSTRUCT_TYPED_ARRAY: {
+				operand_count = 3;
+				CHECK_ARGUMENTS(0, 1, 2);
+				CHECK_TYPE(1);
+				CHECK_INDEX(2, p_function->global_names.size());
+			} break;
+			case F::OPCODE_CONSTRUCT_DICTIONARY: {
+				operand_count = 1;
+				CHECK_ARGUMENTS(0, 2, 1);
+			} break;
+			case F::OPCODE_CALL:
+			case F::OPCODE_CALL_RETURN:
+			case F::OPCODE_CALL_ASYNC: {
+				operand_count = 3;
+				CHECK_ARGUMENTS(0, 1, 2);
+				CHECK_INDEX(1, p_function->global_names.size());
+				CHECK_INDEX(2, p_function->_inline_cache_count);
+			} break;
+			case F::OPCODE_CALL_UTILITY:
+			case F::OPCODE_CALL_SELF_BASE: {
+				operand_count = 2;
+				CHECK_ARGUMENTS(0, 1, 1);
+				CHECK_INDEX(1, p_function->global_names.size());
+			} break;
+			case F::OPCODE_CALL_UTILITY_VALIDATED: {
+				operand_count = 2;
+				CHECK_ARGUMENTS(0, 1, 1);
+				CHECK_INDEX(1, p_function->utilities.size());
+			} break;
+			case F::OPCODE_CALL_GDSCRIPT_UTILITY: {
+				operand_count = 2;
+				CHECK_ARGUMENTS(0, 1, 1);
+				CHECK_INDEX(1, p_function->gds_utilities.size());
+			} break;
+			case F::OPCODE_CALL_BUILTIN_TYPE_VALIDATED: {
+				operand_count = 2;
+				CHECK_ARGUMENTS(0, 1, 2);
+				CHECK_INDEX(1, p_function->builtin_methods.size());
+			} break;
+			case F::OPCODE_CALL_METHOD_BIND:
+			case F::OPCODE_CALL_METHOD_BIND_RET: {
+				operand_count = 2;
+				CHECK_ARGUMENTS(0, 1, 2);
+				CHECK_INDEX(1, p_function->methods.size());
+			} break;
+			case F::OPCODE_CALL_BUILTIN_STATIC: {
+				operand_count = 3;
+				CHECK_TYPE(0);
+				CHECK_INDEX(1, p_function->global_names.size());
+				CHECK_ARGUMENTS(2, 1, 1);
+			} break;
+			case F::OPCODE_CALL_NATIVE_STATIC: {
+				operand_count = 2;
+				CHECK_INDEX(0, p_function->methods.size());
+				CHECK_ARGUMENTS(1, 1, 1);
+			} break;
+			case F::OPCODE_CREATE_LAMBDA:
+			case F::OPCODE_CREATE_SELF_LAMBDA: {
+				operand_count = 2;
+				CHECK_ARGUMENTS(0, 1, 1);
+				CHECK_INDEX(1, p_function->lambdas.size());
+			} break;
+			case F::OPCODE_JUMP: {
+				fixed_arg_count = 0;
+				operand_count = 1;
+				targets.push_back(OPERAND(0));
+			} break;
+			case F::OPCODE_JUMP_IF:
+			case F::OPCODE_JUMP_IF_NOT:
+			case F::OPCODE_JUMP_IF_SHARED: {
+				fixed_arg_count = 1;
+				operand_count = 1;
+				targets.push_back(OPERAND(0));
+			} break;
+			case F::OPCODE_JUMP_TO_DEF_ARGUMENT:
+			case F::OPCODE_BREAKPOINT:
+			case F::OPCODE_END: {
+				fixed_arg_count = 0;
+			} break;
+			case F::OPCODE_RETURN_TYPED_BUILTIN: {
+				fixed_arg_count = 1;
+				operand_count = 1;
+				CHECK_TYPE(0);
+			} break;
+			case F::OPCODE_RETURN_TYPED_ARRAY: {
+				fixed_arg_count = 2;
+				operand_count = 2;
+				CHECK_TYPE(0);
+				CHECK_INDEX(1, p_function->global_names.size());
+			} break;
+			case F::OPCODE_LINE: {
+				fixed_arg_count = 0;
+				operand_count = 1;
+			} break;
+			default: {
+				if (opcode >= F::OPCODE_OPERATOR_VALIDATED && opcode <= F::OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT) {
+					// Operators on known types keep the operator function.
+					fixed_arg_count = 3;
+					operand_count = 1;
+					CHECK_INDEX(0, p_function->operator_funcs.size());
+				} else if (opcode >= F::OPCODE_CALL_PTRCALL_NO_RETURN && opcode <= F::OPCODE_CALL_PTRCALL_PACKED_COLOR_ARRAY) {
+					operand_count = 2;
+					CHECK_ARGUMENTS(0, 1, 2);
+					CHECK_INDEX(0, p_function->_ptrcall_args_size + 1);
+					CHECK_INDEX(1, p_function->methods.size());
+				} else if (opcode >= F::OPCODE_ITERATE_BEGIN && opcode <= F::OPCODE_ITERATE_OBJECT) {
+					fixed_arg_count = 3;
+					operand_count = 1;
+					targets.push_back(OPERAND(0));
+				} else if (opcode >= F::OPCODE_TYPE_ADJUST_BOOL && opcode <= F::OPCODE_TYPE_ADJUST_PACKED_COLOR_ARRAY) {
+					fixed_arg_count = 1;
+				} else {
+					return fail(invalid);
+				}
+			} break;
+		}
+
+#undef OPERAND
+#undef CHECK_INDEX
+#undef CHECK_TYPE
+#undef CHECK_ARGUMENTS
+
+		if ((fixed_arg_count != -1 && arg_count != fixed_arg_count) || operand_count > code_size - operands) {
+			return fail(invalid);
+		}
+		ip = operands + operand_count;
+	}
+
+	// The VM doesn't check for the end of the code in release builds, it
+	// stops at OPCODE_END.
+	if (opcode != F::OPCODE_END) {
+		return fail(invalid);
+	}
+	for (uint32_t i = 0; i < targets.size(); i++) {
+		if (targets[i] < 0 || targets[i] >= code_size || !starts[targets[i]]) {
+			return fail(invalid);
+		}
+	}
+	return true;
+}
+
+bool GDScriptByteCodeCache::Reader::read_class(GDScript *p_script) {
+	if (read_classes.has(p_script)) {
+		return true;
+	}
+	if (reading_classes.has(p_script)) {
+		return fail("its classes inherit each other");
+	}
+	reading_classes.insert(p_script);
+
+	const Dictionary data = classes[p_script];
+	p_script->tool = data.get("tool", false);
+
+	if (data.has("base")) {
+		Ref<GDScript> base = read_script(data["base"], true);
+		if (base.is_null()) {
+			return false;
+		}
+		// Members of inner classes of this script follow those of their base.
+		if (classes.has(base.ptr()) && !read_class(base.ptr())) {
+			return false;
+		}
+		p_script->base = base;
+		p_script->_base = base.ptr();
+		p_script->member_indices = base->member_indices;
+		p_script->native = base->native;
+	} else {
+		const int *index = GDScriptLanguage::get_singleton()->get_global_map().getptr(StringName(data.get("native", String())));
+		if (index) {
+			p_script->native = GDScriptLanguage::get_singleton()->get_global_array()[*index];
+		}
+		if (p_script->native.is_null()) {
+			return fail(vformat("the native class '%s' doesn't exist", data.get("native", String())));
+		}
+	}
+
+	const Array members = data.get("members", Array());
+	for (int i = 0; i + 5 < members.size(); i += 6) {
+		const StringName name = members[i];
+		GDScript::MemberInfo info;
+		info.index = members[i + 1];
+		info.setter = members[i + 2];
+		info.getter = members[i + 3];
+		if (!read_data_type(members[i + 4], info.data_type)) {
+			return false;
+		}
+		p_script->member_indices[name] = info;
+		p_script->member_info[name] = PropertyInfo::from_dict(members[i + 5]);
+		p_script->members.insert(name);
+	}
+	// Instances have one member for each of them, and code refers to them by index.
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->member_indices) {
+		if (E.value.index < 0 || E.value.index >= (int)p_script->member_indices.size()) {
+			return fail(vformat("the member '%s' is invalid", E.key));
+		}
+	}
+
+	const Array constants = data.get("constants", Array());
+	for (int i = 0; i + 1 < constants.size(); i += 2) {
+		Variant value;
+		if (!read_value(constants[i + 1], value)) {
+			return false;
+		}
+		p_script->constants.insert(constants[i], value);
+	}
+
+	const Array signals = data.get("signals", Array());
+	for (int i = 0; i + 1 < signals.size(); i += 2) {
+		const PackedStringArray arguments = signals[i + 1];
+		Vector<StringName> argument_names;
+		for (int j = 0; j < arguments.size(); j++) {
+			argument_names.push_back(arguments[j]);
+		}
+		p_script->_signals[signals[i]] = argument_names;
+	}
+
+	const Array functions = data.get("functions", Array());
+	for (int i = 0; i < functions.size(); i++) {
+		GDScriptFunction *function = read_function(functions[i], p_script);
+		if (!function) {
+			return false;
+		}
+		p_script->member_functions[function->name] = function;
+		if (function->name == GDScriptLanguage::get_singleton()->strings._init) {
+			p_script->initializer = function;
+		}
+	}
+	if (data.has("implicit_initializer")) {
+		p_script->implicit_initializer = read_function(data["implicit_initializer"], p_script);
+		if (!p_script->implicit_initializer) {
+			return false;
+		}
+	}
+	if (data.has("implicit_ready")) {
+		p_script->implicit_ready = read_function(data["implicit_ready"], p_script);
+		if (!p_script->implicit_ready) {
+			return false;
+		}
+	}
+
+	reading_classes.erase(p_script);
+	read_classes.insert(p_script);
+
+	for (KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		if (!read_class(E.value.ptr())) {
+			return false;
+		}
+	}
+
+	p_script->valid = true;
+	return true;
+}
+
+Error GDScriptByteCodeCache::load(const Vector<uint8_t> &p_buffer, GDScript *p_script) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+	const String path = p_script->path;
+	ERR_FAIL_COND_V(path.is_empty(), ERR_INVALID_PARAMETER);
+
+	if (p_buffer.size() < byte_code_header_size || memcmp(p_buffer.ptr(), byte_code_magic, 4) != 0) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	if (decode_uint32(p_buffer.ptr() + 4) != FORMAT_VERSION) {
+		print_verbose(vformat("GDScript: The bytecode of '%s' has another format version, compiling it.", path));
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	Variant root_value;
+	if (decode_variant(root_value, p_buffer.ptr() + byte_code_header_size, p_buffer.size() - byte_code_header_size) != OK || root_value.get_type() != Variant::DICTIONARY) {
+		print_verbose(vformat("GDScript: The bytecode of '%s' is corrupt, compiling it.", path));
+		return ERR_FILE_CORRUPT;
+	}
+	const Dictionary root = root_value;
+
+	if (String(root.get("engine", String())) != _get_engine_version() || bool(root.get("debug", false)) != _is_debug_build() || int(root.get("opcodes", 0)) != GDScriptFunction::OPCODE_END) {
+		print_verbose(vformat("GDScript: The bytecode of '%s' was saved by another engine version or build type, compiling it.", path));
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	if (EngineDebugger::is_active() && !bool(root.get("debugger", false))) {
+		// The debugger needs the local variables of each line.
+		print_verbose(vformat("GDScript: The bytecode of '%s' was saved without debug information, compiling it.", path));
+		return ERR_INVALID_DATA;
+	}
+
+	const Dictionary sources = root.get("sources", Dictionary());
+	if (!sources.has(path)) {
+		return ERR_INVALID_DATA;
+	}
+	const Array source_paths = sources.keys();
+	for (int i = 0; i < source_paths.size(); i++) {
+		if (GDScriptCache::get_source_hash(source_paths[i]) != String(sources[source_paths[i]])) {
+			print_verbose(vformat("GDScript: The bytecode of '%s' is out of date, '%s' changed. Compiling it.", path, source_paths[i]));
+			return ERR_INVALID_DATA;
+		}
+	}
+
+	const Dictionary globals = root.get("globals", Dictionary());
+	const HashMap<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+	const Array global_names = globals.keys();
+	for (int i = 0; i < global_names.size(); i++) {
+		const int *index = global_map.getptr(StringName(global_names[i]));
+		if (!index || *index != int(globals[global_names[i]])) {
+			print_verbose(vformat("GDScript: The bytecode of '%s' is out of date, autoloads changed. Compiling it.", path));
+			return ERR_INVALID_DATA;
+		}
+	}
+
+	Reader reader;
+	reader.main_script = p_script;
+	reader.path = path;
+
+	p_script->fully_qualified_name = path;
+	p_script->_owner = nullptr;
+	reader.make_classes(p_script, root.get("class", Dictionary()));
+	const bool read = reader.read_class(p_script);
+	GDScriptInlineCache::invalidate();
+	if (!read) {
+		for (const KeyValue<GDScript *, Dictionary> &E : reader.classes) {
+			Reader::clear_class(E.key);
+		}
+		print_verbose(vformat("GDScript: Can't load the bytecode of '%s', as %s. Compiling it.", path, reader.error));
+		return ERR_CANT_RESOLVE;
+	}
+
+	for (KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		p_script->_set_subclass_path(E.value, path);
+	}
+	p_script->_init_rpc_methods_properties();
+
+	// Like after compiling, mark it as compiled and load what it depends on.
+	// Dependencies report their own errors when they fail to load.
+	MutexLock lock(GDScriptCache::singleton->lock);
+	const PackedStringArray dependencies = root.get("dependencies", PackedStringArray());
+	HashSet<String> &script_dependencies = GDScriptCache::singleton->dependencies[path];
+	for (int i = 0; i < dependencies.size(); i++) {
+		script_dependencies.insert(dependencies[i]);
+	}
+	GDScriptCache::finish_compiling(path);
+
+	return OK;
+}
+
+String GDScriptByteCodeCache::get_cache_path(const String &p_script_path) {
+	String directory = GDScriptCache::singleton ? GDScriptCache::singleton->byte_code_cache_path : String();
+	if (directory.is_empty()) {
+		directory = ProjectSettings::get_singleton()->get_project_data_path().plus_file("gdscript_cache");
+	}
+	return directory.plus_file(p_script_path.get_file() + "-" + p_script_path.md5_text() + ".gdc");
+}
@@ -0,0 +1,68 @@
+/*************************************************************************/
+/*  gdscript_byte_code_cache.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+
+#ifndef GDSCRIPT_BYTE_CODE_CACHE_H
+#define GDSCRIPT_BYTE_CODE_CACHE_H
+
+#include "core/string/ustring.h"
+#include "core/templates/vector.h"
+
+class GDScript;
+
+// Saves what the compiler produced for a script (its classes, members,
+// constants and functions), so it can be loaded again without parsing,
+// analyzing and compiling the script.
+//
+// Saved bytecode is only loaded by the same engine version and build type,
+// while the sources of the script and of every script it depends on are the
+// ones it was compiled from. Function pointers the bytecode uses (validated
+// operators, setters, methods...) are stored by name and looked up again.
+class GDScriptByteCodeCache {
+	struct Writer;
+	struct Reader;
+
+public:
+	enum {
+		FORMAT_VERSION = 2,
+	};
+
+	// Where GDScriptCache looks for the saved bytecode of a script.
+	static String get_cache_path(const String &p_script_path);
+
+	// Fails if the script isn't compiled, or uses something that can't be
+	// saved (built-in scripts, resources without a path...).
+	static Error save(const GDScript *p_script, Vector<uint8_t> &r_buffer);
+	// Compiles p_script from the buffer, if it is still valid for it. Returns
+	// ERR_CANT_RESOLVE if it failed after creating its inner classes, which
+	// other scripts may already point to: compile it with reload(true) then,
+	// so they are kept.
+	static Error load(const Vector<uint8_t> &p_buffer, GDScript *p_script);
+};
+
+#endif // GDSCRIPT_BYTE_CODE_CACHE_H
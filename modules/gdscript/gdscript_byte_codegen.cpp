@@ -397,6 +397,7 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 	function->_stack_size = RESERVED_STACK + max_locals + temporaries.size();
 	function->_instruction_args_size = instr_args_max;
 	function->_ptrcall_args_size = ptrcall_max;
+	function->_set_inline_cache_count(inline_cache_count);
 
 	ended = true;
 	return function;
@@ -529,12 +530,141 @@ void GDScriptByteCodeGenerator::write_type_adjust(const Address &p_target, Varia
 	append(p_target);
 }
 
+GDScriptFunction::Opcode GDScriptByteCodeGenerator::get_operator_opcode(Variant::Operator p_operator, Variant::Type p_left_type, Variant::Type p_right_type) const {
+	// Common operators on numbers and vectors get their own instruction, which
+	// works on the values directly instead of calling the operator function.
+	switch (p_left_type) {
+		case Variant::INT: {
+			if (p_right_type == Variant::NIL && p_operator == Variant::OP_NEGATE) {
+				return GDScriptFunction::OPCODE_OPERATOR_NEGATE_INT;
+			}
+			if (p_right_type != Variant::INT) {
+				break;
+			}
+			switch (p_operator) {
+				case Variant::OP_ADD:
+					return GDScriptFunction::OPCODE_OPERATOR_ADD_INT;
+				case Variant::OP_SUBTRACT:
+					return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT;
+				case Variant::OP_MULTIPLY:
+					return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT;
+				case Variant::OP_BIT_AND:
+					return GDScriptFunction::OPCODE_OPERATOR_BIT_AND_INT;
+				case Variant::OP_BIT_OR:
+					return GDScriptFunction::OPCODE_OPERATOR_BIT_OR_INT;
+				case Variant::OP_BIT_XOR:
+					return GDScriptFunction::OPCODE_OPERATOR_BIT_XOR_INT;
+				case Variant::OP_EQUAL:
+					return GDScriptFunction::OPCODE_OPERATOR_EQUAL_INT;
+				case Variant::OP_NOT_EQUAL:
+					return GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT;
+				case Variant::OP_LESS:
+					return GDScriptFunction::OPCODE_OPERATOR_LESS_INT;
+				case Variant::OP_LESS_EQUAL:
+					return GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT;
+				case Variant::OP_GREATER:
+					return GDScriptFunction::OPCODE_OPERATOR_GREATER_INT;
+				case Variant::OP_GREATER_EQUAL:
+					return GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT;
+				default:
+					break;
+			}
+		} break;
+		case Variant::FLOAT: {
+			if (p_right_type == Variant::NIL && p_operator == Variant::OP_NEGATE) {
+				return GDScriptFunction::OPCODE_OPERATOR_NEGATE_FLOAT;
+			}
+			if (p_right_type != Variant::FLOAT) {
+				break;
+			}
+			switch (p_operator) {
+				case Variant::OP_ADD:
+					return GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT;
+				case Variant::OP_SUBTRACT:
+					return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT;
+				case Variant::OP_MULTIPLY:
+					return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT;
+				case Variant::OP_DIVIDE:
+					return GDScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT;
+				case Variant::OP_EQUAL:
+					return GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT;
+				case Variant::OP_NOT_EQUAL:
+					return GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT;
+				case Variant::OP_LESS:
+					return GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT;
+				case Variant::OP_LESS_EQUAL:
+					return GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT;
+				case Variant::OP_GREATER:
+					return GDScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT;
+				case Variant::OP_GREATER_EQUAL:
+					return GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT;
+				default:
+					break;
+			}
+		} break;
+		case Variant::BOOL: {
+			if (p_right_type == Variant::NIL && p_operator == Variant::OP_NOT) {
+				return GDScriptFunction::OPCODE_OPERATOR_NOT_BOOL;
+			}
+		} break;
+		case Variant::VECTOR2: {
+			if (p_right_type == Variant::VECTOR2) {
+				switch (p_operator) {
+					case Variant::OP_ADD:
+						return GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR2;
+					case Variant::OP_SUBTRACT:
+						return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR2;
+					case Variant::OP_MULTIPLY:
+						return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR2;
+					default:
+						break;
+				}
+			} else if (p_right_type == Variant::FLOAT) {
+				switch (p_operator) {
+					case Variant::OP_MULTIPLY:
+						return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT;
+					case Variant::OP_DIVIDE:
+						return GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT;
+					default:
+						break;
+				}
+			}
+		} break;
+		case Variant::VECTOR3: {
+			if (p_right_type == Variant::VECTOR3) {
+				switch (p_operator) {
+					case Variant::OP_ADD:
+						return GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR3;
+					case Variant::OP_SUBTRACT:
+						return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR3;
+					case Variant::OP_MULTIPLY:
+						return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3;
+					default:
+						break;
+				}
+			} else if (p_right_type == Variant::FLOAT) {
+				switch (p_operator) {
+					case Variant::OP_MULTIPLY:
+						return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT;
+					case Variant::OP_DIVIDE:
+						return GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT;
+					default:
+						break;
+				}
+			}
+		} break;
+		default:
+			break;
+	}
+	return GDScriptFunction::OPCODE_OPERATOR_VALIDATED;
+}
+
 void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand) {
 	if (HAS_BUILTIN_TYPE(p_left_operand)) {
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, Variant::NIL);
 
-		append(GDScriptFunction::OPCODE_OPERATOR_VALIDATED, 3);
+		append(get_operator_opcode(p_operator, p_left_operand.type.builtin_type, Variant::NIL), 3);
 		append(p_left_operand);
 		append(Address());
 		append(p_target);
@@ -563,7 +693,7 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
-		append(GDScriptFunction::OPCODE_OPERATOR_VALIDATED, 3);
+		append(get_operator_opcode(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type), 3);
 		append(p_left_operand);
 		append(p_right_operand);
 		append(p_target);
@@ -759,6 +889,7 @@ void GDScriptByteCodeGenerator::write_set_named(const Address &p_target, const S
 	append(p_target);
 	append(p_source);
 	append(p_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -774,6 +905,7 @@ void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const S
 	append(p_source);
 	append(p_target);
 	append(p_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
@@ -917,6 +1049,7 @@ void GDScriptByteCodeGenerator::write_call(const Address &p_target, const Addres
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_super_call(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) {
@@ -938,6 +1071,7 @@ void GDScriptByteCodeGenerator::write_call_async(const Address &p_target, const
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_call_gdscript_utility(const Address &p_target, GDScriptUtilityFunctions::FunctionPtr p_function, const Vector<Address> &p_arguments) {
@@ -1185,6 +1319,7 @@ void GDScriptByteCodeGenerator::write_call_self(const Address &p_target, const S
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) {
@@ -1196,6 +1331,7 @@ void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, c
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) {
@@ -1207,6 +1343,7 @@ void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_targ
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_lambda(const Address &p_target, GDScriptFunction *p_function, const Vector<Address> &p_captures, bool p_use_self) {
@@ -30,10 +30,18 @@
 
 #include "gdscript_cache.h"
 
+#include "core/config/engine.h"
+#include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_uid.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 #include "core/templates/vector.h"
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_byte_code_cache.h"
 #include "gdscript_parser.h"
 
 bool GDScriptParserRef::is_valid() const {
@@ -103,7 +111,11 @@ GDScriptParserRef::~GDScriptParserRef() {
 		memdelete(analyzer);
 	}
 	MutexLock lock(GDScriptCache::singleton->lock);
-	GDScriptCache::singleton->parser_map.erase(path);
+	// Parsers made by precompile_scripts() may not be the ones in the map.
+	HashMap<String, GDScriptParserRef *>::Iterator E = GDScriptCache::singleton->parser_map.find(path);
+	if (E && E->value == this) {
+		GDScriptCache::singleton->parser_map.remove(E);
+	}
 }
 
 GDScriptCache *GDScriptCache::singleton = nullptr;
@@ -112,6 +124,7 @@ void GDScriptCache::remove_script(const String &p_path) {
 	MutexLock lock(singleton->lock);
 	singleton->shallow_gdscript_cache.erase(p_path);
 	singleton->full_gdscript_cache.erase(p_path);
+	singleton->compiled_dependencies.erase(p_path);
 }
 
 Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
@@ -163,6 +176,32 @@ String GDScriptCache::get_source_code(const String &p_path) {
 	return source;
 }
 
+String GDScriptCache::get_source_hash(const String &p_path) {
+	MutexLock lock(singleton->lock);
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	if (f.is_null()) {
+		singleton->source_hashes.erase(p_path);
+		return String();
+	}
+
+	// Modification times only have a resolution of one second: a hash is only
+	// kept for a file that didn't change since the second it was made in.
+	const uint64_t size = f->get_length();
+	const uint64_t modified_time = FileAccess::get_modified_time(p_path);
+	HashMap<String, SourceHash>::Iterator E = singleton->source_hashes.find(p_path);
+	if (E && E->value.size == size && E->value.modified_time == modified_time && modified_time < E->value.hash_time) {
+		return E->value.hash;
+	}
+
+	SourceHash source_hash;
+	source_hash.size = size;
+	source_hash.modified_time = modified_time;
+	source_hash.hash_time = (uint64_t)OS::get_singleton()->get_unix_time();
+	source_hash.hash = get_source_code(p_path).md5_text();
+	singleton->source_hashes[p_path] = source_hash;
+	return source_hash.hash;
+}
+
 Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, const String &p_owner) {
 	MutexLock lock(singleton->lock);
 	if (!p_owner.is_empty()) {
@@ -186,6 +225,10 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, const Stri
 }
 
 Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_error, const String &p_owner) {
+	if (singleton->precompile_pending.is_set()) {
+		precompile_startup_scripts();
+	}
+
 	MutexLock lock(singleton->lock);
 
 	if (!p_owner.is_empty()) {
@@ -206,7 +249,37 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 		return script;
 	}
 
-	r_error = script->reload();
+	singleton->loading.insert(p_path);
+
+	String cache_path;
+	if (singleton->use_byte_code_cache || singleton->save_byte_code_cache) {
+		cache_path = GDScriptByteCodeCache::get_cache_path(p_path);
+	}
+
+	bool keep_state = false;
+	if (singleton->use_byte_code_cache) {
+		Error cache_err = script->load_byte_code(cache_path);
+		if (cache_err == OK) {
+			singleton->loading.erase(p_path);
+			return script;
+		}
+		// Other scripts may already use the inner classes it made.
+		keep_state = cache_err == ERR_CANT_RESOLVE;
+	}
+
+	Ref<GDScriptParserRef> precompiled;
+	HashMap<String, Ref<GDScriptParserRef>>::Iterator E = singleton->precompiled_parsers.find(p_path);
+	if (E) {
+		precompiled = E->value;
+		singleton->precompiled_parsers.remove(E);
+	}
+
+	if (precompiled.is_valid()) {
+		r_error = script->_compile(*precompiled->get_parser(), keep_state);
+	} else {
+		r_error = script->reload(keep_state);
+	}
+	singleton->loading.erase(p_path);
 	if (r_error) {
 		return script;
 	}
@@ -214,9 +287,42 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 	singleton->full_gdscript_cache[p_path] = script.ptr();
 	singleton->shallow_gdscript_cache.erase(p_path);
 
+	if (singleton->save_byte_code_cache) {
+		save_byte_code(script, cache_path);
+	}
+
 	return script;
 }
 
+void GDScriptCache::save_byte_code(const Ref<GDScript> &p_script, const String &p_cache_path) {
+	Vector<uint8_t> byte_code;
+	if (GDScriptByteCodeCache::save(p_script.ptr(), byte_code) != OK) {
+		return;
+	}
+
+	// Write it aside first, so a script loaded meanwhile never reads half of it.
+	Ref<DirAccess> da = DirAccess::create_for_path(p_cache_path);
+	Error err = da->make_dir_recursive(p_cache_path.get_base_dir());
+	if (err != OK && err != ERR_ALREADY_EXISTS) {
+		print_verbose(vformat("GDScript: Can't create the bytecode cache directory '%s'.", p_cache_path.get_base_dir()));
+		return;
+	}
+	const String temp_path = p_cache_path + "." + itos(OS::get_singleton()->get_process_id()) + ".tmp";
+	{
+		Ref<FileAccess> f = FileAccess::open(temp_path, FileAccess::WRITE, &err);
+		if (f.is_null()) {
+			print_verbose(vformat("GDScript: Can't write the bytecode cache file '%s'.", temp_path));
+			return;
+		}
+		f->store_buffer(byte_code.ptr(), byte_code.size());
+	}
+
+	if (da->rename(temp_path, p_cache_path) != OK) {
+		da->remove(temp_path);
+		print_verbose(vformat("GDScript: Can't write the bytecode cache file '%s'.", p_cache_path));
+	}
+}
+
 Error GDScriptCache::finish_compiling(const String &p_owner) {
 	// Mark this as compiled.
 	Ref<GDScript> script = get_shallow_script(p_owner);
@@ -224,6 +330,7 @@ Error GDScriptCache::finish_compiling(const String &p_owner) {
 	singleton->shallow_gdscript_cache.erase(p_owner);
 
 	HashSet<String> depends = singleton->dependencies[p_owner];
+	singleton->compiled_dependencies[p_owner] = depends;
 
 	Error err = OK;
 	for (const String &E : depends) {
@@ -241,11 +348,256 @@ Error GDScriptCache::finish_compiling(const String &p_owner) {
 	return err;
 }
 
+static void _find_scripts_in_dir(const String &p_dir, Vector<String> &r_paths) {
+	Ref<DirAccess> da = DirAccess::open(p_dir);
+	if (da.is_null()) {
+		return;
+	}
+	if (da->file_exists(".gdignore")) {
+		return;
+	}
+
+	da->list_dir_begin();
+	for (String name = da->get_next(); !name.is_empty(); name = da->get_next()) {
+		if (name.begins_with(".")) {
+			continue; // Also skips the project data directory.
+		}
+		if (da->current_is_dir()) {
+			_find_scripts_in_dir(p_dir.plus_file(name), r_paths);
+		} else if (name.get_extension() == "gd") {
+			r_paths.push_back(p_dir.plus_file(name));
+		}
+	}
+	da->list_dir_end();
+}
+
+Vector<String> GDScriptCache::find_scripts(PrecompileMode p_mode) {
+	Vector<String> paths;
+
+	switch (p_mode) {
+		case PRECOMPILE_DISABLED: {
+		} break;
+		case PRECOMPILE_MAIN_SCENE: {
+			List<String> to_visit;
+			to_visit.push_back(GLOBAL_GET("application/run/main_scene"));
+			for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : ProjectSettings::get_singleton()->get_autoload_list()) {
+				to_visit.push_back(E.value.path);
+			}
+
+			HashSet<String> visited;
+			while (!to_visit.is_empty()) {
+				String path = to_visit.front()->get();
+				to_visit.pop_front();
+				if (path.begins_with("uid://")) {
+					const ResourceUID::ID id = ResourceUID::get_singleton()->text_to_id(path);
+					path = ResourceUID::get_singleton()->has_id(id) ? ResourceUID::get_singleton()->get_id_path(id) : String();
+				}
+				if (path.is_empty() || visited.has(path)) {
+					continue;
+				}
+				visited.insert(path);
+
+				if (path.get_extension() == "gd") {
+					paths.push_back(path);
+					continue;
+				}
+				List<String> resource_dependencies;
+				ResourceLoader::get_dependencies(path, &resource_dependencies);
+				for (const String &E : resource_dependencies) {
+					to_visit.push_back(E.get_slice("::", 0));
+				}
+			}
+		} break;
+		case PRECOMPILE_ALL_SCRIPTS: {
+			_find_scripts_in_dir("res://", paths);
+		} break;
+	}
+
+	return paths;
+}
+
+struct PrecompileParse {
+	Ref<GDScriptParserRef> *parsers = nullptr;
+	GDScriptCache::CompileTime *times = nullptr;
+};
+
+static void _parse_precompiled_script(void *p_userdata, uint32_t p_index) {
+	PrecompileParse *data = (PrecompileParse *)p_userdata;
+	const uint64_t start = OS::get_singleton()->get_ticks_usec();
+	data->times[p_index].error = data->parsers[p_index]->raise_status(GDScriptParserRef::PARSED);
+	data->times[p_index].parse_usec = OS::get_singleton()->get_ticks_usec() - start;
+}
+
+static void _add_compile_order(const String &p_path, const HashMap<String, HashSet<String>> &p_dependencies, const HashMap<String, int> &p_indices, HashSet<String> &r_visited, Vector<String> &r_order) {
+	if (r_visited.has(p_path)) {
+		return; // Done, or a cycle the compiler deals with.
+	}
+	r_visited.insert(p_path);
+
+	const HashSet<String> *dependencies = p_dependencies.getptr(p_path);
+	if (dependencies) {
+		for (const String &E : *dependencies) {
+			if (p_indices.has(E)) {
+				_add_compile_order(E, p_dependencies, p_indices, r_visited, r_order);
+			}
+		}
+	}
+	r_order.push_back(p_path);
+}
+
+Vector<GDScriptCache::CompileTime> GDScriptCache::precompile_scripts(const Vector<String> &p_paths) {
+	const uint64_t start = OS::get_singleton()->get_ticks_usec();
+
+	Vector<Ref<GDScriptParserRef>> parsers;
+	Vector<CompileTime> times;
+	HashMap<String, int> indices;
+	{
+		MutexLock lock(singleton->lock);
+		for (const String &path : p_paths) {
+			if (indices.has(path) || singleton->full_gdscript_cache.has(path) || singleton->parser_map.has(path) || !FileAccess::exists(path)) {
+				continue;
+			}
+			if (singleton->use_byte_code_cache && FileAccess::exists(GDScriptByteCodeCache::get_cache_path(path))) {
+				continue; // Most likely loaded from its bytecode instead.
+			}
+
+			Ref<GDScriptParserRef> ref;
+			ref.instantiate();
+			ref->parser = memnew(GDScriptParser);
+			ref->path = path;
+			indices.insert(path, parsers.size());
+			parsers.push_back(ref);
+
+			CompileTime time;
+			time.path = path;
+			times.push_back(time);
+		}
+	}
+	if (parsers.is_empty()) {
+		return times;
+	}
+
+	// Parsing only depends on the source, so it doesn't need the lock. The
+	// parsers aren't in the map yet, nothing else can use them meanwhile.
+	PrecompileParse parse;
+	parse.parsers = parsers.ptrw();
+	parse.times = times.ptrw();
+	GDScriptParser::get_builtin_type(StringName()); // Fills its table before threads read it.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && parsers.size() > 1) {
+		pool->wait_for_group_task_completion(pool->add_native_group_task(&_parse_precompiled_script, &parse, parsers.size(), -1, WorkerThreadPool::PRIORITY_HIGH, "Parse GDScript"));
+	} else {
+		for (int i = 0; i < parsers.size(); i++) {
+			_parse_precompiled_script(&parse, i);
+		}
+	}
+
+	MutexLock lock(singleton->lock);
+
+	// Analyzing resolves other scripts through the map, one at a time.
+	for (int i = 0; i < parsers.size(); i++) {
+		const String &path = times[i].path;
+		if (singleton->parser_map.has(path)) {
+			continue; // Parsed meanwhile for another script, keep that one.
+		}
+		singleton->parser_map[path] = parsers.write[i].ptr();
+	}
+	for (int i = 0; i < parsers.size(); i++) {
+		Ref<GDScriptParserRef> ref = parsers[i];
+		CompileTime &time = times.write[i];
+		if (time.error != OK || singleton->parser_map[time.path] != ref.ptr()) {
+			continue;
+		}
+		const uint64_t analyze_start = OS::get_singleton()->get_ticks_usec();
+		time.error = ref->raise_status(GDScriptParserRef::FULLY_SOLVED);
+		time.analyze_usec = OS::get_singleton()->get_ticks_usec() - analyze_start;
+		if (time.error == OK) {
+			singleton->precompiled_parsers.insert(time.path, ref);
+		}
+	}
+
+	// Compiling a script compiles its base classes on demand. Starting with
+	// what each script depends on compiles those from their analyzed parsers.
+	Vector<String> order;
+	HashSet<String> visited;
+	for (int i = 0; i < times.size(); i++) {
+		_add_compile_order(times[i].path, singleton->dependencies, indices, visited, order);
+	}
+	for (const String &path : order) {
+		CompileTime &time = times.write[indices[path]];
+		const uint64_t compile_start = OS::get_singleton()->get_ticks_usec();
+		Error err = OK;
+		Ref<GDScript> script = get_full_script(path, err);
+		if (err == OK) {
+			singleton->precompiled_scripts.push_back(script);
+		}
+		time.compile_usec = OS::get_singleton()->get_ticks_usec() - compile_start;
+		if (time.error == OK) {
+			time.error = err;
+		}
+	}
+	singleton->precompiled_parsers.clear();
+
+	for (const CompileTime &time : times) {
+		const String failed = time.error == OK ? "" : " (failed)";
+		print_verbose(vformat("GDScript: Precompiled '%s'%s: parsing %.2f ms, analysis %.2f ms, compilation %.2f ms.", time.path, failed, time.parse_usec / 1000.0, time.analyze_usec / 1000.0, time.compile_usec / 1000.0));
+	}
+	print_verbose(vformat("GDScript: Precompiled %d scripts in %.2f ms.", times.size(), (OS::get_singleton()->get_ticks_usec() - start) / 1000.0));
+
+	return times;
+}
+
+void GDScriptCache::precompile_startup_scripts() {
+	{
+		MutexLock lock(singleton->lock);
+		if (!singleton->precompile_pending.is_set()) {
+			return;
+		}
+		// Scripts can use autoloads, which are only known once they are all
+		// registered. Wait for a script that's loaded after that.
+		const HashMap<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+		for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : ProjectSettings::get_singleton()->get_autoload_list()) {
+			if (E.value.is_singleton && !global_map.has(E.key)) {
+				return;
+			}
+		}
+		singleton->precompile_pending.clear();
+	}
+
+	precompile_scripts(find_scripts(singleton->precompile_mode));
+}
+
+void GDScriptCache::finish_startup() {
+	Vector<Ref<GDScript>> scripts;
+	{
+		MutexLock lock(singleton->lock);
+		singleton->precompile_pending.clear();
+		scripts = singleton->precompiled_scripts;
+		singleton->precompiled_scripts.clear();
+	}
+	// Freeing them removes them from the cache, which locks it again.
+	scripts.clear();
+}
+
 GDScriptCache::GDScriptCache() {
 	singleton = this;
+
+	// The editor changes scripts all the time, and compiles them to check them.
+	const bool is_editor = Engine::get_singleton()->is_editor_hint();
+	use_byte_code_cache = GLOBAL_DEF("gdscript/bytecode_cache/enabled", true) && !is_editor;
+	save_byte_code_cache = GLOBAL_DEF("gdscript/bytecode_cache/save", false) && !is_editor;
+	byte_code_cache_path = GLOBAL_DEF("gdscript/bytecode_cache/path", "");
+	ProjectSettings::get_singleton()->set_custom_property_info("gdscript/bytecode_cache/path", PropertyInfo(Variant::STRING, "gdscript/bytecode_cache/path", PROPERTY_HINT_DIR));
+
+	precompile_mode = (PrecompileMode)(int)GLOBAL_DEF("gdscript/compilation/precompile_on_startup", PRECOMPILE_DISABLED);
+	ProjectSettings::get_singleton()->set_custom_property_info("gdscript/compilation/precompile_on_startup", PropertyInfo(Variant::INT, "gdscript/compilation/precompile_on_startup", PROPERTY_HINT_ENUM, "Disabled,Main Scene,All Scripts"));
+	if (precompile_mode != PRECOMPILE_DISABLED && !is_editor) {
+		precompile_pending.set();
+	}
 }
 
 GDScriptCache::~GDScriptCache() {
+	precompiled_scripts.clear();
 	parser_map.clear();
 	shallow_gdscript_cache.clear();
 	full_gdscript_cache.clear();
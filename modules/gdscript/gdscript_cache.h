@@ -35,6 +35,7 @@
 #include "core/os/mutex.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hash_set.h"
+#include "core/templates/safe_refcount.h"
 #include "gdscript.h"
 
 class GDScriptAnalyzer;
@@ -70,27 +71,83 @@ public:
 };
 
 class GDScriptCache {
+public:
+	enum PrecompileMode {
+		PRECOMPILE_DISABLED,
+		PRECOMPILE_MAIN_SCENE,
+		PRECOMPILE_ALL_SCRIPTS,
+	};
+
+	// Time spent on a script by precompile_scripts(). Analyzing a script also
+	// analyzes the interface of the scripts it uses, if it wasn't yet.
+	struct CompileTime {
+		String path;
+		uint64_t parse_usec = 0;
+		uint64_t analyze_usec = 0;
+		uint64_t compile_usec = 0;
+		Error error = OK;
+	};
+
+private:
 	// String key is full path.
 	HashMap<String, GDScriptParserRef *> parser_map;
 	HashMap<String, GDScript *> shallow_gdscript_cache;
 	HashMap<String, GDScript *> full_gdscript_cache;
 	HashMap<String, HashSet<String>> dependencies;
+	// What each compiled script depended on when it was compiled.
+	HashMap<String, HashSet<String>> compiled_dependencies;
+
+	struct SourceHash {
+		String hash;
+		uint64_t size = 0;
+		uint64_t modified_time = 0;
+		uint64_t hash_time = 0; // When the source was read.
+	};
+	HashMap<String, SourceHash> source_hashes;
+	// Scripts being compiled, or loaded from their bytecode.
+	HashSet<String> loading;
+
+	bool use_byte_code_cache = false;
+	bool save_byte_code_cache = false;
+	String byte_code_cache_path;
+
+	// Analyzed parsers get_full_script() compiles, instead of parsing the
+	// scripts again. Only kept while precompile_scripts() runs.
+	HashMap<String, Ref<GDScriptParserRef>> precompiled_parsers;
+	// Nothing else may use the scripts it compiled yet, until finish_startup().
+	Vector<Ref<GDScript>> precompiled_scripts;
+	PrecompileMode precompile_mode = PRECOMPILE_DISABLED;
+	SafeFlag precompile_pending;
 
 	friend class GDScript;
 	friend class GDScriptParserRef;
+	friend class GDScriptByteCodeCache;
 
 	static GDScriptCache *singleton;
 
 	Mutex lock;
 	static void remove_script(const String &p_path);
+	static void save_byte_code(const Ref<GDScript> &p_script, const String &p_cache_path);
+	static void precompile_startup_scripts();
 
 public:
 	static Ref<GDScriptParserRef> get_parser(const String &p_path, GDScriptParserRef::Status status, Error &r_error, const String &p_owner = String());
 	static String get_source_code(const String &p_path);
+	static String get_source_hash(const String &p_path);
 	static Ref<GDScript> get_shallow_script(const String &p_path, const String &p_owner = String());
 	static Ref<GDScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String());
 	static Error finish_compiling(const String &p_owner);
 
+	// Scripts of the project, or the ones the main scene and autoloads use.
+	// Scripts only other scripts use aren't listed, they're compiled with them.
+	static Vector<String> find_scripts(PrecompileMode p_mode);
+	// Parses the scripts in parallel, then analyzes and compiles them, the
+	// scripts they depend on first.
+	static Vector<CompileTime> precompile_scripts(const Vector<String> &p_paths);
+	// Frees the precompiled scripts nothing used during startup, and doesn't
+	// precompile anymore if no script was loaded yet.
+	static void finish_startup();
+
 	GDScriptCache();
 	~GDScriptCache();
 };
@@ -134,6 +134,67 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+
+#define DISASSEMBLE_OPERATOR_BINARY(m_name, m_op) \
+	case OPCODE_OPERATOR_##m_name: {             \
+		text += "operator (";                    \
+		text += #m_name;                         \
+		text += ") ";                            \
+		text += DADDR(3);                        \
+		text += " = ";                           \
+		text += DADDR(1);                        \
+		text += " " m_op " ";                    \
+		text += DADDR(2);                        \
+		incr += 5;                               \
+	} break
+
+#define DISASSEMBLE_OPERATOR_UNARY(m_name, m_op) \
+	case OPCODE_OPERATOR_##m_name: {            \
+		text += "operator (";                   \
+		text += #m_name;                        \
+		text += ") ";                           \
+		text += DADDR(3);                       \
+		text += " = " m_op;                     \
+		text += DADDR(1);                       \
+		incr += 5;                              \
+	} break
+
+				DISASSEMBLE_OPERATOR_BINARY(ADD_INT, "+");
+				DISASSEMBLE_OPERATOR_BINARY(SUBTRACT_INT, "-");
+				DISASSEMBLE_OPERATOR_BINARY(MULTIPLY_INT, "*");
+				DISASSEMBLE_OPERATOR_BINARY(BIT_AND_INT, "&");
+				DISASSEMBLE_OPERATOR_BINARY(BIT_OR_INT, "|");
+				DISASSEMBLE_OPERATOR_BINARY(BIT_XOR_INT, "^");
+				DISASSEMBLE_OPERATOR_UNARY(NEGATE_INT, "-");
+				DISASSEMBLE_OPERATOR_BINARY(EQUAL_INT, "==");
+				DISASSEMBLE_OPERATOR_BINARY(NOT_EQUAL_INT, "!=");
+				DISASSEMBLE_OPERATOR_BINARY(LESS_INT, "<");
+				DISASSEMBLE_OPERATOR_BINARY(LESS_EQUAL_INT, "<=");
+				DISASSEMBLE_OPERATOR_BINARY(GREATER_INT, ">");
+				DISASSEMBLE_OPERATOR_BINARY(GREATER_EQUAL_INT, ">=");
+				DISASSEMBLE_OPERATOR_BINARY(ADD_FLOAT, "+");
+				DISASSEMBLE_OPERATOR_BINARY(SUBTRACT_FLOAT, "-");
+				DISASSEMBLE_OPERATOR_BINARY(MULTIPLY_FLOAT, "*");
+				DISASSEMBLE_OPERATOR_BINARY(DIVIDE_FLOAT, "/");
+				DISASSEMBLE_OPERATOR_UNARY(NEGATE_FLOAT, "-");
+				DISASSEMBLE_OPERATOR_BINARY(EQUAL_FLOAT, "==");
+				DISASSEMBLE_OPERATOR_BINARY(NOT_EQUAL_FLOAT, "!=");
+				DISASSEMBLE_OPERATOR_BINARY(LESS_FLOAT, "<");
+				DISASSEMBLE_OPERATOR_BINARY(LESS_EQUAL_FLOAT, "<=");
+				DISASSEMBLE_OPERATOR_BINARY(GREATER_FLOAT, ">");
+				DISASSEMBLE_OPERATOR_BINARY(GREATER_EQUAL_FLOAT, ">=");
+				DISASSEMBLE_OPERATOR_UNARY(NOT_BOOL, "not ");
+				DISASSEMBLE_OPERATOR_BINARY(ADD_VECTOR2, "+");
+				DISASSEMBLE_OPERATOR_BINARY(SUBTRACT_VECTOR2, "-");
+				DISASSEMBLE_OPERATOR_BINARY(MULTIPLY_VECTOR2, "*");
+				DISASSEMBLE_OPERATOR_BINARY(MULTIPLY_VECTOR2_FLOAT, "*");
+				DISASSEMBLE_OPERATOR_BINARY(DIVIDE_VECTOR2_FLOAT, "/");
+				DISASSEMBLE_OPERATOR_BINARY(ADD_VECTOR3, "+");
+				DISASSEMBLE_OPERATOR_BINARY(SUBTRACT_VECTOR3, "-");
+				DISASSEMBLE_OPERATOR_BINARY(MULTIPLY_VECTOR3, "*");
+				DISASSEMBLE_OPERATOR_BINARY(MULTIPLY_VECTOR3_FLOAT, "*");
+				DISASSEMBLE_OPERATOR_BINARY(DIVIDE_VECTOR3_FLOAT, "/");
+
 			case OPCODE_EXTENDS_TEST: {
 				text += "is object ";
 				text += DADDR(3);
@@ -225,7 +286,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += "\"] = ";
 				text += DADDR(2);
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_SET_NAMED_VALIDATED: {
 				text += "set_named validated ";
@@ -246,7 +307,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"]";
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
@@ -509,7 +570,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				}
 				text += ")";
 
-				incr = 5 + argc;
+				incr = 6 + argc;
 			} break;
 			case OPCODE_CALL_METHOD_BIND:
 			case OPCODE_CALL_METHOD_BIND_RET: {
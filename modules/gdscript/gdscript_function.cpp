@@ -31,6 +31,7 @@
 #include "gdscript_function.h"
 
 #include "gdscript.h"
+#include "gdscript_inline_cache.h"
 
 const int *GDScriptFunction::get_code() const {
 	return _code_ptr;
@@ -138,6 +139,17 @@ void GDScriptFunction::debug_get_stack_member_state(int p_line, List<Pair<String
 	}
 }
 
+void GDScriptFunction::_set_inline_cache_count(int p_count) {
+	if (_inline_caches_ptr) {
+		memdelete_arr(_inline_caches_ptr);
+		_inline_caches_ptr = nullptr;
+	}
+	if (p_count > 0) {
+		_inline_caches_ptr = memnew_arr(GDScriptInlineCache, p_count);
+	}
+	_inline_cache_count = p_count;
+}
+
 GDScriptFunction::GDScriptFunction() {
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -153,6 +165,16 @@ GDScriptFunction::~GDScriptFunction() {
 		memdelete(lambdas[i]);
 	}
 
+#ifdef GDSCRIPT_JIT_ENABLED
+	if (jit_code) {
+		GDScriptJIT::free_code(jit_code);
+	}
+#endif
+
+	if (_inline_caches_ptr) {
+		memdelete_arr(_inline_caches_ptr);
+	}
+
 #ifdef DEBUG_ENABLED
 
 	MutexLock lock(GDScriptLanguage::get_singleton()->lock);
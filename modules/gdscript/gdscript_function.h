@@ -38,9 +38,11 @@
 #include "core/templates/pair.h"
 #include "core/templates/self_list.h"
 #include "core/variant/variant.h"
+#include "gdscript_jit.h"
 #include "gdscript_utility_functions.h"
 
 class GDScriptInstance;
+class GDScriptInlineCache;
 class GDScript;
 
 class GDScriptDataType {
@@ -219,6 +221,43 @@ public:
 	enum Opcode {
 		OPCODE_OPERATOR,
 		OPCODE_OPERATOR_VALIDATED,
+		// Operators on values of known builtin types, done in place on their data.
+		// Same layout as validated operators, they keep the operator function.
+		OPCODE_OPERATOR_ADD_INT,
+		OPCODE_OPERATOR_SUBTRACT_INT,
+		OPCODE_OPERATOR_MULTIPLY_INT,
+		OPCODE_OPERATOR_BIT_AND_INT,
+		OPCODE_OPERATOR_BIT_OR_INT,
+		OPCODE_OPERATOR_BIT_XOR_INT,
+		OPCODE_OPERATOR_NEGATE_INT,
+		OPCODE_OPERATOR_EQUAL_INT,
+		OPCODE_OPERATOR_NOT_EQUAL_INT,
+		OPCODE_OPERATOR_LESS_INT,
+		OPCODE_OPERATOR_LESS_EQUAL_INT,
+		OPCODE_OPERATOR_GREATER_INT,
+		OPCODE_OPERATOR_GREATER_EQUAL_INT,
+		OPCODE_OPERATOR_ADD_FLOAT,
+		OPCODE_OPERATOR_SUBTRACT_FLOAT,
+		OPCODE_OPERATOR_MULTIPLY_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_FLOAT,
+		OPCODE_OPERATOR_NEGATE_FLOAT,
+		OPCODE_OPERATOR_EQUAL_FLOAT,
+		OPCODE_OPERATOR_NOT_EQUAL_FLOAT,
+		OPCODE_OPERATOR_LESS_FLOAT,
+		OPCODE_OPERATOR_LESS_EQUAL_FLOAT,
+		OPCODE_OPERATOR_GREATER_FLOAT,
+		OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,
+		OPCODE_OPERATOR_NOT_BOOL,
+		OPCODE_OPERATOR_ADD_VECTOR2,
+		OPCODE_OPERATOR_SUBTRACT_VECTOR2,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR2,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT,
+		OPCODE_OPERATOR_ADD_VECTOR3,
+		OPCODE_OPERATOR_SUBTRACT_VECTOR3,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR3,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET_KEYED,
@@ -426,6 +465,7 @@ public:
 private:
 	friend class GDScriptCompiler;
 	friend class GDScriptByteCodeGenerator;
+	friend class GDScriptByteCodeCache;
 
 	StringName source;
 
@@ -468,6 +508,8 @@ private:
 	int _stack_size = 0;
 	int _instruction_args_size = 0;
 	int _ptrcall_args_size = 0;
+	GDScriptInlineCache *_inline_caches_ptr = nullptr; // One per named get, set and call instruction.
+	int _inline_cache_count = 0;
 
 	int _initial_line = 0;
 	bool _static = false;
@@ -506,6 +548,7 @@ private:
 	List<StackDebug> stack_debug;
 
 	Variant _get_default_variant_for_data_type(const GDScriptDataType &p_data_type);
+	void _set_inline_cache_count(int p_count);
 
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, Variant *p_stack, String &r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Callable::CallError &p_err, const String &p_where, const Variant **argptrs) const;
@@ -532,6 +575,14 @@ private:
 
 #endif
 
+#ifdef GDSCRIPT_JIT_ENABLED
+	friend class GDScriptJIT;
+
+	SafeNumeric<uint32_t> jit_heat; // Calls so far, from any thread.
+	SafeFlag jit_done;
+	GDScriptJIT::Code *jit_code = nullptr;
+#endif
+
 public:
 	struct CallState {
 		GDScript *script = nullptr;
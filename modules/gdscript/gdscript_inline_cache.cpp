@@ -0,0 +1,343 @@
+/*************************************************************************/
+/*  gdscript_inline_cache.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_inline_cache.h"
+
+#include "core/config/engine.h"
+#include "core/core_string_names.h"
+#include "core/object/class_db.h"
+#include "core/object/method_bind.h"
+#include "gdscript.h"
+
+SafeNumeric<uint32_t> GDScriptInlineCache::script_generation(1);
+
+bool GDScriptInlineCache::_get_receiver(const Variant *p_base, Object *&r_object, GDScriptInstance *&r_instance) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		return false;
+	}
+	// Freed objects are left to Variant, to report them.
+	r_object = p_base->get_validated_object();
+	if (!r_object) {
+		return false;
+	}
+
+	ScriptInstance *script_instance = r_object->get_script_instance();
+	if (!script_instance) {
+		r_instance = nullptr;
+		return true;
+	}
+	if (script_instance->is_placeholder() || script_instance->get_language() != GDScriptLanguage::get_singleton()) {
+		return false;
+	}
+	r_instance = static_cast<GDScriptInstance *>(script_instance);
+	return true;
+}
+
+GDScriptFunction *GDScriptInlineCache::_find_function(const GDScript *p_script, const StringName &p_name) {
+	for (const GDScript *script = p_script; script; script = script->_base) {
+		GDScriptFunction *const *function = script->member_functions.getptr(p_name);
+		if (function) {
+			return *function;
+		}
+	}
+	return nullptr;
+}
+
+// Does the same lookups as Object::get(), set() and callp() (and the
+// GDScriptInstance ones), but only keeps the result if it only depends on the
+// class of the object.
+GDScriptInlineCache::Target GDScriptInlineCache::_resolve(Access p_access, Object *p_object, GDScriptInstance *p_instance, const StringName &p_name) {
+	Target target;
+
+#ifdef TOOLS_ENABLED
+	if (p_access == ACCESS_SET && Engine::get_singleton()->is_editor_hint()) {
+		return target; // Object::set() marks the object as edited.
+	}
+#endif
+	if (p_access == ACCESS_CALL && p_name == CoreStringNames::get_singleton()->_free) {
+		return target;
+	}
+
+	if (p_instance) {
+		const GDScript *script = p_instance->script.ptr();
+		const GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+
+		if (p_access == ACCESS_CALL) {
+			if (p_name == SNAME("_ready")) {
+				return target; // Implicit ready functions run first.
+			}
+			target.function = _find_function(script, p_name);
+			if (target.function) {
+				target.kind = KIND_SCRIPT_FUNCTION;
+				return target;
+			}
+		} else {
+			const GDScript::MemberInfo *member = script->member_indices.getptr(p_name);
+			if (member) {
+				StringName accessor = p_access == ACCESS_GET ? member->getter : member->setter;
+				target.index = member->index;
+				if (accessor != StringName()) {
+					target.function = _find_function(script, accessor);
+					if (target.function) {
+						target.kind = KIND_SCRIPT_FUNCTION;
+					} else if (p_access == ACCESS_GET) {
+						target.kind = KIND_MEMBER; // The getter fails, the value is read.
+					}
+					return target;
+				}
+				if (p_access == ACCESS_SET && member->data_type.has_type) {
+					if (member->data_type.builtin_type == Variant::ARRAY && member->data_type.has_container_element_type()) {
+						return target; // Typed arrays are assigned with a check.
+					}
+					target.type = &member->data_type;
+				}
+				target.kind = KIND_MEMBER;
+				return target;
+			}
+
+			for (const GDScript *sl = script; sl; sl = sl->_base) {
+				if (p_access == ACCESS_GET) {
+					if (sl->constants.has(p_name) || sl->_signals.has(p_name) || sl->member_functions.has(p_name) || sl->member_functions.has(language->strings._get)) {
+						return target;
+					}
+				} else if (sl->member_functions.has(language->strings._set)) {
+					return target;
+				}
+			}
+		}
+	}
+
+	const StringName &class_name = p_object->get_class_name();
+	const ClassDB::ClassInfo *class_info = ClassDB::classes.getptr(class_name);
+	if (!class_info) {
+		return target;
+	}
+
+	if (p_access == ACCESS_CALL) {
+		// Scripts handle calls to their static functions.
+		if (p_object->is_class_ptr(Script::get_class_ptr_static())) {
+			return target;
+		}
+		target.method = ClassDB::get_method(class_name, p_name);
+		if (target.method) {
+			target.kind = KIND_METHOD_BIND;
+		}
+		return target;
+	}
+
+	// Extensions get and set their own properties first.
+	if (class_info->native_extension) {
+		return target;
+	}
+
+	for (const ClassDB::ClassInfo *check = class_info; check; check = check->inherits_ptr) {
+		const ClassDB::PropertySetGet *psg = check->property_setget.getptr(p_name);
+		if (psg) {
+			// Indexed getters are called through the object.
+			if (p_access == ACCESS_GET && psg->index < 0 && psg->_getptr) {
+				target.kind = KIND_METHOD_BIND;
+				target.method = psg->_getptr;
+			} else if (p_access == ACCESS_SET && psg->_setptr) {
+				target.kind = KIND_METHOD_BIND;
+				target.method = psg->_setptr;
+				target.index = psg->index;
+			}
+			return target;
+		}
+		if (p_access == ACCESS_GET && (check->constant_map.has(p_name) || check->method_map.has(p_name) || check->signal_map.has(p_name))) {
+			return target;
+		}
+	}
+	return target;
+}
+
+GDScriptInlineCache::Target GDScriptInlineCache::_get_target(Access p_access, Object *p_object, GDScriptInstance *p_instance, const StringName &p_name) {
+	const void *native_class = p_object->get_class_name().data_unique_pointer();
+	const GDScript *script = p_instance ? p_instance->script.ptr() : nullptr;
+	const uint32_t current_script_generation = script_generation.get();
+	const uint32_t current_method_generation = ClassDB::get_method_generation();
+
+	for (int i = 0; i < ENTRY_COUNT; i++) {
+		const Entry &entry = entries[i];
+		const uint32_t version = entry.version.get();
+		if (version & 1) {
+			continue;
+		}
+		if (entry.native_class != native_class || entry.script != script || entry.script_generation != current_script_generation || entry.method_generation != current_method_generation) {
+			continue;
+		}
+		Target target = entry.target;
+#if !defined(NO_THREADS)
+		std::atomic_thread_fence(std::memory_order_acquire);
+#endif
+		if (entry.version.get() == version) {
+			return target;
+		}
+	}
+
+	Target target = _resolve(p_access, p_object, p_instance, p_name);
+
+	// Take an empty or stale entry. When all are in use the instruction sees
+	// too many classes, and it keeps resolving the new ones every time.
+	for (int i = 0; i < ENTRY_COUNT; i++) {
+		Entry &entry = entries[i];
+		uint32_t version = entry.version.get();
+		if (version & 1) {
+			continue;
+		}
+		if (entry.native_class && entry.script_generation == current_script_generation && entry.method_generation == current_method_generation) {
+			continue;
+		}
+		if (!entry.version.compare_exchange(version, version + 1)) {
+			continue;
+		}
+#if !defined(NO_THREADS)
+		std::atomic_thread_fence(std::memory_order_release);
+#endif
+		entry.native_class = native_class;
+		entry.script = script;
+		entry.script_generation = current_script_generation;
+		entry.method_generation = current_method_generation;
+		entry.target = target;
+		entry.version.set(version + 2);
+		break;
+	}
+
+	return target;
+}
+
+bool GDScriptInlineCache::get_named(const Variant *p_base, const StringName &p_name, Variant &r_ret) {
+	Object *object;
+	GDScriptInstance *instance;
+	if (!_get_receiver(p_base, object, instance)) {
+		return false;
+	}
+
+	const Target target = _get_target(ACCESS_GET, object, instance, p_name);
+	// Like Object::callp(), so the object can't be freed while its code runs.
+	OBJ_DEBUG_LOCK_OBJECT(object)
+	switch (target.kind) {
+		case KIND_MEMBER: {
+			if (unlikely(target.index >= instance->members.size())) {
+				return false;
+			}
+			r_ret = instance->members[target.index];
+			return true;
+		}
+		case KIND_SCRIPT_FUNCTION: {
+			Callable::CallError err;
+			r_ret = target.function->call(instance, nullptr, 0, err);
+			if (err.error != Callable::CallError::CALL_OK) {
+				if (unlikely(target.index >= instance->members.size())) {
+					return false;
+				}
+				r_ret = instance->members[target.index];
+			}
+			return true;
+		}
+		case KIND_METHOD_BIND: {
+			Callable::CallError err;
+			r_ret = target.method->call(object, nullptr, 0, err);
+			return true;
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+bool GDScriptInlineCache::set_named(Variant *p_base, const StringName &p_name, const Variant &p_value, bool &r_valid) {
+	Object *object;
+	GDScriptInstance *instance;
+	if (!_get_receiver(p_base, object, instance)) {
+		return false;
+	}
+
+	const Target target = _get_target(ACCESS_SET, object, instance, p_name);
+	OBJ_DEBUG_LOCK_OBJECT(object)
+	switch (target.kind) {
+		case KIND_MEMBER: {
+			// Values of another type are converted by the instance.
+			if (unlikely(target.index >= instance->members.size() || (target.type && !target.type->is_type(p_value)))) {
+				return false;
+			}
+			instance->members.write[target.index] = p_value;
+			r_valid = true;
+			return true;
+		}
+		case KIND_SCRIPT_FUNCTION: {
+			const Variant *args[1] = { &p_value };
+			Callable::CallError err;
+			target.function->call(instance, args, 1, err);
+			r_valid = err.error == Callable::CallError::CALL_OK;
+			return true;
+		}
+		case KIND_METHOD_BIND: {
+			Callable::CallError err;
+			if (target.index >= 0) {
+				Variant index = target.index;
+				const Variant *args[2] = { &index, &p_value };
+				target.method->call(object, args, 2, err);
+			} else {
+				const Variant *args[1] = { &p_value };
+				target.method->call(object, args, 1, err);
+			}
+			r_valid = err.error == Callable::CallError::CALL_OK;
+			return true;
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+bool GDScriptInlineCache::call(Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
+	Object *object;
+	GDScriptInstance *instance;
+	if (!_get_receiver(p_base, object, instance)) {
+		return false;
+	}
+
+	const Target target = _get_target(ACCESS_CALL, object, instance, p_name);
+	OBJ_DEBUG_LOCK_OBJECT(object)
+	switch (target.kind) {
+		case KIND_SCRIPT_FUNCTION: {
+			r_ret = target.function->call(instance, p_args, p_argcount, r_error);
+			return true;
+		}
+		case KIND_METHOD_BIND: {
+			r_ret = target.method->call(object, p_args, p_argcount, r_error);
+			return true;
+		}
+		default: {
+			return false;
+		}
+	}
+}
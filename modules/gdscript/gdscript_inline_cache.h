@@ -0,0 +1,116 @@
+/*************************************************************************/
+/*  gdscript_inline_cache.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_INLINE_CACHE_H
+#define GDSCRIPT_INLINE_CACHE_H
+
+#include "core/templates/safe_refcount.h"
+#include "core/variant/variant.h"
+
+class GDScript;
+class GDScriptDataType;
+class GDScriptFunction;
+class GDScriptInstance;
+class MethodBind;
+
+// Cache of what a name resolved to, for an instruction that gets, sets or
+// calls it on untyped values. Looking up a name on an object means walking
+// its script and then ClassDB, for every access. Each entry remembers, for one
+// class of objects (native class and script), the member index, the getter,
+// setter or method (either a script function or a MethodBind) the name led
+// to, so the next object of the same class goes there directly. A few classes
+// are kept per instruction, if more show up the instruction keeps using the
+// generic path for them.
+//
+// Entries are tagged with the generation of scripts and of ClassDB methods,
+// and are ignored once any script is reloaded or freed, or methods are bound.
+//
+// Only objects with no script or with a GDScript instance are handled, other
+// values must go through Variant as usual. Instructions may run on several
+// threads at once, entries are written under a sequence lock.
+class GDScriptInlineCache {
+public:
+	enum {
+		ENTRY_COUNT = 4,
+	};
+
+private:
+	enum Access {
+		ACCESS_GET,
+		ACCESS_SET,
+		ACCESS_CALL,
+	};
+
+	enum Kind {
+		KIND_GENERIC, // Has to go through the object.
+		KIND_MEMBER,
+		KIND_SCRIPT_FUNCTION,
+		KIND_METHOD_BIND,
+	};
+
+	struct Target {
+		Kind kind = KIND_GENERIC;
+		int index = -1; // Member index, or property index for native setters.
+		const GDScriptDataType *type = nullptr; // Type of typed members.
+		GDScriptFunction *function = nullptr;
+		MethodBind *method = nullptr;
+	};
+
+	struct Entry {
+		SafeNumeric<uint32_t> version; // Odd while the entry is written.
+		const void *native_class = nullptr;
+		const GDScript *script = nullptr;
+		uint32_t script_generation = 0;
+		uint32_t method_generation = 0;
+		Target target;
+	};
+
+	Entry entries[ENTRY_COUNT];
+
+	static SafeNumeric<uint32_t> script_generation;
+
+	static bool _get_receiver(const Variant *p_base, Object *&r_object, GDScriptInstance *&r_instance);
+	static GDScriptFunction *_find_function(const GDScript *p_script, const StringName &p_name);
+	static Target _resolve(Access p_access, Object *p_object, GDScriptInstance *p_instance, const StringName &p_name);
+
+	Target _get_target(Access p_access, Object *p_object, GDScriptInstance *p_instance, const StringName &p_name);
+
+public:
+	// Each returns false if the value is not handled by the cache, in which
+	// case nothing was done and the access must go through Variant.
+	bool get_named(const Variant *p_base, const StringName &p_name, Variant &r_ret);
+	bool set_named(Variant *p_base, const StringName &p_name, const Variant &p_value, bool &r_valid);
+	bool call(Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error);
+
+	// Makes all entries stale, whenever what scripts resolve names to changes.
+	static void invalidate() { script_generation.increment(); }
+};
+
+#endif // GDSCRIPT_INLINE_CACHE_H
@@ -0,0 +1,1226 @@
+/*************************************************************************/
+/*  gdscript_jit.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_jit.h"
+
+#include "gdscript_function.h"
+
+bool GDScriptJIT::supported = false;
+bool GDScriptJIT::enabled = false;
+uint32_t GDScriptJIT::hot_threshold = 1000;
+Mutex GDScriptJIT::mutex;
+
+#ifdef GDSCRIPT_JIT_ENABLED
+
+#include "core/variant/variant_internal.h"
+
+#include <stddef.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+enum Reg {
+	RAX,
+	RCX,
+	RDX,
+	RBX,
+	RSP,
+	RBP,
+	RSI,
+	RDI,
+	R8,
+	R9,
+	R10,
+	R11,
+	R12,
+	R13,
+	R14,
+	R15,
+};
+
+// Registers kept across the whole function.
+const Reg REG_STACK = RBX;
+const Reg REG_CONSTANTS = R12;
+const Reg REG_FRAME = R13;
+const Reg REG_MEMBERS = R14;
+const Reg REG_ARGS = R15;
+
+enum Cond {
+	COND_P = 0xA,
+	COND_NP = 0xB,
+	COND_E = 0x4,
+	COND_NE = 0x5,
+	COND_A = 0x7,
+	COND_AE = 0x3,
+	COND_L = 0xC,
+	COND_GE = 0xD,
+	COND_LE = 0xE,
+	COND_G = 0xF,
+};
+
+const int VARIANT_SIZE = 24;
+const int VARIANT_TYPE = 0;
+const int VARIANT_DATA = 8;
+
+struct Mem {
+	Reg base = RAX;
+	int32_t disp = 0;
+
+	Mem offset(int32_t p_offset) const {
+		Mem m = *this;
+		m.disp += p_offset;
+		return m;
+	}
+	Mem type() const { return offset(VARIANT_TYPE); }
+	Mem data(int32_t p_offset = 0) const { return offset(VARIANT_DATA + p_offset); }
+
+	Mem() {}
+	Mem(Reg p_base, int32_t p_disp) :
+			base(p_base), disp(p_disp) {}
+};
+
+Mem frame_field(size_t p_offset) {
+	return Mem(REG_FRAME, (int32_t)p_offset);
+}
+
+// Only the encodings the templates need. Memory operands are always
+// [base + disp32], opcodes above 0xFF are two byte ones (0x0F xx).
+class Assembler {
+	void _rex(bool p_w, int p_reg, int p_base) {
+		uint8_t rex = 0x40 | (p_w ? 8 : 0) | ((p_reg & 8) ? 4 : 0) | ((p_base & 8) ? 1 : 0);
+		if (rex != 0x40) {
+			emit8(rex);
+		}
+	}
+
+	void _opcode(int p_opcode) {
+		if (p_opcode > 0xFF) {
+			emit8(0x0F);
+		}
+		emit8(p_opcode & 0xFF);
+	}
+
+public:
+	LocalVector<uint8_t> bytes;
+
+	uint32_t size() const { return bytes.size(); }
+
+	void emit8(uint8_t p_byte) { bytes.push_back(p_byte); }
+	void emit32(uint32_t p_value) {
+		for (int i = 0; i < 4; i++) {
+			emit8((p_value >> (i * 8)) & 0xFF);
+		}
+	}
+	void emit64(uint64_t p_value) {
+		emit32(p_value & 0xFFFFFFFF);
+		emit32(p_value >> 32);
+	}
+	void patch32(uint32_t p_pos, uint32_t p_value) {
+		for (int i = 0; i < 4; i++) {
+			bytes[p_pos + i] = (p_value >> (i * 8)) & 0xFF;
+		}
+	}
+
+	// <prefix> <rex> <opcode> reg, [mem]
+	void op_mem(int p_prefix, bool p_w, int p_opcode, int p_reg, const Mem &p_mem) {
+		if (p_prefix) {
+			emit8(p_prefix);
+		}
+		_rex(p_w, p_reg, p_mem.base);
+		_opcode(p_opcode);
+		emit8(0x80 | ((p_reg & 7) << 3) | (p_mem.base & 7));
+		if ((p_mem.base & 7) == RSP) {
+			emit8(0x24); // SIB for RSP and R12 bases.
+		}
+		emit32(p_mem.disp);
+	}
+
+	// <prefix> <rex> <opcode> reg, rm
+	void op_reg(int p_prefix, bool p_w, int p_opcode, int p_reg, int p_rm) {
+		if (p_prefix) {
+			emit8(p_prefix);
+		}
+		_rex(p_w, p_reg, p_rm);
+		_opcode(p_opcode);
+		emit8(0xC0 | ((p_reg & 7) << 3) | (p_rm & 7));
+	}
+
+	void mov_load(Reg p_dst, const Mem &p_src) { op_mem(0, true, 0x8B, p_dst, p_src); }
+	void mov_store(const Mem &p_dst, Reg p_src) { op_mem(0, true, 0x89, p_src, p_dst); }
+	void mov_store8(const Mem &p_dst, Reg p_src) { op_mem(0, false, 0x88, p_src, p_dst); }
+	void mov_store_imm32(const Mem &p_dst, int32_t p_value, bool p_w) {
+		op_mem(0, p_w, 0xC7, 0, p_dst);
+		emit32(p_value);
+	}
+	void movzx_load8(Reg p_dst, const Mem &p_src) { op_mem(0, false, 0x1B6, p_dst, p_src); }
+	void movsxd_load(Reg p_dst, const Mem &p_src) { op_mem(0, true, 0x63, p_dst, p_src); }
+	void lea(Reg p_dst, const Mem &p_src) { op_mem(0, true, 0x8D, p_dst, p_src); }
+	void mov_reg(Reg p_dst, Reg p_src) { op_reg(0, true, 0x89, p_src, p_dst); }
+	void mov_imm64(Reg p_dst, uint64_t p_value) {
+		_rex(true, 0, p_dst);
+		emit8(0xB8 | (p_dst & 7));
+		emit64(p_value);
+	}
+	void mov_imm32(Reg p_dst, uint32_t p_value) {
+		_rex(false, 0, p_dst);
+		emit8(0xB8 | (p_dst & 7));
+		emit32(p_value);
+	}
+	void cmp_imm32(const Mem &p_mem, int32_t p_value) {
+		op_mem(0, false, 0x81, 7, p_mem);
+		emit32(p_value);
+	}
+	void cmp_imm8_byte(const Mem &p_mem, int8_t p_value) {
+		op_mem(0, false, 0x80, 7, p_mem);
+		emit8(p_value);
+	}
+	void setcc(Cond p_cond, Reg p_dst) { op_reg(0, false, 0x190 | p_cond, 0, p_dst); }
+	void test8(Reg p_a, Reg p_b) { op_reg(0, false, 0x84, p_b, p_a); }
+	void and8(Reg p_dst, Reg p_src) { op_reg(0, false, 0x20, p_src, p_dst); }
+	void or8(Reg p_dst, Reg p_src) { op_reg(0, false, 0x08, p_src, p_dst); }
+	void xor_imm8(Reg p_dst, int8_t p_value) {
+		op_reg(0, false, 0x83, 6, p_dst);
+		emit8(p_value);
+	}
+	void add_imm8(Reg p_dst, int8_t p_value) {
+		op_reg(0, true, 0x83, 0, p_dst);
+		emit8(p_value);
+	}
+	void neg(Reg p_dst) { op_reg(0, true, 0xF7, 3, p_dst); }
+	void push(Reg p_reg) {
+		_rex(false, 0, p_reg);
+		emit8(0x50 | (p_reg & 7));
+	}
+	void pop(Reg p_reg) {
+		_rex(false, 0, p_reg);
+		emit8(0x58 | (p_reg & 7));
+	}
+	void sub_rsp(int8_t p_value) {
+		op_reg(0, true, 0x83, 5, RSP);
+		emit8(p_value);
+	}
+	void add_rsp(int8_t p_value) {
+		op_reg(0, true, 0x83, 0, RSP);
+		emit8(p_value);
+	}
+	void call(Reg p_reg) { op_reg(0, false, 0xFF, 2, p_reg); }
+	void jmp_reg(Reg p_reg) { op_reg(0, false, 0xFF, 4, p_reg); }
+	void ret() { emit8(0xC3); }
+
+	// Returns where the rel32 to patch is.
+	uint32_t jmp() {
+		emit8(0xE9);
+		emit32(0);
+		return size() - 4;
+	}
+	uint32_t jcc(Cond p_cond) {
+		emit8(0x0F);
+		emit8(0x80 | p_cond);
+		emit32(0);
+		return size() - 4;
+	}
+	void bind(uint32_t p_rel32_pos, uint32_t p_target) {
+		patch32(p_rel32_pos, p_target - (p_rel32_pos + 4));
+	}
+	void bind_here(uint32_t p_rel32_pos) { bind(p_rel32_pos, size()); }
+
+	// SSE, on xmm registers.
+	void sse_mem(int p_prefix, int p_opcode, int p_xmm, const Mem &p_mem) { op_mem(p_prefix, false, p_opcode, p_xmm, p_mem); }
+	void sse_reg(int p_prefix, int p_opcode, int p_xmm, int p_xmm_src) { op_reg(p_prefix, false, p_opcode, p_xmm, p_xmm_src); }
+};
+
+// SSE opcodes, with 0xF2 for doubles and 0xF3 for floats.
+const int SSE_LOAD = 0x110;
+const int SSE_STORE = 0x111;
+const int SSE_ADD = 0x158;
+const int SSE_MUL = 0x159;
+const int SSE_SUB = 0x15C;
+const int SSE_DIV = 0x15E;
+const int SSE_CVTSD2SS = 0x15A;
+const int SSE_UCOMISD = 0x12E; // With 0x66.
+const int PREFIX_DOUBLE = 0xF2;
+const int PREFIX_FLOAT = 0xF3;
+
+enum InlineOp {
+	INLINE_INT_ADD,
+	INLINE_INT_SUB,
+	INLINE_INT_MUL,
+	INLINE_INT_BIT_AND,
+	INLINE_INT_BIT_OR,
+	INLINE_INT_BIT_XOR,
+	INLINE_INT_NEGATE,
+	INLINE_INT_EQUAL,
+	INLINE_INT_NOT_EQUAL,
+	INLINE_INT_LESS,
+	INLINE_INT_LESS_EQUAL,
+	INLINE_INT_GREATER,
+	INLINE_INT_GREATER_EQUAL,
+	INLINE_FLOAT_ADD,
+	INLINE_FLOAT_SUB,
+	INLINE_FLOAT_MUL,
+	INLINE_FLOAT_DIV,
+	INLINE_FLOAT_NEGATE,
+	INLINE_FLOAT_EQUAL,
+	INLINE_FLOAT_NOT_EQUAL,
+	INLINE_FLOAT_LESS,
+	INLINE_FLOAT_LESS_EQUAL,
+	INLINE_FLOAT_GREATER,
+	INLINE_FLOAT_GREATER_EQUAL,
+	INLINE_BOOL_NOT,
+	INLINE_VECTOR_ADD,
+	INLINE_VECTOR_SUB,
+	INLINE_VECTOR_MUL,
+	INLINE_VECTOR_MUL_FLOAT,
+	INLINE_VECTOR_DIV_FLOAT,
+};
+
+struct InlineOperator {
+	Variant::ValidatedOperatorEvaluator evaluator = nullptr;
+	InlineOp op = INLINE_INT_ADD;
+	int components = 0; // For vectors.
+};
+
+LocalVector<InlineOperator> inline_operators;
+
+void add_inline_operator(Variant::Operator p_op, Variant::Type p_a, Variant::Type p_b, InlineOp p_inline, int p_components = 0) {
+	InlineOperator op;
+	op.evaluator = Variant::get_validated_operator_evaluator(p_op, p_a, p_b);
+	op.op = p_inline;
+	op.components = p_components;
+	if (op.evaluator) {
+		inline_operators.push_back(op);
+	}
+}
+
+const InlineOperator *find_inline_operator(Variant::ValidatedOperatorEvaluator p_evaluator) {
+	for (uint32_t i = 0; i < inline_operators.size(); i++) {
+		if (inline_operators[i].evaluator == p_evaluator) {
+			return &inline_operators[i];
+		}
+	}
+	return nullptr;
+}
+
+// Helpers called from native code for what isn't worth inlining.
+
+void jit_assign(Variant *p_dst, const Variant *p_src) {
+	*p_dst = *p_src;
+}
+
+void jit_assign_bool(Variant *p_dst, bool p_value) {
+	*p_dst = p_value;
+}
+
+bool jit_booleanize(const Variant *p_value) {
+	return p_value->booleanize();
+}
+
+bool jit_iterate_begin_int(Variant *p_counter, const Variant *p_container, Variant *p_iterator) {
+	int64_t size = *VariantInternal::get_int(p_container);
+	VariantInternal::initialize(p_counter, Variant::INT);
+	*VariantInternal::get_int(p_counter) = 0;
+	if (size <= 0) {
+		return false;
+	}
+	VariantInternal::initialize(p_iterator, Variant::INT);
+	*VariantInternal::get_int(p_iterator) = 0;
+	return true;
+}
+
+bool jit_iterate_begin_array(Variant *p_counter, Variant *p_container, Variant *p_iterator) {
+	Array *array = VariantInternal::get_array(p_container);
+	VariantInternal::initialize(p_counter, Variant::INT);
+	*VariantInternal::get_int(p_counter) = 0;
+	if (array->is_empty()) {
+		return false;
+	}
+	*p_iterator = array->get(0);
+	return true;
+}
+
+bool jit_iterate_array(Variant *p_counter, const Variant *p_container, Variant *p_iterator) {
+	const Array *array = VariantInternal::get_array(p_container);
+	int64_t *idx = VariantInternal::get_int(p_counter);
+	(*idx)++;
+	if (*idx >= array->size()) {
+		return false;
+	}
+	*p_iterator = array->get(*idx);
+	return true;
+}
+
+void jit_construct_array(Variant *p_dst, const Variant **p_args, int p_argc) {
+	Array array;
+	array.resize(p_argc);
+	for (int i = 0; i < p_argc; i++) {
+		array[i] = *p_args[i];
+	}
+	*p_dst = Variant(); // Clear potential previous typed array.
+	*p_dst = array;
+}
+
+void jit_construct_typed_array(Variant *p_dst, const Variant **p_args, int p_argc, const Variant *p_script_type, int p_builtin_type, const StringName *p_native_type) {
+	Array array;
+	array.set_typed(p_builtin_type, *p_native_type, *p_script_type);
+	array.resize(p_argc);
+	for (int i = 0; i < p_argc; i++) {
+		array[i] = *p_args[i];
+	}
+	*p_dst = Variant(); // Clear potential previous typed array.
+	*p_dst = array;
+}
+
+template <class T>
+void jit_type_adjust(Variant *p_arg) {
+	VariantTypeAdjust<T>::adjust(p_arg);
+}
+
+typedef void (*TypeAdjustFunc)(Variant *);
+
+const TypeAdjustFunc type_adjust_funcs[] = {
+	jit_type_adjust<bool>,
+	jit_type_adjust<int64_t>,
+	jit_type_adjust<double>,
+	jit_type_adjust<String>,
+	jit_type_adjust<Vector2>,
+	jit_type_adjust<Vector2i>,
+	jit_type_adjust<Rect2>,
+	jit_type_adjust<Rect2i>,
+	jit_type_adjust<Vector3>,
+	jit_type_adjust<Vector3i>,
+	jit_type_adjust<Transform2D>,
+	jit_type_adjust<Plane>,
+	jit_type_adjust<Quaternion>,
+	jit_type_adjust<AABB>,
+	jit_type_adjust<Basis>,
+	jit_type_adjust<Transform3D>,
+	jit_type_adjust<Color>,
+	jit_type_adjust<StringName>,
+	jit_type_adjust<NodePath>,
+	jit_type_adjust<RID>,
+	jit_type_adjust<Object *>,
+	jit_type_adjust<Callable>,
+	jit_type_adjust<Signal>,
+	jit_type_adjust<Dictionary>,
+	jit_type_adjust<Array>,
+	jit_type_adjust<PackedByteArray>,
+	jit_type_adjust<PackedInt32Array>,
+	jit_type_adjust<PackedInt64Array>,
+	jit_type_adjust<PackedFloat32Array>,
+	jit_type_adjust<PackedFloat64Array>,
+	jit_type_adjust<PackedStringArray>,
+	jit_type_adjust<PackedVector2Array>,
+	jit_type_adjust<PackedVector3Array>,
+	jit_type_adjust<PackedColorArray>,
+};
+
+static_assert(sizeof(type_adjust_funcs) / sizeof(type_adjust_funcs[0]) == GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_COLOR_ARRAY - GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL + 1, "Type adjust functions don't match the opcodes.");
+
+// What the compiler reads from the function.
+struct FunctionData {
+	const int *code = nullptr;
+	int code_size = 0;
+	int stack_size = 0;
+	int constant_count = 0;
+	const int *default_args = nullptr;
+	int default_arg_count = 0;
+	const Variant::ValidatedOperatorEvaluator *operator_funcs = nullptr;
+	int operator_funcs_count = 0;
+	const Variant::ValidatedSetter *setters = nullptr;
+	int setters_count = 0;
+	const Variant::ValidatedGetter *getters = nullptr;
+	int getters_count = 0;
+	const Variant::ValidatedIndexedSetter *indexed_setters = nullptr;
+	int indexed_setters_count = 0;
+	const Variant::ValidatedIndexedGetter *indexed_getters = nullptr;
+	int indexed_getters_count = 0;
+	const Variant::ValidatedBuiltInMethod *builtin_methods = nullptr;
+	int builtin_methods_count = 0;
+	const Variant::ValidatedConstructor *constructors = nullptr;
+	int constructors_count = 0;
+	const Variant::ValidatedUtilityFunction *utilities = nullptr;
+	int utilities_count = 0;
+	const StringName *global_names = nullptr;
+	int global_names_count = 0;
+};
+
+class Compiler {
+	struct Fixup {
+		uint32_t pos = 0;
+		int target = 0;
+	};
+
+	const FunctionData &f;
+	GDScriptJIT::Code *code;
+	Assembler a;
+
+	LocalVector<int> offsets; // Native offset of each instruction, or -1.
+	LocalVector<Fixup> jumps; // To instructions.
+	LocalVector<Fixup> exits; // Back to the VM.
+	LocalVector<Mem> args;
+	uint32_t epilogue = 0;
+
+	bool _arg(int p_address, Mem &r_mem) {
+		const int index = p_address & GDScriptFunction::ADDR_MASK;
+		switch ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+			case GDScriptFunction::ADDR_TYPE_STACK: {
+				if (index >= f.stack_size) {
+					return false;
+				}
+				r_mem = Mem(REG_STACK, index * VARIANT_SIZE);
+			} break;
+			case GDScriptFunction::ADDR_TYPE_CONSTANT: {
+				if (index >= f.constant_count) {
+					return false;
+				}
+				r_mem = Mem(REG_CONSTANTS, index * VARIANT_SIZE);
+			} break;
+			case GDScriptFunction::ADDR_TYPE_MEMBER: {
+				code->uses_members = true;
+				r_mem = Mem(REG_MEMBERS, index * VARIANT_SIZE);
+			} break;
+			default:
+				return false;
+		}
+		return true;
+	}
+
+	void _call(const void *p_function) {
+		a.mov_imm64(RAX, (uint64_t)p_function);
+		a.call(RAX);
+	}
+
+	void _jump(int p_target) {
+		jumps.push_back({ a.jmp(), p_target });
+	}
+
+	void _jump_if(Cond p_cond, int p_target) {
+		jumps.push_back({ a.jcc(p_cond), p_target });
+	}
+
+	void _exit_if(Cond p_cond, int p_ip) {
+		exits.push_back({ a.jcc(p_cond), p_ip });
+	}
+
+	void _return() {
+		a.mov_imm32(RAX, (uint32_t)GDScriptJIT::EXIT_RETURN);
+		a.bind(a.jmp(), epilogue);
+	}
+
+	// Stores pointers to the first p_count arguments for validated calls.
+	void _store_call_args(int p_count) {
+		for (int i = 0; i < p_count; i++) {
+			a.lea(RAX, args[i]);
+			a.mov_store(Mem(REG_ARGS, i * sizeof(Variant *)), RAX);
+		}
+	}
+
+	void _assign(const Mem &p_dst, const Mem &p_src) {
+		// Values without references to other data can be copied directly.
+		a.cmp_imm32(p_dst.type(), Variant::FLOAT);
+		const uint32_t dst_slow = a.jcc(COND_A);
+		a.cmp_imm32(p_src.type(), Variant::FLOAT);
+		const uint32_t src_slow = a.jcc(COND_A);
+		for (int i = 0; i < VARIANT_SIZE; i += 8) {
+			a.mov_load(RAX, p_src.offset(i));
+			a.mov_store(p_dst.offset(i), RAX);
+		}
+		const uint32_t done = a.jmp();
+		a.bind_here(dst_slow);
+		a.bind_here(src_slow);
+		a.lea(RDI, p_dst);
+		a.lea(RSI, p_src);
+		_call((const void *)jit_assign);
+		a.bind_here(done);
+	}
+
+	void _assign_bool(const Mem &p_dst, bool p_value) {
+		a.cmp_imm32(p_dst.type(), Variant::FLOAT);
+		const uint32_t slow = a.jcc(COND_A);
+		a.mov_store_imm32(p_dst.type(), Variant::BOOL, false);
+		a.mov_store_imm32(p_dst.data(), p_value ? 1 : 0, true);
+		const uint32_t done = a.jmp();
+		a.bind_here(slow);
+		a.lea(RDI, p_dst);
+		a.mov_imm32(RSI, p_value ? 1 : 0);
+		_call((const void *)jit_assign_bool);
+		a.bind_here(done);
+	}
+
+	// Leaves the condition in AL.
+	void _booleanize(const Mem &p_value) {
+		a.cmp_imm32(p_value.type(), Variant::BOOL);
+		const uint32_t slow = a.jcc(COND_NE);
+		a.movzx_load8(RAX, p_value.data());
+		const uint32_t done = a.jmp();
+		a.bind_here(slow);
+		a.lea(RDI, p_value);
+		_call((const void *)jit_booleanize);
+		a.bind_here(done);
+		a.test8(RAX, RAX);
+	}
+
+	void _operator(const InlineOperator &p_op, const Mem &p_a, const Mem &p_b, const Mem &p_dst) {
+		switch (p_op.op) {
+			case INLINE_INT_ADD:
+			case INLINE_INT_SUB:
+			case INLINE_INT_MUL:
+			case INLINE_INT_BIT_AND:
+			case INLINE_INT_BIT_OR:
+			case INLINE_INT_BIT_XOR: {
+				static const int opcodes[] = { 0x03, 0x2B, 0x1AF, 0x23, 0x0B, 0x33 };
+				a.mov_load(RAX, p_a.data());
+				a.op_mem(0, true, opcodes[p_op.op - INLINE_INT_ADD], RAX, p_b.data());
+				a.mov_store(p_dst.data(), RAX);
+			} break;
+			case INLINE_INT_NEGATE: {
+				a.mov_load(RAX, p_a.data());
+				a.neg(RAX);
+				a.mov_store(p_dst.data(), RAX);
+			} break;
+			case INLINE_INT_EQUAL:
+			case INLINE_INT_NOT_EQUAL:
+			case INLINE_INT_LESS:
+			case INLINE_INT_LESS_EQUAL:
+			case INLINE_INT_GREATER:
+			case INLINE_INT_GREATER_EQUAL: {
+				static const Cond conds[] = { COND_E, COND_NE, COND_L, COND_LE, COND_G, COND_GE };
+				a.mov_load(RAX, p_a.data());
+				a.op_mem(0, true, 0x3B, RAX, p_b.data());
+				a.setcc(conds[p_op.op - INLINE_INT_EQUAL], RAX);
+				a.mov_store8(p_dst.data(), RAX);
+			} break;
+			case INLINE_FLOAT_ADD:
+			case INLINE_FLOAT_SUB:
+			case INLINE_FLOAT_MUL:
+			case INLINE_FLOAT_DIV: {
+				static const int opcodes[] = { SSE_ADD, SSE_SUB, SSE_MUL, SSE_DIV };
+				a.sse_mem(PREFIX_DOUBLE, SSE_LOAD, 0, p_a.data());
+				a.sse_mem(PREFIX_DOUBLE, opcodes[p_op.op - INLINE_FLOAT_ADD], 0, p_b.data());
+				a.sse_mem(PREFIX_DOUBLE, SSE_STORE, 0, p_dst.data());
+			} break;
+			case INLINE_FLOAT_NEGATE: {
+				// Flips the sign bit, like -x does for zeros and NaNs too.
+				a.mov_load(RAX, p_a.data());
+				a.mov_imm64(RCX, 1ULL << 63);
+				a.op_reg(0, true, 0x33, RAX, RCX);
+				a.mov_store(p_dst.data(), RAX);
+			} break;
+			case INLINE_FLOAT_EQUAL:
+			case INLINE_FLOAT_NOT_EQUAL: {
+				// Unordered (NaN) compares are not equal.
+				a.sse_mem(PREFIX_DOUBLE, SSE_LOAD, 0, p_a.data());
+				a.sse_mem(0x66, SSE_UCOMISD, 0, p_b.data());
+				if (p_op.op == INLINE_FLOAT_EQUAL) {
+					a.setcc(COND_E, RAX);
+					a.setcc(COND_NP, RCX);
+					a.and8(RAX, RCX);
+				} else {
+					a.setcc(COND_NE, RAX);
+					a.setcc(COND_P, RCX);
+					a.or8(RAX, RCX);
+				}
+				a.mov_store8(p_dst.data(), RAX);
+			} break;
+			case INLINE_FLOAT_LESS:
+			case INLINE_FLOAT_LESS_EQUAL:
+			case INLINE_FLOAT_GREATER:
+			case INLINE_FLOAT_GREATER_EQUAL: {
+				// Only "above" conditions are false when unordered, so less than
+				// compares the other way around.
+				const bool swap = p_op.op == INLINE_FLOAT_LESS || p_op.op == INLINE_FLOAT_LESS_EQUAL;
+				const bool or_equal = p_op.op == INLINE_FLOAT_LESS_EQUAL || p_op.op == INLINE_FLOAT_GREATER_EQUAL;
+				a.sse_mem(PREFIX_DOUBLE, SSE_LOAD, 0, swap ? p_b.data() : p_a.data());
+				a.sse_mem(0x66, SSE_UCOMISD, 0, swap ? p_a.data() : p_b.data());
+				a.setcc(or_equal ? COND_AE : COND_A, RAX);
+				a.mov_store8(p_dst.data(), RAX);
+			} break;
+			case INLINE_BOOL_NOT: {
+				a.movzx_load8(RAX, p_a.data());
+				a.xor_imm8(RAX, 1);
+				a.mov_store8(p_dst.data(), RAX);
+			} break;
+			case INLINE_VECTOR_ADD:
+			case INLINE_VECTOR_SUB:
+			case INLINE_VECTOR_MUL: {
+				static const int opcodes[] = { SSE_ADD, SSE_SUB, SSE_MUL };
+				// Component by component, so the result can be one of the operands.
+				for (int i = 0; i < p_op.components; i++) {
+					a.sse_mem(PREFIX_FLOAT, SSE_LOAD, 0, p_a.data(i * 4));
+					a.sse_mem(PREFIX_FLOAT, opcodes[p_op.op - INLINE_VECTOR_ADD], 0, p_b.data(i * 4));
+					a.sse_mem(PREFIX_FLOAT, SSE_STORE, 0, p_dst.data(i * 4));
+				}
+			} break;
+			case INLINE_VECTOR_MUL_FLOAT:
+			case INLINE_VECTOR_DIV_FLOAT: {
+				a.sse_mem(PREFIX_DOUBLE, SSE_CVTSD2SS, 1, p_b.data());
+				for (int i = 0; i < p_op.components; i++) {
+					a.sse_mem(PREFIX_FLOAT, SSE_LOAD, 0, p_a.data(i * 4));
+					a.sse_reg(PREFIX_FLOAT, p_op.op == INLINE_VECTOR_MUL_FLOAT ? SSE_MUL : SSE_DIV, 0, 1);
+					a.sse_mem(PREFIX_FLOAT, SSE_STORE, 0, p_dst.data(i * 4));
+				}
+			} break;
+		}
+	}
+
+	// Emits one instruction, returns its size or 0 if it can't be compiled.
+	int _instruction(int p_ip) {
+		const int *c = f.code + p_ip;
+		int opcode = c[0] & GDScriptFunction::INSTR_MASK;
+		if (opcode >= GDScriptFunction::OPCODE_OPERATOR_ADD_INT && opcode <= GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT) {
+			// Typed operators keep their operator function, so they compile like validated ones.
+			opcode = GDScriptFunction::OPCODE_OPERATOR_VALIDATED;
+		}
+		const int arg_count = (c[0] & GDScriptFunction::INSTR_ARGS_MASK) >> GDScriptFunction::INSTR_BITS;
+		const int space = f.code_size - p_ip;
+
+		if (arg_count >= space) {
+			return 0;
+		}
+		args.resize(arg_count);
+		for (int i = 0; i < arg_count; i++) {
+			if (!_arg(c[i + 1], args[i])) {
+				return 0;
+			}
+		}
+
+#define JIT_CHECK_SPACE(m_space) \
+	if ((m_space) > space) {     \
+		return 0;                \
+	}
+#define JIT_CHECK_ARGS(m_count) \
+	if (arg_count < (m_count)) { \
+		return 0;                \
+	}
+#define JIT_CHECK_INDEX(m_index, m_count)     \
+	if ((m_index) < 0 || (m_index) >= (m_count)) { \
+		return 0;                             \
+	}
+
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+				JIT_CHECK_SPACE(5);
+				JIT_CHECK_ARGS(3);
+				JIT_CHECK_INDEX(c[4], f.operator_funcs_count);
+				const Variant::ValidatedOperatorEvaluator evaluator = f.operator_funcs[c[4]];
+				const InlineOperator *op = find_inline_operator(evaluator);
+				if (op) {
+					_operator(*op, args[0], args[1], args[2]);
+				} else {
+					a.lea(RDI, args[0]);
+					a.lea(RSI, args[1]);
+					a.lea(RDX, args[2]);
+					_call((const void *)evaluator);
+				}
+				return 5;
+			}
+			case GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED:
+			case GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED: {
+				JIT_CHECK_SPACE(5);
+				JIT_CHECK_ARGS(3);
+				const bool set = opcode == GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED;
+				JIT_CHECK_INDEX(c[4], set ? f.indexed_setters_count : f.indexed_getters_count);
+				a.lea(RDI, args[0]);
+				a.mov_load(RSI, args[1].data());
+				a.lea(RDX, args[2]);
+				a.lea(RCX, frame_field(offsetof(GDScriptJIT::Frame, flag)));
+				_call(set ? (const void *)f.indexed_setters[c[4]] : (const void *)f.indexed_getters[c[4]]);
+#ifdef DEBUG_ENABLED
+				// The VM reports out of bounds accesses.
+				a.cmp_imm8_byte(frame_field(offsetof(GDScriptJIT::Frame, flag)), 0);
+				_exit_if(COND_NE, p_ip);
+#endif
+				return 5;
+			}
+			case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED:
+			case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED: {
+				JIT_CHECK_SPACE(4);
+				JIT_CHECK_ARGS(2);
+				const bool set = opcode == GDScriptFunction::OPCODE_SET_NAMED_VALIDATED;
+				JIT_CHECK_INDEX(c[3], set ? f.setters_count : f.getters_count);
+				a.lea(RDI, args[0]);
+				a.lea(RSI, args[1]);
+				_call(set ? (const void *)f.setters[c[3]] : (const void *)f.getters[c[3]]);
+				return 4;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN: {
+				JIT_CHECK_SPACE(3);
+				JIT_CHECK_ARGS(2);
+				_assign(args[0], args[1]);
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE: {
+				JIT_CHECK_SPACE(2);
+				JIT_CHECK_ARGS(1);
+				_assign_bool(args[0], opcode == GDScriptFunction::OPCODE_ASSIGN_TRUE);
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+				JIT_CHECK_SPACE(4);
+				JIT_CHECK_ARGS(2);
+				// Conversions are left to the VM.
+				a.cmp_imm32(args[1].type(), c[3]);
+				_exit_if(COND_NE, p_ip);
+				_assign(args[0], args[1]);
+				return 4;
+			}
+			case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED: {
+				JIT_CHECK_SPACE(arg_count + 3);
+				const int argc = c[arg_count + 1];
+				JIT_CHECK_INDEX(argc, arg_count);
+				JIT_CHECK_INDEX(c[arg_count + 2], f.constructors_count);
+				_store_call_args(argc);
+				a.lea(RDI, args[argc]);
+				a.mov_reg(RSI, REG_ARGS);
+				_call((const void *)f.constructors[c[arg_count + 2]]);
+				return arg_count + 3;
+			}
+			case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY: {
+				JIT_CHECK_SPACE(arg_count + 2);
+				const int argc = c[arg_count + 1];
+				JIT_CHECK_INDEX(argc, arg_count);
+				_store_call_args(argc);
+				a.lea(RDI, args[argc]);
+				a.mov_reg(RSI, REG_ARGS);
+				a.mov_imm32(RDX, argc);
+				_call((const void *)jit_construct_array);
+				return arg_count + 2;
+			}
+			case GDScriptFunction::OPCODE_CONSTRUCT_TYPED_ARRAY: {
+				JIT_CHECK_SPACE(arg_count + 4);
+				const int argc = c[arg_count + 1];
+				JIT_CHECK_INDEX(argc + 1, arg_count);
+				JIT_CHECK_INDEX(c[arg_count + 3], f.global_names_count);
+				_store_call_args(argc);
+				a.lea(RDI, args[argc]);
+				a.mov_reg(RSI, REG_ARGS);
+				a.mov_imm32(RDX, argc);
+				a.lea(RCX, args[argc + 1]);
+				a.mov_imm32(R8, c[arg_count + 2]);
+				a.mov_imm64(R9, (uint64_t)&f.global_names[c[arg_count + 3]]);
+				_call((const void *)jit_construct_typed_array);
+				return arg_count + 4;
+			}
+			case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED: {
+				JIT_CHECK_SPACE(arg_count + 3);
+				const int argc = c[arg_count + 1];
+				JIT_CHECK_INDEX(argc + 1, arg_count);
+				JIT_CHECK_INDEX(c[arg_count + 2], f.builtin_methods_count);
+				_store_call_args(argc);
+				a.lea(RDI, args[argc]);
+				a.mov_reg(RSI, REG_ARGS);
+				a.mov_imm32(RDX, argc);
+				a.lea(RCX, args[argc + 1]);
+				_call((const void *)f.builtin_methods[c[arg_count + 2]]);
+				return arg_count + 3;
+			}
+			case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED: {
+				JIT_CHECK_SPACE(arg_count + 3);
+				const int argc = c[arg_count + 1];
+				JIT_CHECK_INDEX(argc, arg_count);
+				JIT_CHECK_INDEX(c[arg_count + 2], f.utilities_count);
+				_store_call_args(argc);
+				a.lea(RDI, args[argc]);
+				a.mov_reg(RSI, REG_ARGS);
+				a.mov_imm32(RDX, argc);
+				_call((const void *)f.utilities[c[arg_count + 2]]);
+				return arg_count + 3;
+			}
+			case GDScriptFunction::OPCODE_JUMP: {
+				JIT_CHECK_SPACE(2);
+				_jump(c[1]);
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+				JIT_CHECK_SPACE(3);
+				JIT_CHECK_ARGS(1);
+				_booleanize(args[0]);
+				_jump_if(opcode == GDScriptFunction::OPCODE_JUMP_IF ? COND_NE : COND_E, c[2]);
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT: {
+				// ip = default_args[defarg], through the label table.
+				a.movsxd_load(RAX, frame_field(offsetof(GDScriptJIT::Frame, defarg)));
+				a.mov_imm64(RCX, (uint64_t)f.default_args);
+				a.emit8(0x48); // movsxd rax, dword [rcx + rax * 4]
+				a.emit8(0x63);
+				a.emit8(0x04);
+				a.emit8(0x81);
+				a.mov_imm64(RCX, (uint64_t)code->labels.ptr());
+				a.emit8(0x48); // mov rax, [rcx + rax * 8]
+				a.emit8(0x8B);
+				a.emit8(0x04);
+				a.emit8(0xC1);
+				a.jmp_reg(RAX);
+				return 1;
+			}
+			case GDScriptFunction::OPCODE_RETURN: {
+				JIT_CHECK_SPACE(2);
+				JIT_CHECK_ARGS(1);
+				a.mov_load(RDI, frame_field(offsetof(GDScriptJIT::Frame, retvalue)));
+				a.lea(RSI, args[0]);
+				_call((const void *)jit_assign);
+				_return();
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN: {
+				JIT_CHECK_SPACE(3);
+				JIT_CHECK_ARGS(1);
+				a.cmp_imm32(args[0].type(), c[2]);
+				_exit_if(COND_NE, p_ip);
+				a.mov_load(RDI, frame_field(offsetof(GDScriptJIT::Frame, retvalue)));
+				a.lea(RSI, args[0]);
+				_call((const void *)jit_assign);
+				_return();
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_RETURN_TYPED_ARRAY:
+			case GDScriptFunction::OPCODE_RETURN_TYPED_NATIVE:
+			case GDScriptFunction::OPCODE_RETURN_TYPED_SCRIPT: {
+				// Returns once, the VM does the checks.
+				const int size = opcode == GDScriptFunction::OPCODE_RETURN_TYPED_ARRAY ? 5 : 3;
+				JIT_CHECK_SPACE(size);
+				exits.push_back({ a.jmp(), p_ip });
+				return size;
+			}
+			case GDScriptFunction::OPCODE_END: {
+				_return();
+				return 1;
+			}
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_ARRAY:
+			case GDScriptFunction::OPCODE_ITERATE_ARRAY: {
+				JIT_CHECK_SPACE(5);
+				JIT_CHECK_ARGS(3);
+				a.lea(RDI, args[0]);
+				a.lea(RSI, args[1]);
+				a.lea(RDX, args[2]);
+				if (opcode == GDScriptFunction::OPCODE_ITERATE_BEGIN_INT) {
+					_call((const void *)jit_iterate_begin_int);
+				} else if (opcode == GDScriptFunction::OPCODE_ITERATE_BEGIN_ARRAY) {
+					_call((const void *)jit_iterate_begin_array);
+				} else {
+					_call((const void *)jit_iterate_array);
+				}
+				a.test8(RAX, RAX);
+				_jump_if(COND_E, c[4]);
+				return 5;
+			}
+			case GDScriptFunction::OPCODE_ITERATE_INT: {
+				JIT_CHECK_SPACE(5);
+				JIT_CHECK_ARGS(3);
+				a.mov_load(RAX, args[0].data());
+				a.add_imm8(RAX, 1);
+				a.mov_store(args[0].data(), RAX);
+				a.op_mem(0, true, 0x3B, RAX, args[1].data());
+				_jump_if(COND_GE, c[4]);
+				a.mov_store(args[2].data(), RAX);
+				return 5;
+			}
+			case GDScriptFunction::OPCODE_ASSERT: {
+				JIT_CHECK_SPACE(3);
+				JIT_CHECK_ARGS(1);
+#ifdef DEBUG_ENABLED
+				// The VM reports failed assertions.
+				_booleanize(args[0]);
+				_exit_if(COND_E, p_ip);
+#endif
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_BREAKPOINT: {
+				return 1;
+			}
+			case GDScriptFunction::OPCODE_LINE: {
+				JIT_CHECK_SPACE(2);
+				a.mov_store_imm32(frame_field(offsetof(GDScriptJIT::Frame, line)), c[1], false);
+				return 2;
+			}
+			default: {
+				if (opcode >= GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL && opcode <= GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_COLOR_ARRAY) {
+					JIT_CHECK_SPACE(2);
+					JIT_CHECK_ARGS(1);
+					a.lea(RDI, args[0]);
+					_call((const void *)type_adjust_funcs[opcode - GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL]);
+					return 2;
+				}
+			} break;
+		}
+
+#undef JIT_CHECK_SPACE
+#undef JIT_CHECK_ARGS
+#undef JIT_CHECK_INDEX
+
+		// Calls to objects, untyped operations, await...
+		return 0;
+	}
+
+	void _prologue() {
+		static const Reg saved[] = { RBX, RBP, R12, R13, R14, R15 };
+		for (const Reg reg : saved) {
+			a.push(reg);
+		}
+		a.sub_rsp(8); // Keep the stack aligned for calls.
+
+		a.mov_reg(REG_FRAME, RDI);
+		a.mov_load(REG_STACK, frame_field(offsetof(GDScriptJIT::Frame, stack)));
+		a.mov_load(REG_CONSTANTS, frame_field(offsetof(GDScriptJIT::Frame, constants)));
+		a.mov_load(REG_MEMBERS, frame_field(offsetof(GDScriptJIT::Frame, members)));
+		a.mov_load(REG_ARGS, frame_field(offsetof(GDScriptJIT::Frame, args)));
+
+		// Jump to the instruction to start from.
+		a.op_reg(0, false, 0x89, RSI, RAX); // mov eax, esi
+		a.mov_imm64(RCX, (uint64_t)code->labels.ptr());
+		a.emit8(0x48); // mov rax, [rcx + rax * 8]
+		a.emit8(0x8B);
+		a.emit8(0x04);
+		a.emit8(0xC1);
+		a.jmp_reg(RAX);
+
+		epilogue = a.size();
+		a.add_rsp(8);
+		for (int i = 5; i >= 0; i--) {
+			a.pop(saved[i]);
+		}
+		a.ret();
+	}
+
+public:
+	bool compile() {
+		code->labels.resize(f.code_size + 1);
+		offsets.resize(f.code_size + 1);
+		for (int i = 0; i <= f.code_size; i++) {
+			code->labels[i] = nullptr;
+			offsets[i] = -1;
+		}
+
+		_prologue();
+
+		int ip = 0;
+		while (ip < f.code_size) {
+			offsets[ip] = a.size();
+			const int size = _instruction(ip);
+			if (size == 0) {
+				return false;
+			}
+			ip += size;
+		}
+		if (ip != f.code_size) {
+			return false;
+		}
+		offsets[f.code_size] = a.size();
+		exits.push_back({ a.jmp(), f.code_size });
+
+		for (uint32_t i = 0; i < jumps.size(); i++) {
+			if (jumps[i].target < 0 || jumps[i].target > f.code_size || offsets[jumps[i].target] == -1) {
+				return false;
+			}
+			a.bind(jumps[i].pos, offsets[jumps[i].target]);
+		}
+		for (int i = 0; i < f.default_arg_count; i++) {
+			if (f.default_args[i] < 0 || f.default_args[i] > f.code_size || offsets[f.default_args[i]] == -1) {
+				return false;
+			}
+		}
+
+		for (uint32_t i = 0; i < exits.size(); i++) {
+			a.bind_here(exits[i].pos);
+			a.mov_imm32(RAX, exits[i].target);
+			a.bind(a.jmp(), epilogue);
+		}
+
+		// Written first, and only made executable once complete.
+		const size_t page_size = sysconf(_SC_PAGESIZE);
+		code->memory_size = (a.size() + page_size - 1) / page_size * page_size;
+		void *memory = mmap(nullptr, code->memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (memory == MAP_FAILED) {
+			code->memory_size = 0;
+			return false;
+		}
+		code->memory = (uint8_t *)memory;
+		memcpy(code->memory, a.bytes.ptr(), a.size());
+		if (mprotect(code->memory, code->memory_size, PROT_READ | PROT_EXEC) != 0) {
+			return false;
+		}
+
+		code->entry = (GDScriptJIT::EntryFunc)code->memory;
+		for (int i = 0; i <= f.code_size; i++) {
+			if (offsets[i] != -1) {
+				code->labels[i] = code->memory + offsets[i];
+			}
+		}
+		return true;
+	}
+
+	Compiler(const FunctionData &p_function, GDScriptJIT::Code *p_code) :
+			f(p_function), code(p_code) {}
+};
+
+} // namespace
+
+void GDScriptJIT::initialize() {
+	// Generated code relies on how Variant is laid out.
+	Variant v = int64_t(0);
+	supported = sizeof(Variant) == VARIANT_SIZE &&
+			*(const int *)((const uint8_t *)&v + VARIANT_TYPE) == Variant::INT &&
+			(const uint8_t *)VariantInternal::get_int(&v) - (const uint8_t *)&v == VARIANT_DATA &&
+			(const uint8_t *)VariantInternal::get_bool(&v) - (const uint8_t *)&v == VARIANT_DATA &&
+			(const uint8_t *)VariantInternal::get_float(&v) - (const uint8_t *)&v == VARIANT_DATA;
+	if (!supported) {
+		enabled = false;
+		return;
+	}
+
+	inline_operators.clear();
+	add_inline_operator(Variant::OP_ADD, Variant::INT, Variant::INT, INLINE_INT_ADD);
+	add_inline_operator(Variant::OP_SUBTRACT, Variant::INT, Variant::INT, INLINE_INT_SUB);
+	add_inline_operator(Variant::OP_MULTIPLY, Variant::INT, Variant::INT, INLINE_INT_MUL);
+	add_inline_operator(Variant::OP_BIT_AND, Variant::INT, Variant::INT, INLINE_INT_BIT_AND);
+	add_inline_operator(Variant::OP_BIT_OR, Variant::INT, Variant::INT, INLINE_INT_BIT_OR);
+	add_inline_operator(Variant::OP_BIT_XOR, Variant::INT, Variant::INT, INLINE_INT_BIT_XOR);
+	add_inline_operator(Variant::OP_NEGATE, Variant::INT, Variant::NIL, INLINE_INT_NEGATE);
+	add_inline_operator(Variant::OP_EQUAL, Variant::INT, Variant::INT, INLINE_INT_EQUAL);
+	add_inline_operator(Variant::OP_NOT_EQUAL, Variant::INT, Variant::INT, INLINE_INT_NOT_EQUAL);
+	add_inline_operator(Variant::OP_LESS, Variant::INT, Variant::INT, INLINE_INT_LESS);
+	add_inline_operator(Variant::OP_LESS_EQUAL, Variant::INT, Variant::INT, INLINE_INT_LESS_EQUAL);
+	add_inline_operator(Variant::OP_GREATER, Variant::INT, Variant::INT, INLINE_INT_GREATER);
+	add_inline_operator(Variant::OP_GREATER_EQUAL, Variant::INT, Variant::INT, INLINE_INT_GREATER_EQUAL);
+	add_inline_operator(Variant::OP_ADD, Variant::FLOAT, Variant::FLOAT, INLINE_FLOAT_ADD);
+	add_inline_operator(Variant::OP_SUBTRACT, Variant::FLOAT, Variant::FLOAT, INLINE_FLOAT_SUB);
+	add_inline_operator(Variant::OP_MULTIPLY, Variant::FLOAT, Variant::FLOAT, INLINE_FLOAT_MUL);
+	add_inline_operator(Variant::OP_DIVIDE, Variant::FLOAT, Variant::FLOAT, INLINE_FLOAT_DIV);
+	add_inline_operator(Variant::OP_NEGATE, Variant::FLOAT, Variant::NIL, INLINE_FLOAT_NEGATE);
+	add_inline_operator(Variant::OP_EQUAL, Variant::FLOAT, Variant::FLOAT, INLINE_FLOAT_EQUAL);
+	add_inline_operator(Variant::OP_NOT_EQUAL, Variant::FLOAT, Variant::FLOAT, INLINE_FLOAT_NOT_EQUAL);
+	add_inline_operator(Variant::OP_LESS, Variant::FLOAT, Variant::FLOAT, INLINE_FLOAT_LESS);
+	add_inline_operator(Variant::OP_LESS_EQUAL, Variant::FLOAT, Variant::FLOAT, INLINE_FLOAT_LESS_EQUAL);
+	add_inline_operator(Variant::OP_GREATER, Variant::FLOAT, Variant::FLOAT, INLINE_FLOAT_GREATER);
+	add_inline_operator(Variant::OP_GREATER_EQUAL, Variant::FLOAT, Variant::FLOAT, INLINE_FLOAT_GREATER_EQUAL);
+	add_inline_operator(Variant::OP_NOT, Variant::BOOL, Variant::NIL, INLINE_BOOL_NOT);
+
+#ifndef REAL_T_IS_DOUBLE
+	Variant v3 = Vector3();
+	Variant v2 = Vector2();
+	if ((const uint8_t *)VariantInternal::get_vector3(&v3) - (const uint8_t *)&v3 == VARIANT_DATA &&
+			(const uint8_t *)VariantInternal::get_vector2(&v2) - (const uint8_t *)&v2 == VARIANT_DATA) {
+		const Variant::Type types[] = { Variant::VECTOR2, Variant::VECTOR3 };
+		for (int i = 0; i < 2; i++) {
+			const int components = i + 2;
+			add_inline_operator(Variant::OP_ADD, types[i], types[i], INLINE_VECTOR_ADD, components);
+			add_inline_operator(Variant::OP_SUBTRACT, types[i], types[i], INLINE_VECTOR_SUB, components);
+			add_inline_operator(Variant::OP_MULTIPLY, types[i], types[i], INLINE_VECTOR_MUL, components);
+			add_inline_operator(Variant::OP_MULTIPLY, types[i], Variant::FLOAT, INLINE_VECTOR_MUL_FLOAT, components);
+			add_inline_operator(Variant::OP_DIVIDE, types[i], Variant::FLOAT, INLINE_VECTOR_DIV_FLOAT, components);
+		}
+	}
+#endif
+}
+
+GDScriptJIT::Code *GDScriptJIT::heat_up(GDScriptFunction *p_function) {
+	if (p_function->jit_done.is_set()) {
+		return p_function->jit_code;
+	}
+	if (p_function->jit_heat.increment() < hot_threshold) {
+		return nullptr;
+	}
+
+	MutexLock lock(mutex);
+	if (p_function->jit_done.is_set()) {
+		return p_function->jit_code;
+	}
+
+	FunctionData data;
+	data.code = p_function->_code_ptr;
+	data.code_size = p_function->_code_size;
+	data.stack_size = p_function->_stack_size;
+	data.constant_count = p_function->_constant_count;
+	data.default_args = p_function->_default_arg_ptr;
+	data.default_arg_count = p_function->_default_arg_count;
+	data.operator_funcs = p_function->_operator_funcs_ptr;
+	data.operator_funcs_count = p_function->_operator_funcs_count;
+	data.setters = p_function->_setters_ptr;
+	data.setters_count = p_function->_setters_count;
+	data.getters = p_function->_getters_ptr;
+	data.getters_count = p_function->_getters_count;
+	data.indexed_setters = p_function->_indexed_setters_ptr;
+	data.indexed_setters_count = p_function->_indexed_setters_count;
+	data.indexed_getters = p_function->_indexed_getters_ptr;
+	data.indexed_getters_count = p_function->_indexed_getters_count;
+	data.builtin_methods = p_function->_builtin_methods_ptr;
+	data.builtin_methods_count = p_function->_builtin_methods_count;
+	data.constructors = p_function->_constructors_ptr;
+	data.constructors_count = p_function->_constructors_count;
+	data.utilities = p_function->_utilities_ptr;
+	data.utilities_count = p_function->_utilities_count;
+	data.global_names = p_function->_global_names_ptr;
+	data.global_names_count = p_function->_global_names_count;
+
+	Code *code = memnew(Code);
+	Compiler compiler(data, code);
+	if (!compiler.compile()) {
+		free_code(code);
+		code = nullptr;
+	}
+
+	p_function->jit_code = code;
+	p_function->jit_done.set();
+	return code;
+}
+
+bool GDScriptJIT::is_compiled(const GDScriptFunction *p_function) {
+	return p_function->jit_done.is_set() && p_function->jit_code;
+}
+
+void GDScriptJIT::free_code(Code *p_code) {
+	if (p_code->memory) {
+		munmap(p_code->memory, p_code->memory_size);
+	}
+	memdelete(p_code);
+}
+
+#else
+
+void GDScriptJIT::initialize() {
+}
+
+GDScriptJIT::Code *GDScriptJIT::heat_up(GDScriptFunction *p_function) {
+	return nullptr;
+}
+
+bool GDScriptJIT::is_compiled(const GDScriptFunction *p_function) {
+	return false;
+}
+
+void GDScriptJIT::free_code(Code *p_code) {
+}
+
+#endif // GDSCRIPT_JIT_ENABLED
@@ -0,0 +1,110 @@
+/*************************************************************************/
+/*  gdscript_jit.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_JIT_H
+#define GDSCRIPT_JIT_H
+
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "core/typedefs.h"
+
+// The native tier needs the computed goto VM to enter and leave native code,
+// and only knows how to emit x86-64 code for the System V ABI.
+#if defined(__x86_64__) && defined(UNIX_ENABLED) && defined(__GNUC__)
+#define GDSCRIPT_JIT_ENABLED
+#endif
+
+class GDScriptFunction;
+class Variant;
+
+// Compiles hot functions whose instructions are all typed (validated) ones to
+// native code, one template per instruction. Native code runs on the same
+// stack as the VM, so it can be entered at any instruction and leave to the
+// VM at any instruction: whenever something happens that it doesn't handle
+// (a type check fails, an error must be reported), it returns the address the
+// VM must continue from. The VM enters it when the function is called, and at
+// loop back-edges so long loops are compiled while they run.
+class GDScriptJIT {
+public:
+	enum {
+		EXIT_RETURN = -1, // The function returned, retvalue is set.
+	};
+
+	// What native code needs from the VM. Offsets are used by generated code.
+	struct Frame {
+		Variant *stack = nullptr;
+		Variant *constants = nullptr;
+		Variant *members = nullptr;
+		Variant **args = nullptr; // Scratch space for call arguments.
+		Variant *retvalue = nullptr;
+		int defarg = 0;
+		int line = 0;
+		bool flag = false; // Out of bounds result of indexed accesses.
+	};
+
+	typedef int (*EntryFunc)(Frame *p_frame, int p_ip);
+
+	struct Code {
+		EntryFunc entry = nullptr;
+		uint8_t *memory = nullptr;
+		size_t memory_size = 0;
+		// Native address of each instruction, indexed by address in the bytecode.
+		LocalVector<const uint8_t *> labels;
+		bool uses_members = false;
+	};
+
+private:
+	static bool supported;
+	static bool enabled;
+	static uint32_t hot_threshold;
+	static Mutex mutex;
+
+public:
+	static void initialize();
+
+	static bool is_supported() { return supported; }
+	static void set_enabled(bool p_enabled) { enabled = p_enabled && supported; }
+	static bool is_enabled() { return enabled; }
+	// Calls and loop iterations before a function is compiled.
+	static void set_hot_threshold(uint32_t p_threshold) { hot_threshold = p_threshold; }
+	static uint32_t get_hot_threshold() { return hot_threshold; }
+
+	// Counts a call or loop iteration, and compiles the function once it's hot.
+	// Returns the native code once there is some.
+	static Code *heat_up(GDScriptFunction *p_function);
+	static bool is_compiled(const GDScriptFunction *p_function);
+	static void free_code(Code *p_code);
+
+	_FORCE_INLINE_ static int run(Code *p_code, Frame *p_frame, int p_ip) {
+		return p_code->entry(p_frame, p_ip);
+	}
+};
+
+#endif // GDSCRIPT_JIT_H
@@ -33,6 +33,7 @@
 #include "core/core_string_names.h"
 #include "core/os/os.h"
 #include "gdscript.h"
+#include "gdscript_inline_cache.h"
 #include "gdscript_lambda_callable.h"
 
 Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_instance, Variant *p_stack, String &r_error) const {
@@ -229,6 +230,41 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {        \
 		&&OPCODE_OPERATOR,                           \
 		&&OPCODE_OPERATOR_VALIDATED,                 \
+		&&OPCODE_OPERATOR_ADD_INT,                   \
+		&&OPCODE_OPERATOR_SUBTRACT_INT,              \
+		&&OPCODE_OPERATOR_MULTIPLY_INT,              \
+		&&OPCODE_OPERATOR_BIT_AND_INT,               \
+		&&OPCODE_OPERATOR_BIT_OR_INT,                \
+		&&OPCODE_OPERATOR_BIT_XOR_INT,               \
+		&&OPCODE_OPERATOR_NEGATE_INT,                \
+		&&OPCODE_OPERATOR_EQUAL_INT,                 \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT,             \
+		&&OPCODE_OPERATOR_LESS_INT,                  \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT,            \
+		&&OPCODE_OPERATOR_GREATER_INT,               \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_INT,         \
+		&&OPCODE_OPERATOR_ADD_FLOAT,                 \
+		&&OPCODE_OPERATOR_SUBTRACT_FLOAT,            \
+		&&OPCODE_OPERATOR_MULTIPLY_FLOAT,            \
+		&&OPCODE_OPERATOR_DIVIDE_FLOAT,              \
+		&&OPCODE_OPERATOR_NEGATE_FLOAT,              \
+		&&OPCODE_OPERATOR_EQUAL_FLOAT,               \
+		&&OPCODE_OPERATOR_NOT_EQUAL_FLOAT,           \
+		&&OPCODE_OPERATOR_LESS_FLOAT,                \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT,          \
+		&&OPCODE_OPERATOR_GREATER_FLOAT,             \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,       \
+		&&OPCODE_OPERATOR_NOT_BOOL,                  \
+		&&OPCODE_OPERATOR_ADD_VECTOR2,               \
+		&&OPCODE_OPERATOR_SUBTRACT_VECTOR2,          \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR2,          \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT,    \
+		&&OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT,      \
+		&&OPCODE_OPERATOR_ADD_VECTOR3,               \
+		&&OPCODE_OPERATOR_SUBTRACT_VECTOR3,          \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR3,          \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT,    \
+		&&OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT,      \
 		&&OPCODE_EXTENDS_TEST,                       \
 		&&OPCODE_IS_BUILTIN,                         \
 		&&OPCODE_SET_KEYED,                          \
@@ -628,6 +664,43 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	bool awaited = false;
 #endif
 
+#ifdef GDSCRIPT_JIT_ENABLED
+	// Native code doesn't step through the debugger or the profiler, and
+	// leaves functions resumed after await to the VM.
+	bool jit_allowed = !p_state && GDScriptJIT::is_enabled();
+#ifdef DEBUG_ENABLED
+	jit_allowed = jit_allowed && !EngineDebugger::is_active() && !GDScriptLanguage::get_singleton()->profiling;
+#endif
+
+	GDScriptJIT::Frame jit_frame;
+	jit_frame.stack = stack;
+	jit_frame.constants = _constants_ptr;
+	jit_frame.args = instruction_args;
+	jit_frame.retvalue = &retvalue;
+	jit_frame.defarg = defarg;
+
+	// Runs native code from m_ip, if the function is hot enough to have some.
+#define JIT_ENTER(m_ip)                                                                      \
+	{                                                                                        \
+		GDScriptJIT::Code *native = GDScriptJIT::heat_up(this);                              \
+		if (native && (!native->uses_members || p_instance)) {                               \
+			jit_frame.members = native->uses_members ? p_instance->members.ptrw() : nullptr; \
+			jit_frame.line = line;                                                           \
+			const int exit_ip = GDScriptJIT::run(native, &jit_frame, m_ip);                  \
+			line = jit_frame.line;                                                           \
+			if (exit_ip == GDScriptJIT::EXIT_RETURN) {                                       \
+				OPCODE_OUT;                                                                  \
+			}                                                                                \
+			ip = exit_ip;                                                                    \
+			DISPATCH_OPCODE;                                                                 \
+		}                                                                                    \
+	}
+
+	if (jit_allowed) {
+		JIT_ENTER(ip);
+	}
+#endif
+
 #ifdef DEBUG_ENABLED
 	OPCODE_WHILE(ip < _code_size) {
 		int last_opcode = _code_ptr[ip] & INSTR_MASK;
@@ -694,6 +767,63 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#define OPCODE_OPERATOR_BINARY(m_name, m_result, m_left, m_op, m_right)                                                             \
+	OPCODE(OPCODE_OPERATOR_##m_name) {                                                                                              \
+		CHECK_SPACE(5);                                                                                                             \
+		GET_INSTRUCTION_ARG(a, 0);                                                                                                  \
+		GET_INSTRUCTION_ARG(b, 1);                                                                                                  \
+		GET_INSTRUCTION_ARG(dst, 2);                                                                                                \
+		*VariantInternal::OP_GET_##m_result(dst) = *VariantInternal::OP_GET_##m_left(a) m_op *VariantInternal::OP_GET_##m_right(b); \
+		ip += 5;                                                                                                                    \
+	}                                                                                                                               \
+	DISPATCH_OPCODE
+
+#define OPCODE_OPERATOR_UNARY(m_name, m_result, m_op, m_operand)                                 \
+	OPCODE(OPCODE_OPERATOR_##m_name) {                                                           \
+		CHECK_SPACE(5);                                                                          \
+		GET_INSTRUCTION_ARG(a, 0);                                                               \
+		GET_INSTRUCTION_ARG(dst, 2);                                                             \
+		*VariantInternal::OP_GET_##m_result(dst) = m_op *VariantInternal::OP_GET_##m_operand(a); \
+		ip += 5;                                                                                 \
+	}                                                                                            \
+	DISPATCH_OPCODE
+
+			OPCODE_OPERATOR_BINARY(ADD_INT, INT, INT, +, INT);
+			OPCODE_OPERATOR_BINARY(SUBTRACT_INT, INT, INT, -, INT);
+			OPCODE_OPERATOR_BINARY(MULTIPLY_INT, INT, INT, *, INT);
+			OPCODE_OPERATOR_BINARY(BIT_AND_INT, INT, INT, &, INT);
+			OPCODE_OPERATOR_BINARY(BIT_OR_INT, INT, INT, |, INT);
+			OPCODE_OPERATOR_BINARY(BIT_XOR_INT, INT, INT, ^, INT);
+			OPCODE_OPERATOR_UNARY(NEGATE_INT, INT, -, INT);
+			OPCODE_OPERATOR_BINARY(EQUAL_INT, BOOL, INT, ==, INT);
+			OPCODE_OPERATOR_BINARY(NOT_EQUAL_INT, BOOL, INT, !=, INT);
+			OPCODE_OPERATOR_BINARY(LESS_INT, BOOL, INT, <, INT);
+			OPCODE_OPERATOR_BINARY(LESS_EQUAL_INT, BOOL, INT, <=, INT);
+			OPCODE_OPERATOR_BINARY(GREATER_INT, BOOL, INT, >, INT);
+			OPCODE_OPERATOR_BINARY(GREATER_EQUAL_INT, BOOL, INT, >=, INT);
+			OPCODE_OPERATOR_BINARY(ADD_FLOAT, FLOAT, FLOAT, +, FLOAT);
+			OPCODE_OPERATOR_BINARY(SUBTRACT_FLOAT, FLOAT, FLOAT, -, FLOAT);
+			OPCODE_OPERATOR_BINARY(MULTIPLY_FLOAT, FLOAT, FLOAT, *, FLOAT);
+			OPCODE_OPERATOR_BINARY(DIVIDE_FLOAT, FLOAT, FLOAT, /, FLOAT);
+			OPCODE_OPERATOR_UNARY(NEGATE_FLOAT, FLOAT, -, FLOAT);
+			OPCODE_OPERATOR_BINARY(EQUAL_FLOAT, BOOL, FLOAT, ==, FLOAT);
+			OPCODE_OPERATOR_BINARY(NOT_EQUAL_FLOAT, BOOL, FLOAT, !=, FLOAT);
+			OPCODE_OPERATOR_BINARY(LESS_FLOAT, BOOL, FLOAT, <, FLOAT);
+			OPCODE_OPERATOR_BINARY(LESS_EQUAL_FLOAT, BOOL, FLOAT, <=, FLOAT);
+			OPCODE_OPERATOR_BINARY(GREATER_FLOAT, BOOL, FLOAT, >, FLOAT);
+			OPCODE_OPERATOR_BINARY(GREATER_EQUAL_FLOAT, BOOL, FLOAT, >=, FLOAT);
+			OPCODE_OPERATOR_UNARY(NOT_BOOL, BOOL, !, BOOL);
+			OPCODE_OPERATOR_BINARY(ADD_VECTOR2, VECTOR2, VECTOR2, +, VECTOR2);
+			OPCODE_OPERATOR_BINARY(SUBTRACT_VECTOR2, VECTOR2, VECTOR2, -, VECTOR2);
+			OPCODE_OPERATOR_BINARY(MULTIPLY_VECTOR2, VECTOR2, VECTOR2, *, VECTOR2);
+			OPCODE_OPERATOR_BINARY(MULTIPLY_VECTOR2_FLOAT, VECTOR2, VECTOR2, *, FLOAT);
+			OPCODE_OPERATOR_BINARY(DIVIDE_VECTOR2_FLOAT, VECTOR2, VECTOR2, /, FLOAT);
+			OPCODE_OPERATOR_BINARY(ADD_VECTOR3, VECTOR3, VECTOR3, +, VECTOR3);
+			OPCODE_OPERATOR_BINARY(SUBTRACT_VECTOR3, VECTOR3, VECTOR3, -, VECTOR3);
+			OPCODE_OPERATOR_BINARY(MULTIPLY_VECTOR3, VECTOR3, VECTOR3, *, VECTOR3);
+			OPCODE_OPERATOR_BINARY(MULTIPLY_VECTOR3_FLOAT, VECTOR3, VECTOR3, *, FLOAT);
+			OPCODE_OPERATOR_BINARY(DIVIDE_VECTOR3_FLOAT, VECTOR3, VECTOR3, /, FLOAT);
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 				CHECK_SPACE(4);
 
@@ -972,7 +1102,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 
 				GET_INSTRUCTION_ARG(dst, 0);
 				GET_INSTRUCTION_ARG(value, 1);
@@ -982,8 +1112,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_cache_count);
+
 				bool valid;
-				dst->set_named(*index, *value, valid);
+				if (!_inline_caches_ptr[cache_idx].set_named(dst, *index, *value, valid)) {
+					dst->set_named(*index, *value, valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -992,7 +1127,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1012,7 +1147,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_INSTRUCTION_ARG(src, 0);
 				GET_INSTRUCTION_ARG(dst, 1);
@@ -1022,22 +1157,23 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+				int cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_cache_count);
 
-#else
-				*dst = src->get_named(*index, valid);
-#endif
+				// Not assigned to dst right away, src and dst may be the same stack position.
+				Variant ret;
+				bool valid = _inline_caches_ptr[cache_idx].get_named(src, *index, ret);
+				if (!valid) {
+					ret = src->get_named(*index, valid);
+				}
 #ifdef DEBUG_ENABLED
 				if (!valid) {
 					err_text = "Invalid get index '" + index->operator String() + "' (on base: '" + _get_var_type(src) + "').";
 					OPCODE_BREAK;
 				}
-				*dst = ret;
 #endif
-				ip += 4;
+				*dst = ret;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1492,7 +1628,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_CALL_ASYNC)
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 				bool call_ret = (_code_ptr[ip] & INSTR_MASK) != OPCODE_CALL;
 #ifdef DEBUG_ENABLED
 				bool call_async = (_code_ptr[ip] & INSTR_MASK) == OPCODE_CALL_ASYNC;
@@ -1507,6 +1643,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+				int cache_idx = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_cache_count);
+				GDScriptInlineCache *cache = &_inline_caches_ptr[cache_idx];
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
@@ -1521,7 +1661,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					if (!cache->call(base, *methodname, (const Variant **)argptrs, argc, *ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					}
 #ifdef DEBUG_ENABLED
 					if (!call_async && ret->get_type() == Variant::OBJECT) {
 						// Check if getting a function state without await.
@@ -1540,7 +1682,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 				} else {
 					Variant ret;
-					base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					if (!cache->call(base, *methodname, (const Variant **)argptrs, argc, ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					}
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1585,7 +1729,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
@@ -2316,6 +2460,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				int to = _code_ptr[ip + 1];
 
 				GD_ERR_BREAK(to < 0 || to > _code_size);
+#ifdef GDSCRIPT_JIT_ENABLED
+				if (to < ip && jit_allowed) {
+					// Loop iterations count too, so long loops get compiled.
+					JIT_ENTER(to);
+				}
+#endif
 				ip = to;
 			}
 			DISPATCH_OPCODE;
@@ -36,6 +36,7 @@
 #include "core/io/resource_loader.h"
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_byte_code_cache.h"
 #include "gdscript_cache.h"
 #include "gdscript_tokenizer.h"
 #include "gdscript_utility_functions.h"
@@ -69,7 +70,13 @@ Ref<GDScriptEditorTranslationParserPlugin> gdscript_translation_parser_plugin;
 class EditorExportGDScript : public EditorExportPlugin {
 	GDCLASS(EditorExportGDScript, EditorExportPlugin);
 
+	bool debug = false;
+
 public:
+	virtual void _export_begin(const HashSet<String> &p_features, bool p_debug, const String &p_path, int p_flags) override {
+		debug = p_debug;
+	}
+
 	virtual void _export_file(const String &p_path, const String &p_type, const HashSet<String> &p_features) override {
 		int script_mode = EditorExportPreset::MODE_SCRIPT_COMPILED;
 		String script_key;
@@ -85,8 +92,30 @@ public:
 			return;
 		}
 
-		// TODO: Re-add compiled GDScript on export.
-		return;
+#ifdef DEBUG_ENABLED
+		// The editor only compiles debug bytecode. Release builds compile
+		// scripts when they start, and may save their own bytecode cache.
+		if (!debug) {
+			return;
+		}
+#endif
+
+		// Only a cache inside the project can be exported. The source is still
+		// exported: the cache is checked against it, and used when it's outdated.
+		const String cache_path = GDScriptByteCodeCache::get_cache_path(p_path);
+		if (!cache_path.begins_with("res://")) {
+			return;
+		}
+
+		Error err = OK;
+		Ref<GDScript> script = GDScriptCache::get_full_script(p_path, err);
+		if (err != OK || script.is_null()) {
+			return;
+		}
+		Vector<uint8_t> byte_code = script->get_as_byte_code();
+		if (!byte_code.is_empty()) {
+			add_file(cache_path, byte_code, false);
+		}
 	}
 };
 
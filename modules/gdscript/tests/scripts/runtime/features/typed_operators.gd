@@ -0,0 +1,34 @@
+func test():
+	var a := 7
+	var b := -3
+	print(a + b, " ", a - b, " ", a * b, " ", -a)
+	print(a & b, " ", a | b, " ", a ^ b)
+	print(a == b, a != b, a < b, a <= b, a > b, a >= b)
+
+	var x := 2.5
+	var y := 0.5
+	print(x + y, " ", x - y, " ", x * y, " ", x / y, " ", -x)
+	print(x == y, x != y, x < y, x <= y, x > y, x >= y)
+	var nan := NAN
+	print(nan == nan, nan != nan, nan < x, nan >= x)
+
+	var t := true
+	print(not t, " ", not not t)
+
+	var u := Vector2(1.5, -2)
+	var v := Vector2(0.5, 4)
+	print(u + v, " ", u - v, " ", u * v, " ", u * y, " ", u / y)
+
+	var p := Vector3(1, 2, 3)
+	var q := Vector3(-1, 0.5, 2)
+	print(p + q, " ", p - q, " ", p * q, " ", p * x, " ", p / y)
+
+	# Results stored back into typed locals.
+	var total := 0
+	var sum := 0.0
+	var position := Vector3()
+	for i in 10:
+		total += i * 2 - 1
+		sum += i * 0.25
+		position = position + q * 0.5
+	print(total, " ", sum, " ", position)
@@ -0,0 +1,194 @@
+/*************************************************************************/
+/*  test_gdscript_byte_code_cache.h                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_GDSCRIPT_BYTE_CODE_CACHE_H
+#define TEST_GDSCRIPT_BYTE_CODE_CACHE_H
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
+#include "modules/gdscript/gdscript.h"
+#include "modules/gdscript/gdscript_byte_code_cache.h"
+#include "modules/gdscript/gdscript_cache.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+const char *byte_code_test_source = R"(
+extends RefCounted
+
+signal changed(value)
+
+class Inner:
+	var value := 2
+
+	func twice() -> int:
+		return value * 2
+
+var health := 10:
+	set(value):
+		health = clampi(value, 0, 100)
+		changed.emit(health)
+
+static func add(a: int, b: int) -> int:
+	return a + b
+
+func run() -> Array:
+	var inner := Inner.new()
+	var numbers := [3, 1, 2]
+	numbers.sort()
+	var square := func(x: int) -> int: return x * x
+	var counter := RefCounted.new()
+	health = 500
+	return [inner.twice(), add(2, 3), numbers, square.call(4), len("abc"), absi(-3), counter.get_reference_count(), health, Vector2(3, 4).length()]
+)";
+
+TEST_CASE("[Modules][GDScript] Bytecode cache") {
+	const String directory = OS::get_singleton()->get_cache_path().plus_file("gdscript_byte_code_cache_test");
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->make_dir_recursive(directory);
+	const String path = directory.plus_file("byte_code_test.gd");
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string(byte_code_test_source);
+	}
+
+	Error err = OK;
+	Ref<GDScript> compiled = GDScriptCache::get_full_script(path, err);
+	REQUIRE_MESSAGE(err == OK, "The script should compile.");
+	const Vector<uint8_t> byte_code = compiled->get_as_byte_code();
+	REQUIRE_MESSAGE(!byte_code.is_empty(), "The compiled script should be saved.");
+
+	SUBCASE("Loaded bytecode gives the same results") {
+		Ref<GDScript> loaded = memnew(GDScript);
+		loaded->set_script_path(path);
+		CHECK(GDScriptByteCodeCache::load(byte_code, loaded.ptr()) == OK);
+		REQUIRE(loaded->is_valid());
+		CHECK(loaded->has_script_signal("changed"));
+
+		Ref<RefCounted> expected_object = memnew(RefCounted);
+		expected_object->set_script(compiled);
+		Ref<RefCounted> loaded_object = memnew(RefCounted);
+		loaded_object->set_script(loaded);
+
+		const Variant expected = expected_object->call("run");
+		const Variant result = loaded_object->call("run");
+		CHECK_MESSAGE(result == expected, vformat("run() should return the same result, got %s instead of %s.", result, expected));
+	}
+
+	SUBCASE("Invalid bytecode is rejected") {
+		Ref<GDScript> loaded = memnew(GDScript);
+		loaded->set_script_path(path);
+
+		Vector<uint8_t> garbage;
+		garbage.push_back(1);
+		garbage.push_back(2);
+		garbage.push_back(3);
+		CHECK(GDScriptByteCodeCache::load(garbage, loaded.ptr()) == ERR_FILE_UNRECOGNIZED);
+
+		Vector<uint8_t> truncated = byte_code;
+		truncated.resize(byte_code.size() / 2);
+		ERR_PRINT_OFF;
+		CHECK(GDScriptByteCodeCache::load(truncated, loaded.ptr()) != OK);
+		ERR_PRINT_ON;
+		CHECK_FALSE(loaded->is_valid());
+	}
+
+	SUBCASE("Bytecode with operands out of bounds is rejected") {
+		Variant root_value;
+		REQUIRE(decode_variant(root_value, byte_code.ptr() + 8, byte_code.size() - 8) == OK);
+		const Dictionary root = root_value;
+		const Array functions = Dictionary(root["class"])["functions"];
+		Dictionary add;
+		for (int i = 0; i < functions.size(); i++) {
+			if (String(Dictionary(functions[i])["name"]) == "add") {
+				add = functions[i];
+			}
+		}
+		REQUIRE(!add.is_empty());
+
+		// Arguments come after the self, class and nil stack slots.
+		const int stack_size = add["stack_size"];
+		for (const int address : { 3, stack_size }) {
+			PackedInt32Array code;
+			code.push_back(GDScriptFunction::OPCODE_ASSIGN | (2 << GDScriptFunction::INSTR_BITS));
+			code.push_back(address);
+			code.push_back(GDScriptFunction::ADDR_NIL);
+			code.push_back(GDScriptFunction::OPCODE_END);
+			add["code"] = code;
+
+			int len = 0;
+			REQUIRE(encode_variant(root, nullptr, len) == OK);
+			Vector<uint8_t> changed_byte_code;
+			changed_byte_code.resize(8 + len);
+			memcpy(changed_byte_code.ptrw(), byte_code.ptr(), 8);
+			REQUIRE(encode_variant(root, changed_byte_code.ptrw() + 8, len) == OK);
+
+			Ref<GDScript> loaded = memnew(GDScript);
+			loaded->set_script_path(path);
+			if (address < stack_size) {
+				CHECK(GDScriptByteCodeCache::load(changed_byte_code, loaded.ptr()) == OK);
+				CHECK(loaded->is_valid());
+			} else {
+				CHECK(GDScriptByteCodeCache::load(changed_byte_code, loaded.ptr()) == ERR_CANT_RESOLVE);
+				CHECK_FALSE(loaded->is_valid());
+			}
+		}
+	}
+
+	SUBCASE("Bytecode of a changed source is rejected") {
+		// Same length and likely the same modification time as what was compiled.
+		const String changed_source = String(byte_code_test_source).replace("value * 2", "value * 3");
+		REQUIRE(changed_source.length() == String(byte_code_test_source).length());
+		{
+			Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+			REQUIRE(f.is_valid());
+			f->store_string(changed_source);
+		}
+
+		Ref<GDScript> loaded = memnew(GDScript);
+		loaded->set_script_path(path);
+		CHECK(GDScriptByteCodeCache::load(byte_code, loaded.ptr()) == ERR_INVALID_DATA);
+		CHECK_FALSE(loaded->is_valid());
+
+		da->remove(path);
+		CHECK(GDScriptByteCodeCache::load(byte_code, loaded.ptr()) == ERR_INVALID_DATA);
+		CHECK_FALSE(loaded->is_valid());
+	}
+
+	da->remove(path);
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_BYTE_CODE_CACHE_H
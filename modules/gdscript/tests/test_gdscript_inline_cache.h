@@ -0,0 +1,214 @@
+/*************************************************************************/
+/*  test_gdscript_inline_cache.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_GDSCRIPT_INLINE_CACHE_H
+#define TEST_GDSCRIPT_INLINE_CACHE_H
+
+#include "core/io/resource.h"
+#include "modules/gdscript/gdscript.h"
+#include "modules/gdscript/gdscript_inline_cache.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+Ref<GDScript> load_inline_cache_script(const String &p_source) {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(p_source);
+	const Error error = gdscript->reload();
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+	return gdscript;
+}
+
+Ref<RefCounted> instantiate_inline_cache_script(const Ref<GDScript> &p_script) {
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(p_script);
+	return instance;
+}
+
+const char *inline_cache_user_source = R"(
+extends RefCounted
+
+func read_values(objects):
+	var result = []
+	for o in objects:
+		result.append(o.value)
+	return result
+
+func write_values(objects, v):
+	for o in objects:
+		o.value = v
+
+func write_typed(o, v):
+	o.typed = v
+
+func describe_all(objects):
+	var result = []
+	for o in objects:
+		result.append(o.describe())
+	return result
+
+func read_names(objects):
+	var result = []
+	for o in objects:
+		result.append(o.resource_name)
+	return result
+
+func write_names(objects, n):
+	for o in objects:
+		o.resource_name = n
+
+func classes(objects):
+	var result = []
+	for o in objects:
+		result.append(o.get_class())
+	return result
+
+func destroy_all(objects):
+	for o in objects:
+		o.destroy()
+)";
+
+TEST_CASE("[Modules][GDScript] Inline caches of untyped accesses") {
+	Ref<GDScript> user_script = load_inline_cache_script(inline_cache_user_source);
+	Ref<RefCounted> user = instantiate_inline_cache_script(user_script);
+
+	Ref<GDScript> first_script = load_inline_cache_script(R"(
+extends RefCounted
+var value = 1
+func describe():
+	return "first"
+)");
+	Ref<GDScript> second_script = load_inline_cache_script(R"(
+extends RefCounted
+var padding = 0
+var typed: int = 2
+var value = 10:
+	set(v):
+		value = v * 2
+func describe():
+	return "second"
+)");
+	Ref<RefCounted> first = instantiate_inline_cache_script(first_script);
+	Ref<RefCounted> second = instantiate_inline_cache_script(second_script);
+
+	// Each function runs twice, the second time entries are already there.
+	SUBCASE("Members, setters and functions of several scripts") {
+		Dictionary dictionary;
+		dictionary["value"] = 100;
+		const Vector<Variant> objects = varray(first, second, dictionary, first, second);
+
+		for (int i = 0; i < 2; i++) {
+			CHECK(user->call("read_values", objects) == Variant(varray(1, 10, 100, 1, 10)));
+			CHECK(user->call("describe_all", varray(first, second, first, second)) == Variant(varray("first", "second", "first", "second")));
+		}
+
+		user->call("write_values", varray(first, second), 3);
+		CHECK(int(first->get("value")) == 3);
+		CHECK_MESSAGE(int(second->get("value")) == 6, "The setter should be called.");
+		user->call("write_values", varray(first, second), 4);
+		CHECK(int(first->get("value")) == 4);
+		CHECK_MESSAGE(int(second->get("value")) == 8, "The setter should be called.");
+
+		for (int i = 0; i < 2; i++) {
+			user->call("write_typed", second, 7);
+			CHECK(second->get("typed").get_type() == Variant::INT);
+			CHECK(int(second->get("typed")) == 7);
+			user->call("write_typed", second, 2.5);
+			CHECK_MESSAGE(second->get("typed").get_type() == Variant::INT, "Values of another type should still be converted.");
+			CHECK(int(second->get("typed")) == 2);
+		}
+	}
+
+	SUBCASE("Native properties and methods") {
+		Ref<Resource> resource = memnew(Resource);
+		Ref<GDScript> resource_script = load_inline_cache_script("extends Resource\n");
+		Ref<Resource> scripted_resource = memnew(Resource);
+		scripted_resource->set_script(resource_script);
+		const Vector<Variant> objects = varray(resource, scripted_resource);
+
+		for (int i = 0; i < 2; i++) {
+			user->call("write_names", objects, vformat("name %d", i));
+			CHECK(user->call("read_names", objects) == Variant(varray(vformat("name %d", i), vformat("name %d", i))));
+			CHECK(user->call("classes", varray(resource, scripted_resource, first)) == Variant(varray("Resource", "Resource", "RefCounted")));
+		}
+	}
+
+	SUBCASE("More classes than entries") {
+		Array objects;
+		Array expected;
+		for (int i = 0; i < GDScriptInlineCache::ENTRY_COUNT * 2; i++) {
+			Ref<GDScript> script = load_inline_cache_script(vformat("extends RefCounted\nvar value = %d\n", i));
+			objects.push_back(instantiate_inline_cache_script(script));
+			expected.push_back(i);
+		}
+		for (int i = 0; i < 2; i++) {
+			CHECK(user->call("read_values", objects) == Variant(expected));
+		}
+	}
+
+#ifdef DEBUG_ENABLED
+	SUBCASE("Objects can't be freed by their cached functions") {
+		Ref<GDScript> destroyed_script = load_inline_cache_script(R"(
+extends Object
+func destroy():
+	free()
+)");
+		Object *object = memnew(Object);
+		object->set_script(destroyed_script);
+		const ObjectID id = object->get_instance_id();
+
+		// The second call uses the entry of the first one.
+		ERR_PRINT_OFF;
+		user->call("destroy_all", varray(object, object));
+		ERR_PRINT_ON;
+		CHECK_MESSAGE(ObjectDB::get_instance(id) == object, "The object should be locked while its function runs.");
+		memdelete(object);
+	}
+#endif
+
+	SUBCASE("Reloading a script") {
+		const Vector<Variant> objects = varray(first, first);
+		CHECK(user->call("describe_all", objects) == Variant(varray("first", "first")));
+
+		first_script->set_source_code(R"(
+extends RefCounted
+var value = 1
+func describe():
+	return "reloaded"
+)");
+		REQUIRE(first_script->reload(true) == OK);
+		CHECK_MESSAGE(user->call("describe_all", objects) == Variant(varray("reloaded", "reloaded")), "Entries should be stale once the script is reloaded.");
+	}
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_INLINE_CACHE_H
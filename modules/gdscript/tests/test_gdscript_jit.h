@@ -0,0 +1,335 @@
+/*************************************************************************/
+/*  test_gdscript_jit.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_GDSCRIPT_JIT_H
+#define TEST_GDSCRIPT_JIT_H
+
+#include "gdscript_test_runner.h"
+
+#include "core/os/os.h"
+#include "modules/gdscript/gdscript.h"
+#include "modules/gdscript/gdscript_jit.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+// Changes the JIT settings for a scope.
+class JITSettings {
+	bool was_enabled = false;
+	uint32_t old_threshold = 0;
+
+public:
+	JITSettings(bool p_enabled, uint32_t p_threshold = 0) {
+		was_enabled = GDScriptJIT::is_enabled();
+		old_threshold = GDScriptJIT::get_hot_threshold();
+		GDScriptJIT::set_enabled(p_enabled);
+		GDScriptJIT::set_hot_threshold(p_threshold);
+	}
+	~JITSettings() {
+		GDScriptJIT::set_enabled(was_enabled);
+		GDScriptJIT::set_hot_threshold(old_threshold);
+	}
+};
+
+Ref<GDScript> load_jit_script(const String &p_source) {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(p_source);
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+	return gdscript;
+}
+
+bool is_function_compiled(const Ref<GDScript> &p_script, const StringName &p_function) {
+	GDScriptFunction *const *function = p_script->get_member_functions().getptr(p_function);
+	return function && GDScriptJIT::is_compiled(*function);
+}
+
+const char *jit_test_source = R"(
+extends RefCounted
+
+var counter := 0
+
+func sum_ints(n: int) -> int:
+	var total := 0
+	for i in n:
+		total += i * 3 - (i & 7)
+		if total > 100000:
+			total = -total ^ 5
+	return total
+
+func float_loop(n: int) -> float:
+	var x := 0.5
+	var i := 0
+	while i < n:
+		x = x * 1.0001 + 0.25 / (i + 1.0)
+		if x > 10.0 or x < -10.0:
+			x -= 5.0
+		i += 1
+	return x
+
+func compare_floats(a: float, b: float) -> Array:
+	return [a < b, a <= b, a > b, a >= b, a == b, a != b]
+
+func vectors(n: int) -> Vector3:
+	var p := Vector3(1.0, 2.0, 3.0)
+	var v := Vector3(0.5, -0.25, 0.125)
+	for i in n:
+		p = p + v * 0.5 - p / 8.0
+		p.y += 0.01
+	return p
+
+func arrays(n: int) -> int:
+	var a := []
+	for i in n:
+		a.append(i * 2)
+	var total := 0
+	for i in a.size():
+		var x: int = a[i]
+		total += x
+	return total
+
+func converted(values: Array) -> float:
+	var total := 0.0
+	for i in values.size():
+		var x: float = values[i]
+		total += x
+	return total
+
+func defaults(a: int, b: int = 10, c: int = 100) -> int:
+	return a + b + c
+
+func out_of_bounds(a: Array, i: int) -> int:
+	var x: int = a[i]
+	return x + 1
+
+func members(n: int) -> int:
+	for i in n:
+		counter += i
+	return counter
+)";
+
+TEST_CASE("[Modules][GDScript][JIT] Native code gives the same results as the VM") {
+	if (!GDScriptJIT::is_supported()) {
+		MESSAGE("The native tier isn't supported on this platform.");
+		return;
+	}
+
+	Ref<GDScript> gdscript = load_jit_script(jit_test_source);
+	Ref<RefCounted> interpreted = memnew(RefCounted);
+	interpreted->set_script(gdscript);
+	Ref<RefCounted> native = memnew(RefCounted);
+	native->set_script(gdscript);
+
+	// Calls with the VM first, then again once the function is compiled.
+	auto compare = [&](const StringName &p_function, const Vector<Variant> &p_args) {
+		const Variant **argptrs = (const Variant **)alloca(sizeof(Variant *) * p_args.size());
+		for (int i = 0; i < p_args.size(); i++) {
+			argptrs[i] = &p_args[i];
+		}
+		Callable::CallError ce;
+		Variant expected;
+		{
+			JITSettings settings(false);
+			expected = interpreted->callp(p_function, argptrs, p_args.size(), ce);
+		}
+		Variant result;
+		{
+			JITSettings settings(true);
+			result = native->callp(p_function, argptrs, p_args.size(), ce);
+		}
+		CHECK_MESSAGE(ce.error == Callable::CallError::CALL_OK, "The call should succeed.");
+		CHECK_MESSAGE(result == expected, vformat("%s() should return the same result in native code, got %s instead of %s.", p_function, result, expected));
+	};
+
+	SUBCASE("Integers, floats and conditions") {
+		compare("sum_ints", varray(1000));
+		compare("sum_ints", varray(0));
+		compare("float_loop", varray(500));
+		CHECK(is_function_compiled(gdscript, "sum_ints"));
+		CHECK(is_function_compiled(gdscript, "float_loop"));
+
+		compare("compare_floats", varray(1.0, 2.0));
+		compare("compare_floats", varray(2.0, 2.0));
+		compare("compare_floats", varray(3.0, 2.0));
+		compare("compare_floats", varray(NAN, 2.0));
+		CHECK(is_function_compiled(gdscript, "compare_floats"));
+	}
+
+	SUBCASE("Vectors and arrays") {
+		compare("vectors", varray(100));
+		compare("arrays", varray(100));
+		CHECK(is_function_compiled(gdscript, "vectors"));
+		CHECK(is_function_compiled(gdscript, "arrays"));
+	}
+
+	SUBCASE("Falling back to the VM") {
+		// Ints are converted by the VM, and native code continues after.
+		compare("converted", varray(varray(1, 2.5, 3, 4.5)));
+		CHECK(is_function_compiled(gdscript, "converted"));
+
+		compare("defaults", varray(1));
+		compare("defaults", varray(1, 2));
+		compare("defaults", varray(1, 2, 3));
+		CHECK(is_function_compiled(gdscript, "defaults"));
+
+		// Errors are reported by the VM.
+		ERR_PRINT_OFF;
+		compare("out_of_bounds", varray(varray(1, 2), 1));
+		compare("out_of_bounds", varray(varray(1, 2), 5));
+		ERR_PRINT_ON;
+		CHECK(is_function_compiled(gdscript, "out_of_bounds"));
+	}
+
+	SUBCASE("Members") {
+		compare("members", varray(100));
+		CHECK(is_function_compiled(gdscript, "members"));
+	}
+}
+
+TEST_CASE("[Modules][GDScript][JIT] Functions are compiled once hot") {
+	if (!GDScriptJIT::is_supported()) {
+		return;
+	}
+
+	Ref<GDScript> gdscript = load_jit_script(jit_test_source);
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(gdscript);
+
+	JITSettings settings(true, 50);
+	instance->call("defaults", 1);
+	CHECK_FALSE_MESSAGE(is_function_compiled(gdscript, "defaults"), "Functions called once should stay in the VM.");
+	for (int i = 0; i < 50; i++) {
+		instance->call("defaults", i);
+	}
+	CHECK_MESSAGE(is_function_compiled(gdscript, "defaults"), "Functions called often should be compiled.");
+
+	// Called once, but loops enough.
+	CHECK(int(instance->call("sum_ints", 100)) == int(instance->call("sum_ints", 100)));
+	CHECK_MESSAGE(is_function_compiled(gdscript, "sum_ints"), "Functions with long loops should be compiled.");
+}
+
+TEST_SUITE("[Modules][GDScript][JIT]") {
+	TEST_CASE("Script compilation and runtime with native code") {
+		if (!GDScriptJIT::is_supported()) {
+			return;
+		}
+		// Everything that can be compiled is, right away.
+		JITSettings settings(true);
+		GDScriptTestRunner runner("modules/gdscript/tests/scripts", true);
+		int fail_count = runner.run_tests();
+		INFO("Make sure `*.out` files have expected results.");
+		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass with native code.");
+	}
+}
+
+// Compares the VM and native code on typed workloads, run with
+// `godot --test gdscript-jit-benchmark`.
+
+const char *jit_benchmark_source = R"(
+extends RefCounted
+
+func integers(n: int) -> int:
+	var total := 0
+	for i in n:
+		total += (i * 7) & 1023
+		if total > 1000000:
+			total -= 1000000
+	return total
+
+func floats(n: int) -> float:
+	var x := 0.0
+	var v := 1.0
+	for i in n:
+		v = v * 0.999 + 0.5
+		x += v / (v + 1.0)
+	return x
+
+func vectors(n: int) -> Vector3:
+	var position := Vector3()
+	var velocity := Vector3(1.0, 2.0, 3.0)
+	var gravity := Vector3(0.0, -9.8, 0.0)
+	for i in n:
+		velocity = velocity + gravity * 0.016
+		position = position + velocity * 0.016
+		if position.y < 0.0:
+			velocity.y = -velocity.y * 0.5
+			position.y = 0.0
+	return position
+
+func arrays(n: int) -> int:
+	var values := []
+	values.resize(1024)
+	for i in 1024:
+		values[i] = i
+	var total := 0
+	for i in n:
+		var x: int = values[i & 1023]
+		total += x
+		values[i & 1023] = x + 1
+	return total
+)";
+
+void benchmark_gdscript_jit() {
+	if (!GDScriptJIT::is_supported()) {
+		print_line("The native tier isn't supported on this platform.");
+		return;
+	}
+
+	Ref<GDScript> gdscript = load_jit_script(jit_benchmark_source);
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(gdscript);
+
+	const char *functions[] = { "integers", "floats", "vectors", "arrays" };
+	const int iterations = 5000000;
+	OS *os = OS::get_singleton();
+
+	for (const char *function : functions) {
+		uint64_t usec[2];
+		Variant results[2];
+		for (int native = 0; native < 2; native++) {
+			JITSettings settings(native);
+			const uint64_t t = os->get_ticks_usec();
+			results[native] = instance->call(function, iterations);
+			usec[native] = os->get_ticks_usec() - t;
+		}
+		print_line(vformat("%-10s VM %7.1f ms  native %7.1f ms  (%.1fx)", function, usec[0] / 1000.0, usec[1] / 1000.0, double(usec[0]) / MAX(usec[1], uint64_t(1))) +
+				String(is_function_compiled(gdscript, function) ? "" : "  not compiled") +
+				String(results[0] == results[1] ? "" : "  results differ!"));
+	}
+}
+
+REGISTER_TEST_COMMAND("gdscript-jit-benchmark", &benchmark_gdscript_jit);
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_JIT_H
@@ -0,0 +1,156 @@
+/*************************************************************************/
+/*  test_gdscript_operators.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_GDSCRIPT_OPERATORS_H
+#define TEST_GDSCRIPT_OPERATORS_H
+
+#include "core/os/os.h"
+#include "modules/gdscript/gdscript.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+// Operators on typed locals use their own instructions, untyped ones go
+// through Variant. Both must agree.
+struct OperatorCase {
+	const char *name;
+	const char *left_type;
+	const char *left;
+	const char *op;
+	const char *right_type; // nullptr for unary operators.
+	const char *right;
+};
+
+const OperatorCase operator_cases[] = {
+	{ "int + int", "int", "7", "+", "int", "-3" },
+	{ "int - int", "int", "7", "-", "int", "-3" },
+	{ "int * int", "int", "7", "*", "int", "-3" },
+	{ "int & int", "int", "7", "&", "int", "-3" },
+	{ "int | int", "int", "7", "|", "int", "-3" },
+	{ "int ^ int", "int", "7", "^", "int", "-3" },
+	{ "-int", "int", "7", "-", nullptr, nullptr },
+	{ "int == int", "int", "7", "==", "int", "-3" },
+	{ "int != int", "int", "7", "!=", "int", "-3" },
+	{ "int < int", "int", "7", "<", "int", "-3" },
+	{ "int <= int", "int", "7", "<=", "int", "-3" },
+	{ "int > int", "int", "7", ">", "int", "-3" },
+	{ "int >= int", "int", "7", ">=", "int", "-3" },
+	{ "float + float", "float", "2.5", "+", "float", "0.5" },
+	{ "float - float", "float", "2.5", "-", "float", "0.5" },
+	{ "float * float", "float", "2.5", "*", "float", "0.5" },
+	{ "float / float", "float", "2.5", "/", "float", "0.5" },
+	{ "-float", "float", "2.5", "-", nullptr, nullptr },
+	{ "float == float", "float", "2.5", "==", "float", "0.5" },
+	{ "float != float", "float", "2.5", "!=", "float", "0.5" },
+	{ "float < float", "float", "2.5", "<", "float", "0.5" },
+	{ "float <= float", "float", "2.5", "<=", "float", "0.5" },
+	{ "float > float", "float", "2.5", ">", "float", "0.5" },
+	{ "float >= float", "float", "2.5", ">=", "float", "0.5" },
+	{ "not bool", "bool", "true", "not ", nullptr, nullptr },
+	{ "Vector2 + Vector2", "Vector2", "Vector2(1.5, -2)", "+", "Vector2", "Vector2(0.5, 4)" },
+	{ "Vector2 - Vector2", "Vector2", "Vector2(1.5, -2)", "-", "Vector2", "Vector2(0.5, 4)" },
+	{ "Vector2 * Vector2", "Vector2", "Vector2(1.5, -2)", "*", "Vector2", "Vector2(0.5, 4)" },
+	{ "Vector2 * float", "Vector2", "Vector2(1.5, -2)", "*", "float", "0.5" },
+	{ "Vector2 / float", "Vector2", "Vector2(1.5, -2)", "/", "float", "0.5" },
+	{ "Vector3 + Vector3", "Vector3", "Vector3(1, 2, 3)", "+", "Vector3", "Vector3(-1, 0.5, 2)" },
+	{ "Vector3 - Vector3", "Vector3", "Vector3(1, 2, 3)", "-", "Vector3", "Vector3(-1, 0.5, 2)" },
+	{ "Vector3 * Vector3", "Vector3", "Vector3(1, 2, 3)", "*", "Vector3", "Vector3(-1, 0.5, 2)" },
+	{ "Vector3 * float", "Vector3", "Vector3(1, 2, 3)", "*", "float", "0.5" },
+	{ "Vector3 / float", "Vector3", "Vector3(1, 2, 3)", "/", "float", "0.5" },
+};
+
+const int operator_case_count = sizeof(operator_cases) / sizeof(operator_cases[0]);
+
+// One typed and one untyped function per operator, which apply it n times.
+Ref<GDScript> load_operator_script() {
+	String source = "extends RefCounted\n";
+	for (int i = 0; i < operator_case_count; i++) {
+		const OperatorCase &c = operator_cases[i];
+		const String expression = c.right_type ? vformat("a %s b", c.op) : vformat("%sa", c.op);
+		for (int typed = 0; typed < 2; typed++) {
+			source += vformat("\nfunc %s_%d(n: int):\n", typed ? "typed" : "untyped", i);
+			source += typed ? vformat("\tvar a: %s = %s\n", c.left_type, c.left) : vformat("\tvar a = %s\n", c.left);
+			if (c.right_type) {
+				source += typed ? vformat("\tvar b: %s = %s\n", c.right_type, c.right) : vformat("\tvar b = %s\n", c.right);
+			}
+			source += vformat("\tvar r = %s\n\tfor i in n:\n\t\tr = %s\n\treturn r\n", expression, expression);
+		}
+	}
+
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(source);
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+	return gdscript;
+}
+
+TEST_CASE("[Modules][GDScript] Operators on typed values give the same results as on Variants") {
+	Ref<GDScript> gdscript = load_operator_script();
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(gdscript);
+
+	for (int i = 0; i < operator_case_count; i++) {
+		const Variant typed = instance->call(vformat("typed_%d", i), 1);
+		const Variant untyped = instance->call(vformat("untyped_%d", i), 1);
+		CHECK_MESSAGE(typed.get_type() == untyped.get_type(), vformat("%s should have the same result type.", operator_cases[i].name));
+		CHECK_MESSAGE(typed == untyped, vformat("%s should give %s, got %s.", operator_cases[i].name, untyped, typed));
+	}
+}
+
+// Compares each operator on typed and untyped locals, run with
+// `godot --test gdscript-operator-benchmark`.
+void benchmark_gdscript_operators() {
+	Ref<GDScript> gdscript = load_operator_script();
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(gdscript);
+
+	const int iterations = 2000000;
+	OS *os = OS::get_singleton();
+
+	// The loop itself is included, so this is the time per iteration.
+	for (int i = 0; i < operator_case_count; i++) {
+		double nsec[2];
+		for (int typed = 0; typed < 2; typed++) {
+			const uint64_t t = os->get_ticks_usec();
+			instance->call(vformat("%s_%d", typed ? "typed" : "untyped", i), iterations);
+			nsec[typed] = (os->get_ticks_usec() - t) * 1000.0 / iterations;
+		}
+		print_line(vformat("%-18s untyped %5.1f ns  typed %5.1f ns  (%.2fx)", operator_cases[i].name, nsec[0], nsec[1], nsec[0] / MAX(nsec[1], 0.001)));
+	}
+}
+
+REGISTER_TEST_COMMAND("gdscript-operator-benchmark", &benchmark_gdscript_operators);
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_OPERATORS_H
@@ -0,0 +1,107 @@
+/*************************************************************************/
+/*  test_gdscript_precompile.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_GDSCRIPT_PRECOMPILE_H
+#define TEST_GDSCRIPT_PRECOMPILE_H
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/resource.h"
+#include "core/os/os.h"
+#include "modules/gdscript/gdscript.h"
+#include "modules/gdscript/gdscript_cache.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+TEST_CASE("[Modules][GDScript] Precompiling scripts in parallel") {
+	const String directory = OS::get_singleton()->get_cache_path().plus_file("gdscript_precompile_test");
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->make_dir_recursive(directory);
+
+	const String base_path = directory.plus_file("precompile_base.gd");
+	const String derived_path = directory.plus_file("precompile_derived.gd");
+	const String user_path = directory.plus_file("precompile_user.gd");
+	const String broken_path = directory.plus_file("precompile_broken.gd");
+
+	HashMap<String, String> sources;
+	sources[base_path] = "extends RefCounted\n\nfunc value() -> int:\n\treturn 1\n";
+	sources[derived_path] = vformat("extends \"%s\"\n\nfunc value() -> int:\n\treturn super() + 1\n", base_path);
+	sources[user_path] = vformat("extends RefCounted\n\nconst Derived = preload(\"%s\")\n\nfunc value() -> int:\n\treturn Derived.new().value() * 10\n", derived_path);
+	sources[broken_path] = "extends RefCounted\n\nfunc value(\n";
+	for (const KeyValue<String, String> &E : sources) {
+		Ref<FileAccess> f = FileAccess::open(E.key, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string(E.value);
+	}
+
+	Vector<String> paths;
+	paths.push_back(user_path);
+	paths.push_back(derived_path);
+	paths.push_back(base_path);
+	paths.push_back(broken_path);
+
+	ERR_PRINT_OFF;
+	const Vector<GDScriptCache::CompileTime> times = GDScriptCache::precompile_scripts(paths);
+	ERR_PRINT_ON;
+
+	REQUIRE_MESSAGE(times.size() == 4, "Every script should be compiled once.");
+	for (const GDScriptCache::CompileTime &time : times) {
+		if (time.path == broken_path) {
+			CHECK_MESSAGE(time.error != OK, "The broken script should fail to compile.");
+		} else {
+			CHECK_MESSAGE(time.error == OK, vformat("'%s' should compile.", time.path));
+		}
+	}
+
+	// The cache keeps them until startup is over, then nothing else uses them.
+	CHECK(ResourceCache::has(user_path));
+	CHECK(ResourceCache::has(base_path));
+	GDScriptCache::finish_startup();
+	CHECK_FALSE(ResourceCache::has(user_path));
+	CHECK_FALSE(ResourceCache::has(base_path));
+
+	Error err = OK;
+	Ref<GDScript> user = GDScriptCache::get_full_script(user_path, err);
+	REQUIRE(err == OK);
+	CHECK(user->is_valid());
+	Ref<RefCounted> object = memnew(RefCounted);
+	object->set_script(user);
+	CHECK(int(object->call("value")) == 20);
+
+	for (const KeyValue<String, String> &E : sources) {
+		da->remove(E.key);
+	}
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_PRECOMPILE_H
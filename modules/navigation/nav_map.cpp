@@ -683,10 +683,7 @@ void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
 void NavMap::step(real_t p_deltatime) {
 	deltatime = p_deltatime;
 	if (controlled_agents.size() > 0) {
-		if (step_work_pool.get_thread_count() == 0) {
-			step_work_pool.init();
-		}
-		step_work_pool.do_work(
+		WorkerThreadPool::get_singleton()->do_work(
 				controlled_agents.size(),
 				this,
 				&NavMap::compute_single_step,
@@ -736,5 +733,4 @@ NavMap::NavMap() {
 }
 
 NavMap::~NavMap() {
-	step_work_pool.finish();
 }
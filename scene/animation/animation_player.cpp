@@ -660,7 +660,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double
 					}
 
 				} else if (p_is_current && p_delta != 0) {
-					List<int> indices;
+					Animation::KeyIndices indices;
 					a->value_track_get_key_indices(i, p_time, p_delta, &indices, p_pingponged);
 
 					for (int &F : indices) {
@@ -718,7 +718,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double
 					break;
 				}
 
-				List<int> indices;
+				Animation::KeyIndices indices;
 
 				a->method_track_get_key_indices(i, p_time, p_delta, &indices, p_pingponged);
 
@@ -808,7 +808,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double
 
 				} else {
 					//find stuff to play
-					List<int> to_play;
+					Animation::KeyIndices to_play;
 					a->track_get_key_indices_in_range(i, p_time, p_delta, &to_play, p_pingponged);
 					if (to_play.size()) {
 						int idx = to_play.back()->get();
@@ -915,7 +915,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double
 					}
 				} else {
 					//find stuff to play
-					List<int> to_play;
+					Animation::KeyIndices to_play;
 					a->track_get_key_indices_in_range(i, p_time, p_delta, &to_play, p_pingponged);
 					if (to_play.size()) {
 						int idx = to_play.back()->get();
@@ -32,6 +32,7 @@
 
 #include "animation_blend_tree.h"
 #include "core/config/engine.h"
+#include "core/os/arena_allocator.h"
 #include "scene/resources/animation.h"
 #include "scene/scene_string_names.h"
 #include "servers/audio/audio_stream.h"
@@ -864,7 +865,11 @@ static void _call_object(Object *p_object, const StringName &p_method, const Vec
 		p_object->callp(p_method, argptrs, argcount, ce);
 	}
 }
+static MemoryCounters process_graph_memory_counters("AnimationTree::process_graph");
+
 void AnimationTree::_process_graph(double p_delta) {
+	ArenaScope arena_scope(&process_graph_memory_counters);
+
 	_update_properties(); //if properties need updating, update them
 
 	//check all tracks, see if they need modification
@@ -1344,7 +1349,7 @@ void AnimationTree::_process_graph(double p_delta) {
 								Variant value = a->track_get_key_value(i, idx);
 								t->object->set_indexed(t->subpath, value);
 							} else {
-								List<int> indices;
+								Animation::KeyIndices indices;
 								a->value_track_get_key_indices(i, time, delta, &indices, pingponged);
 								for (int &F : indices) {
 									Variant value = a->track_get_key_value(i, F);
@@ -1371,7 +1376,7 @@ void AnimationTree::_process_graph(double p_delta) {
 								_call_object(t->object, method, params, false);
 							}
 						} else {
-							List<int> indices;
+							Animation::KeyIndices indices;
 							a->method_track_get_key_indices(i, time, delta, &indices, pingponged);
 							for (int &F : indices) {
 								StringName method = a->method_track_get_name(i, F);
@@ -1441,7 +1446,7 @@ void AnimationTree::_process_graph(double p_delta) {
 
 						} else {
 							//find stuff to play
-							List<int> to_play;
+							Animation::KeyIndices to_play;
 							a->track_get_key_indices_in_range(i, time, delta, &to_play, pingponged);
 							if (to_play.size()) {
 								int idx = to_play.back()->get();
@@ -1563,7 +1568,7 @@ void AnimationTree::_process_graph(double p_delta) {
 							}
 						} else {
 							//find stuff to play
-							List<int> to_play;
+							Animation::KeyIndices to_play;
 							a->track_get_key_indices_in_range(i, time, delta, &to_play, pingponged);
 							if (to_play.size()) {
 								int idx = to_play.back()->get();
@@ -38,6 +38,7 @@
 #include "core/io/resource_loader.h"
 #include "core/multiplayer/multiplayer_api.h"
 #include "core/object/message_queue.h"
+#include "core/object/method_handle.h"
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
@@ -248,6 +249,9 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 
 	call_lock++;
 
+	// Nodes in a group tend to share a class, resolve the method once for all of them.
+	MethodHandle method(p_function);
+
 	if (p_call_flags & GROUP_CALL_REVERSE) {
 		for (int i = node_count - 1; i >= 0; i--) {
 			if (call_lock && call_skip.has(nodes[i])) {
@@ -256,7 +260,7 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 
 			if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
 				Callable::CallError ce;
-				nodes[i]->callp(p_function, p_args, p_argcount, ce);
+				method.call(nodes[i], p_args, p_argcount, ce);
 			} else {
 				MessageQueue::get_singleton()->push_callp(nodes[i], p_function, p_args, p_argcount);
 			}
@@ -270,7 +274,7 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 
 			if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
 				Callable::CallError ce;
-				nodes[i]->callp(p_function, p_args, p_argcount, ce);
+				method.call(nodes[i], p_args, p_argcount, ce);
 			} else {
 				MessageQueue::get_singleton()->push_callp(nodes[i], p_function, p_args, p_argcount);
 			}
@@ -111,9 +111,27 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 	LocalVector<DeferredNodePathProperties> deferred_node_paths;
 
+	// The editor may rely on properties being set through Object::set(), which
+	// also marks objects as edited in builds with tools.
+	Vector<PropertySetter> setters;
+	bool use_setters = p_edit_state == GEN_EDIT_STATE_DISABLED;
+#ifdef TOOLS_ENABLED
+	use_setters = use_setters && !Engine::get_singleton()->is_editor_hint();
+#endif
+	if (use_setters) {
+		setters = _get_property_setters();
+	}
+	int setter_offset = 0;
+
 	for (int i = 0; i < nc; i++) {
 		const NodeData &n = nd[i];
 
+		const PropertySetter *node_setters = nullptr;
+		if (!setters.is_empty()) {
+			node_setters = &setters[setter_offset];
+			setter_offset += n.properties.size();
+		}
+
 		Node *parent = nullptr;
 		String old_parent_path;
 
@@ -220,6 +238,11 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			}
 		}
 
+		if (node_setters && (missing_node || node->get_class_name() != snames[n.type])) {
+			// Not created from its type (e.g. a placeholder), so setters may not apply.
+			node_setters = nullptr;
+		}
+
 		if (node) {
 			// may not have found the node (part of instantiated scene and removed)
 			// if found all is good, otherwise ignore
@@ -317,7 +340,22 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 						}
 
 						if (set_valid) {
-							node->set(snames[nprops[j].name], value, &valid);
+							const PropertySetter *setter = node_setters ? &node_setters[j] : nullptr;
+							if (setter && setter->method && !node->get_script_instance()) {
+								// Same as what Object::set() ends up doing, without the lookups.
+								cached_setter_calls.increment();
+								Callable::CallError ce;
+								if (setter->index >= 0) {
+									Variant index = setter->index;
+									const Variant *args[2] = { &index, &value };
+									setter->method->call(node, args, 2, ce);
+								} else {
+									const Variant *args[1] = { &value };
+									setter->method->call(node, args, 1, ce);
+								}
+							} else {
+								node->set(snames[nprops[j].name], value, &valid);
+							}
 						}
 					}
 				}
@@ -458,6 +496,53 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 	return ret_nodes[0];
 }
 
+Vector<SceneState::PropertySetter> SceneState::_get_property_setters() const {
+	MutexLock lock(property_setters_mutex);
+
+	// Methods bound or unregistered since, which setters may be.
+	if (property_setters_generation == ClassDB::get_method_generation()) {
+		return property_setters;
+	}
+
+	property_setters.clear();
+	for (int i = 0; i < nodes.size(); i++) {
+		const NodeData &n = nodes[i];
+
+		// Only nodes created from their type here have setters known in advance.
+		StringName type;
+		if (n.type != TYPE_INSTANCED && n.instance < 0 && !(i == 0 && base_scene_idx >= 0) && n.type >= 0 && n.type < names.size()) {
+			type = names[n.type];
+			// Extensions can handle properties before their setters are called.
+			const ClassDB::APIType api = ClassDB::get_api_type(type);
+			if (api == ClassDB::API_EXTENSION || api == ClassDB::API_EDITOR_EXTENSION) {
+				type = StringName();
+			}
+		}
+
+		for (int j = 0; j < n.properties.size(); j++) {
+			const int name = n.properties[j].name;
+			PropertySetter setter;
+			if (type != StringName() && !(name & FLAG_PATH_PROPERTY_IS_NODE) && name >= 0 && name < names.size() && names[name] != CoreStringNames::get_singleton()->_script) {
+				const StringName setter_name = ClassDB::get_property_setter(type, names[name]);
+				if (setter_name != StringName()) {
+					setter.method = ClassDB::get_method(type, setter_name);
+					setter.index = ClassDB::get_property_index(type, names[name]);
+				}
+			}
+			property_setters.push_back(setter);
+		}
+	}
+	property_setters_generation = ClassDB::get_method_generation();
+
+	return property_setters;
+}
+
+void SceneState::_clear_property_setters() {
+	MutexLock lock(property_setters_mutex);
+	property_setters.clear();
+	property_setters_generation = 0;
+}
+
 static int _nm_get_string(const String &p_string, HashMap<StringName, int> &name_map) {
 	if (name_map.has(p_string)) {
 		return name_map[p_string];
@@ -984,6 +1069,7 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_clear_property_setters();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1142,6 +1228,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 	ERR_FAIL_COND(!p_dictionary.has("conns"));
 	//ERR_FAIL_COND( !p_dictionary.has("path"));
 
+	_clear_property_setters();
+
 	int version = 1;
 	if (p_dictionary.has("version")) {
 		version = p_dictionary["version"];
@@ -1604,6 +1692,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.index = p_index;
 
 	nodes.push_back(nd);
+	_clear_property_setters();
 
 	return nodes.size() - 1;
 }
@@ -1620,6 +1709,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value, bool p_d
 	}
 	prop.value = p_value;
 	nodes.write[p_node].properties.push_back(prop);
+	_clear_property_setters();
 }
 
 void SceneState::add_node_group(int p_node, int p_group) {
@@ -1749,6 +1839,25 @@ Node *PackedScene::instantiate(GenEditState p_edit_state) const {
 	return s;
 }
 
+TypedArray<Node> PackedScene::instantiate_many(int p_count, GenEditState p_edit_state) const {
+	ERR_FAIL_COND_V(p_count < 0, TypedArray<Node>());
+
+	TypedArray<Node> instances;
+	instances.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		Node *instance = instantiate(p_edit_state);
+		if (!instance) {
+			for (int j = 0; j < i; j++) {
+				memdelete(Object::cast_to<Node>(instances[j]));
+			}
+			return TypedArray<Node>();
+		}
+		instances[i] = instance;
+	}
+
+	return instances;
+}
+
 void PackedScene::replace_state(Ref<SceneState> p_by) {
 	state = p_by;
 	state->set_path(get_path());
@@ -1780,6 +1889,7 @@ void PackedScene::reset_state() {
 void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pack", "path"), &PackedScene::pack);
 	ClassDB::bind_method(D_METHOD("instantiate", "edit_state"), &PackedScene::instantiate, DEFVAL(GEN_EDIT_STATE_DISABLED));
+	ClassDB::bind_method(D_METHOD("instantiate_many", "count", "edit_state"), &PackedScene::instantiate_many, DEFVAL(GEN_EDIT_STATE_DISABLED));
 	ClassDB::bind_method(D_METHOD("can_instantiate"), &PackedScene::can_instantiate);
 	ClassDB::bind_method(D_METHOD("_set_bundled_scene"), &PackedScene::_set_bundled_scene);
 	ClassDB::bind_method(D_METHOD("_get_bundled_scene"), &PackedScene::_get_bundled_scene);
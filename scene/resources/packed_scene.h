@@ -32,6 +32,7 @@
 #define PACKED_SCENE_H
 
 #include "core/io/resource.h"
+#include "core/os/mutex.h"
 #include "scene/main/node.h"
 
 class SceneState : public RefCounted {
@@ -89,6 +90,22 @@ class SceneState : public RefCounted {
 
 	Vector<ConnectionData> connections;
 
+	// Setters of the node properties, one for each property of each node in
+	// order. They are looked up the first time the scene is instantiated, so
+	// instances don't look them up by name again.
+	struct PropertySetter {
+		MethodBind *method = nullptr;
+		int index = -1;
+	};
+
+	mutable Mutex property_setters_mutex;
+	mutable Vector<PropertySetter> property_setters;
+	mutable uint32_t property_setters_generation = 0;
+	mutable SafeNumeric<uint64_t> cached_setter_calls;
+
+	Vector<PropertySetter> _get_property_setters() const;
+	void _clear_property_setters();
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 
@@ -146,6 +163,8 @@ public:
 
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state) const;
+	// How many properties were set through the cached setters rather than Object::set().
+	uint64_t get_cached_setter_calls() const { return cached_setter_calls.get(); }
 
 	Ref<SceneState> get_base_scene_state() const;
 
@@ -231,6 +250,7 @@ public:
 
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
+	TypedArray<Node> instantiate_many(int p_count, GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
 
 	void recreate_state();
 	void replace_state(Ref<SceneState> p_by);
@@ -115,6 +115,13 @@ Error ResourceLoaderText::_parse_sub_resource(VariantParser::Stream *p_stream, R
 	}
 
 	String id = token.value;
+	if (!int_resources.has(id) && lazy_sub_resources.has(id)) {
+		Error err = _load_lazy_sub_resource(id);
+		if (err) {
+			r_err_str = "Can't load sub-resource: " + id;
+			return err;
+		}
+	}
 	ERR_FAIL_COND_V(!int_resources.has(id), ERR_INVALID_PARAMETER);
 	r_res = int_resources[id];
 
@@ -395,6 +402,164 @@ Ref<PackedScene> ResourceLoaderText::_parse_node_tag(VariantParser::ResourcePars
 	}
 }
 
+Error ResourceLoaderText::_create_sub_resource(const String &p_id, const String &p_type) {
+	String path = local_path + "::" + p_id;
+
+	//bool exists=ResourceCache::has(path);
+
+	Ref<Resource> res;
+	bool do_assign = false;
+
+	if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
+		//reuse existing
+		Ref<Resource> cache = ResourceCache::get_ref(path);
+		if (cache.is_valid() && cache->get_class() == p_type) {
+			res = cache;
+			res->reset_state();
+			do_assign = true;
+		}
+	}
+
+	MissingResource *missing_resource = nullptr;
+
+	if (res.is_null()) { //not reuse
+		Ref<Resource> cache = ResourceCache::get_ref(path);
+		if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && cache.is_valid()) { //only if it doesn't exist
+			//cached, do not assign
+			res = cache;
+		} else {
+			//create
+
+			Object *obj = ClassDB::instantiate(p_type);
+			if (!obj) {
+				if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
+					missing_resource = memnew(MissingResource);
+					missing_resource->set_original_class(p_type);
+					missing_resource->set_recording_properties(true);
+					obj = missing_resource;
+				} else {
+					error_text += "Can't create sub resource of type: " + p_type;
+					_printerr();
+					error = ERR_FILE_CORRUPT;
+					return error;
+				}
+			}
+
+			Resource *r = Object::cast_to<Resource>(obj);
+			if (!r) {
+				error_text += "Can't create sub resource of type, because not a resource: " + p_type;
+				_printerr();
+				error = ERR_FILE_CORRUPT;
+				return error;
+			}
+
+			res = Ref<Resource>(r);
+			do_assign = true;
+		}
+	}
+
+	int_resources[p_id] = res; //always assign int resources
+	if (do_assign && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
+		res->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE);
+		res->set_scene_unique_id(p_id);
+	}
+
+	Dictionary missing_resource_properties;
+
+	while (true) {
+		String assign;
+		Variant value;
+
+		error = VariantParser::parse_tag_assign_eof(&stream, lines, error_text, next_tag, assign, value, &rp);
+
+		if (error) {
+			_printerr();
+			return error;
+		}
+
+		if (!assign.is_empty()) {
+			if (do_assign) {
+				bool set_valid = true;
+
+				if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
+					// If the property being set is a missing resource (and the parent is not),
+					// then setting it will most likely not work.
+					// Instead, save it as metadata.
+
+					Ref<MissingResource> mr = value;
+					if (mr.is_valid()) {
+						missing_resource_properties[assign] = mr;
+						set_valid = false;
+					}
+				}
+
+				if (set_valid) {
+					res->set(assign, value);
+				}
+			}
+			//it's assignment
+		} else if (!next_tag.name.is_empty()) {
+			error = OK;
+			break;
+		} else {
+			error = ERR_FILE_CORRUPT;
+			error_text = "Premature end of file while parsing [sub_resource]";
+			_printerr();
+			return error;
+		}
+	}
+
+	if (missing_resource) {
+		missing_resource->set_recording_properties(false);
+	}
+
+	if (!missing_resource_properties.is_empty()) {
+		res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+	}
+
+	return OK;
+}
+
+Error ResourceLoaderText::_skip_sub_resource() {
+	while (true) {
+		String assign;
+		error = VariantParser::skip_tag_assign_eof(&stream, lines, error_text, next_tag, assign, &rp);
+		if (error) {
+			_printerr();
+			return error;
+		}
+
+		if (assign.is_empty()) {
+			if (!next_tag.name.is_empty()) {
+				return OK;
+			}
+			error = ERR_FILE_CORRUPT;
+			error_text = "Premature end of file while parsing [sub_resource]";
+			_printerr();
+			return error;
+		}
+	}
+}
+
+Error ResourceLoaderText::_load_lazy_sub_resource(const String &p_id) {
+	const LazySubResource lazy = lazy_sub_resources[p_id];
+	lazy_sub_resources.erase(p_id);
+
+	// Parse it where it is in the file, then go back to what was being parsed.
+	const uint64_t position = stream.get_position();
+	const int line = lines;
+	const VariantParser::Tag tag = next_tag;
+
+	stream.seek(lazy.position);
+	lines = lazy.line;
+	Error err = _create_sub_resource(p_id, lazy.type);
+
+	stream.seek(position);
+	lines = line;
+	next_tag = tag;
+	return err;
+}
+
 Error ResourceLoaderText::load() {
 	if (error != OK) {
 		return error;
@@ -527,125 +692,42 @@ Error ResourceLoaderText::load() {
 		String type = next_tag.fields["type"];
 		String id = next_tag.fields["id"];
 
-		String path = local_path + "::" + id;
-
-		//bool exists=ResourceCache::has(path);
-
-		Ref<Resource> res;
-		bool do_assign = false;
-
-		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
-			//reuse existing
-			Ref<Resource> cache = ResourceCache::get_ref(path);
-			if (cache.is_valid() && cache->get_class() == type) {
-				res = cache;
-				res->reset_state();
-				do_assign = true;
-			}
+		if (is_scene) {
+			// Only created if something in the file references it, see
+			// _parse_sub_resource(). Sub-resources referenced by any node are
+			// created, instantiated or not.
+			LazySubResource lazy;
+			lazy.type = type;
+			lazy.position = stream.get_position();
+			lazy.line = lines;
+			lazy_sub_resources[id] = lazy;
+
+			error = _skip_sub_resource();
+		} else {
+			error = _create_sub_resource(id, type);
 		}
-
-		MissingResource *missing_resource = nullptr;
-
-		if (res.is_null()) { //not reuse
-			Ref<Resource> cache = ResourceCache::get_ref(path);
-			if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && cache.is_valid()) { //only if it doesn't exist
-				//cached, do not assign
-				res = cache;
-			} else {
-				//create
-
-				Object *obj = ClassDB::instantiate(type);
-				if (!obj) {
-					if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
-						missing_resource = memnew(MissingResource);
-						missing_resource->set_original_class(type);
-						missing_resource->set_recording_properties(true);
-						obj = missing_resource;
-					} else {
-						error_text += "Can't create sub resource of type: " + type;
-						_printerr();
-						error = ERR_FILE_CORRUPT;
-						return error;
-					}
-				}
-
-				Resource *r = Object::cast_to<Resource>(obj);
-				if (!r) {
-					error_text += "Can't create sub resource of type, because not a resource: " + type;
-					_printerr();
-					error = ERR_FILE_CORRUPT;
-					return error;
-				}
-
-				res = Ref<Resource>(r);
-				do_assign = true;
-			}
+		if (error) {
+			return error;
 		}
 
 		resource_current++;
 
-		int_resources[id] = res; //always assign int resources
-		if (do_assign && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
-			res->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE);
-			res->set_scene_unique_id(id);
+		if (progress && resources_total > 0) {
+			*progress = resource_current / float(resources_total);
 		}
+	}
 
-		Dictionary missing_resource_properties;
-
-		while (true) {
-			String assign;
-			Variant value;
-
-			error = VariantParser::parse_tag_assign_eof(&stream, lines, error_text, next_tag, assign, value, &rp);
-
+	if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE) {
+		// Replacing must reset and reload the cached copy of every sub-resource,
+		// referenced or not, so create them all now, in file order (except for the
+		// ones created earlier because a previous one references them).
+		while (!lazy_sub_resources.is_empty()) {
+			const String id = lazy_sub_resources.begin()->key;
+			error = _load_lazy_sub_resource(id);
 			if (error) {
-				_printerr();
-				return error;
-			}
-
-			if (!assign.is_empty()) {
-				if (do_assign) {
-					bool set_valid = true;
-
-					if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
-						// If the property being set is a missing resource (and the parent is not),
-						// then setting it will most likely not work.
-						// Instead, save it as metadata.
-
-						Ref<MissingResource> mr = value;
-						if (mr.is_valid()) {
-							missing_resource_properties[assign] = mr;
-							set_valid = false;
-						}
-					}
-
-					if (set_valid) {
-						res->set(assign, value);
-					}
-				}
-				//it's assignment
-			} else if (!next_tag.name.is_empty()) {
-				error = OK;
-				break;
-			} else {
-				error = ERR_FILE_CORRUPT;
-				error_text = "Premature end of file while parsing [sub_resource]";
-				_printerr();
 				return error;
 			}
 		}
-
-		if (missing_resource) {
-			missing_resource->set_recording_properties(false);
-		}
-
-		if (!missing_resource_properties.is_empty()) {
-			res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
-		}
-
-		if (progress && resources_total > 0) {
-			*progress = resource_current / float(resources_total);
-		}
 	}
 
 	while (true) {
@@ -874,6 +956,8 @@ void ResourceLoaderText::get_dependencies(Ref<FileAccess> p_f, List<String> *p_d
 }
 
 Error ResourceLoaderText::rename_dependencies(Ref<FileAccess> p_f, const String &p_path, const HashMap<String, String> &p_map) {
+	// Tags are copied using the position of the file, so it can't be read ahead.
+	stream.readahead_enabled = false;
 	open(p_f, true);
 	ERR_FAIL_COND_V(error != OK, error);
 	ignore_resource_parsing = true;
@@ -61,6 +61,18 @@ class ResourceLoaderText {
 	HashMap<String, ExtResource> ext_resources;
 	HashMap<String, Ref<Resource>> int_resources;
 
+	// The sub-resources of scenes are skipped when loading, and only created
+	// when something in the file references them. Where to parse them from,
+	// until then. Whether a branch of the scene that gets instantiated uses
+	// them doesn't matter, the whole SceneState is read at load time.
+	struct LazySubResource {
+		String type;
+		uint64_t position = 0;
+		int line = 0;
+	};
+
+	HashMap<String, LazySubResource> lazy_sub_resources;
+
 	int resources_total = 0;
 	int resource_current = 0;
 	String resource_type;
@@ -82,6 +94,9 @@ class ResourceLoaderText {
 	static Error _parse_ext_resources(void *p_self, VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str) { return reinterpret_cast<ResourceLoaderText *>(p_self)->_parse_ext_resource(p_stream, r_res, line, r_err_str); }
 
 	Error _parse_sub_resource(VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str);
+	Error _create_sub_resource(const String &p_id, const String &p_type);
+	Error _skip_sub_resource();
+	Error _load_lazy_sub_resource(const String &p_id);
 	Error _parse_ext_resource(VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str);
 
 	// for converter
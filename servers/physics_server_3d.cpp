@@ -31,7 +31,9 @@
 #include "physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/os/arena_allocator.h"
 #include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
 
 void PhysicsServer3DRenderingServerHandler::set_vertex(int p_vertex_id, const void *p_vector3) {
 	GDVIRTUAL_REQUIRED_CALL(_set_vertex, p_vertex_id, p_vector3);
@@ -356,11 +358,13 @@ Dictionary PhysicsDirectSpaceState3D::_intersect_ray(const Ref<PhysicsRayQueryPa
 
 Array PhysicsDirectSpaceState3D::_intersect_point(const Ref<PhysicsPointQueryParameters3D> &p_point_query, int p_max_results) {
 	ERR_FAIL_COND_V(p_point_query.is_null(), Array());
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
 
-	Vector<ShapeResult> ret;
+	ArenaScope arena_scope;
+	LocalVector<ShapeResult, uint32_t, false, false, ArenaAllocator> ret;
 	ret.resize(p_max_results);
 
-	int rc = intersect_point(p_point_query->get_parameters(), ret.ptrw(), ret.size());
+	int rc = intersect_point(p_point_query->get_parameters(), ret.ptr(), ret.size());
 
 	if (rc == 0) {
 		return Array();
@@ -381,10 +385,12 @@ Array PhysicsDirectSpaceState3D::_intersect_point(const Ref<PhysicsPointQueryPar
 
 Array PhysicsDirectSpaceState3D::_intersect_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
 
-	Vector<ShapeResult> sr;
+	ArenaScope arena_scope;
+	LocalVector<ShapeResult, uint32_t, false, false, ArenaAllocator> sr;
 	sr.resize(p_max_results);
-	int rc = intersect_shape(p_shape_query->get_parameters(), sr.ptrw(), sr.size());
+	int rc = intersect_shape(p_shape_query->get_parameters(), sr.ptr(), sr.size());
 	Array ret;
 	ret.resize(rc);
 	for (int i = 0; i < rc; i++) {
@@ -416,11 +422,13 @@ Array PhysicsDirectSpaceState3D::_cast_motion(const Ref<PhysicsShapeQueryParamet
 
 Array PhysicsDirectSpaceState3D::_collide_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
 
-	Vector<Vector3> ret;
+	ArenaScope arena_scope;
+	LocalVector<Vector3, uint32_t, false, false, ArenaAllocator> ret;
 	ret.resize(p_max_results * 2);
 	int rc = 0;
-	bool res = collide_shape(p_shape_query->get_parameters(), ret.ptrw(), p_max_results, rc);
+	bool res = collide_shape(p_shape_query->get_parameters(), ret.ptr(), p_max_results, rc);
 	if (!res) {
 		return Array();
 	}
@@ -0,0 +1,345 @@
+/*************************************************************************/
+/*  test_compression.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_COMPRESSION_H
+#define TEST_COMPRESSION_H
+
+#include "core/io/compression.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access_compressed.h"
+#include "core/io/resource_saver.h"
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+#include "core/templates/local_vector.h"
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestCompression {
+
+// Text resembling a small text resource, like the ones the test dictionary was trained on.
+static String make_text_resource(int p_seed) {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(p_seed);
+	String text = vformat("[gd_resource type=\"StandardMaterial3D\" load_steps=%d format=3]\n\n", rng->randi_range(1, 5));
+	for (int i = 0; i < rng->randi_range(0, 3); i++) {
+		text += vformat("[ext_resource type=\"Texture2D\" path=\"res://textures/tex_%d.png\" id=\"%d\"]\n", rng->randi_range(0, 999), i + 1);
+	}
+	text += "\n[resource]\n";
+	text += vformat("albedo_color = Color(%.1f, 0.2, 0.1, 1)\nroughness = %.1f\nresource_name = \"Node_%d\"\n", rng->randf(), rng->randf(), rng->randi_range(0, 99));
+	return text;
+}
+
+static Vector<uint8_t> make_data(int p_size) {
+	Vector<uint8_t> data;
+	data.resize(p_size);
+	for (int i = 0; i < p_size; i++) {
+		// Compressible, but not trivially.
+		data.write[i] = (i / 7) % 251 ^ (i % 13);
+	}
+	return data;
+}
+
+TEST_CASE("[Compression] Compress and decompress in every mode") {
+	const Vector<uint8_t> data = make_data(100000);
+	const Compression::Mode modes[] = { Compression::MODE_FASTLZ, Compression::MODE_DEFLATE, Compression::MODE_ZSTD, Compression::MODE_GZIP };
+	for (const Compression::Mode mode : modes) {
+		Vector<uint8_t> compressed;
+		compressed.resize(Compression::get_max_compressed_buffer_size(data.size(), mode));
+		int compressed_size = Compression::compress(compressed.ptrw(), data.ptr(), data.size(), mode);
+		CHECK(compressed_size > 0);
+		CHECK(compressed_size < data.size());
+
+		Vector<uint8_t> decompressed;
+		decompressed.resize(data.size());
+		CHECK(Compression::decompress(decompressed.ptrw(), decompressed.size(), compressed.ptr(), compressed_size, mode) == data.size());
+		CHECK(decompressed == data);
+	}
+}
+
+TEST_CASE("[Compression] Zstandard dictionary") {
+	const Vector<uint8_t> dictionary = FileAccess::get_file_as_array(TestUtils::get_data_path("compression/text_resources.dict"));
+	REQUIRE(dictionary.size() > 0);
+	const CharString text = make_text_resource(1).utf8();
+
+	Vector<uint8_t> compressed;
+	compressed.resize(Compression::get_max_compressed_buffer_size(text.length()));
+	const int plain_size = Compression::compress(compressed.ptrw(), (const uint8_t *)text.get_data(), text.length());
+	REQUIRE(plain_size > 0);
+
+	const uint32_t id = Compression::add_zstd_dictionary(dictionary);
+	REQUIRE(id != 0);
+	CHECK(Compression::has_zstd_dictionary(id));
+	const int dictionary_size = Compression::compress(compressed.ptrw(), (const uint8_t *)text.get_data(), text.length(), Compression::MODE_ZSTD, id);
+	REQUIRE(dictionary_size > 0);
+	CHECK_MESSAGE(dictionary_size < plain_size / 2, "Small inputs similar to the training samples should compress much better.");
+
+	Vector<uint8_t> decompressed;
+	decompressed.resize(text.length());
+	CHECK(Compression::decompress(decompressed.ptrw(), decompressed.size(), compressed.ptr(), dictionary_size) == text.length());
+	CHECK(memcmp(decompressed.ptr(), text.get_data(), text.length()) == 0);
+
+	Compression::remove_zstd_dictionary(id);
+	CHECK_FALSE(Compression::has_zstd_dictionary(id));
+	ERR_PRINT_OFF;
+	CHECK(Compression::decompress(decompressed.ptrw(), decompressed.size(), compressed.ptr(), dictionary_size) == -1);
+	CHECK(Compression::add_zstd_dictionary(make_data(4)) == 0);
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[Compression] Train a Zstandard dictionary") {
+	Vector<Vector<uint8_t>> samples;
+	for (int i = 0; i < 200; i++) {
+		const CharString text = make_text_resource(i).utf8();
+		Vector<uint8_t> sample;
+		sample.resize(text.length());
+		memcpy(sample.ptrw(), text.get_data(), text.length());
+		samples.push_back(sample);
+	}
+	const Vector<uint8_t> dictionary = Compression::train_zstd_dictionary(samples, 16384);
+	REQUIRE(dictionary.size() > 0);
+	CHECK(dictionary.size() <= 16384);
+
+	// A raw content dictionary, its ID has to be passed to decompress.
+	const uint32_t id = Compression::add_zstd_dictionary(dictionary);
+	REQUIRE(id != 0);
+	const CharString text = make_text_resource(1000).utf8();
+	Vector<uint8_t> compressed;
+	compressed.resize(Compression::get_max_compressed_buffer_size(text.length()));
+	const int plain_size = Compression::compress(compressed.ptrw(), (const uint8_t *)text.get_data(), text.length());
+	const int dictionary_size = Compression::compress(compressed.ptrw(), (const uint8_t *)text.get_data(), text.length(), Compression::MODE_ZSTD, id);
+	REQUIRE(dictionary_size > 0);
+	CHECK_MESSAGE(dictionary_size < plain_size / 2, "Inputs similar to the training samples should compress much better.");
+
+	Vector<uint8_t> decompressed;
+	decompressed.resize(text.length());
+	CHECK(Compression::decompress(decompressed.ptrw(), decompressed.size(), compressed.ptr(), dictionary_size, Compression::MODE_ZSTD, id) == text.length());
+	CHECK(memcmp(decompressed.ptr(), text.get_data(), text.length()) == 0);
+
+	// Compressed files record the dictionary they use.
+	const String path = OS::get_singleton()->get_cache_path().plus_file("compressed_dictionary_test.bin");
+	{
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("TEST", Compression::MODE_ZSTD, 4096, id);
+		REQUIRE(fac->_open(path, FileAccess::WRITE) == OK);
+		fac->store_buffer((const uint8_t *)text.get_data(), text.length());
+	}
+	{
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("TEST");
+		REQUIRE(fac->_open(path, FileAccess::READ) == OK);
+		CHECK(fac->get_zstd_dictionary() == id);
+		REQUIRE(fac->get_length() == uint64_t(text.length()));
+		CHECK(fac->get_buffer(decompressed.ptrw(), text.length()) == uint64_t(text.length()));
+		CHECK(memcmp(decompressed.ptr(), text.get_data(), text.length()) == 0);
+	}
+
+	DirAccess::remove_file_or_error(path);
+	Compression::remove_zstd_dictionary(id);
+
+	// Nothing in common, nothing to train on.
+	Vector<Vector<uint8_t>> unrelated;
+	unrelated.push_back(make_data(1000));
+	CHECK(Compression::train_zstd_dictionary(unrelated, 16384).is_empty());
+}
+
+TEST_CASE("[FileAccessCompressed] Read whole blocks and seek") {
+	const String path = OS::get_singleton()->get_cache_path().plus_file("compressed_test.bin");
+	// A multiple of the block size, the last block is empty.
+	const int sizes[] = { 100000, 4096 * 20 };
+	for (const int size : sizes) {
+		const Vector<uint8_t> data = make_data(size);
+		{
+			Ref<FileAccessCompressed> fac;
+			fac.instantiate();
+			fac->configure("TEST", Compression::MODE_ZSTD, 4096);
+			REQUIRE(fac->_open(path, FileAccess::WRITE) == OK);
+			fac->store_buffer(data.ptr(), data.size());
+		}
+
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("TEST");
+		REQUIRE(fac->_open(path, FileAccess::READ) == OK);
+		CHECK(fac->get_length() == uint64_t(size));
+
+		// Starts in the middle of a block, then covers several whole blocks.
+		Vector<uint8_t> read;
+		read.resize(size);
+		CHECK(fac->get_buffer(read.ptrw(), 1000) == 1000);
+		CHECK(fac->get_8() == data[1000]);
+		CHECK(fac->get_buffer(read.ptrw() + 1001, 50000) == 50000);
+		CHECK(fac->get_position() == 51001);
+		CHECK(fac->get_buffer(read.ptrw() + 51001, size) == uint64_t(size - 51001));
+		CHECK(fac->eof_reached());
+		read.write[1000] = data[1000];
+		CHECK(read == data);
+
+		fac->seek(4096 * 3 + 10);
+		CHECK(fac->get_8() == data[4096 * 3 + 10]);
+		fac->seek(100);
+		CHECK(fac->get_buffer(read.ptrw(), 4096 * 4) == 4096 * 4);
+		CHECK(memcmp(read.ptr(), data.ptr() + 100, 4096 * 4) == 0);
+		CHECK(fac->get_8() == data[100 + 4096 * 4]);
+		fac->seek(size - 1);
+		CHECK(fac->get_8() == data[size - 1]);
+		CHECK_FALSE(fac->eof_reached());
+		fac->get_8();
+		CHECK(fac->eof_reached());
+	}
+
+	DirAccess::remove_file_or_error(path);
+}
+
+// A small binary resource, like the ones compressed resources in a pack usually are.
+static Vector<uint8_t> make_binary_resource(int p_seed) {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(p_seed);
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name(vformat("Material_%d", rng->randi_range(0, 999)));
+	resource->set_meta("albedo_color", Color(rng->randf(), rng->randf(), rng->randf()));
+	resource->set_meta("roughness", rng->randf());
+	resource->set_meta("texture_path", vformat("res://textures/tex_%d.png", rng->randi_range(0, 999)));
+	PackedVector3Array points;
+	for (int i = 0; i < rng->randi_range(0, 16); i++) {
+		points.push_back(Vector3(rng->randi_range(-10, 10), 0, rng->randi_range(-10, 10)));
+	}
+	resource->set_meta("points", points);
+
+	const String path = OS::get_singleton()->get_cache_path().plus_file("compression_benchmark.res");
+	ERR_FAIL_COND_V(ResourceSaver::save(path, resource) != OK, Vector<uint8_t>());
+	const Vector<uint8_t> data = FileAccess::get_file_as_array(path);
+	DirAccess::remove_file_or_error(path);
+	return data;
+}
+
+void benchmark_compression() {
+	const int rounds = 20;
+
+	// Typical payloads: many small binary resources and a large one.
+	Vector<Vector<uint8_t>> resource_payloads;
+	for (int i = 0; i < 500; i++) {
+		resource_payloads.push_back(make_binary_resource(i));
+	}
+	Vector<Vector<uint8_t>> binary_payloads;
+	binary_payloads.push_back(make_data(4 * 1024 * 1024));
+
+	// Trained like exporting a pack does, on the first half so the rest wasn't seen.
+	const uint32_t dictionary = Compression::add_zstd_dictionary(Compression::train_zstd_dictionary(resource_payloads.slice(0, 250), 65536));
+	resource_payloads = resource_payloads.slice(250);
+
+	struct Method {
+		const char *name;
+		Compression::Mode mode;
+		uint32_t dictionary;
+	};
+	const Method methods[] = {
+		{ "fastlz", Compression::MODE_FASTLZ, 0 },
+		{ "deflate", Compression::MODE_DEFLATE, 0 },
+		{ "gzip", Compression::MODE_GZIP, 0 },
+		{ "zstd", Compression::MODE_ZSTD, 0 },
+		{ "zstd+dict", Compression::MODE_ZSTD, dictionary },
+	};
+
+	for (int payload_type = 0; payload_type < 2; payload_type++) {
+		const Vector<Vector<uint8_t>> &payloads = payload_type == 0 ? resource_payloads : binary_payloads;
+		const uint32_t block_size = payload_type == 0 ? 4096 : 65536;
+		print_line(payload_type == 0 ? "Small binary resources:" : "Large binary resource:");
+
+		for (const Method &method : methods) {
+			uint64_t raw_size = 0;
+			uint64_t compressed_size = 0;
+			LocalVector<Vector<uint8_t>> blocks;
+			LocalVector<int> block_sizes;
+			for (const Vector<uint8_t> &payload : payloads) {
+				for (int offset = 0; offset < payload.size(); offset += block_size) {
+					const int size = MIN(int(block_size), payload.size() - offset);
+					Vector<uint8_t> block;
+					block.resize(Compression::get_max_compressed_buffer_size(size, method.mode));
+					block.resize(Compression::compress(block.ptrw(), payload.ptr() + offset, size, method.mode, method.dictionary));
+					raw_size += size;
+					compressed_size += block.size();
+					blocks.push_back(block);
+					block_sizes.push_back(size);
+				}
+			}
+
+			Vector<uint8_t> decompressed;
+			decompressed.resize(block_size);
+			const uint64_t t = OS::get_singleton()->get_ticks_usec();
+			for (int round = 0; round < rounds; round++) {
+				for (uint32_t i = 0; i < blocks.size(); i++) {
+					Compression::decompress(decompressed.ptrw(), block_sizes[i], blocks[i].ptr(), blocks[i].size(), method.mode, method.dictionary);
+				}
+			}
+			const double seconds = MAX(OS::get_singleton()->get_ticks_usec() - t, uint64_t(1)) / 1000000.0;
+			print_line(vformat("  %-10s ratio %5.3f  decode %8.1f MB/s", method.name, double(compressed_size) / raw_size, raw_size * rounds / seconds / (1024 * 1024)));
+		}
+	}
+
+	// Reading a large compressed file at once decompresses its blocks in parallel.
+	const String path = OS::get_singleton()->get_cache_path().plus_file("compression_benchmark.bin");
+	const Vector<uint8_t> &data = binary_payloads[0];
+	{
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("BNCH", Compression::MODE_ZSTD, 65536);
+		ERR_FAIL_COND(fac->_open(path, FileAccess::WRITE) != OK);
+		fac->store_buffer(data.ptr(), data.size());
+	}
+	Vector<uint8_t> read;
+	read.resize(data.size());
+	print_line("Reading a compressed file:");
+	for (const uint64_t chunk : { uint64_t(4096), uint64_t(data.size()) }) {
+		const uint64_t t = OS::get_singleton()->get_ticks_usec();
+		for (int round = 0; round < rounds; round++) {
+			Ref<FileAccessCompressed> fac;
+			fac.instantiate();
+			fac->configure("BNCH");
+			fac->_open(path, FileAccess::READ);
+			for (uint64_t offset = 0; offset < uint64_t(data.size()); offset += chunk) {
+				fac->get_buffer(read.ptrw() + offset, MIN(chunk, data.size() - offset));
+			}
+		}
+		const double seconds = MAX(OS::get_singleton()->get_ticks_usec() - t, uint64_t(1)) / 1000000.0;
+		print_line(vformat("  %-10s %8.1f MB/s", chunk == 4096 ? "4 KiB reads" : "one read", double(data.size()) * rounds / seconds / (1024 * 1024)));
+	}
+	DirAccess::remove_file_or_error(path);
+	Compression::remove_zstd_dictionary(dictionary);
+}
+
+REGISTER_TEST_COMMAND("compression-benchmark", &benchmark_compression);
+
+} // namespace TestCompression
+
+#endif // TEST_COMPRESSION_H
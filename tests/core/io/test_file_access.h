@@ -32,6 +32,9 @@
 #define TEST_FILE_ACCESS_H
 
 #include "core/io/file_access.h"
+#include "core/io/file_access_pack.h"
+#include "core/io/pck_packer.h"
+#include "core/os/os.h"
 #include "tests/test_macros.h"
 #include "tests/test_utils.h"
 
@@ -78,6 +81,74 @@ TEST_CASE("[FileAccess] CSV read") {
 	CHECK(row5[1] == "tab separated");
 	CHECK(row5[2] == "lines, good?");
 }
+TEST_CASE("[FileAccess] Memory mapped read") {
+	const String path = TestUtils::get_data_path("translations.csv");
+	const Vector<uint8_t> contents = FileAccess::get_file_as_array(path);
+	REQUIRE(contents.size() > 16);
+
+	// Falls back to a regular file where mapping is not supported, without views.
+	Ref<FileAccess> f = FileAccess::open_mapped(path, FileAccess::MAPPING_HINT_SEQUENTIAL);
+	REQUIRE(f.is_valid());
+	CHECK(f->get_length() == (uint64_t)contents.size());
+	CHECK(f->get_8() == contents[0]);
+
+	const uint8_t *view = f->get_buffer_view(8);
+	if (view) {
+		CHECK(memcmp(view, contents.ptr() + 1, 8) == 0);
+		CHECK(f->get_position() == 9);
+		CHECK_MESSAGE(f->get_buffer_view(contents.size()) == nullptr, "Views past the end should not be returned.");
+		CHECK(f->get_position() == 9);
+	} else {
+		f->seek(9);
+	}
+
+	Vector<uint8_t> rest;
+	rest.resize(contents.size());
+	CHECK(f->get_buffer(rest.ptrw(), rest.size()) == (uint64_t)contents.size() - 9);
+	CHECK(memcmp(rest.ptr(), contents.ptr() + 9, contents.size() - 9) == 0);
+	CHECK(f->eof_reached());
+}
+
+TEST_CASE("[FileAccess] Read files from a pack") {
+	REQUIRE(PackedData::get_singleton());
+	const String source_path = TestUtils::get_data_path("translations.csv");
+	const String pck_path = OS::get_singleton()->get_cache_path().plus_file("file_access_test.pck");
+	const Vector<uint8_t> contents = FileAccess::get_file_as_array(source_path);
+
+	PCKPacker pck_packer;
+	REQUIRE(pck_packer.pck_start(pck_path) == OK);
+	REQUIRE(pck_packer.add_file("res://file_access_test/translations.csv", source_path) == OK);
+	REQUIRE(pck_packer.flush() == OK);
+	REQUIRE(PackedData::get_singleton()->add_pack(pck_path, true, 0) == OK);
+
+	Ref<FileAccess> f = FileAccess::open("res://file_access_test/translations.csv", FileAccess::READ);
+	REQUIRE(f.is_valid());
+	CHECK(f->get_length() == (uint64_t)contents.size());
+
+	Vector<uint8_t> read;
+	read.resize(contents.size());
+	CHECK(f->get_buffer(read.ptrw(), 4) == 4);
+	const uint8_t *view = f->get_buffer_view(4);
+	if (view) {
+		memcpy(read.ptrw() + 4, view, 4);
+	} else {
+		CHECK(f->get_buffer(read.ptrw() + 4, 4) == 4);
+	}
+	CHECK(f->get_buffer(read.ptrw() + 8, contents.size() - 8) == (uint64_t)contents.size() - 8);
+	CHECK(read == contents);
+
+	f->seek(1);
+	CHECK(f->get_8() == contents[1]);
+	f->seek_end(-1);
+	CHECK(f->get_8() == contents[contents.size() - 1]);
+	CHECK_FALSE(f->eof_reached());
+	f->get_8();
+	CHECK(f->eof_reached());
+
+	f.unref();
+	PackedData::get_singleton()->remove_pack(pck_path);
+	DirAccess::remove_file_or_error(pck_path);
+}
 } // namespace TestFileAccess
 
 #endif // TEST_FILE_ACCESS_H
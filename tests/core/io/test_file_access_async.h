@@ -0,0 +1,203 @@
+/*************************************************************************/
+/*  test_file_access_async.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FILE_ACCESS_ASYNC_H
+#define TEST_FILE_ACCESS_ASYNC_H
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/file_access_async.h"
+#include "core/io/file_access_pack.h"
+#include "core/io/pck_packer.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFileAccessAsync {
+
+String write_test_file(int p_size) {
+	const String dir = OS::get_singleton()->get_cache_path().plus_file("file_access_async");
+	DirAccess::create(DirAccess::ACCESS_FILESYSTEM)->make_dir_recursive(dir);
+	const String path = dir.plus_file("data.bin");
+
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+	REQUIRE(f.is_valid());
+	for (int i = 0; i < p_size; i++) {
+		f->store_8(i * 7);
+	}
+	return path;
+}
+
+void check_reads(FileAccessAsync *p_async) {
+	const int size = 1 << 20;
+	const String path = write_test_file(size);
+
+	SUBCASE("Many reads at once") {
+		const int count = 200; // More than can be queued at once.
+		const int length = 4096;
+		Vector<uint8_t> buffer;
+		buffer.resize(count * length);
+
+		Vector<FileAccessAsync::ReadID> ids;
+		for (int i = 0; i < count; i++) {
+			const FileAccessAsync::ReadID id = p_async->read(path, i * 5000, buffer.ptrw() + i * length, length);
+			REQUIRE(id != FileAccessAsync::INVALID_READ_ID);
+			ids.push_back(id);
+		}
+
+		// Polled in reverse, they don't have to complete in order.
+		for (int i = count - 1; i >= 0; i--) {
+			uint64_t read = 0;
+			FileAccessAsync::Status status = FileAccessAsync::STATUS_PENDING;
+			if (i % 2) {
+				while ((status = p_async->poll(ids[i], &read)) == FileAccessAsync::STATUS_PENDING) {
+					OS::get_singleton()->delay_usec(100);
+				}
+			} else {
+				status = p_async->wait(ids[i], &read);
+			}
+			CHECK(status == FileAccessAsync::STATUS_DONE);
+			CHECK(read == length);
+		}
+
+		bool matches = true;
+		for (int i = 0; i < count && matches; i++) {
+			for (int j = 0; j < length; j++) {
+				if (buffer[i * length + j] != uint8_t((i * 5000 + j) * 7)) {
+					matches = false;
+					break;
+				}
+			}
+		}
+		CHECK_MESSAGE(matches, "The reads should have read the file at their offset.");
+	}
+
+	SUBCASE("Reading past the end") {
+		Vector<uint8_t> buffer;
+		buffer.resize(1000);
+		uint64_t read = 0;
+		CHECK(p_async->wait(p_async->read(path, size - 100, buffer.ptrw(), 1000), &read) == FileAccessAsync::STATUS_DONE);
+		CHECK(read == 100);
+		CHECK(buffer[99] == uint8_t((size - 1) * 7));
+
+		read = 1;
+		CHECK(p_async->wait(p_async->read(path, size + 100, buffer.ptrw(), 1000), &read) == FileAccessAsync::STATUS_DONE);
+		CHECK(read == 0);
+	}
+
+	SUBCASE("Missing files") {
+		uint8_t buffer[16];
+		const FileAccessAsync::ReadID id = p_async->read(path + ".missing", 0, buffer, 16);
+		CHECK((id == FileAccessAsync::INVALID_READ_ID || p_async->wait(id) == FileAccessAsync::STATUS_FAILED));
+	}
+
+	SUBCASE("Prefetching") {
+		const FileAccessAsync::ReadID id = p_async->prefetch(path, 0, size);
+		if (p_async->uses_threads()) {
+			CHECK_MESSAGE(id == FileAccessAsync::INVALID_READ_ID, "Prefetching should not take up a thread.");
+		} else if (id != FileAccessAsync::INVALID_READ_ID) {
+			uint64_t read = 1;
+			CHECK(p_async->wait(id, &read) == FileAccessAsync::STATUS_DONE);
+			CHECK(read == 0);
+		}
+	}
+}
+
+TEST_CASE("[FileAccessAsync] Reading with the default implementation") {
+	REQUIRE(FileAccessAsync::get_singleton());
+	check_reads(FileAccessAsync::get_singleton());
+}
+
+TEST_CASE("[FileAccessAsync] Reading on the WorkerThreadPool") {
+	FileAccessAsync *async = memnew(FileAccessAsync);
+	CHECK(async->uses_threads());
+	check_reads(async);
+	memdelete(async);
+}
+
+TEST_CASE("[FileAccessAsync] Reading files in packs") {
+	const int size = 1 << 16;
+	const String path = write_test_file(size);
+	const String pck_path = path.get_base_dir().plus_file("data.pck");
+
+	// Another file first, so the one read isn't at the start of the pack.
+	PCKPacker pck_packer;
+	REQUIRE(pck_packer.pck_start(pck_path) == OK);
+	REQUIRE(pck_packer.add_file("res://file_access_async_test/first.bin", path) == OK);
+	REQUIRE(pck_packer.add_file("res://file_access_async_test/data.bin", path) == OK);
+	REQUIRE(pck_packer.flush() == OK);
+	REQUIRE(PackedData::get_singleton()->add_pack(pck_path, true, 0) == OK);
+
+	String location_path;
+	uint64_t offset = 0;
+	uint64_t location_size = 0;
+	REQUIRE(PackedData::get_singleton()->get_file_location("res://file_access_async_test/data.bin", location_path, offset, location_size));
+	CHECK(location_path == pck_path);
+	CHECK(offset >= (uint64_t)size);
+	CHECK(location_size == (uint64_t)size);
+	{
+		Ref<FileAccess> f = FileAccess::open(pck_path, FileAccess::READ);
+		REQUIRE(f.is_valid());
+		f->seek(offset + 100);
+		CHECK(f->get_8() == uint8_t(100 * 7));
+	}
+	CHECK(!PackedData::get_singleton()->get_file_location("res://file_access_async_test/missing.bin", location_path, offset, location_size));
+
+	FileAccessAsync *thread_async = memnew(FileAccessAsync);
+	for (FileAccessAsync *async : { FileAccessAsync::get_singleton(), thread_async }) {
+		// Reads stop at the end of the file, not of the pack.
+		Vector<uint8_t> buffer;
+		buffer.resize(size);
+		uint64_t read = 0;
+		CHECK(async->wait(async->read("res://file_access_async_test/data.bin", 100, buffer.ptrw(), size), &read) == FileAccessAsync::STATUS_DONE);
+		CHECK(read == (uint64_t)size - 100);
+		bool matches = true;
+		for (int i = 0; i < size - 100; i++) {
+			if (buffer[i] != uint8_t((i + 100) * 7)) {
+				matches = false;
+				break;
+			}
+		}
+		CHECK_MESSAGE(matches, "The read should have read the file in the pack.");
+
+		const FileAccessAsync::ReadID id = async->prefetch("res://file_access_async_test/data.bin", 0, size);
+		if (id != FileAccessAsync::INVALID_READ_ID) {
+			CHECK(async->wait(id) == FileAccessAsync::STATUS_DONE);
+		}
+	}
+	memdelete(thread_async);
+
+	PackedData::get_singleton()->remove_pack(pck_path);
+	DirAccess::remove_file_or_error(pck_path);
+}
+
+} // namespace TestFileAccessAsync
+
+#endif // TEST_FILE_ACCESS_ASYNC_H
@@ -31,8 +31,12 @@
 #ifndef TEST_JSON_H
 #define TEST_JSON_H
 
+#include "core/io/dir_access.h"
 #include "core/io/json.h"
+#include "core/io/stream_peer.h"
+#include "core/os/os.h"
 
+#include "tests/test_macros.h"
 #include "thirdparty/doctest/doctest.h"
 
 namespace TestJSON {
@@ -146,6 +150,311 @@ TEST_CASE("[JSON] Parsing objects (dictionaries)") {
 			dictionary["empty_object"].hash() == Dictionary().hash(),
 			"The parsed JSON should contain the expected values.");
 }
+Ref<StreamPeerBuffer> make_json_stream(const String &p_json) {
+	Ref<StreamPeerBuffer> stream;
+	stream.instantiate();
+	const CharString utf8 = p_json.utf8();
+	Vector<uint8_t> bytes;
+	bytes.resize(utf8.length());
+	memcpy(bytes.ptrw(), utf8.get_data(), utf8.length());
+	stream->set_data_array(bytes);
+	return stream;
+}
+
+String get_json_stream_text(const Ref<StreamPeerBuffer> &p_stream) {
+	const Vector<uint8_t> bytes = p_stream->get_data_array();
+	return String::utf8((const char *)bytes.ptr(), bytes.size());
+}
+
+TEST_CASE("[JSONReader] Reading events") {
+	Ref<JSONReader> reader;
+	reader.instantiate();
+	reader->open_stream(make_json_stream(R"({"name": "Godot Engine", "tags": [1, true, null], "empty": {}})"));
+
+	CHECK(reader->next() == JSONReader::EVENT_OBJECT_BEGIN);
+	CHECK(reader->next() == JSONReader::EVENT_KEY);
+	CHECK(reader->get_key() == "name");
+	CHECK(reader->next() == JSONReader::EVENT_VALUE);
+	CHECK(reader->get_value() == "Godot Engine");
+	CHECK(reader->next() == JSONReader::EVENT_KEY);
+	CHECK(reader->get_key() == "tags");
+	CHECK(reader->next() == JSONReader::EVENT_ARRAY_BEGIN);
+	CHECK(reader->get_depth() == 2);
+	CHECK(reader->next() == JSONReader::EVENT_VALUE);
+	CHECK((int)reader->get_value() == 1);
+	CHECK(reader->next() == JSONReader::EVENT_VALUE);
+	CHECK(reader->get_value() == Variant(true));
+	CHECK(reader->next() == JSONReader::EVENT_VALUE);
+	CHECK(reader->get_value() == Variant());
+	CHECK(reader->next() == JSONReader::EVENT_ARRAY_END);
+	CHECK(reader->next() == JSONReader::EVENT_KEY);
+	CHECK(reader->get_key() == "empty");
+	CHECK(reader->next() == JSONReader::EVENT_OBJECT_BEGIN);
+	CHECK(reader->next() == JSONReader::EVENT_OBJECT_END);
+	CHECK(reader->next() == JSONReader::EVENT_OBJECT_END);
+	CHECK(reader->get_depth() == 0);
+	CHECK(reader->next() == JSONReader::EVENT_END);
+	CHECK(reader->get_error() == OK);
+}
+
+TEST_CASE("[JSONReader] Reading values across chunks") {
+	// Strings longer than a chunk, and escapes split between chunks.
+	String long_string;
+	for (int i = 0; i < JSONReader::CHUNK_SIZE / 8; i++) {
+		long_string += U"abcdé\\n\\u00e9";
+	}
+	const String json_string = R"({"long": ")" + long_string + R"(", "pair": "😀", "numbers": [-1.5, 2e3, 0], "nested": [[], [{"a": "b"}]]})";
+
+	JSON json;
+	REQUIRE(json.parse(json_string) == OK);
+
+	for (int offset = 0; offset < 8; offset++) {
+		// Shift the document so chunk boundaries fall on different characters.
+		Ref<JSONReader> reader;
+		reader.instantiate();
+		reader->open_stream(make_json_stream(String(" ").repeat(offset) + json_string));
+		const Variant value = reader->read_value();
+		CHECK(reader->get_error() == OK);
+		CHECK(reader->next() == JSONReader::EVENT_END);
+		CHECK_MESSAGE(
+				json.stringify(value) == json.stringify(json.get_data()),
+				"The value read should be the same as the one parsed by JSON.");
+	}
+}
+
+TEST_CASE("[JSONReader] Reading records one at a time") {
+	Ref<JSONReader> reader;
+	reader.instantiate();
+	reader->open_stream(make_json_stream(R"([{"id": 0}, {"id": 1, "skipped": [1, 2]}, {"id": 2}])"));
+
+	CHECK(reader->next() == JSONReader::EVENT_ARRAY_BEGIN);
+	int count = 0;
+	while (reader->next() == JSONReader::EVENT_OBJECT_BEGIN) {
+		if (count == 1) {
+			CHECK(reader->skip_value() == OK);
+		} else {
+			const Dictionary record = reader->read_value();
+			CHECK((int)record["id"] == count);
+		}
+		count++;
+	}
+	CHECK(count == 3);
+	CHECK(reader->get_error() == OK);
+	CHECK(reader->next() == JSONReader::EVENT_END);
+}
+
+// Has no data available every other read, like a non-blocking connection.
+class TrickleStreamPeer : public StreamPeerBuffer {
+	bool starved = false;
+
+public:
+	virtual Error get_partial_data(uint8_t *p_buffer, int p_bytes, int &r_received) override {
+		starved = !starved;
+		if (starved) {
+			r_received = 0;
+			return OK;
+		}
+		return StreamPeerBuffer::get_partial_data(p_buffer, MIN(p_bytes, 3), r_received);
+	}
+};
+
+TEST_CASE("[JSONReader] Reading a stream with no data available yet") {
+	Ref<TrickleStreamPeer> stream;
+	stream.instantiate();
+	const CharString utf8 = String(R"({"name": "Godot Engine", "tags": [1, true, null]})").utf8();
+	Vector<uint8_t> bytes;
+	bytes.resize(utf8.length());
+	memcpy(bytes.ptrw(), utf8.get_data(), utf8.length());
+	stream->set_data_array(bytes);
+
+	Ref<JSONReader> reader;
+	reader.instantiate();
+	reader->open_stream(stream);
+	const Dictionary value = reader->read_value();
+	CHECK(reader->get_error() == OK);
+	CHECK(value["name"] == "Godot Engine");
+	CHECK(Array(value["tags"]).size() == 3);
+	CHECK(reader->next() == JSONReader::EVENT_END);
+}
+
+TEST_CASE("[JSONReader] Errors") {
+	Ref<JSONReader> reader;
+	reader.instantiate();
+
+	reader->open_stream(make_json_stream("[1, 2]]"));
+	reader->read_value();
+	CHECK(reader->next() == JSONReader::EVENT_ERROR);
+	CHECK(reader->get_error_message() == "Expected 'EOF'");
+
+	reader->open_stream(make_json_stream("{\n\"a\": \"unterminated\n"));
+	reader->read_value();
+	CHECK(reader->get_error() == ERR_PARSE_ERROR);
+	CHECK(reader->get_error_message() == "Unterminated String");
+	CHECK(reader->get_error_line() == 2);
+
+	reader->open_stream(make_json_stream("[1 2]"));
+	reader->read_value();
+	CHECK(reader->get_error_message() == "Expected ','");
+
+	reader->open_stream(make_json_stream("[nope]"));
+	reader->read_value();
+	CHECK(reader->get_error_message() == "Expected 'true','false' or 'null', got 'nope'.");
+}
+
+TEST_CASE("[JSONWriter] Writing matches JSON::stringify") {
+	JSON json;
+	REQUIRE(json.parse(R"({"name": "Godot \"Engine\"", "tags": [1, 2.5, [], {}], "nested": {"b": null, "a": [true, false]}})") == OK);
+
+	const String indents[] = { "", "\t" };
+	for (const String &indent : indents) {
+		for (int sort_keys = 0; sort_keys < 2; sort_keys++) {
+			Ref<StreamPeerBuffer> stream;
+			stream.instantiate();
+			Ref<JSONWriter> writer;
+			writer.instantiate();
+			writer->open_stream(stream, indent, sort_keys);
+			CHECK(writer->write_value(json.get_data()) == OK);
+			CHECK(writer->close() == OK);
+			CHECK(get_json_stream_text(stream) == json.stringify(json.get_data(), indent, sort_keys));
+		}
+	}
+}
+
+TEST_CASE("[JSONWriter] Writing containers element by element") {
+	Ref<StreamPeerBuffer> stream;
+	stream.instantiate();
+	Ref<JSONWriter> writer;
+	writer.instantiate();
+	writer->open_stream(stream);
+
+	writer->begin_object();
+	writer->write_key("events");
+	writer->begin_array();
+	for (int i = 0; i < 3; i++) {
+		Dictionary event;
+		event["id"] = i;
+		writer->write_value(event);
+	}
+	writer->end_array();
+	writer->write_key("count");
+	writer->write_value(3);
+	writer->end_object();
+	CHECK(writer->close() == OK);
+
+	CHECK(get_json_stream_text(stream) == R"({"events":[{"id":0},{"id":1},{"id":2}],"count":3})");
+
+	ERR_PRINT_OFF;
+	writer->open_stream(stream);
+	writer->begin_object();
+	CHECK(writer->write_value(1) == ERR_INVALID_DATA);
+	CHECK(writer->end_array() == ERR_INVALID_DATA);
+	CHECK(writer->close() == ERR_INVALID_DATA);
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[JSONWriter] Writing and reading a file") {
+	Array records;
+	for (int i = 0; i < 10000; i++) {
+		Dictionary record;
+		record["id"] = i;
+		record["name"] = vformat(U"Record é %d", i);
+		records.push_back(record);
+	}
+
+	const String path = OS::get_singleton()->get_cache_path().plus_file("json_writer.json");
+	Ref<JSONWriter> writer;
+	writer.instantiate();
+	REQUIRE(writer->open(path, "  ") == OK);
+	CHECK(writer->write_value(records) == OK);
+	CHECK(writer->close() == OK);
+
+	Ref<JSONReader> reader;
+	reader.instantiate();
+	REQUIRE(reader->open(path) == OK);
+	const Array read = reader->read_value();
+	CHECK(reader->get_error() == OK);
+	CHECK(JSON().stringify(read) == JSON().stringify(records));
+	reader->close();
+
+	DirAccess::remove_file_or_error(path);
+}
+
+void benchmark_json() {
+	const int records = 200000;
+	const String path = OS::get_singleton()->get_cache_path().plus_file("benchmark.json");
+
+	Array data;
+	for (int i = 0; i < records; i++) {
+		Dictionary record;
+		record["id"] = i;
+		record["name"] = vformat("Record %d", i);
+		Array position;
+		position.push_back(i * 0.5);
+		position.push_back(i * 0.25);
+		position.push_back(-i);
+		record["position"] = position;
+		data.push_back(record);
+	}
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		ERR_FAIL_COND(f.is_null());
+		JSON json;
+		f->store_string(json.stringify(data, "\t"));
+	}
+	const uint64_t stringify_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	Ref<JSONWriter> writer;
+	writer.instantiate();
+	ERR_FAIL_COND(writer->open(path, "\t") != OK);
+	writer->begin_array();
+	for (int i = 0; i < records; i++) {
+		writer->write_value(data[i]);
+	}
+	writer->end_array();
+	ERR_FAIL_COND(writer->close() != OK);
+	const uint64_t write_usec = OS::get_singleton()->get_ticks_usec() - t;
+	data.clear();
+
+	const uint64_t base_memory = Memory::get_mem_usage();
+	t = OS::get_singleton()->get_ticks_usec();
+	uint64_t parse_memory = 0;
+	{
+		JSON json;
+		ERR_FAIL_COND(json.parse(FileAccess::get_file_as_string(path)) != OK);
+		parse_memory = Memory::get_mem_usage() - base_memory;
+	}
+	const uint64_t parse_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	uint64_t read_memory = 0;
+	int read_records = 0;
+	{
+		Ref<JSONReader> reader;
+		reader.instantiate();
+		ERR_FAIL_COND(reader->open(path) != OK);
+		reader->next();
+		while (reader->next() == JSONReader::EVENT_OBJECT_BEGIN) {
+			const Dictionary record = reader->read_value();
+			read_records++;
+			read_memory = MAX(read_memory, Memory::get_mem_usage() - base_memory);
+		}
+		ERR_FAIL_COND(reader->get_error() != OK || read_records != records);
+	}
+	const uint64_t read_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	print_line(vformat("JSON document with %d records (%s):", records, String::humanize_size(FileAccess::open(path, FileAccess::READ)->get_length())));
+	print_line(vformat("  JSON.stringify()    %8.2f ms", stringify_usec / 1000.0));
+	print_line(vformat("  JSONWriter          %8.2f ms", write_usec / 1000.0));
+	print_line(vformat("  JSON.parse()        %8.2f ms, %s in use", parse_usec / 1000.0, String::humanize_size(parse_memory)));
+	print_line(vformat("  JSONReader records  %8.2f ms, %s in use", read_usec / 1000.0, String::humanize_size(read_memory)));
+
+	DirAccess::remove_file_or_error(path);
+}
+
+REGISTER_TEST_COMMAND("json-benchmark", &benchmark_json);
 } // namespace TestJSON
 
 #endif // TEST_JSON_H
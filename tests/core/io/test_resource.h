@@ -31,10 +31,14 @@
 #ifndef TEST_RESOURCE
 #define TEST_RESOURCE
 
+#include "core/io/file_access_pack.h"
+#include "core/io/pck_packer.h"
 #include "core/io/resource.h"
+#include "core/io/resource_format_binary.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/os/os.h"
+#include "tests/test_macros.h"
 
 #include "thirdparty/doctest/doctest.h"
 
@@ -109,6 +113,191 @@ TEST_CASE("[Resource] Saving and loading") {
 			loaded_child_resource_text->get_name() == "I'm a child resource",
 			"The loaded child resource name should be equal to the expected value.");
 }
+
+TEST_CASE("[Resource] Saving and loading large packed arrays") {
+	PackedFloat32Array floats;
+	floats.resize(100000);
+	for (int i = 0; i < floats.size(); i++) {
+		floats.write[i] = i * 0.5;
+	}
+	PackedVector3Array vectors;
+	vectors.resize(10000);
+	for (int i = 0; i < vectors.size(); i++) {
+		vectors.write[i] = Vector3(i, -i, i * 2);
+	}
+
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_meta("floats", floats);
+	resource->set_meta("vectors", vectors);
+	resource->set_meta("small", PackedInt32Array({ 1, 2, 3 }));
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("large_arrays.res");
+	REQUIRE(ResourceSaver::save(save_path, resource) == OK);
+
+	Ref<Resource> loaded = ResourceLoader::load(save_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	REQUIRE(loaded.is_valid());
+	CHECK(PackedFloat32Array(loaded->get_meta("floats")) == floats);
+	CHECK(PackedVector3Array(loaded->get_meta("vectors")) == vectors);
+	CHECK(PackedInt32Array(loaded->get_meta("small")) == PackedInt32Array({ 1, 2, 3 }));
+
+	// Only files with aligned arrays need the newer format version.
+	Ref<FileAccess> f = FileAccess::open(save_path, FileAccess::READ);
+	REQUIRE(f.is_valid());
+	f->seek(20);
+	CHECK(f->get_32() == 5);
+	f.unref();
+	Ref<Resource> small_resource = memnew(Resource);
+	small_resource->set_meta("small", PackedInt32Array({ 1, 2, 3 }));
+	const String small_save_path = OS::get_singleton()->get_cache_path().plus_file("small_arrays.res");
+	REQUIRE(ResourceSaver::save(small_save_path, small_resource) == OK);
+	f = FileAccess::open(small_save_path, FileAccess::READ);
+	REQUIRE(f.is_valid());
+	f->seek(20);
+	CHECK(f->get_32() == 4);
+	f.unref();
+	DirAccess::remove_file_or_error(small_save_path);
+
+	// Loaded from a pack, the arrays may use the mapped file in place.
+	REQUIRE(PackedData::get_singleton());
+	const String pck_path = OS::get_singleton()->get_cache_path().plus_file("large_arrays.pck");
+	PCKPacker pck_packer;
+	REQUIRE(pck_packer.pck_start(pck_path) == OK);
+	REQUIRE(pck_packer.add_file("res://resource_test/large_arrays.res", save_path) == OK);
+	REQUIRE(pck_packer.flush() == OK);
+	REQUIRE(PackedData::get_singleton()->add_pack(pck_path, true, 0) == OK);
+
+	loaded = ResourceLoader::load("res://resource_test/large_arrays.res", "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	REQUIRE(loaded.is_valid());
+	PackedFloat32Array loaded_floats = loaded->get_meta("floats");
+	CHECK(loaded_floats == floats);
+	CHECK(PackedVector3Array(loaded->get_meta("vectors")) == vectors);
+
+	// Writing to the array copies it, the file and other loads are not affected.
+	loaded_floats.set(0, -1.0);
+	CHECK(loaded_floats[0] == -1.0);
+	CHECK(PackedFloat32Array(loaded->get_meta("floats"))[0] == 0.0);
+	loaded.unref();
+	loaded = ResourceLoader::load("res://resource_test/large_arrays.res", "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	REQUIRE(loaded.is_valid());
+	CHECK(PackedFloat32Array(loaded->get_meta("floats")) == floats);
+
+	loaded.unref();
+	PackedData::get_singleton()->remove_pack(pck_path);
+	CHECK_FALSE(FileAccess::exists("res://resource_test/large_arrays.res"));
+	DirAccess::remove_file_or_error(save_path);
+	DirAccess::remove_file_or_error(pck_path);
+}
+
+TEST_CASE("[Resource] Loading dependencies in parallel") {
+	// Two resources sharing a dependency, both used by the main one.
+	const String dir = OS::get_singleton()->get_cache_path().simplify_path();
+	const String leaf_path = dir.plus_file("dependency_leaf.res");
+	const String a_path = dir.plus_file("dependency_a.res");
+	const String b_path = dir.plus_file("dependency_b.res");
+	const String main_path = dir.plus_file("dependency_main.res");
+	{
+		Ref<Resource> leaf = memnew(Resource);
+		leaf->set_name("leaf");
+		leaf->set_path(leaf_path);
+		REQUIRE(ResourceSaver::save(leaf_path, leaf) == OK);
+		Ref<Resource> a = memnew(Resource);
+		a->set_name("a");
+		a->set_meta("leaf", leaf);
+		a->set_path(a_path);
+		REQUIRE(ResourceSaver::save(a_path, a) == OK);
+		Ref<Resource> b = memnew(Resource);
+		b->set_name("b");
+		b->set_meta("leaf", leaf);
+		b->set_path(b_path);
+		REQUIRE(ResourceSaver::save(b_path, b) == OK);
+		Ref<Resource> main = memnew(Resource);
+		main->set_meta("a", a);
+		main->set_meta("b", b);
+		REQUIRE(ResourceSaver::save(main_path, main) == OK);
+	}
+
+	ResourceLoader::clear_profile();
+	ResourceLoader::set_profiling(true);
+	REQUIRE(ResourceLoader::load_threaded_request(main_path, "", true) == OK);
+	Ref<Resource> loaded = ResourceLoader::load_threaded_get(main_path);
+	ResourceLoader::set_profiling(false);
+
+	REQUIRE(loaded.is_valid());
+	Ref<Resource> a = loaded->get_meta("a");
+	Ref<Resource> b = loaded->get_meta("b");
+	REQUIRE(a.is_valid());
+	REQUIRE(b.is_valid());
+	CHECK(a->get_name() == "a");
+	CHECK(b->get_name() == "b");
+	CHECK(Ref<Resource>(a->get_meta("leaf"))->get_name() == "leaf");
+	CHECK_MESSAGE(Ref<Resource>(a->get_meta("leaf")) == Ref<Resource>(b->get_meta("leaf")), "Shared dependencies should be loaded once.");
+
+	const Vector<ResourceLoader::LoadProfileEntry> profile = ResourceLoader::get_profile();
+	for (const String &path : { leaf_path, a_path, b_path, main_path }) {
+		int loads = 0;
+		for (const ResourceLoader::LoadProfileEntry &entry : profile) {
+			if (entry.path.get_file() == path.get_file()) {
+				loads++;
+			}
+		}
+		CHECK_MESSAGE(loads == 1, "Every resource should be loaded, and only once: ", path);
+	}
+	ResourceLoader::clear_profile();
+
+	a.unref();
+	b.unref();
+	loaded.unref();
+	for (const String &path : { leaf_path, a_path, b_path, main_path }) {
+		DirAccess::remove_file_or_error(path);
+	}
+}
+
+double benchmark_resource_load(const String &p_path, int p_rounds) {
+	const uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_rounds; i++) {
+		Ref<Resource> loaded = ResourceLoader::load(p_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+		ERR_FAIL_COND_V(loaded.is_null(), 0);
+	}
+	return (OS::get_singleton()->get_ticks_usec() - t) / 1000.0 / p_rounds;
+}
+
+void benchmark_resource_loading() {
+	const int rounds = 20;
+	PackedFloat32Array floats;
+	floats.resize(4 * 1024 * 1024);
+	for (int i = 0; i < floats.size(); i++) {
+		floats.write[i] = i;
+	}
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_meta("floats", floats);
+
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("benchmark.res");
+	const String v4_save_path = OS::get_singleton()->get_cache_path().plus_file("benchmark_v4.res");
+	const String pck_path = OS::get_singleton()->get_cache_path().plus_file("benchmark.pck");
+	ERR_FAIL_COND(ResourceSaver::save(save_path, resource) != OK);
+	// The same resource without aligned arrays, as format version 4 stores it.
+	ResourceFormatSaverBinaryInstance v4_saver;
+	v4_saver.write_aligned_arrays = false;
+	ERR_FAIL_COND(v4_saver.save(v4_save_path, resource) != OK);
+	PCKPacker pck_packer;
+	pck_packer.pck_start(pck_path);
+	pck_packer.add_file("res://resource_benchmark/benchmark.res", save_path);
+	pck_packer.add_file("res://resource_benchmark/benchmark_v4.res", v4_save_path);
+	pck_packer.flush();
+	ERR_FAIL_COND(PackedData::get_singleton()->add_pack(pck_path, true, 0) != OK);
+
+	print_line(vformat("Loading a resource with a %s array:", String::humanize_size(floats.size() * sizeof(float))));
+	print_line(vformat("  file, version 4  %8.2f ms", benchmark_resource_load(v4_save_path, rounds)));
+	print_line(vformat("  file, version 5  %8.2f ms", benchmark_resource_load(save_path, rounds)));
+	print_line(vformat("  pack, version 4  %8.2f ms", benchmark_resource_load("res://resource_benchmark/benchmark_v4.res", rounds)));
+	print_line(vformat("  pack, version 5  %8.2f ms", benchmark_resource_load("res://resource_benchmark/benchmark.res", rounds)));
+
+	PackedData::get_singleton()->remove_pack(pck_path);
+	DirAccess::remove_file_or_error(save_path);
+	DirAccess::remove_file_or_error(v4_save_path);
+	DirAccess::remove_file_or_error(pck_path);
+}
+
+REGISTER_TEST_COMMAND("resource-load-benchmark", &benchmark_resource_loading);
 } // namespace TestResource
 
 #endif // TEST_RESOURCE
@@ -0,0 +1,308 @@
+/*************************************************************************/
+/*  test_resource_import_cache.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RESOURCE_IMPORT_CACHE_H
+#define TEST_RESOURCE_IMPORT_CACHE_H
+
+#include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/resource_import_cache.h"
+#include "core/os/os.h"
+
+#ifdef TOOLS_ENABLED
+#include "editor/import/resource_importer_bitmask.h"
+#include "editor/import/resource_importer_csv_translation.h"
+#include "editor/import/resource_importer_image.h"
+#include "editor/import/resource_importer_wav.h"
+#endif
+
+#include "tests/test_macros.h"
+
+namespace TestResourceImportCache {
+
+// Writes the source in upper case, once for each platform variant if asked to.
+// The text is reversed if the project says so.
+class TextImporter : public ResourceImporter {
+public:
+	static inline const String reverse_setting = "test/import_cache/reverse";
+
+	int import_count = 0;
+	bool cacheable = true;
+	bool generate_files = false;
+
+	virtual String get_importer_name() const override { return "test_text"; }
+	virtual String get_visible_name() const override { return "Text"; }
+	virtual void get_recognized_extensions(List<String> *p_extensions) const override { p_extensions->push_back("txt"); }
+	virtual String get_save_extension() const override { return "upper"; }
+	virtual String get_resource_type() const override { return String(); }
+
+	virtual void get_import_options(const String &p_path, List<ImportOption> *r_options, int p_preset = 0) const override {
+		r_options->push_back(ImportOption(PropertyInfo(Variant::STRING, "suffix"), ""));
+		r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "variants"), false));
+	}
+	virtual bool get_option_visibility(const String &p_path, const String &p_option, const HashMap<StringName, Variant> &p_options) const override { return true; }
+	virtual bool can_cache_import() const override { return cacheable; }
+
+	static bool is_reversing() {
+		return ProjectSettings::get_singleton()->has_setting(reverse_setting) && bool(ProjectSettings::get_singleton()->get_setting(reverse_setting));
+	}
+	virtual String get_import_settings_string() const override { return is_reversing() ? "reverse" : ""; }
+
+	virtual Error import(const String &p_source_file, const String &p_save_path, const HashMap<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = nullptr, Variant *r_metadata = nullptr) override {
+		import_count++;
+		String text = FileAccess::get_file_as_string(p_source_file).to_upper() + String(p_options["suffix"]);
+		if (is_reversing()) {
+			String reversed;
+			for (int i = text.length() - 1; i >= 0; i--) {
+				reversed += text[i];
+			}
+			text = reversed;
+		}
+
+		Vector<String> paths;
+		if (p_options["variants"]) {
+			r_platform_variants->push_back("a");
+			r_platform_variants->push_back("b");
+			paths.push_back(p_save_path + ".a.upper");
+			paths.push_back(p_save_path + ".b.upper");
+		} else {
+			paths.push_back(p_save_path + ".upper");
+		}
+		for (int i = 0; i < paths.size(); i++) {
+			Ref<FileAccess> f = FileAccess::open(paths[i], FileAccess::WRITE);
+			f->store_string(text);
+		}
+
+		if (generate_files) {
+			Ref<FileAccess> f = FileAccess::open(p_save_path + ".extra", FileAccess::WRITE);
+			f->store_string(text);
+			r_gen_files->push_back(p_save_path + ".extra");
+		}
+
+		if (r_metadata) {
+			Dictionary metadata;
+			metadata["length"] = text.length();
+			*r_metadata = metadata;
+		}
+		return OK;
+	}
+};
+
+// Imports through the cache, the way EditorFileSystem does.
+Error import_cached(Ref<ResourceImportCache> p_cache, Ref<TextImporter> p_importer, const String &p_source_file, const String &p_base_path, const HashMap<StringName, Variant> &p_options, List<String> &r_variants, Variant &r_metadata) {
+	List<String> gen_files;
+	return p_cache->import(p_importer, p_source_file, p_base_path, p_options, &r_variants, &gen_files, &r_metadata);
+}
+
+void write_file(const String &p_path, const String &p_text) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
+	REQUIRE(f.is_valid());
+	f->store_string(p_text);
+}
+
+TEST_CASE("[ResourceImportCache] Keys") {
+	const String dir = OS::get_singleton()->get_cache_path().plus_file("import_cache_keys");
+	DirAccess::create(DirAccess::ACCESS_FILESYSTEM)->make_dir_recursive(dir);
+	write_file(dir.plus_file("a.txt"), "same");
+	write_file(dir.plus_file("b.txt"), "same");
+	write_file(dir.plus_file("c.txt"), "other");
+
+	Ref<TextImporter> importer;
+	importer.instantiate();
+	HashMap<StringName, Variant> options;
+
+	const String key = ResourceImportCache::get_key(dir.plus_file("a.txt"), importer, options);
+	CHECK(key.length() == 64);
+	CHECK_MESSAGE(
+			ResourceImportCache::get_key(dir.plus_file("b.txt"), importer, options) == key,
+			"Files with the same contents should have the same key, wherever they are.");
+	CHECK(ResourceImportCache::get_key(dir.plus_file("c.txt"), importer, options) != key);
+
+	options["suffix"] = "";
+	CHECK_MESSAGE(
+			ResourceImportCache::get_key(dir.plus_file("a.txt"), importer, options) == key,
+			"Missing options should be the same as their default values.");
+	options["suffix"] = "!";
+	CHECK(ResourceImportCache::get_key(dir.plus_file("a.txt"), importer, options) != key);
+
+	ERR_PRINT_OFF;
+	CHECK(ResourceImportCache::get_key(dir.plus_file("missing.txt"), importer, options).is_empty());
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[ResourceImportCache] Storing and retrieving imports") {
+	const String dir = OS::get_singleton()->get_cache_path().plus_file("import_cache_imports");
+	DirAccess::create(DirAccess::ACCESS_FILESYSTEM)->make_dir_recursive(dir);
+	write_file(dir.plus_file("first.txt"), "hello");
+	write_file(dir.plus_file("second.txt"), "hello");
+
+	// Start from an empty cache, entries are kept across runs.
+	const String cache_dir = dir.plus_file("cache");
+	Ref<DirAccess> da = DirAccess::open(cache_dir);
+	if (da.is_valid()) {
+		da->erase_contents_recursive();
+	}
+
+	Ref<ResourceImportCache> cache;
+	cache.instantiate();
+	cache->set_directory(cache_dir);
+	Ref<TextImporter> importer;
+	importer.instantiate();
+
+	SUBCASE("Without platform variants") {
+		HashMap<StringName, Variant> options;
+		options["suffix"] = "?";
+		options["variants"] = false;
+
+		List<String> variants;
+		Variant metadata;
+		REQUIRE(import_cached(cache, importer, dir.plus_file("first.txt"), dir.plus_file("first"), options, variants, metadata) == OK);
+		CHECK(importer->import_count == 1);
+		CHECK(cache->get_misses() == 1);
+
+		// Another source with the same contents is restored from the cache.
+		variants.clear();
+		metadata = Variant();
+		REQUIRE(import_cached(cache, importer, dir.plus_file("second.txt"), dir.plus_file("second"), options, variants, metadata) == OK);
+		CHECK(importer->import_count == 1);
+		CHECK(cache->get_hits() == 1);
+		CHECK(FileAccess::get_file_as_string(dir.plus_file("second.upper")) == "HELLO?");
+		CHECK(variants.is_empty());
+		CHECK(Dictionary(metadata)["length"] == Variant(6));
+
+		// Changing an option imports it again.
+		options["suffix"] = "!";
+		REQUIRE(import_cached(cache, importer, dir.plus_file("second.txt"), dir.plus_file("second"), options, variants, metadata) == OK);
+		CHECK(importer->import_count == 2);
+		CHECK(cache->get_misses() == 2);
+		CHECK(FileAccess::get_file_as_string(dir.plus_file("second.upper")) == "HELLO!");
+	}
+
+	SUBCASE("With platform variants") {
+		HashMap<StringName, Variant> options;
+		options["suffix"] = "";
+		options["variants"] = true;
+
+		List<String> variants;
+		Variant metadata;
+		REQUIRE(import_cached(cache, importer, dir.plus_file("first.txt"), dir.plus_file("first"), options, variants, metadata) == OK);
+
+		variants.clear();
+		REQUIRE(import_cached(cache, importer, dir.plus_file("second.txt"), dir.plus_file("second"), options, variants, metadata) == OK);
+		CHECK(importer->import_count == 1);
+		REQUIRE(variants.size() == 2);
+		CHECK(variants[0] == "a");
+		CHECK(variants[1] == "b");
+		CHECK(FileAccess::get_file_as_string(dir.plus_file("second.a.upper")) == "HELLO");
+		CHECK(FileAccess::get_file_as_string(dir.plus_file("second.b.upper")) == "HELLO");
+
+		// Entries can be shared by another cache using the same directory.
+		Ref<ResourceImportCache> other_cache;
+		other_cache.instantiate();
+		other_cache->set_directory(cache_dir);
+		const String key = ResourceImportCache::get_key(dir.plus_file("first.txt"), importer, options);
+		CHECK(!other_cache->load_entry(key).is_empty());
+		CHECK(other_cache->load_entry(String("0").repeat(64)).is_empty());
+	}
+
+	SUBCASE("Project settings") {
+		HashMap<StringName, Variant> options;
+		options["suffix"] = "";
+		options["variants"] = false;
+		List<String> variants;
+		Variant metadata;
+		REQUIRE(import_cached(cache, importer, dir.plus_file("first.txt"), dir.plus_file("first"), options, variants, metadata) == OK);
+		CHECK(importer->import_count == 1);
+
+		// The importer depends on this setting through its import settings string.
+		ProjectSettings::get_singleton()->set_setting(TextImporter::reverse_setting, true);
+		REQUIRE(import_cached(cache, importer, dir.plus_file("second.txt"), dir.plus_file("second"), options, variants, metadata) == OK);
+		CHECK(importer->import_count == 2);
+		CHECK(FileAccess::get_file_as_string(dir.plus_file("second.upper")) == "OLLEH");
+
+		ProjectSettings::get_singleton()->clear(TextImporter::reverse_setting);
+		REQUIRE(import_cached(cache, importer, dir.plus_file("second.txt"), dir.plus_file("second"), options, variants, metadata) == OK);
+		CHECK(importer->import_count == 2);
+		CHECK(FileAccess::get_file_as_string(dir.plus_file("second.upper")) == "HELLO");
+	}
+
+	SUBCASE("Importers that don't opt in") {
+		importer->cacheable = false;
+		HashMap<StringName, Variant> options;
+		options["suffix"] = "";
+		options["variants"] = false;
+		List<String> variants;
+		Variant metadata;
+		REQUIRE(import_cached(cache, importer, dir.plus_file("first.txt"), dir.plus_file("first"), options, variants, metadata) == OK);
+		REQUIRE(import_cached(cache, importer, dir.plus_file("first.txt"), dir.plus_file("first"), options, variants, metadata) == OK);
+		CHECK(importer->import_count == 2);
+		CHECK(cache->get_hits() + cache->get_misses() == 0);
+	}
+
+	SUBCASE("Imports that generate other files") {
+		importer->generate_files = true;
+		HashMap<StringName, Variant> options;
+		options["suffix"] = "";
+		options["variants"] = false;
+		List<String> variants;
+		List<String> gen_files;
+		Variant metadata;
+		REQUIRE(cache->import(importer, dir.plus_file("first.txt"), dir.plus_file("first"), options, &variants, &gen_files, &metadata) == OK);
+		REQUIRE(gen_files.size() == 1);
+		CHECK(gen_files[0] == dir.plus_file("first.extra"));
+
+		// Not stored, as the other files would be missing when retrieving it.
+		gen_files.clear();
+		REQUIRE(cache->import(importer, dir.plus_file("first.txt"), dir.plus_file("first"), options, &variants, &gen_files, &metadata) == OK);
+		CHECK(importer->import_count == 2);
+		CHECK(gen_files.size() == 1);
+		CHECK(cache->get_hits() == 0);
+	}
+
+	cache->reset_stats();
+	CHECK(cache->get_hits() == 0);
+	CHECK(cache->get_misses() == 0);
+}
+
+#ifdef TOOLS_ENABLED
+TEST_CASE("[ResourceImportCache] Importers opting in") {
+	CHECK(Ref<ResourceImporter>(memnew(ResourceImporterImage))->can_cache_import());
+	CHECK(Ref<ResourceImporter>(memnew(ResourceImporterWAV))->can_cache_import());
+	CHECK(Ref<ResourceImporter>(memnew(ResourceImporterBitMap))->can_cache_import());
+
+	// Writes a translation for each locale, besides the destination file.
+	CHECK(!Ref<ResourceImporter>(memnew(ResourceImporterCSVTranslation))->can_cache_import());
+}
+#endif // TOOLS_ENABLED
+
+} // namespace TestResourceImportCache
+
+#endif // TEST_RESOURCE_IMPORT_CACHE_H
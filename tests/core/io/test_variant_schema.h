@@ -0,0 +1,385 @@
+/*************************************************************************/
+/*  test_variant_schema.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_VARIANT_SCHEMA_H
+#define TEST_VARIANT_SCHEMA_H
+
+#include "core/io/marshalls.h"
+#include "core/io/resource.h"
+#include "core/io/variant_schema.h"
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestVariantSchema {
+
+Dictionary make_item(const String &p_name, int p_count) {
+	Dictionary item;
+	item["item"] = p_name;
+	item["count"] = p_count;
+	return item;
+}
+
+Dictionary make_record(int p_id) {
+	Dictionary record;
+	record["id"] = p_id;
+	record["name"] = vformat("Player %d", p_id);
+	record["position"] = Vector3(p_id, -p_id * 0.5, 8);
+	record["health"] = 87.5;
+	record["alive"] = true;
+	record["stunned"] = false;
+	Array inventory;
+	inventory.push_back(make_item("sword", 1));
+	inventory.push_back(make_item("potion", 3));
+	record["inventory"] = inventory;
+	return record;
+}
+
+PackedByteArray encode_with_schema(const Ref<VariantSchema> &p_schema, const Variant &p_value) {
+	int len = 0;
+	PackedByteArray bytes;
+	if (p_schema->encode(p_value, nullptr, len) != OK) {
+		return bytes;
+	}
+	bytes.resize(len);
+	p_schema->encode(p_value, bytes.ptrw(), len);
+	return bytes;
+}
+
+TEST_CASE("[VariantSchema] Encoding dictionaries") {
+	Ref<VariantSchema> schema;
+	schema.instantiate();
+	const Dictionary record = make_record(42);
+	REQUIRE(schema->create_from_dictionary(record) == OK);
+	CHECK(schema->get_field_count() == 7);
+	CHECK(schema->get_field_name(0) == "id");
+	CHECK(schema->get_field_type(2) == Variant::VECTOR3);
+	CHECK(schema->get_field_schema(6).is_valid());
+
+	const PackedByteArray bytes = encode_with_schema(schema, record);
+	int variant_len = 0;
+	encode_variant(record, nullptr, variant_len);
+	CHECK_MESSAGE(
+			bytes.size() < variant_len / 3,
+			"Encoding with a schema should be much more compact than encode_variant().");
+
+	Dictionary decoded;
+	int len = 0;
+	CHECK(schema->decode(bytes.ptr(), bytes.size(), decoded, &len) == OK);
+	CHECK(len == bytes.size());
+	CHECK(decoded == record);
+
+	// Values are converted to the type of the field.
+	Dictionary converted = make_record(1);
+	converted["health"] = 50;
+	const PackedByteArray converted_bytes = encode_with_schema(schema, converted);
+	CHECK(schema->decode(converted_bytes.ptr(), converted_bytes.size(), decoded) == OK);
+	CHECK(decoded["health"].get_type() == Variant::FLOAT);
+
+	ERR_PRINT_OFF;
+	Dictionary missing = make_record(1);
+	missing.erase("name");
+	CHECK(encode_with_schema(schema, missing).is_empty());
+	Dictionary wrong_type = make_record(1);
+	wrong_type["position"] = "here";
+	CHECK(encode_with_schema(schema, wrong_type).is_empty());
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[VariantSchema] Math types encoded with either precision") {
+	Ref<VariantSchema> schema;
+	schema.instantiate();
+	schema->add_field("position", Variant::VECTOR2);
+	schema->add_field("path", Variant::PACKED_VECTOR2_ARRAY);
+
+	// As encoded by a build with single precision floats...
+	uint8_t single[1 + 8 + 1 + 8];
+	single[0] = 0;
+	encode_float(1.5, single + 1);
+	encode_float(-2.25, single + 5);
+	single[9] = 1;
+	encode_float(3, single + 10);
+	encode_float(4, single + 14);
+
+	// ...and by one with double precision.
+	uint8_t doubles[1 + 16 + 1 + 16];
+	doubles[0] = 1;
+	encode_double(1.5, doubles + 1);
+	encode_double(-2.25, doubles + 9);
+	doubles[17] = 1;
+	encode_double(3, doubles + 18);
+	encode_double(4, doubles + 26);
+
+	PackedVector2Array path;
+	path.push_back(Vector2(3, 4));
+
+	Dictionary decoded;
+	int len = 0;
+	CHECK(schema->decode(single, sizeof(single), decoded, &len) == OK);
+	CHECK(len == sizeof(single));
+	CHECK(decoded["position"] == Variant(Vector2(1.5, -2.25)));
+	CHECK(decoded["path"] == Variant(path));
+
+	decoded.clear();
+	CHECK(schema->decode(doubles, sizeof(doubles), decoded, &len) == OK);
+	CHECK(len == sizeof(doubles));
+	CHECK(decoded["position"] == Variant(Vector2(1.5, -2.25)));
+	CHECK(decoded["path"] == Variant(path));
+
+	// The data is shorter than the flag says.
+	ERR_PRINT_OFF;
+	single[0] = 1;
+	CHECK(schema->decode(single, sizeof(single), decoded) != OK);
+	doubles[0] = 0x80;
+	CHECK(schema->decode(doubles, sizeof(doubles), decoded) != OK);
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[VariantSchema] Encoding objects") {
+	Ref<VariantSchema> schema;
+	schema.instantiate();
+	REQUIRE(schema->create_from_class("Resource") == OK);
+
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name("Encoded");
+	resource->set_local_to_scene(true);
+	const PackedByteArray bytes = encode_with_schema(schema, resource);
+	REQUIRE(!bytes.is_empty());
+
+	Ref<Resource> decoded = memnew(Resource);
+	CHECK(schema->decode_object(bytes.ptr(), bytes.size(), decoded.ptr()) == OK);
+	CHECK(decoded->get_name() == "Encoded");
+	CHECK(decoded->is_local_to_scene());
+}
+
+Variant make_random_value(RandomNumberGenerator &p_rng, Variant::Type p_type) {
+	// Floats that real_t can represent exactly.
+	const real_t r = p_rng.randi_range(-100000, 100000) / 64.0;
+	switch (p_type) {
+		case Variant::BOOL:
+			return p_rng.randi_range(0, 1) == 1;
+		case Variant::INT:
+			return (int64_t(p_rng.randi()) << 32 | p_rng.randi()) >> p_rng.randi_range(0, 63);
+		case Variant::FLOAT:
+			return p_rng.randfn(0, 1e6);
+		case Variant::STRING: {
+			String string;
+			const int length = p_rng.randi_range(0, 40);
+			for (int i = 0; i < length; i++) {
+				string += char32_t(p_rng.randi_range(1, 0x2fff));
+			}
+			return string;
+		}
+		case Variant::STRING_NAME:
+			return StringName(vformat("name_%d", p_rng.randi()));
+		case Variant::VECTOR2:
+			return Vector2(r, -r);
+		case Variant::VECTOR2I:
+			return Vector2i(p_rng.randi(), p_rng.randi());
+		case Variant::RECT2:
+			return Rect2(r, 1, 2, -r);
+		case Variant::VECTOR3:
+			return Vector3(r, 0.5, -r);
+		case Variant::VECTOR3I:
+			return Vector3i(p_rng.randi(), 3, p_rng.randi());
+		case Variant::TRANSFORM2D:
+			return Transform2D(r, Vector2(r, 2));
+		case Variant::QUATERNION:
+			return Quaternion(r, 0.25, 0.5, -r);
+		case Variant::TRANSFORM3D:
+			return Transform3D(Basis(Vector3(r, 0, 1), Vector3(0, r, 0), Vector3(2, 0, r)), Vector3(r, r, 4));
+		case Variant::COLOR:
+			return Color(r, 0.5, 0.25, 1);
+		case Variant::PACKED_BYTE_ARRAY: {
+			PackedByteArray array;
+			array.resize(p_rng.randi_range(0, 300));
+			for (int i = 0; i < array.size(); i++) {
+				array.write[i] = p_rng.randi();
+			}
+			return array;
+		}
+		case Variant::PACKED_INT32_ARRAY: {
+			PackedInt32Array array;
+			array.resize(p_rng.randi_range(0, 20));
+			for (int i = 0; i < array.size(); i++) {
+				array.write[i] = p_rng.randi();
+			}
+			return array;
+		}
+		case Variant::PACKED_VECTOR3_ARRAY: {
+			PackedVector3Array array;
+			array.resize(p_rng.randi_range(0, 20));
+			for (int i = 0; i < array.size(); i++) {
+				array.write[i] = Vector3(r, i, -r);
+			}
+			return array;
+		}
+		case Variant::PACKED_STRING_ARRAY: {
+			PackedStringArray array;
+			for (int i = p_rng.randi_range(0, 5); i > 0; i--) {
+				array.push_back(itos(p_rng.randi()));
+			}
+			return array;
+		}
+		default: {
+			// Fields of any type.
+			Array array;
+			array.push_back(r);
+			array.push_back("any");
+			return array;
+		}
+	}
+}
+
+TEST_CASE("[VariantSchema] Round trip of random values") {
+	const Variant::Type types[] = {
+		Variant::BOOL,
+		Variant::INT,
+		Variant::FLOAT,
+		Variant::STRING,
+		Variant::STRING_NAME,
+		Variant::VECTOR2,
+		Variant::VECTOR2I,
+		Variant::RECT2,
+		Variant::VECTOR3,
+		Variant::VECTOR3I,
+		Variant::TRANSFORM2D,
+		Variant::QUATERNION,
+		Variant::TRANSFORM3D,
+		Variant::COLOR,
+		Variant::PACKED_BYTE_ARRAY,
+		Variant::PACKED_INT32_ARRAY,
+		Variant::PACKED_VECTOR3_ARRAY,
+		Variant::PACKED_STRING_ARRAY,
+		Variant::NIL,
+		Variant::BOOL,
+	};
+	const int type_count = sizeof(types) / sizeof(types[0]);
+
+	RandomNumberGenerator rng;
+	rng.set_seed(1234);
+
+	for (int round = 0; round < 200; round++) {
+		// A random schema, with a nested one.
+		Ref<VariantSchema> schema;
+		schema.instantiate();
+		Ref<VariantSchema> element_schema;
+		element_schema.instantiate();
+		for (int i = rng.randi_range(1, 12); i > 0; i--) {
+			element_schema->add_field(vformat("e%d", i), types[rng.randi_range(0, type_count - 1)]);
+		}
+		for (int i = rng.randi_range(1, 12); i > 0; i--) {
+			schema->add_field(vformat("f%d", i), types[rng.randi_range(0, type_count - 1)]);
+		}
+		schema->add_field("elements", Variant::ARRAY, element_schema);
+
+		Dictionary value;
+		for (int i = 0; i < schema->get_field_count() - 1; i++) {
+			value[String(schema->get_field_name(i))] = make_random_value(rng, schema->get_field_type(i));
+		}
+		Array elements;
+		for (int i = rng.randi_range(0, 3); i > 0; i--) {
+			Dictionary element;
+			for (int j = 0; j < element_schema->get_field_count(); j++) {
+				element[String(element_schema->get_field_name(j))] = make_random_value(rng, element_schema->get_field_type(j));
+			}
+			elements.push_back(element);
+		}
+		value["elements"] = elements;
+
+		const PackedByteArray bytes = encode_with_schema(schema, value);
+		REQUIRE(!bytes.is_empty());
+		Dictionary decoded;
+		CHECK(schema->decode(bytes.ptr(), bytes.size(), decoded) == OK);
+		CHECK_MESSAGE(decoded == value, vformat("Round %d should decode the value that was encoded.", round));
+
+		// Incomplete and corrupted data must fail, or decode to something.
+		ERR_PRINT_OFF;
+		const int truncated = rng.randi_range(0, bytes.size() - 1);
+		CHECK(schema->decode(bytes.ptr(), truncated, decoded) != OK);
+		PackedByteArray corrupted = bytes;
+		for (int i = 0; i < 4; i++) {
+			corrupted.write[rng.randi_range(0, corrupted.size() - 1)] = rng.randi();
+		}
+		schema->decode(corrupted.ptr(), corrupted.size(), decoded);
+		ERR_PRINT_ON;
+	}
+}
+
+void benchmark_variant_schema() {
+	const int rounds = 100000;
+	const Dictionary record = make_record(12345);
+	Ref<VariantSchema> schema;
+	schema.instantiate();
+	ERR_FAIL_COND(schema->create_from_dictionary(record) != OK);
+
+	int variant_len = 0;
+	encode_variant(record, nullptr, variant_len);
+	PackedByteArray variant_bytes;
+	variant_bytes.resize(variant_len);
+	int schema_len = 0;
+	schema->encode(record, nullptr, schema_len);
+	PackedByteArray schema_bytes;
+	schema_bytes.resize(schema_len);
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		encode_variant(record, variant_bytes.ptrw(), variant_len);
+	}
+	const double variant_encode = (OS::get_singleton()->get_ticks_usec() - t) / 1000.0;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		Variant decoded;
+		decode_variant(decoded, variant_bytes.ptr(), variant_len);
+	}
+	const double variant_decode = (OS::get_singleton()->get_ticks_usec() - t) / 1000.0;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		schema->encode(record, schema_bytes.ptrw(), schema_len);
+	}
+	const double schema_encode = (OS::get_singleton()->get_ticks_usec() - t) / 1000.0;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		Dictionary decoded;
+		schema->decode(schema_bytes.ptr(), schema_len, decoded);
+	}
+	const double schema_decode = (OS::get_singleton()->get_ticks_usec() - t) / 1000.0;
+
+	print_line(vformat("Encoding a record %d times:", rounds));
+	print_line(vformat("  encode_variant()  %4d bytes, encode %8.2f ms, decode %8.2f ms", variant_len, variant_encode, variant_decode));
+	print_line(vformat("  VariantSchema     %4d bytes, encode %8.2f ms, decode %8.2f ms", schema_len, schema_encode, schema_decode));
+}
+
+REGISTER_TEST_COMMAND("variant-schema-benchmark", &benchmark_variant_schema);
+} // namespace TestVariantSchema
+
+#endif // TEST_VARIANT_SCHEMA_H
@@ -0,0 +1,241 @@
+/*************************************************************************/
+/*  test_message_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/config/project_settings.h"
+#include "core/object/message_queue.h"
+#include "core/object/object.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+class Receiver : public Object {
+public:
+	LocalVector<Vector2i> received;
+
+	void receive(int p_thread, int p_index) {
+		received.push_back(Vector2i(p_thread, p_index));
+	}
+
+	void receive_and_push(int p_thread, int p_index) {
+		received.push_back(Vector2i(p_thread, p_index));
+		if (p_index > 0) {
+			MessageQueue::get_singleton()->push_callable(callable_mp(this, &Receiver::receive_and_push), p_thread, p_index - 1);
+		}
+	}
+};
+
+struct PushState {
+	Receiver *receiver = nullptr;
+	int thread = 0;
+	int count = 0;
+};
+
+static void push_calls(void *p_userdata) {
+	PushState *state = (PushState *)p_userdata;
+	for (int i = 0; i < state->count; i++) {
+		MessageQueue::get_singleton()->push_callable(callable_mp(state->receiver, &Receiver::receive), state->thread, i);
+	}
+}
+
+// The test runner only creates a message queue for scene tests.
+class ScopedMessageQueue {
+	MessageQueue *owned = nullptr;
+
+public:
+	ScopedMessageQueue() {
+		if (!MessageQueue::get_singleton()) {
+			owned = memnew(MessageQueue);
+		}
+		MessageQueue::get_singleton()->flush();
+	}
+
+	~ScopedMessageQueue() {
+		if (owned) {
+			memdelete(owned);
+		}
+	}
+};
+
+TEST_CASE("[MessageQueue] Calls are flushed in the order they were pushed") {
+	ScopedMessageQueue scoped_queue;
+	MessageQueue *mq = MessageQueue::get_singleton();
+	Receiver receiver;
+
+	// More than fits in a single page.
+	const int count = 5000;
+	for (int i = 0; i < count; i++) {
+		CHECK(mq->push_callable(callable_mp(&receiver, &Receiver::receive), 0, i) == OK);
+	}
+	CHECK(mq->get_stats().buffer_used > count * sizeof(Variant) * 2);
+
+	mq->flush();
+	CHECK(mq->get_stats().last_flush_messages == count);
+	REQUIRE(receiver.received.size() == count);
+	for (int i = 0; i < count; i++) {
+		CHECK_MESSAGE(receiver.received[i] == Vector2i(0, i), "Calls should be flushed in order.");
+	}
+
+	// Every kind of message is flushed.
+	receiver.received.clear();
+	mq->push_callable(callable_mp(&receiver, &Receiver::receive), 0, 0);
+	mq->push_notification(&receiver, Object::NOTIFICATION_POSTINITIALIZE);
+	mq->push_callable(callable_mp(&receiver, &Receiver::receive), 0, 1);
+	mq->flush();
+	CHECK(mq->get_stats().last_flush_messages == 3);
+	CHECK(receiver.received.size() == 2);
+}
+
+TEST_CASE("[MessageQueue] Calls pushed while flushing are flushed too") {
+	ScopedMessageQueue scoped_queue;
+	MessageQueue *mq = MessageQueue::get_singleton();
+	Receiver receiver;
+
+	// Each call pushes the next one, past the end of the first page.
+	const int count = 2000;
+	mq->push_callable(callable_mp(&receiver, &Receiver::receive_and_push), 0, count - 1);
+	mq->flush();
+	CHECK(mq->get_stats().last_flush_messages == count);
+	REQUIRE(receiver.received.size() == count);
+	for (int i = 0; i < count; i++) {
+		CHECK(receiver.received[i] == Vector2i(0, count - 1 - i));
+	}
+	CHECK(mq->get_stats().buffer_used == 0);
+}
+
+TEST_CASE("[MessageQueue] The queue grows past its size limit") {
+	ScopedMessageQueue scoped_queue;
+	MessageQueue *mq = MessageQueue::get_singleton();
+	Receiver receiver;
+
+	const uint64_t limit = uint64_t(int(GLOBAL_GET("memory/limits/message_queue/max_size_kb"))) * 1024;
+	int count = 0;
+	ERR_PRINT_OFF;
+	while (mq->get_stats().buffer_used <= limit) {
+		REQUIRE(mq->push_callable(callable_mp(&receiver, &Receiver::receive), 0, count) == OK);
+		count++;
+	}
+	CHECK(mq->push_set(&receiver, "name", "value") == OK);
+	ERR_PRINT_ON;
+
+	mq->flush();
+	CHECK(mq->get_stats().last_flush_messages == count + 1);
+	CHECK(receiver.received.size() == count);
+	CHECK(mq->get_stats().buffer_used == 0);
+}
+
+TEST_CASE("[MessageQueue] Calls pushed from several threads") {
+	ScopedMessageQueue scoped_queue;
+	MessageQueue *mq = MessageQueue::get_singleton();
+	Receiver receiver;
+
+	const int thread_count = 4;
+	const int count = 2000;
+	Thread threads[thread_count];
+	PushState states[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		states[i].receiver = &receiver;
+		states[i].thread = i;
+		states[i].count = count;
+		threads[i].start(push_calls, &states[i]);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	CHECK(mq->get_stats().thread_queues >= thread_count);
+
+	mq->flush();
+	REQUIRE(receiver.received.size() == thread_count * count);
+
+	// Each thread's calls keep their order.
+	int next_index[thread_count] = {};
+	for (uint32_t i = 0; i < receiver.received.size(); i++) {
+		const Vector2i &call = receiver.received[i];
+		REQUIRE(call.x >= 0);
+		REQUIRE(call.x < thread_count);
+		CHECK(call.y == next_index[call.x]);
+		next_index[call.x] = call.y + 1;
+	}
+
+	// The queues of the threads that exited are released once flushed.
+	CHECK(mq->get_stats().thread_queues < thread_count);
+	CHECK(mq->get_stats().max_flush_messages >= thread_count * count);
+}
+
+static void push_one_call(void *p_userdata) {
+	PushState *state = (PushState *)p_userdata;
+	MessageQueue::get_singleton()->push_callable(callable_mp(state->receiver, &Receiver::receive), state->thread, 0);
+}
+
+TEST_CASE("[MessageQueue] Threads only hold pages while they have calls queued") {
+	ScopedMessageQueue scoped_queue;
+	MessageQueue *mq = MessageQueue::get_singleton();
+	Receiver receiver;
+
+	const int thread_count = 64;
+	Thread threads[thread_count];
+	PushState states[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		states[i].receiver = &receiver;
+		states[i].thread = i;
+		threads[i].start(push_one_call, &states[i]);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	// Only the queued calls count against the limit, not the pages holding them.
+	MessageQueue::Stats stats = mq->get_stats();
+	CHECK(stats.buffer_used <= thread_count * (sizeof(Variant) * 3 + 64));
+
+	mq->flush();
+	CHECK(receiver.received.size() == thread_count);
+
+	// Every page went back to the pool.
+	stats = mq->get_stats();
+	CHECK(stats.buffer_used == 0);
+	CHECK(stats.pages == stats.pooled_pages);
+
+	// Pushing again reuses a pooled page.
+	uint32_t pages = stats.pages;
+	mq->push_callable(callable_mp(&receiver, &Receiver::receive), 0, 0);
+	CHECK(mq->get_stats().pages == pages);
+	mq->flush();
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
@@ -32,7 +32,9 @@
 #define TEST_OBJECT_H
 
 #include "core/core_string_names.h"
+#include "core/object/callable_method_pointer.h"
 #include "core/object/class_db.h"
+#include "core/object/method_handle.h"
 #include "core/object/object.h"
 #include "core/object/script_language.h"
 
@@ -275,6 +277,144 @@ TEST_CASE("[Object] Absent name getter") {
 			actual_value == Variant(),
 			"The returned value should equal nil variant.");
 }
+
+class _TestCallpObject : public Object {
+	GDCLASS(_TestCallpObject, Object);
+
+public:
+	int callp_calls = 0;
+
+	Variant callp(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) override {
+		callp_calls++;
+		return Object::callp(p_method, p_args, p_argcount, r_error);
+	}
+};
+
+TEST_CASE("[Object] Method handles") {
+	Object object;
+	// Allocated with memnew() to be registered in ClassDB.
+	_TestDerivedObject *derived = memnew(_TestDerivedObject);
+	Callable::CallError ce;
+	Variant ret;
+
+	MethodHandle set_meta("set_meta");
+	Variant name = "test";
+	Variant value = 42;
+	const Variant *args[2] = { &name, &value };
+	set_meta.call(&object, args, 2, ce);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(object.get_meta("test") == Variant(42));
+
+	MethodBind *mb = set_meta.resolve(&object);
+	CHECK(mb == ClassDB::get_method("Object", "set_meta"));
+
+	// Inherited methods resolve the same way on derived classes.
+	value = 7;
+	set_meta.call(derived, args, 2, ce);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(derived->get_meta("test") == Variant(7));
+	CHECK(set_meta.resolve(derived) == mb);
+
+	// Methods unknown to ClassDB go through Object::callp().
+	MethodHandle missing("does_not_exist");
+	missing.call(&object, nullptr, 0, ce);
+	CHECK(ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD);
+	CHECK(missing.resolve(&object) == nullptr);
+
+	// Classes overriding callp() get every call.
+	_TestCallpObject *overriding = memnew(_TestCallpObject);
+	value = 5;
+	set_meta.call(overriding, args, 2, ce);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(overriding->callp_calls == 1);
+	CHECK(overriding->get_meta("test") == Variant(5));
+	CHECK(set_meta.resolve(overriding) == nullptr);
+	Callable(overriding, "set_meta").call(args, 2, ret, ce);
+	CHECK(overriding->callp_calls == 2);
+
+	// Callables use handles too.
+	value = 3;
+	Callable(&object, "set_meta").call(args, 2, ret, ce);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(object.get_meta("test") == Variant(3));
+
+	memdelete(overriding);
+	memdelete(derived);
+}
+
+class _TestSignalReceiver : public Object {
+public:
+	Object *emitter = nullptr;
+	Callable to_connect;
+	Callable to_disconnect;
+	Vector<int> received;
+
+	void receive(int p_value) {
+		received.push_back(p_value);
+	}
+
+	void receive_bound(int p_value, int p_bound) {
+		received.push_back(p_value * 100 + p_bound);
+	}
+
+	void receive_and_change(int p_value) {
+		received.push_back(p_value);
+		if (to_connect.is_valid()) {
+			emitter->connect("test_signal", to_connect);
+		}
+		if (to_disconnect.is_valid()) {
+			emitter->disconnect("test_signal", to_disconnect);
+		}
+	}
+};
+
+TEST_CASE("[Object] Signals") {
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("test_signal", PropertyInfo(Variant::INT, "value")));
+
+	_TestSignalReceiver first;
+	_TestSignalReceiver second;
+	first.emitter = &emitter;
+
+	emitter.connect("test_signal", callable_mp(&first, &_TestSignalReceiver::receive));
+	CHECK(emitter.emit_signal("test_signal", 1) == OK);
+	CHECK(first.received.size() == 1);
+	CHECK(first.received[0] == 1);
+
+	// Connecting invalidates the cached connection list.
+	Vector<Variant> binds;
+	binds.push_back(7);
+	emitter.connect("test_signal", callable_mp(&second, &_TestSignalReceiver::receive_bound), binds);
+	emitter.emit_signal("test_signal", 2);
+	CHECK(first.received.size() == 2);
+	REQUIRE(second.received.size() == 1);
+	CHECK(second.received[0] == 207);
+
+	// Changes made while emitting only apply to the next emission.
+	emitter.disconnect("test_signal", callable_mp(&first, &_TestSignalReceiver::receive));
+	emitter.connect("test_signal", callable_mp(&first, &_TestSignalReceiver::receive_and_change));
+	first.to_connect = callable_mp(&first, &_TestSignalReceiver::receive);
+	first.to_disconnect = callable_mp(&second, &_TestSignalReceiver::receive_bound);
+	emitter.emit_signal("test_signal", 3);
+	CHECK(first.received.size() == 3);
+	CHECK(second.received.size() == 2);
+	CHECK(second.received[1] == 307);
+
+	first.to_connect = Callable();
+	first.to_disconnect = Callable();
+	emitter.emit_signal("test_signal", 4);
+	CHECK(first.received.size() == 5);
+	CHECK(second.received.size() == 2);
+
+	// One shot connections are removed after the emission.
+	emitter.connect("test_signal", callable_mp(&second, &_TestSignalReceiver::receive), Vector<Variant>(), Object::CONNECT_ONESHOT);
+	emitter.emit_signal("test_signal", 5);
+	emitter.emit_signal("test_signal", 6);
+	CHECK(second.received.size() == 3);
+	CHECK(second.received[2] == 5);
+	CHECK_FALSE(emitter.is_connected("test_signal", callable_mp(&second, &_TestSignalReceiver::receive)));
+}
+
 } // namespace TestObject
 
 #endif // TEST_OBJECT_H
@@ -0,0 +1,194 @@
+/*************************************************************************/
+/*  test_arena_allocator.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ARENA_ALLOCATOR_H
+#define TEST_ARENA_ALLOCATOR_H
+
+#include "core/os/arena_allocator.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestArenaAllocator {
+
+TEST_CASE("[ArenaAllocator] Heap fallback outside of scopes") {
+	CHECK_FALSE(ThreadArena::is_active());
+
+	void *mem = ThreadArena::alloc(64);
+	REQUIRE(mem != nullptr);
+	CHECK_FALSE(ThreadArena::owns(mem));
+	memset(mem, 0xAB, 64);
+
+	mem = ThreadArena::realloc(mem, 4096);
+	REQUIRE(mem != nullptr);
+	CHECK(((uint8_t *)mem)[63] == 0xAB);
+	ThreadArena::free(mem);
+}
+
+TEST_CASE("[ArenaAllocator] Scope rewinds allocations") {
+	ThreadArena::Mark before = ThreadArena::get_mark();
+	{
+		ArenaScope scope;
+		CHECK(ThreadArena::is_active());
+
+		void *a = ThreadArena::alloc(24);
+		void *b = ThreadArena::alloc(100);
+		CHECK(ThreadArena::owns(a));
+		CHECK(ThreadArena::owns(b));
+		CHECK(((uintptr_t)a % ThreadArena::ALIGN) == 0);
+		CHECK(((uintptr_t)b % ThreadArena::ALIGN) == 0);
+		CHECK(ThreadArena::get_mark().in_use > before.in_use);
+
+		// Freeing the most recent allocation gives its space back.
+		ThreadArena::free(b);
+		void *c = ThreadArena::alloc(100);
+		CHECK(c == b);
+
+		{
+			ArenaScope nested;
+			ThreadArena::alloc(ThreadArena::CHUNK_SIZE * 2);
+		}
+		void *d = ThreadArena::alloc(8);
+		CHECK(ThreadArena::owns(d));
+		CHECK((uint8_t *)d > (uint8_t *)c);
+	}
+	CHECK_FALSE(ThreadArena::is_active());
+	CHECK(ThreadArena::get_mark().in_use == before.in_use);
+	ThreadArena::frame_reset();
+}
+
+TEST_CASE("[ArenaAllocator] LocalVector adapter") {
+	ArenaScope scope;
+
+	LocalVector<int, uint32_t, false, false, ArenaAllocator> vector;
+	vector.push_back(0);
+	const int *first = vector.ptr();
+	for (int i = 1; i < 1000; i++) {
+		vector.push_back(i);
+	}
+	// Being the last allocation, the buffer grows in place.
+	CHECK(vector.ptr() == first);
+	CHECK(ThreadArena::owns(vector.ptr()));
+
+	bool all_match = true;
+	for (int i = 0; i < 1000; i++) {
+		all_match = all_match && vector[i] == i;
+	}
+	CHECK(all_match);
+
+	// Growing a buffer that is no longer the last allocation moves it.
+	LocalVector<int, uint32_t, false, false, ArenaAllocator> other;
+	other.push_back(1);
+	vector.resize(5000);
+	CHECK(vector.ptr() != first);
+	CHECK(vector[999] == 999);
+	CHECK(other[0] == 1);
+}
+
+TEST_CASE("[ArenaAllocator] Growing inside a nested scope") {
+	ArenaScope scope;
+
+	LocalVector<int, uint32_t, false, false, ArenaAllocator> vector;
+	vector.push_back(42);
+	CHECK(ThreadArena::owns(vector.ptr()));
+	{
+		ArenaScope nested;
+		// The nested scope would reclaim a new arena buffer, so it moves to the heap.
+		for (int i = 0; i < 1000; i++) {
+			vector.push_back(i);
+		}
+		CHECK_FALSE(ThreadArena::owns(vector.ptr()));
+	}
+	void *other = ThreadArena::alloc(4096);
+	memset(other, 0, 4096);
+	CHECK(vector[0] == 42);
+	CHECK(vector[1000] == 999);
+}
+
+TEST_CASE("[ArenaAllocator] HashMap adapter") {
+	ArenaScope scope;
+
+	HashMap<int, int, HashMapHasherDefault, HashMapComparatorDefault<int>, ArenaTypedAllocator<HashMapElement<int, int>>> map;
+	for (int i = 0; i < 500; i++) {
+		map.insert(i, i * 2);
+	}
+	CHECK(map.size() == 500);
+	CHECK(map[250] == 500);
+	CHECK(ThreadArena::owns(map.getptr(250)));
+	map.erase(250);
+	CHECK_FALSE(map.has(250));
+	CHECK(map.has(251));
+}
+
+TEST_CASE("[ArenaAllocator] Memory counters") {
+	static MemoryCounters counters("Test");
+	counters.reset();
+
+	{
+		ArenaScope scope(&counters);
+		CHECK(ThreadArena::get_counters() == &counters);
+		ThreadArena::alloc(32);
+		ThreadArena::alloc(32);
+		{
+			// Scopes without their own counters keep attributing to the outer ones.
+			ArenaScope nested;
+			ThreadArena::alloc(64);
+		}
+
+		// Arena chunks themselves come from the heap, so only look at the difference.
+		uint64_t heap_allocs = counters.heap_allocs.get();
+		uint64_t heap_bytes = counters.heap_bytes.get();
+		void *mem = memalloc(16);
+		memfree(mem);
+		heap_allocs = counters.heap_allocs.get() - heap_allocs;
+		heap_bytes = counters.heap_bytes.get() - heap_bytes;
+#ifdef DEBUG_ENABLED
+		CHECK(heap_allocs == 1);
+		CHECK(heap_bytes == 16);
+#else
+		CHECK(heap_allocs == 0);
+#endif
+	}
+	CHECK(ThreadArena::get_counters() == nullptr);
+
+	CHECK(counters.arena_allocs.get() == 3);
+	CHECK(counters.arena_bytes.get() == 128);
+
+	bool registered = false;
+	for (MemoryCounters *c = MemoryCounters::get_first(); c; c = c->get_next()) {
+		registered = registered || c == &counters;
+	}
+	CHECK(registered);
+}
+
+} // namespace TestArenaAllocator
+
+#endif // TEST_ARENA_ALLOCATOR_H
@@ -0,0 +1,194 @@
+/*************************************************************************/
+/*  test_small_block_allocator.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SMALL_BLOCK_ALLOCATOR_H
+#define TEST_SMALL_BLOCK_ALLOCATOR_H
+
+#include "core/os/arena_allocator.h"
+#include "core/os/os.h"
+#include "core/os/small_block_allocator.h"
+#include "core/os/thread.h"
+#include "core/string/ustring.h"
+#include "core/templates/vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSmallBlockAllocator {
+
+TEST_CASE("[SmallBlockAllocator] Allocation and reuse") {
+	void *a = SmallBlockAllocator::alloc(16);
+	void *b = SmallBlockAllocator::alloc(128);
+	REQUIRE(a != nullptr);
+	REQUIRE(b != nullptr);
+	CHECK(((uintptr_t)a % PAD_ALIGN) == 0);
+	CHECK(((uintptr_t)b % PAD_ALIGN) == 0);
+
+	// The prefix belongs to the caller, like with Memory::alloc_static(size, true).
+	memset(((uint8_t *)a) - PAD_ALIGN, 0xCD, PAD_ALIGN + 16);
+	memset(((uint8_t *)b) - PAD_ALIGN, 0xCD, PAD_ALIGN + 128);
+
+	SmallBlockAllocator::free(a, 16);
+	void *c = SmallBlockAllocator::alloc(8);
+	CHECK_MESSAGE(c == a, "Freed blocks should be reused first.");
+
+	SmallBlockAllocator::free(c, 8);
+	SmallBlockAllocator::free(b, 128);
+
+	CHECK(SmallBlockAllocator::get_capacity(1) == 16);
+	CHECK(SmallBlockAllocator::get_capacity(33) == 64);
+	CHECK(SmallBlockAllocator::get_capacity(128) == 128);
+	CHECK(SmallBlockAllocator::get_stats().slabs > 0);
+}
+
+static void free_blocks(void *p_userdata) {
+	Vector<void *> *blocks = (Vector<void *> *)p_userdata;
+	for (int i = 0; i < blocks->size(); i++) {
+		SmallBlockAllocator::free((*blocks)[i], 32);
+	}
+}
+
+TEST_CASE("[SmallBlockAllocator] Freeing from another thread") {
+	Vector<void *> blocks;
+	for (int i = 0; i < 1000; i++) {
+		void *block = SmallBlockAllocator::alloc(32);
+		memset(block, i & 0xFF, 32);
+		blocks.push_back(block);
+	}
+
+	Thread thread;
+	thread.start(free_blocks, &blocks);
+	thread.wait_to_finish();
+
+	// The other thread's cache was given back when it exited.
+	CHECK(SmallBlockAllocator::get_stats().free_blocks >= 1000);
+}
+
+TEST_CASE("[CowData] Moving between pooled and heap storage") {
+	String s = "a";
+	for (int i = 0; i < 100; i++) {
+		s += String::chr('a' + (i % 26));
+	}
+	CHECK(s.length() == 101);
+	CHECK(s.begins_with("aabc"));
+	CHECK(s.ends_with("tuv"));
+
+	s = s.substr(0, 3);
+	CHECK(s == "aab");
+
+	Vector<int> v;
+	for (int i = 0; i < 100; i++) {
+		v.push_back(i);
+	}
+	v.resize(2);
+	CHECK(v.size() == 2);
+	CHECK(v[1] == 1);
+	v.resize(64);
+	CHECK(v[1] == 1);
+}
+
+TEST_CASE("[CowData] Copy on write for pooled storage") {
+	String a = "short";
+	String b = a;
+	CHECK(a.ptr() == b.ptr());
+
+	b += "er";
+	CHECK(a == "short");
+	CHECK(b == "shorter");
+
+	Vector<uint8_t> va;
+	va.push_back(1);
+	Vector<uint8_t> vb = va;
+	vb.set(0, 2);
+	CHECK(va[0] == 1);
+	CHECK(vb[0] == 2);
+}
+
+// Allocation count benchmark for common String operations, run with
+// `godot --test string-alloc-benchmark`. Every pooled allocation used to be a
+// call into malloc, heap allocations are the ones still reaching it.
+
+template <class F>
+void benchmark_string_op(const String &p_name, int p_rounds, F p_op) {
+	static MemoryCounters counters("String benchmark");
+	counters.reset();
+
+	OS *os = OS::get_singleton();
+	int checksum = 0;
+
+	uint64_t t = os->get_ticks_usec();
+	{
+		ArenaScope scope(&counters);
+		for (int i = 0; i < p_rounds; i++) {
+			checksum += p_op(i);
+		}
+	}
+	const uint64_t usec = os->get_ticks_usec() - t;
+
+	print_line(vformat("  %-10s %8.1f ns/op", p_name, usec * 1000.0 / p_rounds) +
+			vformat("  heap %6.2f/op  pooled %6.2f/op  (%d)", double(counters.heap_allocs.get()) / p_rounds, double(counters.pool_allocs.get()) / p_rounds, checksum));
+}
+
+void benchmark_string_allocations() {
+	const int rounds = 100000;
+	const String path = "Root/Player/Skeleton3D/BoneAttachment3D/CollisionShape3D";
+	const String csv = "position,rotation,scale,visible,name";
+
+	print_line("String operations:");
+	benchmark_string_op("split", rounds, [&](int i) {
+		return csv.split(",").size();
+	});
+	benchmark_string_op("replace", rounds, [&](int i) {
+		return path.replace("3D", "2D").length();
+	});
+	benchmark_string_op("format", rounds, [&](int i) {
+		Dictionary values;
+		values["name"] = "Node";
+		values["index"] = i;
+		return String("{name}_{index}").format(values).length();
+	});
+	benchmark_string_op("vformat", rounds, [&](int i) {
+		return vformat("Node_%d", i).length();
+	});
+	benchmark_string_op("concat", rounds, [&](int i) {
+		return (String("Node") + itos(i)).length();
+	});
+	benchmark_string_op("path_join", rounds, [&](int i) {
+		return path.get_base_dir().plus_file("Mesh").length();
+	});
+
+	SmallBlockAllocator::Stats stats = SmallBlockAllocator::get_stats();
+	print_line(vformat("Small block pool: %d slabs (%s), %d free blocks.", stats.slabs, String::humanize_size(stats.slab_bytes), stats.free_blocks));
+}
+
+REGISTER_TEST_COMMAND("string-alloc-benchmark", &benchmark_string_allocations);
+
+} // namespace TestSmallBlockAllocator
+
+#endif // TEST_SMALL_BLOCK_ALLOCATOR_H
@@ -0,0 +1,106 @@
+/*************************************************************************/
+/*  test_string_name.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName from_cstring = StringName("test_string_name_interning");
+	const StringName from_string = StringName(String("test_string_name_interning"));
+	const StringName from_static = StringName(StaticCString::create("test_string_name_interning"));
+
+	CHECK_MESSAGE(from_cstring.data_unique_pointer() == from_string.data_unique_pointer(), "Equal names should share the same entry.");
+	CHECK_MESSAGE(from_cstring.data_unique_pointer() == from_static.data_unique_pointer(), "Equal names should share the same entry.");
+	CHECK(from_cstring == "test_string_name_interning");
+
+	CHECK(StringName::search("test_string_name_interning") == from_cstring);
+	CHECK(StringName::search(U"test_string_name_interning") == from_cstring);
+	CHECK(StringName::search(String("test_string_name_interning")) == from_cstring);
+	CHECK_FALSE(StringName::search("test_string_name_never_interned"));
+}
+
+TEST_CASE("[StringName] Names are re-created after being freed") {
+	const StringName::TableStats before = StringName::get_table_stats();
+	{
+		const StringName name = StringName("test_string_name_transient");
+		CHECK(StringName::get_table_stats().entries == before.entries + 1);
+		CHECK(StringName::get_table_stats().inserts == before.inserts + 1);
+	}
+	CHECK(StringName::get_table_stats().entries == before.entries);
+	CHECK_FALSE(StringName::search("test_string_name_transient"));
+
+	const StringName name = StringName("test_string_name_transient");
+	CHECK(name == "test_string_name_transient");
+	CHECK(StringName::get_table_stats().inserts == before.inserts + 2);
+}
+
+struct ConcurrentInterner {
+	static constexpr uint32_t NAME_COUNT = 64;
+	const void *seen[NAME_COUNT] = {};
+	SafeNumeric<uint32_t> mismatches;
+
+	void intern(uint32_t p_index, void *p_userdata) {
+		const uint32_t name_index = p_index % NAME_COUNT;
+		// Alternate construction paths, all of them must resolve to the same entry.
+		StringName name = (p_index & 1) ? StringName(vformat("test_string_name_concurrent_%d", name_index)) : StringName(("test_string_name_concurrent_" + itos(name_index)).utf8().get_data());
+		if (seen[name_index] != name.data_unique_pointer()) {
+			mismatches.increment();
+		}
+	}
+};
+
+TEST_CASE("[StringName] Concurrent interning") {
+	ConcurrentInterner interner;
+	Vector<StringName> names;
+	for (uint32_t i = 0; i < ConcurrentInterner::NAME_COUNT; i++) {
+		names.push_back(StringName(vformat("test_string_name_concurrent_%d", i)));
+		interner.seen[i] = names[i].data_unique_pointer();
+	}
+
+	WorkerThreadPool::get_singleton()->do_work(ConcurrentInterner::NAME_COUNT * 64, &interner, &ConcurrentInterner::intern, (void *)nullptr);
+	CHECK_MESSAGE(interner.mismatches.get() == 0, "Names interned from several threads should resolve to the existing entries.");
+
+	const StringName::TableStats stats = StringName::get_table_stats();
+	CHECK(stats.entries >= ConcurrentInterner::NAME_COUNT);
+	CHECK(stats.buckets_used > 0);
+	CHECK(stats.buckets_used <= stats.entries);
+	CHECK(stats.longest_chain >= 1);
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
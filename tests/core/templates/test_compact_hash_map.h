@@ -0,0 +1,167 @@
+/*************************************************************************/
+/*  test_compact_hash_map.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_COMPACT_HASH_MAP_H
+#define TEST_COMPACT_HASH_MAP_H
+
+#include "core/templates/compact_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCompactHashMap {
+
+TEST_CASE("[CompactHashMap] Insert element") {
+	CompactHashMap<int, int> map;
+	CompactHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+}
+
+TEST_CASE("[CompactHashMap] Overwrite element") {
+	CompactHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(42, 1234);
+
+	CHECK(map[42] == 1234);
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("[CompactHashMap] Erase") {
+	CompactHashMap<int, int> map;
+	CompactHashMap<int, int>::Iterator e = map.insert(42, 84);
+	map.insert(43, 86);
+	map.remove(e);
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+	CHECK(map.erase(43));
+	CHECK_FALSE(map.erase(43));
+	CHECK(map.is_empty());
+	CHECK(map.begin() == map.end());
+}
+
+TEST_CASE("[CompactHashMap] Iteration keeps insertion order") {
+	CompactHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 12385);
+	map.insert(0, 12934);
+	map.insert(123485, 1238888);
+	map.insert(123, 111111);
+
+	Vector<Pair<int, int>> expected;
+	expected.push_back(Pair<int, int>(42, 84));
+	expected.push_back(Pair<int, int>(123, 111111));
+	expected.push_back(Pair<int, int>(0, 12934));
+	expected.push_back(Pair<int, int>(123485, 1238888));
+
+	int idx = 0;
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(expected[idx] == Pair<int, int>(E.key, E.value));
+		++idx;
+	}
+	CHECK(idx == 4);
+
+	const CompactHashMap<int, int> const_map = map;
+	idx = 0;
+	for (const KeyValue<int, int> &E : const_map) {
+		CHECK(expected[idx] == Pair<int, int>(E.key, E.value));
+		++idx;
+	}
+	CHECK(idx == 4);
+	CHECK(const_map.last()->key == 123485);
+	CHECK(const_map.get_at_index(2)->key == 0);
+}
+
+TEST_CASE("[CompactHashMap] Erase while iterating and reuse") {
+	CompactHashMap<int, int> map;
+	const int count = 1000;
+	for (int i = 0; i < count; i++) {
+		map.insert(i, i);
+	}
+
+	for (CompactHashMap<int, int>::Iterator E = map.begin(); E != map.end(); ++E) {
+		if (E->key % 3) {
+			map.remove(E);
+		}
+	}
+	CHECK(map.size() == (count + 2) / 3);
+	CHECK(map.get_at_index(1)->key == 3);
+
+	// Erased entries get reclaimed instead of growing forever.
+	const uint32_t capacity = map.get_capacity();
+	for (int i = 0; i < count * 10; i++) {
+		map.insert(count + i, i);
+		map.erase(count + i);
+	}
+	CHECK(map.get_capacity() == capacity);
+
+	int previous = -1;
+	bool ordered = true;
+	for (const KeyValue<int, int> &E : map) {
+		if (E.key <= previous || E.key % 3) {
+			ordered = false;
+		}
+		previous = E.key;
+	}
+	CHECK(ordered);
+
+	// Erasing the last elements while iterating.
+	for (CompactHashMap<int, int>::Iterator E = map.begin(); E != map.end(); ++E) {
+		map.remove(E);
+	}
+	CHECK(map.is_empty());
+}
+
+TEST_CASE("[CompactHashMap] Pointers stay valid when inserting") {
+	CompactHashMap<int, int> map;
+	map.insert(0, 1234);
+	map.insert(1, 5678);
+	const int *first = map.getptr(0);
+	map.erase(1);
+
+	for (int i = 2; i < 1000; i++) {
+		map.insert(i, i);
+	}
+	CHECK(map.getptr(0) == first);
+	CHECK(*first == 1234);
+
+	// Reading a value while inserting another key must not use freed memory.
+	map[1000] = map[0];
+	CHECK(map[1000] == 1234);
+	CHECK(map.getptr(0) == first);
+}
+
+} // namespace TestCompactHashMap
+
+#endif // TEST_COMPACT_HASH_MAP_H
@@ -0,0 +1,308 @@
+/*************************************************************************/
+/*  test_flat_hash_map.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FLAT_HASH_MAP_H
+#define TEST_FLAT_HASH_MAP_H
+
+#include "core/os/os.h"
+#include "core/templates/flat_hash_map.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/oa_hash_map.h"
+#include "core/templates/rb_map.h"
+#include "core/templates/rid.h"
+#include "core/variant/variant.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFlatHashMap {
+
+TEST_CASE("[FlatHashMap] Insert element") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+}
+
+TEST_CASE("[FlatHashMap] Overwrite element") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(42, 1234);
+
+	CHECK(map[42] == 1234);
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("[FlatHashMap] Erase via element") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+	map.remove(e);
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+}
+
+TEST_CASE("[FlatHashMap] Erase via key") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	CHECK(map.erase(42));
+	CHECK_FALSE(map.erase(42));
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+	CHECK(map.is_empty());
+}
+
+TEST_CASE("[FlatHashMap] Size") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 84);
+	map.insert(123, 84);
+	map.insert(0, 84);
+	map.insert(123485, 84);
+
+	CHECK(map.size() == 4);
+}
+
+TEST_CASE("[FlatHashMap] Iteration") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 12385);
+	map.insert(0, 12934);
+	map.insert(123485, 1238888);
+	map.insert(123, 111111);
+
+	// Order is unspecified, only check every pair is visited once.
+	HashMap<int, int> expected;
+	expected.insert(42, 84);
+	expected.insert(123, 111111);
+	expected.insert(0, 12934);
+	expected.insert(123485, 1238888);
+
+	int count = 0;
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(expected.has(E.key));
+		CHECK(expected[E.key] == E.value);
+		expected.erase(E.key);
+		count++;
+	}
+	CHECK(count == 4);
+	CHECK(expected.is_empty());
+
+	const FlatHashMap<int, int> const_map = map;
+	count = 0;
+	for (const KeyValue<int, int> &E : const_map) {
+		CHECK(map[E.key] == E.value);
+		count++;
+	}
+	CHECK(count == 4);
+}
+
+TEST_CASE("[FlatHashMap] Many elements with erase and reinsertion") {
+	FlatHashMap<int, int> map;
+	const int count = 10000;
+	for (int i = 0; i < count; i++) {
+		map.insert(i, i * 2);
+	}
+	CHECK(map.size() == count);
+	CHECK(map.get_capacity() >= count);
+
+	// Erase while iterating, this leaves tombstones behind.
+	for (FlatHashMap<int, int>::Iterator E = map.begin(); E != map.end(); ++E) {
+		if (E->key % 2) {
+			map.remove(E);
+		}
+	}
+	CHECK(map.size() == count / 2);
+
+	bool all_found = true;
+	for (int i = 0; i < count; i++) {
+		const int *value = map.getptr(i);
+		if ((i % 2 == 0) != (value != nullptr) || (value && *value != i * 2)) {
+			all_found = false;
+		}
+	}
+	CHECK_MESSAGE(all_found, "Only even keys should remain, with their values intact.");
+
+	// Churn through insertions and erasures, tombstones must not make the map grow forever.
+	const uint32_t capacity = map.get_capacity();
+	for (int i = 0; i < count * 10; i++) {
+		map.insert(count + i, i);
+		map.erase(count + i);
+	}
+	CHECK(map.size() == count / 2);
+	CHECK(map.get_capacity() == capacity);
+	CHECK(map.has(0));
+	CHECK(!map.has(1));
+
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK(!map.has(0));
+}
+
+TEST_CASE("[FlatHashMap] Engine key types") {
+	FlatHashMap<StringName, int> string_names;
+	string_names[StringName("position")] = 1;
+	string_names[StringName("rotation")] = 2;
+	CHECK(string_names[StringName("position")] == 1);
+	CHECK(string_names.getptr(StringName("scale")) == nullptr);
+
+	FlatHashMap<Variant, Variant, VariantHasher, VariantComparator> variants;
+	variants.insert(1, "one");
+	variants.insert("one", 1);
+	variants.insert(Vector2(1, 2), Vector3(1, 2, 3));
+	CHECK(variants[1] == Variant("one"));
+	CHECK(variants["one"] == Variant(1));
+	CHECK(variants[Vector2(1, 2)] == Variant(Vector3(1, 2, 3)));
+	CHECK(variants.size() == 3);
+}
+
+// Benchmark comparing the engine maps, run with `godot --test hash-map-benchmark`.
+
+struct HashMapOps {
+	template <class M, class K>
+	static _FORCE_INLINE_ void insert(M &p_map, const K &p_key, int p_value) { p_map.insert(p_key, p_value); }
+	template <class M, class K>
+	static _FORCE_INLINE_ bool lookup(M &p_map, const K &p_key) { return p_map.getptr(p_key) != nullptr; }
+	template <class M, class K>
+	static _FORCE_INLINE_ void erase(M &p_map, const K &p_key) { p_map.erase(p_key); }
+};
+
+struct OAHashMapOps {
+	template <class M, class K>
+	static _FORCE_INLINE_ void insert(M &p_map, const K &p_key, int p_value) { p_map.insert(p_key, p_value); }
+	template <class M, class K>
+	static _FORCE_INLINE_ bool lookup(M &p_map, const K &p_key) { return p_map.lookup_ptr(p_key) != nullptr; }
+	template <class M, class K>
+	static _FORCE_INLINE_ void erase(M &p_map, const K &p_key) { p_map.remove(p_key); }
+};
+
+struct RBMapOps {
+	template <class M, class K>
+	static _FORCE_INLINE_ void insert(M &p_map, const K &p_key, int p_value) { p_map.insert(p_key, p_value); }
+	template <class M, class K>
+	static _FORCE_INLINE_ bool lookup(M &p_map, const K &p_key) { return p_map.find(p_key) != nullptr; }
+	template <class M, class K>
+	static _FORCE_INLINE_ void erase(M &p_map, const K &p_key) { p_map.erase(p_key); }
+};
+
+template <class M, class Ops, class K>
+void benchmark_map(const String &p_name, const Vector<K> &p_keys, const Vector<K> &p_missing, int p_rounds) {
+	OS *os = OS::get_singleton();
+	M map;
+	uint32_t found = 0;
+
+	uint64_t t = os->get_ticks_usec();
+	for (int i = 0; i < p_keys.size(); i++) {
+		Ops::insert(map, p_keys[i], i);
+	}
+	const uint64_t insert_usec = os->get_ticks_usec() - t;
+
+	t = os->get_ticks_usec();
+	for (int r = 0; r < p_rounds; r++) {
+		for (int i = 0; i < p_keys.size(); i++) {
+			found += Ops::lookup(map, p_keys[i]);
+		}
+	}
+	const uint64_t hit_usec = os->get_ticks_usec() - t;
+
+	t = os->get_ticks_usec();
+	for (int r = 0; r < p_rounds; r++) {
+		for (int i = 0; i < p_missing.size(); i++) {
+			found += Ops::lookup(map, p_missing[i]);
+		}
+	}
+	const uint64_t miss_usec = os->get_ticks_usec() - t;
+
+	t = os->get_ticks_usec();
+	for (int i = 0; i < p_keys.size(); i++) {
+		Ops::erase(map, p_keys[i]);
+	}
+	const uint64_t erase_usec = os->get_ticks_usec() - t;
+
+	// Normalize to nanoseconds per operation so sizes can be compared.
+	const double ops = p_keys.size();
+	print_line(vformat("  %-12s", p_name) +
+			vformat(" insert %7.1f ns  erase %7.1f ns", insert_usec * 1000.0 / ops, erase_usec * 1000.0 / ops) +
+			vformat("  hit %7.1f ns  miss %7.1f ns  (%d found)", hit_usec * 1000.0 / (ops * p_rounds), miss_usec * 1000.0 / (ops * p_rounds), found));
+}
+
+template <class K, class H = HashMapHasherDefault, class C = HashMapComparatorDefault<K>>
+void benchmark_key_type(const String &p_key_type, const Vector<K> &p_keys, const Vector<K> &p_missing) {
+	// Do about the same amount of lookups regardless of the size.
+	const int rounds = MAX(1, 1000000 / p_keys.size());
+
+	print_line(vformat("%s keys, %d elements:", p_key_type, p_keys.size()));
+	benchmark_map<FlatHashMap<K, int, H, C>, HashMapOps>("FlatHashMap", p_keys, p_missing, rounds);
+	benchmark_map<HashMap<K, int, H, C>, HashMapOps>("HashMap", p_keys, p_missing, rounds);
+	benchmark_map<OAHashMap<K, int, H, C>, OAHashMapOps>("OAHashMap", p_keys, p_missing, rounds);
+	benchmark_map<RBMap<K, int>, RBMapOps>("RBMap", p_keys, p_missing, rounds);
+}
+
+void benchmark_hash_maps() {
+	const int sizes[] = { 16, 1000, 100000 };
+
+	for (const int size : sizes) {
+		Vector<StringName> string_names;
+		Vector<StringName> missing_string_names;
+		Vector<RID> rids;
+		Vector<RID> missing_rids;
+		Vector<Variant> variants;
+		Vector<Variant> missing_variants;
+
+		for (int i = 0; i < size; i++) {
+			// Property-like names and sequential RIDs, as produced by RID_Owner.
+			string_names.push_back(StringName(vformat("property_%d", i)));
+			missing_string_names.push_back(StringName(vformat("missing_property_%d", i)));
+			rids.push_back(RID::from_uint64(i + 1));
+			missing_rids.push_back(RID::from_uint64(size + i + 1));
+			// Dictionary-like mix of String and int keys.
+			if (i % 2) {
+				variants.push_back(vformat("key_%d", i));
+				missing_variants.push_back(vformat("missing_key_%d", i));
+			} else {
+				variants.push_back(i);
+				missing_variants.push_back(-i - 1);
+			}
+		}
+
+		benchmark_key_type("StringName", string_names, missing_string_names);
+		benchmark_key_type("RID", rids, missing_rids);
+		benchmark_key_type<Variant, VariantHasher, VariantComparator>("Variant", variants, missing_variants);
+	}
+}
+
+REGISTER_TEST_COMMAND("hash-map-benchmark", &benchmark_hash_maps);
+
+} // namespace TestFlatHashMap
+
+#endif // TEST_FLAT_HASH_MAP_H
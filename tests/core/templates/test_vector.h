@@ -530,6 +530,58 @@ TEST_CASE("[Vector] Operators") {
 	CHECK(vector != vector_other);
 }
 
+class TestCowDataOwner : public CowDataOwner {
+public:
+	int retained = 0;
+
+	virtual void retain() override { retained++; }
+	virtual void release() override { retained--; }
+};
+
+TEST_CASE("[Vector] Adopt external memory") {
+	TestCowDataOwner owner;
+	alignas(16) uint8_t memory[CowData<int>::ADOPTED_HEADER_SIZE + 4 * sizeof(int)] = {};
+	int *data = (int *)(memory + CowData<int>::ADOPTED_HEADER_SIZE);
+	for (int i = 0; i < 4; i++) {
+		data[i] = i;
+	}
+
+	{
+		Vector<int> vector;
+		vector.adopt(data, 4, &owner);
+		CHECK(owner.retained == 1);
+		CHECK(vector.size() == 4);
+		CHECK(vector.ptr() == data);
+		CHECK(vector[3] == 3);
+
+		// Copies share the adopted memory, adopting it again too.
+		Vector<int> copy = vector;
+		CHECK(copy.ptr() == data);
+		Vector<int> adopted_again;
+		adopted_again.adopt(data, 4, &owner);
+		CHECK(adopted_again.ptr() == data);
+		CHECK(owner.retained == 1);
+
+		// Writing copies it first.
+		copy.write[0] = 10;
+		CHECK(copy.ptr() != data);
+		CHECK(copy[0] == 10);
+		CHECK(data[0] == 0);
+		copy.push_back(4);
+		CHECK(copy.size() == 5);
+		CHECK(vector.size() == 4);
+	}
+	CHECK_MESSAGE(owner.retained == 0, "The owner should be released along with the last copy.");
+
+	// It can be adopted again once released.
+	Vector<int> vector;
+	vector.adopt(data, 4, &owner);
+	CHECK(owner.retained == 1);
+	CHECK(vector[2] == 2);
+	vector.clear();
+	CHECK(owner.retained == 0);
+}
+
 } // namespace TestVector
 
 #endif // TEST_VECTOR_H
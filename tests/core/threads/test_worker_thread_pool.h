@@ -0,0 +1,135 @@
+/*************************************************************************/
+/*  test_worker_thread_pool.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_WORKER_THREAD_POOL_H
+#define TEST_WORKER_THREAD_POOL_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/safe_refcount.h"
+
+#include "tests/test_macros.h"
+
+namespace TestWorkerThreadPool {
+
+struct ElementCounter {
+	LocalVector<SafeNumeric<uint32_t>> counts;
+
+	void process(uint32_t p_index, void *p_userdata) {
+		counts[p_index].increment();
+	}
+};
+
+TEST_CASE("[WorkerThreadPool] Group task processes every element once") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	REQUIRE(pool);
+
+	const uint32_t count = 1000;
+	ElementCounter counter;
+	counter.counts.resize(count);
+
+	WorkerThreadPool::GroupID group = pool->add_template_group_task(&counter, &ElementCounter::process, (void *)nullptr, count);
+	pool->wait_for_group_task_completion(group);
+
+	uint32_t processed_once = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (counter.counts[i].get() == 1) {
+			processed_once++;
+		}
+	}
+	CHECK_MESSAGE(processed_once == count, "Every element should be processed exactly once.");
+
+	pool->do_work(count, &counter, &ElementCounter::process, (void *)nullptr);
+	CHECK_MESSAGE(counter.counts[count - 1].get() == 2, "do_work() should run the group and wait for it.");
+
+	WorkerThreadPool::GroupID empty_group = pool->add_template_group_task(&counter, &ElementCounter::process, (void *)nullptr, 0);
+	CHECK(pool->is_group_task_completed(empty_group));
+	pool->wait_for_group_task_completion(empty_group);
+}
+
+struct OrderRecorder {
+	SafeNumeric<uint32_t> sequence;
+	uint32_t order[3] = {};
+
+	void record(int p_step) {
+		order[p_step] = sequence.increment();
+	}
+};
+
+TEST_CASE("[WorkerThreadPool] Tasks start after their dependencies") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	REQUIRE(pool);
+
+	OrderRecorder recorder;
+	Vector<WorkerThreadPool::TaskID> dependencies;
+
+	WorkerThreadPool::TaskID first = pool->add_template_task(&recorder, &OrderRecorder::record, 0);
+	dependencies.push_back(first);
+	WorkerThreadPool::TaskID second = pool->add_template_task(&recorder, &OrderRecorder::record, 1, WorkerThreadPool::PRIORITY_HIGH, String(), dependencies);
+	dependencies.push_back(second);
+	WorkerThreadPool::TaskID third = pool->add_template_task(&recorder, &OrderRecorder::record, 2, WorkerThreadPool::PRIORITY_LOW, String(), dependencies);
+
+	pool->wait_for_task_completion(third);
+	pool->wait_for_task_completion(second);
+	pool->wait_for_task_completion(first);
+
+	CHECK(recorder.order[0] == 1);
+	CHECK(recorder.order[1] == 2);
+	CHECK(recorder.order[2] == 3);
+}
+
+struct NestedWork {
+	ElementCounter counter;
+	SafeNumeric<uint32_t> outer_done;
+
+	void outer(uint32_t p_index, void *p_userdata) {
+		// Submitting and waiting from a worker must not deadlock, even with every thread busy.
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		pool->wait_for_group_task_completion(pool->add_template_group_task(&counter, &ElementCounter::process, (void *)nullptr, 16));
+		outer_done.increment();
+	}
+};
+
+TEST_CASE("[WorkerThreadPool] Nested group tasks") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	REQUIRE(pool);
+
+	NestedWork work;
+	work.counter.counts.resize(16);
+
+	const uint32_t outer_count = MAX(2, pool->get_thread_count() * 2);
+	pool->wait_for_group_task_completion(pool->add_template_group_task(&work, &NestedWork::outer, (void *)nullptr, outer_count));
+
+	CHECK(work.outer_done.get() == outer_count);
+	CHECK(work.counter.counts[0].get() == outer_count);
+}
+
+} // namespace TestWorkerThreadPool
+
+#endif // TEST_WORKER_THREAD_POOL_H
@@ -31,7 +31,9 @@
 #ifndef TEST_ARRAY_H
 #define TEST_ARRAY_H
 
+#include "core/io/json.h"
 #include "core/variant/array.h"
+#include "core/variant/variant_parser.h"
 #include "tests/test_macros.h"
 #include "tests/test_tools.h"
 
@@ -516,6 +518,158 @@ TEST_CASE("[Array] Recursive self comparison") {
 	a2.clear();
 }
 
+TEST_CASE("[Array] Typed arrays of value types") {
+	Array ints;
+	ints.set_typed(Variant::INT, StringName(), Variant());
+	for (int i = 0; i < 10; i++) {
+		ints.push_back(9 - i);
+	}
+	ints.push_front(100);
+	ints.insert(1, -1);
+	CHECK(ints.size() == 12);
+	CHECK(ints.get(0) == Variant(100));
+	CHECK(ints.get(1) == Variant(-1));
+	CHECK(ints.get(11).get_type() == Variant::INT);
+	CHECK(ints.find(5) == 6);
+	CHECK(ints.count(5) == 1);
+	CHECK(ints.has(0));
+
+	ints.sort();
+	CHECK(ints.front() == Variant(-1));
+	CHECK(ints.back() == Variant(100));
+	CHECK(ints.bsearch(4) == 5);
+	ints.remove_at(0);
+	CHECK(ints.pop_back() == Variant(100));
+	CHECK(ints.size() == 10);
+
+	// Compares and hashes the same as the boxed equivalent.
+	Array boxed = build_array(0, 1, 2, 3, 4, 5, 6, 7, 8, 9);
+	CHECK(ints == boxed);
+	CHECK(ints.hash() == boxed.hash());
+	CHECK(Variant(ints).stringify() == "[0, 1, 2, 3, 4, 5, 6, 7, 8, 9]");
+
+	// Growing fills with the default value of the type rather than null.
+	ints.resize(12);
+	CHECK(ints.get(11).get_type() == Variant::INT);
+	CHECK(int(ints.get(11)) == 0);
+
+	Array copy = ints.duplicate();
+	copy.set(0, 42);
+	CHECK(int(ints.get(0)) == 0);
+	CHECK(int(copy.get(0)) == 42);
+
+	// Writing through element references keeps the contents.
+	ints[2] = 20;
+	CHECK(int(ints.get(2)) == 20);
+	ints.push_back(7);
+	CHECK(int(ints[12]) == 7);
+	ints.resize(14);
+	CHECK(ints.get(13).get_type() == Variant::INT);
+	ints.clear();
+	ints.push_back(1);
+	CHECK(ints.size() == 1);
+	CHECK(int(ints.get(0)) == 1);
+}
+
+TEST_CASE("[Array] Reading typed arrays of value types keeps them unboxed") {
+	Array ints;
+	ints.set_typed(Variant::INT, StringName(), Variant());
+	ints.push_back(1);
+	ints.push_back(2);
+	Array other_handle = ints;
+
+	Ref<JSON> json;
+	json.instantiate();
+	CHECK(json->stringify(ints) == "[1,2]");
+	String text;
+	CHECK(VariantWriter::write_to_string(ints, text) == OK);
+	CHECK(text == "[1, 2]");
+
+	const Array &const_ints = ints;
+	CHECK(int(const_ints[1]) == 2);
+	// References stay valid across reads of other elements.
+	const Variant &first = const_ints[0];
+	for (int i = 0; i < 100; i++) {
+		CHECK(int(const_ints[1]) == 2);
+	}
+	CHECK(&const_ints[0] == &first);
+	CHECK(int(first) == 1);
+	CHECK(ints.is_unboxed());
+
+	// Writes are seen through every handle and by references read before.
+	ints[0] = 10;
+	CHECK(int(first) == 10);
+	CHECK(int(other_handle.get(0)) == 10);
+	CHECK(int(other_handle.get(1)) == 2);
+	ints.set(1, 20);
+	CHECK(int(const_ints[1]) == 20);
+	CHECK(ints.is_unboxed());
+}
+
+TEST_CASE("[Array] Writing to typed arrays of value types keeps them unboxed") {
+	Array ints;
+	ints.set_typed(Variant::INT, StringName(), Variant());
+	ints.resize(4);
+
+	for (int i = 0; i < 4; i++) {
+		ints[i] = i * 10;
+	}
+	ints.push_back(40);
+	ints.reverse();
+	CHECK(ints.is_unboxed());
+	CHECK(ints == build_array(40, 30, 20, 10, 0));
+
+	Array copy = ints.duplicate();
+	ints[0] = 5;
+	CHECK(ints.duplicate() == build_array(5, 30, 20, 10, 0));
+	CHECK(copy.is_unboxed());
+	CHECK(int(copy.get(0)) == 40);
+
+	// Only a value of another type boxes the array.
+	ints[1] = "thirty";
+	CHECK(ints.is_unboxed());
+	CHECK(ints.get(1) == Variant("thirty"));
+	ints.push_back(50);
+	CHECK_FALSE(ints.is_unboxed());
+	CHECK(ints.get(1) == Variant("thirty"));
+	CHECK(ints.size() == 6);
+	CHECK(int(ints.get(5)) == 50);
+}
+
+TEST_CASE("[Array] Typed arrays of value types conversion") {
+	Array untyped = build_array(1.5, 2, 0.5);
+	Array floats;
+	floats.set_typed(Variant::FLOAT, StringName(), Variant());
+	CHECK(floats.typed_assign(untyped));
+	CHECK(floats.size() == 3);
+	CHECK(floats.get(1).get_type() == Variant::FLOAT);
+	floats.sort();
+	CHECK(double(floats.get(0)) == 0.5);
+	CHECK(double(floats.get(2)) == 2.0);
+
+	Array vectors;
+	vectors.set_typed(Variant::VECTOR3, StringName(), Variant());
+	vectors.push_back(Vector3(1, 2, 3));
+	vectors.append_array(vectors);
+	vectors.reverse();
+	CHECK(vectors.size() == 2);
+	CHECK(Vector3(vectors.get(1)) == Vector3(1, 2, 3));
+
+	ERR_PRINT_OFF;
+	vectors.push_back(Vector2(1, 2));
+	ERR_PRINT_ON;
+	CHECK(vectors.size() == 2);
+
+	PackedVector3Array packed = Variant(vectors);
+	CHECK(packed.size() == 2);
+	CHECK(packed[0] == Vector3(1, 2, 3));
+
+	Array back_to_untyped;
+	CHECK(back_to_untyped.typed_assign(vectors));
+	CHECK(back_to_untyped.get_typed_builtin() == Variant::NIL);
+	CHECK(back_to_untyped == vectors);
+}
+
 } // namespace TestArray
 
 #endif // TEST_ARRAY_H
@@ -104,6 +104,53 @@ TEST_CASE("[Dictionary] get_key_at_index()") {
 	CHECK(int(val) == 3);
 }
 
+TEST_CASE("[Dictionary] Insertion order with erased keys") {
+	Dictionary map;
+	// Go past the small size, so the lookup index gets used too.
+	for (int i = 0; i < 100; i++) {
+		map[i] = i * 10;
+	}
+	for (int i = 0; i < 100; i += 2) {
+		map.erase(i);
+	}
+	map[0] = "re-added";
+	CHECK(map.size() == 51);
+
+	CHECK(int(map.get_key_at_index(0)) == 1);
+	CHECK(int(map.get_value_at_index(0)) == 10);
+	CHECK(int(map.get_key_at_index(49)) == 99);
+	CHECK(int(map.get_key_at_index(50)) == 0);
+	CHECK(String(map.get_value_at_index(50)) == "re-added");
+	CHECK(map.get_key_at_index(51) == Variant());
+	CHECK(map.get_key_at_index(-1) == Variant());
+
+	Array keys = map.keys();
+	bool ordered = true;
+	for (int i = 0; i < 50; i++) {
+		if (int(keys[i]) != i * 2 + 1 || !map.has(i * 2 + 1) || map.has(i * 2 + 2)) {
+			ordered = false;
+		}
+	}
+	CHECK_MESSAGE(ordered, "Keys should keep their insertion order after erasing others.");
+
+	int count = 0;
+	for (const Variant *key = map.next(nullptr); key; key = map.next(key)) {
+		count++;
+	}
+	CHECK(count == 51);
+}
+
+TEST_CASE("[Dictionary] Value pointers stay valid when inserting") {
+	Dictionary map;
+	map["first"] = "value";
+	const Variant *first = map.getptr("first");
+	for (int i = 0; i < 100; i++) {
+		map[i] = map["first"];
+	}
+	CHECK(map.getptr("first") == first);
+	CHECK(String(map[99]) == "value");
+}
+
 TEST_CASE("[Dictionary] getptr()") {
 	Dictionary map;
 	map[1] = 3;
@@ -31,6 +31,8 @@
 #ifndef TEST_VARIANT_H
 #define TEST_VARIANT_H
 
+#include "core/io/dir_access.h"
+#include "core/os/os.h"
 #include "core/variant/variant.h"
 #include "core/variant/variant_parser.h"
 
@@ -911,6 +913,169 @@ TEST_CASE("[Variant] Nested dictionary comparison") {
 	CHECK_FALSE(v_d1 == v_d_other_val);
 }
 
+TEST_CASE("[VariantParser] Reading files with and without readahead") {
+	// Strings longer than the readahead buffer, so values span several reads.
+	const String long_string = String("abcdefghij").repeat(1000);
+	Dictionary dictionary;
+	dictionary["long"] = long_string;
+	dictionary["vector"] = Vector3(1, 2, 3);
+	Array array;
+	array.push_back(1);
+	array.push_back("two");
+	array.push_back(Color(0.5, 0.5, 0.5));
+	dictionary["array"] = array;
+	String dictionary_str;
+	VariantWriter::write_to_string(dictionary, dictionary_str);
+
+	const String path = OS::get_singleton()->get_cache_path().plus_file("variant_parser_readahead.tres");
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_line("[resource]");
+		f->store_line("first = " + dictionary_str);
+		f->store_line("second = \"" + long_string + "\"");
+		f->store_line("third = 3");
+	}
+
+	for (const bool readahead : { true, false }) {
+		VariantParser::StreamFile stream;
+		stream.readahead_enabled = readahead;
+		stream.f = FileAccess::open(path, FileAccess::READ);
+		REQUIRE(stream.f.is_valid());
+
+		VariantParser::Tag tag;
+		String error;
+		int line = 1;
+		REQUIRE(VariantParser::parse_tag(&stream, line, error, tag) == OK);
+		CHECK(tag.name == "resource");
+
+		String assign;
+		Variant value;
+		REQUIRE(VariantParser::parse_tag_assign_eof(&stream, line, error, tag, assign, value) == OK);
+		CHECK(assign == "first");
+		CHECK(value == Variant(dictionary));
+
+		// Parsing again from the same position gives the same value.
+		const uint64_t position = stream.get_position();
+		const int position_line = line;
+		REQUIRE(VariantParser::parse_tag_assign_eof(&stream, line, error, tag, assign, value) == OK);
+		CHECK(assign == "second");
+		CHECK(value == Variant(long_string));
+		stream.seek(position);
+		line = position_line;
+		REQUIRE(VariantParser::parse_tag_assign_eof(&stream, line, error, tag, assign, value) == OK);
+		CHECK(assign == "second");
+		CHECK(value == Variant(long_string));
+
+		REQUIRE(VariantParser::parse_tag_assign_eof(&stream, line, error, tag, assign, value) == OK);
+		CHECK(assign == "third");
+		CHECK(value == Variant(3));
+		// The dictionary is written over several lines.
+		CHECK(line == 3 + dictionary_str.get_slice_count("\n"));
+
+		CHECK(VariantParser::parse_tag_assign_eof(&stream, line, error, tag, assign, value) == ERR_FILE_EOF);
+		CHECK(stream.is_eof());
+	}
+
+	DirAccess::remove_file_or_error(path);
+}
+
+TEST_CASE("[VariantParser] Skipping values") {
+	VariantParser::StreamString stream;
+	stream.s = R"([sub_resource type="Resource" id="1"]
+constructor = Vector2(1, 2)
+spaced_constructor = Vector2 ( 3, 4 )
+resource = SubResource("2")
+nested = { "key": [1, 2, { "color": Color(1, 1, 1, 1) }] }
+string = "] ) }"
+string_name = &"name"
+identifier = true
+negative = -1.5
+
+[node name="Node" type="Node"]
+)";
+
+	VariantParser::Tag tag;
+	String error;
+	int line = 1;
+	REQUIRE(VariantParser::parse_tag(&stream, line, error, tag) == OK);
+	CHECK(tag.name == "sub_resource");
+
+	// Sub-resources aren't loaded when skipping, so no resource parser is needed.
+	Vector<String> assigns;
+	while (true) {
+		String assign;
+		REQUIRE(VariantParser::skip_tag_assign_eof(&stream, line, error, tag, assign) == OK);
+		if (assign.is_empty()) {
+			break;
+		}
+		assigns.push_back(assign);
+	}
+
+	Vector<String> expected;
+	for (const char *assign : { "constructor", "spaced_constructor", "resource", "nested", "string", "string_name", "identifier", "negative" }) {
+		expected.push_back(assign);
+	}
+	CHECK(assigns == expected);
+	CHECK(tag.name == "node");
+	CHECK(tag.fields["name"] == Variant("Node"));
+	CHECK(line == 11);
+}
+
+double benchmark_variant_parser_read(const String &p_path, bool p_readahead, bool p_skip) {
+	const uint64_t t = OS::get_singleton()->get_ticks_usec();
+	VariantParser::StreamFile stream;
+	stream.readahead_enabled = p_readahead;
+	stream.f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V(stream.f.is_null(), 0);
+	VariantParser::Tag tag;
+	String error;
+	int line = 1;
+	Error err = VariantParser::parse_tag(&stream, line, error, tag);
+	while (err == OK) {
+		String assign;
+		Variant value;
+		if (p_skip) {
+			err = VariantParser::skip_tag_assign_eof(&stream, line, error, tag, assign);
+		} else {
+			err = VariantParser::parse_tag_assign_eof(&stream, line, error, tag, assign, value);
+		}
+	}
+	ERR_FAIL_COND_V_MSG(err != ERR_FILE_EOF, 0, error);
+	return (OS::get_singleton()->get_ticks_usec() - t) / 1000.0;
+}
+
+void benchmark_variant_parser() {
+	const int sub_resources = 20000;
+	const String path = OS::get_singleton()->get_cache_path().plus_file("benchmark.tscn");
+	uint64_t size = 0;
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		ERR_FAIL_COND(f.is_null());
+		f->store_line(vformat("[gd_scene load_steps=%d format=3]", sub_resources + 1));
+		f->store_line("");
+		for (int i = 0; i < sub_resources; i++) {
+			f->store_line(vformat("[sub_resource type=\"Resource\" id=\"%d\"]", i));
+			f->store_line(vformat("resource_name = \"Resource number %d\"", i));
+			f->store_line(vformat("transform = Transform3D(1, 0, 0, 0, 1, 0, 0, 0, 1, %d, %d, %d)", i, -i, i * 2));
+			f->store_line(vformat("points = PackedVector2Array(%d, 0, 1.5, 2.5, 3.5, 4.5, 5.5, 6.5)", i));
+			f->store_line("metadata/tags = [\"one\", \"two\", \"three\"]");
+			f->store_line("");
+		}
+		f->store_line("[node name=\"Root\" type=\"Node\"]");
+		size = f->get_position();
+	}
+
+
+	print_line(vformat("Reading a scene with %d sub-resources (%s):", sub_resources, String::humanize_size(size)));
+	print_line(vformat("  parse, char by char  %8.2f ms", benchmark_variant_parser_read(path, false, false)));
+	print_line(vformat("  parse, readahead     %8.2f ms", benchmark_variant_parser_read(path, true, false)));
+	print_line(vformat("  skip, readahead      %8.2f ms", benchmark_variant_parser_read(path, true, true)));
+
+	DirAccess::remove_file_or_error(path);
+}
+
+REGISTER_TEST_COMMAND("variant-parser-benchmark", &benchmark_variant_parser);
 } // namespace TestVariant
 
 #endif // TEST_VARIANT_H
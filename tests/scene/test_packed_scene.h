@@ -0,0 +1,388 @@
+/*************************************************************************/
+/*  test_packed_scene.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PACKED_SCENE_H
+#define TEST_PACKED_SCENE_H
+
+#include "core/config/engine.h"
+#include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/resource_loader.h"
+#include "core/object/script_language.h"
+#include "core/os/os.h"
+#include "scene/main/node.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+// Declared in global namespace because of GDCLASS macro warning (Windows):
+// "Unqualified friend declaration referring to type outside of the nearest enclosing namespace
+// is a Microsoft extension; add a nested name specifier".
+class _TestPackedSceneNode : public Node {
+	GDCLASS(_TestPackedSceneNode, Node);
+
+	int value = 0;
+
+protected:
+	static void _bind_methods() {
+		ClassDB::bind_method(D_METHOD("set_value", "value"), &_TestPackedSceneNode::set_value);
+		ClassDB::bind_method(D_METHOD("get_value"), &_TestPackedSceneNode::get_value);
+		ADD_PROPERTY(PropertyInfo(Variant::INT, "value"), "set_value", "get_value");
+	}
+
+public:
+	// Given to the nodes created from then on.
+	static inline ScriptInstance *(*create_script_instance)() = nullptr;
+
+	int set_calls = 0;
+
+	void set_value(int p_value) {
+		value = p_value;
+		set_calls++;
+	}
+	int get_value() const { return value; }
+
+	_TestPackedSceneNode() {
+		if (create_script_instance) {
+			set_script_instance(create_script_instance());
+		}
+	}
+};
+
+namespace TestPackedScene {
+
+// Handles every property, as a script overriding them would.
+class _MockScriptInstance : public ScriptInstance {
+	HashMap<StringName, Variant> properties;
+
+public:
+	bool set(const StringName &p_name, const Variant &p_value) override {
+		properties[p_name] = p_value;
+		return true;
+	}
+	bool get(const StringName &p_name, Variant &r_ret) const override {
+		if (properties.has(p_name)) {
+			r_ret = properties[p_name];
+			return true;
+		}
+		return false;
+	}
+	void get_property_list(List<PropertyInfo> *p_properties) const override {
+	}
+	Variant::Type get_property_type(const StringName &p_name, bool *r_is_valid) const override {
+		return Variant::NIL;
+	}
+	void get_method_list(List<MethodInfo> *p_list) const override {
+	}
+	bool has_method(const StringName &p_method) const override {
+		return false;
+	}
+	Variant callp(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) override {
+		return Variant();
+	}
+	void notification(int p_notification) override {
+	}
+	Ref<Script> get_script() const override {
+		return Ref<Script>();
+	}
+	const Vector<Multiplayer::RPCConfig> get_rpc_methods() const override {
+		return Vector<Multiplayer::RPCConfig>();
+	}
+	ScriptLanguage *get_language() override {
+		return nullptr;
+	}
+};
+
+ScriptInstance *create_mock_script_instance() {
+	return memnew(_MockScriptInstance);
+}
+
+Ref<PackedScene> make_packed_scene() {
+	GDREGISTER_CLASS(_TestPackedSceneNode);
+
+	Node *root = memnew(Node);
+	root->set_name("Root");
+	_TestPackedSceneNode *child = memnew(_TestPackedSceneNode);
+	child->set_name("Child");
+	child->set_value(42);
+	root->add_child(child);
+	child->set_owner(root);
+
+	Ref<PackedScene> scene;
+	scene.instantiate();
+	Error err = scene->pack(root);
+	memdelete(root);
+	if (err != OK) {
+		return Ref<PackedScene>();
+	}
+	return scene;
+}
+
+_TestPackedSceneNode *get_test_child(Node *p_instance) {
+	if (!p_instance || p_instance->get_child_count() != 1) {
+		return nullptr;
+	}
+	return Object::cast_to<_TestPackedSceneNode>(p_instance->get_child(0));
+}
+
+TEST_CASE("[PackedScene] Instantiating with cached property setters") {
+	Ref<PackedScene> scene = make_packed_scene();
+	REQUIRE(scene.is_valid());
+
+	// Only the child has a property to set, the root has none.
+	Ref<SceneState> state = scene->get_state();
+	uint64_t cached_calls = state->get_cached_setter_calls();
+
+	// The first instance looks the setters up.
+	Node *instance = scene->instantiate();
+	_TestPackedSceneNode *child = get_test_child(instance);
+	REQUIRE(child);
+	CHECK(child->get_value() == 42);
+	CHECK(child->set_calls == 1);
+	CHECK(state->get_cached_setter_calls() == cached_calls + 1);
+	memdelete(instance);
+
+	instance = scene->instantiate();
+	child = get_test_child(instance);
+	REQUIRE(child);
+	CHECK(child->get_value() == 42);
+	CHECK(child->set_calls == 1);
+	CHECK(state->get_cached_setter_calls() == cached_calls + 2);
+	memdelete(instance);
+	cached_calls += 2;
+
+	SUBCASE("Methods bound since") {
+		const uint32_t generation = ClassDB::get_method_generation();
+		if (!ClassDB::has_method("_TestPackedSceneNode", "set_value_again")) {
+			ClassDB::bind_method(D_METHOD("set_value_again", "value"), &_TestPackedSceneNode::set_value);
+		}
+		CHECK(ClassDB::get_method_generation() != generation);
+
+		instance = scene->instantiate();
+		child = get_test_child(instance);
+		REQUIRE(child);
+		CHECK(child->get_value() == 42);
+		CHECK(child->set_calls == 1);
+		CHECK(state->get_cached_setter_calls() == cached_calls + 1);
+		memdelete(instance);
+	}
+
+	SUBCASE("A script handling the property") {
+		_TestPackedSceneNode::create_script_instance = &create_mock_script_instance;
+		instance = scene->instantiate();
+		_TestPackedSceneNode::create_script_instance = nullptr;
+		child = get_test_child(instance);
+		REQUIRE(child);
+		REQUIRE(child->get_script_instance());
+		CHECK_MESSAGE(
+				child->set_calls == 0,
+				"The cached setter should not be called when a script handles the property.");
+		CHECK(child->get_value() == 0);
+		Variant value;
+		CHECK(child->get_script_instance()->get("value", value));
+		CHECK(value == Variant(42));
+		CHECK(state->get_cached_setter_calls() == cached_calls);
+		memdelete(instance);
+	}
+
+#ifdef TOOLS_ENABLED
+	SUBCASE("In the editor") {
+		// Properties are set through Object::set(), which marks the node as edited.
+		Engine::get_singleton()->set_editor_hint(true);
+		instance = scene->instantiate();
+		Engine::get_singleton()->set_editor_hint(false);
+		child = get_test_child(instance);
+		REQUIRE(child);
+		CHECK(child->get_value() == 42);
+		CHECK(child->set_calls == 1);
+		CHECK(child->is_edited());
+		CHECK(state->get_cached_setter_calls() == cached_calls);
+		memdelete(instance);
+	}
+#endif
+}
+
+TEST_CASE("[PackedScene] Instantiating many") {
+	Ref<PackedScene> scene = make_packed_scene();
+	REQUIRE(scene.is_valid());
+
+	TypedArray<Node> instances = scene->instantiate_many(3);
+	REQUIRE(instances.size() == 3);
+	for (int i = 0; i < instances.size(); i++) {
+		Node *instance = Object::cast_to<Node>(instances[i]);
+		_TestPackedSceneNode *child = get_test_child(instance);
+		REQUIRE(child);
+		CHECK(child->get_value() == 42);
+		for (int j = 0; j < i; j++) {
+			CHECK(Object::cast_to<Node>(instances[j]) != instance);
+		}
+	}
+	for (int i = 0; i < instances.size(); i++) {
+		memdelete(Object::cast_to<Node>(instances[i]));
+	}
+
+	CHECK(scene->instantiate_many(0).is_empty());
+	ERR_PRINT_OFF;
+	CHECK(scene->instantiate_many(-1).is_empty());
+	ERR_PRINT_ON;
+}
+
+// The node references a sub-resource, which references one further down the
+// file. Another one is referenced by nothing.
+const char *text_scene =
+		"[gd_scene load_steps=4 format=3]\n"
+		"\n"
+		"[sub_resource type=\"Resource\" id=\"Resource_used\"]\n"
+		"resource_name = \"used\"\n"
+		"metadata/next = SubResource(\"Resource_forward\")\n"
+		"\n"
+		"[sub_resource type=\"Resource\" id=\"Resource_unused\"]\n"
+		"resource_name = \"unused\"\n"
+		"\n"
+		"[sub_resource type=\"Resource\" id=\"Resource_forward\"]\n"
+		"resource_name = \"forward\"\n"
+		"\n"
+		"[node name=\"Root\" type=\"Node\"]\n"
+		"metadata/resource = SubResource(\"Resource_used\")\n";
+
+String write_text_scene(const String &p_name) {
+	const String path = ProjectSettings::get_singleton()->localize_path(OS::get_singleton()->get_cache_path().plus_file(p_name));
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+	if (f.is_valid()) {
+		f->store_string(text_scene);
+	}
+	return path;
+}
+
+TEST_CASE("[PackedScene] Loading sub-resources of text scenes") {
+	const String path = write_text_scene("sub_resources.tscn");
+	Ref<PackedScene> scene = ResourceLoader::load(path);
+	REQUIRE(scene.is_valid());
+
+	Node *root = scene->instantiate();
+	REQUIRE(root);
+	const Ref<Resource> used = root->get_meta("resource");
+	REQUIRE(used.is_valid());
+	CHECK(used->get_name() == "used");
+	CHECK(used->get_path() == path + "::Resource_used");
+	const Ref<Resource> forward = used->get_meta("next");
+	REQUIRE(forward.is_valid());
+	CHECK(forward->get_name() == "forward");
+	CHECK(ResourceCache::has(path + "::Resource_forward"));
+	CHECK_MESSAGE(
+			!ResourceCache::has(path + "::Resource_unused"),
+			"Sub-resources nothing references should not be created.");
+	memdelete(root);
+
+	DirAccess::remove_file_or_error(path);
+}
+
+TEST_CASE("[PackedScene] Replacing sub-resources of text scenes") {
+	const String path = write_text_scene("replace_sub_resources.tscn");
+	Vector<Ref<Resource>> cached;
+	for (const char *id : { "Resource_used", "Resource_unused", "Resource_forward" }) {
+		Ref<Resource> resource = memnew(Resource);
+		resource->set_name("stale");
+		resource->set_path(path + "::" + id);
+		cached.push_back(resource);
+	}
+
+	Ref<PackedScene> scene = ResourceLoader::load(path, "", ResourceFormatLoader::CACHE_MODE_REPLACE);
+	REQUIRE(scene.is_valid());
+
+	// The cached instances are kept, with the values from the file, whether the
+	// scene references them or not.
+	CHECK(cached[0]->get_name() == "used");
+	CHECK(cached[1]->get_name() == "unused");
+	CHECK(cached[2]->get_name() == "forward");
+	CHECK(Ref<Resource>(cached[0]->get_meta("next")) == cached[2]);
+
+	Node *root = scene->instantiate();
+	REQUIRE(root);
+	CHECK(Ref<Resource>(root->get_meta("resource")) == cached[0]);
+	memdelete(root);
+
+	DirAccess::remove_file_or_error(path);
+}
+
+double benchmark_text_scene_load(const String &p_path, ResourceFormatLoader::CacheMode p_cache_mode) {
+	const uint64_t start = OS::get_singleton()->get_ticks_usec();
+	Ref<PackedScene> scene = ResourceLoader::load(p_path, "", p_cache_mode);
+	ERR_FAIL_COND_V(scene.is_null(), 0);
+	Node *root = scene->instantiate();
+	ERR_FAIL_NULL_V(root, 0);
+	memdelete(root);
+	return (OS::get_singleton()->get_ticks_usec() - start) / 1000.0;
+}
+
+void benchmark_text_scene() {
+	const int sub_resources = 20000;
+	const String path = OS::get_singleton()->get_cache_path().plus_file("benchmark_scene.tscn");
+
+	for (const int referenced_every : { 1, 10 }) {
+		uint64_t size = 0;
+		{
+			Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+			ERR_FAIL_COND(f.is_null());
+			f->store_line(vformat("[gd_scene load_steps=%d format=3]", sub_resources + 1));
+			f->store_line("");
+			for (int i = 0; i < sub_resources; i++) {
+				f->store_line(vformat("[sub_resource type=\"Resource\" id=\"%d\"]", i));
+				f->store_line(vformat("resource_name = \"Resource number %d\"", i));
+				f->store_line(vformat("metadata/transform = Transform3D(1, 0, 0, 0, 1, 0, 0, 0, 1, %d, %d, %d)", i, -i, i * 2));
+				f->store_line(vformat("metadata/points = PackedVector2Array(%d, 0, 1.5, 2.5, 3.5, 4.5, 5.5, 6.5)", i));
+				f->store_line("metadata/tags = [\"one\", \"two\", \"three\"]");
+				f->store_line("");
+			}
+			f->store_line("[node name=\"Root\" type=\"Node\"]");
+			f->store_line("");
+			for (int i = 0; i < sub_resources; i += referenced_every) {
+				f->store_line(vformat("[node name=\"Child%d\" type=\"Node\" parent=\".\"]", i));
+				f->store_line(vformat("metadata/resource = SubResource(\"%d\")", i));
+				f->store_line("");
+			}
+			size = f->get_position();
+		}
+
+		// Replacing creates every sub-resource, as loading did before they were
+		// created lazily.
+		print_line(vformat("Loading a scene with %d sub-resources, %d referenced (%s):", sub_resources, sub_resources / referenced_every, String::humanize_size(size)));
+		print_line(vformat("  referenced only  %8.2f ms", benchmark_text_scene_load(path, ResourceFormatLoader::CACHE_MODE_IGNORE)));
+		print_line(vformat("  all (replace)    %8.2f ms", benchmark_text_scene_load(path, ResourceFormatLoader::CACHE_MODE_REPLACE)));
+	}
+
+	DirAccess::remove_file_or_error(path);
+}
+
+REGISTER_TEST_COMMAND("text-scene-benchmark", &benchmark_text_scene);
+} // namespace TestPackedScene
+
+#endif // TEST_PACKED_SCENE_H
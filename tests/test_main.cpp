@@ -30,13 +30,17 @@
 
 #include "test_main.h"
 
+#include "tests/core/io/test_compression.h"
 #include "tests/core/io/test_config_file.h"
 #include "tests/core/io/test_file_access.h"
+#include "tests/core/io/test_file_access_async.h"
 #include "tests/core/io/test_image.h"
 #include "tests/core/io/test_json.h"
 #include "tests/core/io/test_marshalls.h"
 #include "tests/core/io/test_pck_packer.h"
 #include "tests/core/io/test_resource.h"
+#include "tests/core/io/test_resource_import_cache.h"
+#include "tests/core/io/test_variant_schema.h"
 #include "tests/core/io/test_xml_parser.h"
 #include "tests/core/math/test_aabb.h"
 #include "tests/core/math/test_astar.h"
@@ -54,12 +58,18 @@
 #include "tests/core/math/test_vector3.h"
 #include "tests/core/math/test_vector3i.h"
 #include "tests/core/object/test_class_db.h"
+#include "tests/core/object/test_message_queue.h"
 #include "tests/core/object/test_method_bind.h"
 #include "tests/core/object/test_object.h"
+#include "tests/core/os/test_arena_allocator.h"
+#include "tests/core/os/test_small_block_allocator.h"
 #include "tests/core/string/test_node_path.h"
 #include "tests/core/string/test_string.h"
+#include "tests/core/string/test_string_name.h"
 #include "tests/core/string/test_translation.h"
 #include "tests/core/templates/test_command_queue.h"
+#include "tests/core/templates/test_compact_hash_map.h"
+#include "tests/core/templates/test_flat_hash_map.h"
 #include "tests/core/templates/test_hash_map.h"
 #include "tests/core/templates/test_hash_set.h"
 #include "tests/core/templates/test_list.h"
@@ -70,6 +80,7 @@
 #include "tests/core/test_crypto.h"
 #include "tests/core/test_hashing_context.h"
 #include "tests/core/test_time.h"
+#include "tests/core/threads/test_worker_thread_pool.h"
 #include "tests/core/variant/test_array.h"
 #include "tests/core/variant/test_dictionary.h"
 #include "tests/core/variant/test_variant.h"
@@ -77,6 +88,7 @@
 #include "tests/scene/test_code_edit.h"
 #include "tests/scene/test_curve.h"
 #include "tests/scene/test_gradient.h"
+#include "tests/scene/test_packed_scene.h"
 #include "tests/scene/test_path_3d.h"
 #include "tests/scene/test_text_edit.h"
 #include "tests/scene/test_theme.h"